@@ -33,6 +33,17 @@ void Mutation::AddWriteOp(MutationOpType type, const std::string& table,
       MutationOp(type, table, std::move(columns), std::move(values)));
 }
 
+void Mutation::AddWriteOp(MutationOpType type, const Table* table,
+                          const std::string& table_name,
+                          std::vector<const Column*> columns,
+                          std::vector<std::string> column_names,
+                          std::vector<ValueList> values) {
+  MutationOp& op = ops_.emplace_back(
+      MutationOp(type, table_name, std::move(column_names), std::move(values)));
+  op.resolved_table = table;
+  op.resolved_columns = std::move(columns);
+}
+
 void Mutation::AddDeleteOp(const std::string& table, const KeySet& key_set) {
   ops_.emplace_back(MutationOp(MutationOpType::kDelete, table, key_set));
 }
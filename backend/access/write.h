@@ -33,6 +33,9 @@ namespace spanner {
 namespace emulator {
 namespace backend {
 
+class Column;
+class Table;
+
 // MutationOpType enumerates the type of mutation operations.
 enum class MutationOpType {
   kInsert,
@@ -71,6 +74,13 @@ struct MutationOp {
 
   // Mutation data for kDelete.
   KeySet key_set;
+
+  // Schema objects named by `table` and `columns`, if the producer of the op
+  // already resolved them (e.g. while converting a request). The transaction
+  // then skips resolving the names again, provided that `resolved_table` is
+  // still the table named `table` in its schema.
+  const Table* resolved_table = nullptr;
+  std::vector<const Column*> resolved_columns;
 };
 
 // Streams a debug string representation of MutationOp to out.
@@ -89,6 +99,14 @@ class Mutation {
                   std::vector<std::string> columns,
                   std::vector<ValueList> values);
 
+  // Same as above, for a table and columns which were already resolved against
+  // the schema. `column_names` are the names of `columns`.
+  void AddWriteOp(MutationOpType type, const Table* table,
+                  const std::string& table_name,
+                  std::vector<const Column*> columns,
+                  std::vector<std::string> column_names,
+                  std::vector<ValueList> values);
+
   // Adds a Delete MutationOp to this Mutation.
   void AddDeleteOp(const std::string& table, const KeySet& key_set);
 
@@ -19,8 +19,10 @@
 #include <variant>
 
 #include "absl/status/status.h"
+#include "absl/types/span.h"
 #include "backend/actions/ops.h"
 #include "absl/status/status.h"
+#include "zetasql/base/status_macros.h"
 
 namespace google {
 namespace spanner {
@@ -106,6 +108,14 @@ absl::Status Verifier::Verify(const ActionContext* ctx,
                     op);
 }
 
+absl::Status Verifier::VerifyBatch(const ActionContext* ctx,
+                                   absl::Span<const WriteOp> ops) const {
+  for (const WriteOp& op : ops) {
+    ZETASQL_RETURN_IF_ERROR(Verify(ctx, op));
+  }
+  return absl::OkStatus();
+}
+
 absl::Status Verifier::Verify(const ActionContext* ctx,
                               const InsertOp& op) const {
   return absl::OkStatus();
@@ -20,6 +20,7 @@
 #include <string>
 
 #include "absl/status/status.h"
+#include "absl/types/span.h"
 #include "backend/actions/context.h"
 #include "backend/actions/ops.h"
 #include "backend/schema/catalog/table.h"
@@ -155,6 +156,13 @@ class Verifier {
   // context.
   absl::Status Verify(const ActionContext* ctx, const WriteOp& op) const;
 
+  // Executes the verification on a batch of WriteOps within the given action
+  // context. All ops in the batch belong to the same table and are sorted in
+  // key order. The default implementation verifies each op individually;
+  // verifiers which can share storage accesses across ops override this.
+  virtual absl::Status VerifyBatch(const ActionContext* ctx,
+                                   absl::Span<const WriteOp> ops) const;
+
  private:
   virtual absl::Status Verify(const ActionContext* ctx,
                               const InsertOp& op) const;
@@ -77,9 +77,8 @@ RetrieveTableWithTrackedChangeStreams(const Schema* schema) {
   absl::flat_hash_map<const Table*, std::vector<const ChangeStream*>>
       table_with_tracked_change_streams;
   for (const ChangeStream* change_stream : schema->change_streams()) {
-    absl::flat_hash_map<std::string, std::vector<std::string>>
-        tracked_tables_columns = change_stream->tracked_tables_columns();
-    for (const auto& [table, columns] : tracked_tables_columns) {
+    for (const auto& [table, columns] :
+         change_stream->tracked_tables_columns()) {
       table_with_tracked_change_streams[schema->FindTable(table)].emplace_back(
           change_stream);
     }
@@ -133,9 +132,10 @@ int64_t GetOrdinalPosition(const Table* table, const Column* column) {
 
 // Compare if the list of non-key columns tracked by the change stream in this
 // writeOp is the same as that from last mod group.
-bool CheckIfNonKeyColumnsRemainSame(std::vector<const Column*> op_columns,
-                                    ModGroup last_mod_group, const Table* table,
-                                    const ChangeStream* change_stream) {
+bool CheckIfNonKeyColumnsRemainSame(
+    const std::vector<const Column*>& op_columns,
+    const ModGroup& last_mod_group, const Table* table,
+    const ChangeStream* change_stream) {
   std::vector<const Column*> op_non_key_columns_tracked_by_change_stream;
   for (const Column* column : op_columns) {
     if (column->FindChangeStream(change_stream->Name())) {
@@ -161,23 +161,27 @@ std::string ToFragmentIdString(int64_t record_sequence) {
 }
 
 // Mods inside one DataChangeRecord have the same set of mod type, user table,
-// tracked non-key columns, and change stream.
+// tracked non-key columns, and change stream. The column types and mods are
+// moved out of the last mod group of the change stream, which must be erased or
+// discarded afterwards.
 DataChangeRecord BuildDataChangeRecord(
     std::string tracked_table_name, std::string value_capture_type,
     const ChangeStream* change_stream, TransactionID transaction_id,
     int64_t record_sequence_number,
     absl::flat_hash_map<const ChangeStream*, ModGroup>*
         last_mod_group_by_change_stream) {
-  std::vector<ColumnType> column_types =
-      (*last_mod_group_by_change_stream)[change_stream].column_types;
+  ModGroup& mod_group = (*last_mod_group_by_change_stream)[change_stream];
   std::string record_sequence = ToFragmentIdString(record_sequence_number);
   DataChangeRecord record{
-      (*last_mod_group_by_change_stream)[change_stream].partition_token_str,
+      mod_group.partition_token_str,
       zetasql::Value::Timestamp(kCommitTimestampValueSentinel),
-      std::to_string(transaction_id), record_sequence, false,
-      tracked_table_name, column_types,
-      (*last_mod_group_by_change_stream)[change_stream].mods,
-      (*last_mod_group_by_change_stream)[change_stream].mod_type,
+      std::to_string(transaction_id),
+      record_sequence,
+      false,
+      tracked_table_name,
+      std::move(mod_group.column_types),
+      std::move(mod_group.mods),
+      mod_group.mod_type,
       value_capture_type,
       -1,  // number_of_records_in_transaction will be reset after processing
            // all mods in one transaction
@@ -351,7 +355,7 @@ absl::Status LogTableMod(
           last_mod_group_by_change_stream);
       last_mod_group_by_change_stream->erase(change_stream);
       (*data_change_records_in_transaction_by_change_stream)[change_stream]
-          .push_back(record);
+          .push_back(std::move(record));
     }
   }
 
@@ -422,8 +426,8 @@ absl::Status LogTableMod(
 }
 
 std::pair<std::vector<const Column*>, std::vector<zetasql::Value>>
-GetTrackedColumnsAndValues(std::vector<const Column*> columns,
-                           std::vector<zetasql::Value> values,
+GetTrackedColumnsAndValues(const std::vector<const Column*>& columns,
+                           const std::vector<zetasql::Value>& values,
                            const ChangeStream* change_stream,
                            const Table* table) {
   std::vector<const Column*> tracked_columns;
@@ -440,7 +444,7 @@ GetTrackedColumnsAndValues(std::vector<const Column*> columns,
 }
 
 absl::Status LogTableMod(
-    WriteOp op, const ChangeStream* change_stream,
+    const WriteOp& op, const ChangeStream* change_stream,
     zetasql::Value partition_token,
     absl::flat_hash_map<const ChangeStream*, std::vector<DataChangeRecord>>*
         data_change_records_in_transaction_by_change_stream,
@@ -635,8 +639,8 @@ absl::StatusOr<Key> ComputeChangeStreamDataTableKey(
 }
 
 absl::StatusOr<WriteOp> ConvertDataChangeRecordToWriteOp(
-    const ChangeStream* change_stream, DataChangeRecord record,
-    std::vector<const Column*> columns) {
+    const ChangeStream* change_stream, const DataChangeRecord& record,
+    const std::vector<const Column*>& columns) {
   // Compute change_stream_data_table key
   ZETASQL_ASSIGN_OR_RETURN(Key change_stream_data_table_key,
                    ComputeChangeStreamDataTableKey(
@@ -754,7 +758,7 @@ std::vector<WriteOp> BuildMutation(
           std::vector<DataChangeRecord>();
     }
     (*data_change_records_in_transaction_by_change_stream)[change_stream]
-        .push_back(record);
+        .push_back(std::move(record));
   }
   for (auto& [change_stream, records] :
        *data_change_records_in_transaction_by_change_stream) {
@@ -768,7 +772,7 @@ std::vector<WriteOp> BuildMutation(
     (*data_change_records_in_transaction_by_change_stream)
         [change_stream][number_of_records_in_transaction - 1]
             .is_last_record_in_transaction_in_partition = true;
-    for (DataChangeRecord record : records) {
+    for (DataChangeRecord& record : records) {
       record.number_of_records_in_transaction =
           number_of_records_in_transaction;
       write_ops.push_back(
@@ -780,8 +784,11 @@ std::vector<WriteOp> BuildMutation(
 }
 
 absl::StatusOr<std::vector<WriteOp>> BuildChangeStreamWriteOps(
-    const Schema* schema, std::vector<WriteOp> buffered_write_ops,
+    const Schema* schema, const std::vector<WriteOp>& buffered_write_ops,
     ReadOnlyStore* store, TransactionID transaction_id) {
+  if (schema->change_streams().empty()) {
+    return std::vector<WriteOp>();
+  }
   // Map for change streams and their partition tokens within the transaction.
   absl::flat_hash_map<const ChangeStream*, zetasql::Value>
       change_stream_with_partition_token;
@@ -797,9 +804,12 @@ absl::StatusOr<std::vector<WriteOp>> BuildChangeStreamWriteOps(
   absl::flat_hash_map<const ChangeStream*, ModGroup>
       last_mod_group_by_change_stream;
   for (const auto& write_op : buffered_write_ops) {
-    const Table* table = TableOf(write_op);
-    for (const ChangeStream* change_stream :
-         table_with_tracked_change_streams[table]) {
+    auto tracking_change_streams =
+        table_with_tracked_change_streams.find(TableOf(write_op));
+    if (tracking_change_streams == table_with_tracked_change_streams.end()) {
+      continue;
+    }
+    for (const ChangeStream* change_stream : tracking_change_streams->second) {
       if (!change_stream_with_partition_token.contains(change_stream)) {
         change_stream_with_partition_token[change_stream] =
             RetrieveChangeStreamWithPartitionToken(store, change_stream)
@@ -89,7 +89,7 @@ struct ModGroup {
 // Group table mods belonging to the same DataChangeRecord into the same
 // ModGroup.
 absl::Status LogTableMod(
-    WriteOp op, const ChangeStream* change_stream,
+    const WriteOp& op, const ChangeStream* change_stream,
     zetasql::Value partition_token,
     absl::flat_hash_map<const ChangeStream*, std::vector<DataChangeRecord>>*
         data_change_records_in_transaction_by_change_stream,
@@ -110,7 +110,7 @@ std::vector<WriteOp> BuildMutation(
 
 // Build change stream write_ops.
 absl::StatusOr<std::vector<WriteOp>> BuildChangeStreamWriteOps(
-    const Schema* schema, std::vector<WriteOp> buffered_write_ops,
+    const Schema* schema, const std::vector<WriteOp>& buffered_write_ops,
     ReadOnlyStore* store, TransactionID transaction_id);
 }  // namespace backend
 }  // namespace emulator
@@ -16,12 +16,19 @@
 
 #include "backend/actions/foreign_key.h"
 
+#include <algorithm>
+#include <variant>
+#include <vector>
+
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
+#include "absl/types/span.h"
 #include "backend/actions/action.h"
 #include "backend/actions/context.h"
 #include "backend/actions/ops.h"
+#include "backend/datamodel/key.h"
 #include "backend/datamodel/key_range.h"
 #include "backend/storage/iterator.h"
 #include "common/errors.h"
@@ -33,6 +40,49 @@ namespace spanner {
 namespace emulator {
 namespace backend {
 
+namespace {
+
+void SortAndDedupKeys(std::vector<Key>* keys) {
+  std::sort(keys->begin(), keys->end());
+  keys->erase(std::unique(keys->begin(), keys->end()), keys->end());
+}
+
+// Returns for each of the sorted and deduplicated prefix_keys whether a row
+// with that key prefix exists in data_table.
+//
+// Each key is probed with its own prefix lookup, in key order. Storage reads
+// materialize and lock every row of the key range they cover, so a single
+// scan over the range spanned by the keys would read the whole table for a
+// batch touching keys at both of its ends.
+absl::StatusOr<std::vector<bool>> PrefixesExist(
+    const ActionContext* ctx, const Table* data_table,
+    const std::vector<Key>& prefix_keys) {
+  std::vector<bool> exists(prefix_keys.size(), false);
+  for (int i = 0; i < prefix_keys.size(); ++i) {
+    ZETASQL_ASSIGN_OR_RETURN(bool found,
+                     ctx->store()->PrefixExists(data_table, prefix_keys[i]));
+    exists[i] = found;
+  }
+  return exists;
+}
+
+// Returns the index of key in the sorted and deduplicated keys.
+int FindSortedKey(const std::vector<Key>& keys, const Key& key) {
+  return std::lower_bound(keys.begin(), keys.end(), key) - keys.begin();
+}
+
+}  // namespace
+
+Key ForeignKeyPrefix(const Key& key, int num_columns, const Table* data_table) {
+  Key prefix;
+  for (int i = 0; i < num_columns; ++i) {
+    const KeyColumn* key_column = data_table->primary_key()[i];
+    prefix.AddColumn(key.ColumnValue(i), key_column->is_descending(),
+                     key_column->is_nulls_last());
+  }
+  return prefix;
+}
+
 ForeignKeyReferencingVerifier::ForeignKeyReferencingVerifier(
     const ForeignKey* foreign_key)
     : foreign_key_(foreign_key) {}
@@ -60,6 +110,41 @@ absl::Status ForeignKeyReferencingVerifier::Verify(const ActionContext* ctx,
   return absl::OkStatus();
 }
 
+absl::Status ForeignKeyReferencingVerifier::VerifyBatch(
+    const ActionContext* ctx, absl::Span<const WriteOp> ops) const {
+  if (!foreign_key_->enforced()) {
+    return absl::OkStatus();
+  }
+  const int num_columns = foreign_key_->referencing_columns().size();
+  const Table* referenced_data_table = foreign_key_->referenced_data_table();
+  std::vector<Key> keys;
+  keys.reserve(ops.size());
+  for (const WriteOp& op : ops) {
+    if (const InsertOp* insert_op = std::get_if<InsertOp>(&op)) {
+      keys.push_back(
+          ForeignKeyPrefix(insert_op->key, num_columns, referenced_data_table));
+    }
+  }
+  SortAndDedupKeys(&keys);
+
+  ZETASQL_ASSIGN_OR_RETURN(std::vector<bool> exists,
+                   PrefixesExist(ctx, referenced_data_table, keys));
+  // Report the first offending op, as verifying the ops one by one would.
+  for (const WriteOp& op : ops) {
+    if (const InsertOp* insert_op = std::get_if<InsertOp>(&op)) {
+      Key key =
+          ForeignKeyPrefix(insert_op->key, num_columns, referenced_data_table);
+      if (!exists[FindSortedKey(keys, key)]) {
+        return error::ForeignKeyReferencedKeyNotFound(
+            foreign_key_->Name(), foreign_key_->referencing_table()->Name(),
+            foreign_key_->referenced_table()->Name(),
+            Key(key.column_values()).DebugString());
+      }
+    }
+  }
+  return absl::OkStatus();
+}
+
 ForeignKeyReferencedVerifier::ForeignKeyReferencedVerifier(
     const ForeignKey* foreign_key)
     : foreign_key_(foreign_key) {}
@@ -96,6 +181,62 @@ absl::Status ForeignKeyReferencedVerifier::Verify(const ActionContext* ctx,
   return absl::OkStatus();
 }
 
+absl::Status ForeignKeyReferencedVerifier::VerifyBatch(
+    const ActionContext* ctx, absl::Span<const WriteOp> ops) const {
+  if (!foreign_key_->enforced()) {
+    return absl::OkStatus();
+  }
+  const int num_columns = foreign_key_->referencing_columns().size();
+  const Table* referenced_data_table = foreign_key_->referenced_data_table();
+  const Table* referencing_data_table = foreign_key_->referencing_data_table();
+  std::vector<Key> deleted_keys;
+  deleted_keys.reserve(ops.size());
+  for (const WriteOp& op : ops) {
+    if (const DeleteOp* delete_op = std::get_if<DeleteOp>(&op)) {
+      deleted_keys.push_back(
+          ForeignKeyPrefix(delete_op->key, num_columns, referenced_data_table));
+    }
+  }
+  SortAndDedupKeys(&deleted_keys);
+
+  // A deleted key may have been inserted back later in the same transaction,
+  // so only the keys which are really gone from the referenced index need to
+  // be checked against the referencing index.
+  ZETASQL_ASSIGN_OR_RETURN(std::vector<bool> still_referenced,
+                   PrefixesExist(ctx, referenced_data_table, deleted_keys));
+  std::vector<Key> removed_keys;
+  for (int i = 0; i < deleted_keys.size(); ++i) {
+    if (!still_referenced[i]) {
+      removed_keys.push_back(ForeignKeyPrefix(deleted_keys[i], num_columns,
+                                              referencing_data_table));
+    }
+  }
+  // The referencing index may order its columns differently.
+  SortAndDedupKeys(&removed_keys);
+
+  ZETASQL_ASSIGN_OR_RETURN(std::vector<bool> referencing_key_exists,
+                   PrefixesExist(ctx, referencing_data_table, removed_keys));
+  // Report the first offending op, as verifying the ops one by one would.
+  for (const WriteOp& op : ops) {
+    if (const DeleteOp* delete_op = std::get_if<DeleteOp>(&op)) {
+      Key deleted_key =
+          ForeignKeyPrefix(delete_op->key, num_columns, referenced_data_table);
+      if (still_referenced[FindSortedKey(deleted_keys, deleted_key)]) {
+        continue;
+      }
+      Key removed_key =
+          ForeignKeyPrefix(deleted_key, num_columns, referencing_data_table);
+      if (referencing_key_exists[FindSortedKey(removed_keys, removed_key)]) {
+        return error::ForeignKeyReferencingKeyFound(
+            foreign_key_->Name(), foreign_key_->referencing_table()->Name(),
+            foreign_key_->referenced_table()->Name(),
+            Key(removed_key.column_values()).DebugString());
+      }
+    }
+  }
+  return absl::OkStatus();
+}
+
 }  // namespace backend
 }  // namespace emulator
 }  // namespace spanner
@@ -20,14 +20,22 @@
 #include "backend/actions/action.h"
 #include "backend/actions/context.h"
 #include "backend/actions/ops.h"
+#include "backend/datamodel/key.h"
 #include "backend/schema/catalog/foreign_key.h"
+#include "backend/schema/catalog/table.h"
 #include "absl/status/status.h"
+#include "absl/types/span.h"
 
 namespace google {
 namespace spanner {
 namespace emulator {
 namespace backend {
 
+// Returns the first `num_columns` values of `key` as a key ordered like the
+// primary key of `data_table`, so that it can be compared against the keys of
+// rows read from that table.
+Key ForeignKeyPrefix(const Key& key, int num_columns, const Table* data_table);
+
 // ForeignKeyReferencingVerifier triggers on mutations to a foreign key's
 // referencing index data table.
 //
@@ -41,10 +49,17 @@ namespace backend {
 // referencing row, and a following operation inserts the referenced row. Since
 // verifiers are triggered after all operations have been evaluated and applied,
 // this verifier will only see the final result.
+//
+// When verifying a batch of operations, the referenced keys are collected,
+// sorted and deduplicated, so that each distinct key is looked up in the
+// referenced index data table once, in key order.
 class ForeignKeyReferencingVerifier : public Verifier {
  public:
   explicit ForeignKeyReferencingVerifier(const ForeignKey* foreign_key);
 
+  absl::Status VerifyBatch(const ActionContext* ctx,
+                           absl::Span<const WriteOp> ops) const override;
+
  private:
   absl::Status Verify(const ActionContext* ctx,
                       const InsertOp& op) const override;
@@ -67,10 +82,17 @@ class ForeignKeyReferencingVerifier : public Verifier {
 // referenced row, but a following operation inserts it. Since verifiers are
 // triggered after all operations have been evaluated and applied, this verifier
 // will only see the final result.
+//
+// When verifying a batch of deletions, each distinct deleted key is looked up
+// once in the referenced index data table, and, if it is really gone, once in
+// the referencing index data table.
 class ForeignKeyReferencedVerifier : public Verifier {
  public:
   explicit ForeignKeyReferencedVerifier(const ForeignKey* foreign_key);
 
+  absl::Status VerifyBatch(const ActionContext* ctx,
+                           absl::Span<const WriteOp> ops) const override;
+
  private:
   absl::Status Verify(const ActionContext* ctx,
                       const DeleteOp& op) const override;
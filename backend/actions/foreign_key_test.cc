@@ -18,6 +18,7 @@
 
 #include <memory>
 #include <queue>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -169,6 +170,69 @@ TEST_F(ForeignKeyTest, DeleteReferencedRowWithoutReferencingRow) {
       ctx(), Delete(referenced_data_, Key({Int64(4), Int64(5), Int64(6)}))));
 }
 
+TEST_F(ForeignKeyTest, VerifyBatchOfReferencingRows) {
+  ZETASQL_ASSERT_OK(
+      store()->Insert(referenced_data_, Key({Int64(1), Int64(2), Int64(3)}),
+                      referenced_columns_, {Int64(1), Int64(2), Int64(3)}));
+  ZETASQL_ASSERT_OK(
+      store()->Insert(referenced_data_, Key({Int64(4), Int64(5), Int64(6)}),
+                      referenced_columns_, {Int64(4), Int64(5), Int64(6)}));
+
+  // Duplicate and scattered referenced keys are all found.
+  std::vector<WriteOp> ops = {
+      Insert(referencing_data_, Key({Int64(1), Int64(2), Int64(7)}),
+             referencing_columns_, {Int64(1), Int64(2), Int64(7)}),
+      Insert(referencing_data_, Key({Int64(1), Int64(2), Int64(8)}),
+             referencing_columns_, {Int64(1), Int64(2), Int64(8)}),
+      Insert(referencing_data_, Key({Int64(4), Int64(5), Int64(9)}),
+             referencing_columns_, {Int64(4), Int64(5), Int64(9)})};
+  ZETASQL_EXPECT_OK(referencing_verifier_->VerifyBatch(ctx(), ops));
+
+  // A single missing referenced key in the batch fails the verification.
+  ops.push_back(Insert(referencing_data_, Key({Int64(4), Int64(6), Int64(1)}),
+                       referencing_columns_, {Int64(4), Int64(6), Int64(1)}));
+  EXPECT_THAT(referencing_verifier_->VerifyBatch(ctx(), ops),
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+  ZETASQL_EXPECT_OK(unenforced_referencing_verifier_->VerifyBatch(ctx(), ops));
+}
+
+TEST_F(ForeignKeyTest, VerifyBatchReportsFirstOffendingOp) {
+  // Both referenced keys are missing; the error names the key of the first op
+  // rather than the smallest key.
+  std::vector<WriteOp> ops = {
+      Insert(referencing_data_, Key({Int64(9), Int64(9), Int64(1)}),
+             referencing_columns_, {Int64(9), Int64(9), Int64(1)}),
+      Insert(referencing_data_, Key({Int64(1), Int64(1), Int64(2)}),
+             referencing_columns_, {Int64(1), Int64(1), Int64(2)})};
+  EXPECT_THAT(referencing_verifier_->VerifyBatch(ctx(), ops),
+              StatusIs(absl::StatusCode::kFailedPrecondition,
+                       testing::HasSubstr(
+                           Key({Int64(9), Int64(9)}).DebugString())));
+}
+
+TEST_F(ForeignKeyTest, VerifyBatchOfDeletedReferencedRows) {
+  // The first deleted key is still present in the referenced index (e.g. it
+  // was re-inserted), the second has no referencing rows.
+  ZETASQL_ASSERT_OK(
+      store()->Insert(referenced_data_, Key({Int64(1), Int64(2), Int64(3)}),
+                      referenced_columns_, {Int64(1), Int64(2), Int64(3)}));
+  ZETASQL_ASSERT_OK(
+      store()->Insert(referencing_data_, Key({Int64(1), Int64(2), Int64(4)}),
+                      referencing_columns_, {Int64(1), Int64(2), Int64(4)}));
+  std::vector<WriteOp> ops = {
+      Delete(referenced_data_, Key({Int64(1), Int64(2), Int64(3)})),
+      Delete(referenced_data_, Key({Int64(4), Int64(5), Int64(6)}))};
+  ZETASQL_EXPECT_OK(referenced_verifier_->VerifyBatch(ctx(), ops));
+
+  // Deleting a referenced key that still has referencing rows fails.
+  ZETASQL_ASSERT_OK(
+      store()->Insert(referencing_data_, Key({Int64(4), Int64(5), Int64(1)}),
+                      referencing_columns_, {Int64(4), Int64(5), Int64(1)}));
+  EXPECT_THAT(referenced_verifier_->VerifyBatch(ctx(), ops),
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+  ZETASQL_EXPECT_OK(unenforced_referenced_verifier_->VerifyBatch(ctx(), ops));
+}
+
 }  // namespace
 }  // namespace backend
 }  // namespace emulator
@@ -28,6 +28,7 @@
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
 #include "backend/access/write.h"
 #include "backend/actions/check_constraint.h"
 #include "backend/actions/column_value.h"
@@ -39,7 +40,9 @@
 #include "backend/actions/index.h"
 #include "backend/actions/interleave.h"
 #include "backend/actions/ops.h"
+#include "backend/actions/search_index.h"
 #include "backend/actions/unique_index.h"
+#include "backend/actions/vector_index.h"
 #include "backend/query/analyzer_options.h"
 #include "backend/query/function_catalog.h"
 #include "backend/schema/catalog/check_constraint.h"
@@ -58,7 +61,7 @@ namespace backend {
 
 absl::Status ActionRegistry::ExecuteValidators(const ActionContext* ctx,
                                                const WriteOp& op) {
-  for (auto& validator : table_validators_[TableOf(op)]) {
+  for (auto& validator : GetTableActions(TableOf(op)).validators) {
     ZETASQL_RETURN_IF_ERROR(validator->Validate(ctx, op));
   }
   return absl::OkStatus();
@@ -66,7 +69,7 @@ absl::Status ActionRegistry::ExecuteValidators(const ActionContext* ctx,
 
 absl::Status ActionRegistry::ExecuteEffectors(const ActionContext* ctx,
                                               const WriteOp& op) {
-  for (auto& effector : table_effectors_[TableOf(op)]) {
+  for (auto& effector : GetTableActions(TableOf(op)).effectors) {
     ZETASQL_RETURN_IF_ERROR(effector->Effect(ctx, op));
   }
   return absl::OkStatus();
@@ -76,19 +79,23 @@ absl::Status ActionRegistry::ExecuteGeneratedKeyEffectors(
     const MutationOp& op,
     std::vector<std::vector<zetasql::Value>>* generated_values,
     std::vector<const Column*>* columns_with_generated_values) {
-  if (table_generated_key_effectors_.find(op.table) ==
-      table_generated_key_effectors_.end()) {
+  const Table* table = schema_->FindTableCaseSensitive(op.table);
+  if (table == nullptr) {
+    return absl::OkStatus();
+  }
+  const TableActions& actions = GetTableActions(table);
+  if (actions.generated_key_effector == nullptr) {
     return absl::OkStatus();
   }
 
-  ZETASQL_RETURN_IF_ERROR(table_generated_key_effectors_[op.table]->Effect(
+  ZETASQL_RETURN_IF_ERROR(actions.generated_key_effector->Effect(
       op, generated_values, columns_with_generated_values));
   return absl::OkStatus();
 }
 
 absl::Status ActionRegistry::ExecuteModifiers(const ActionContext* ctx,
                                               const WriteOp& op) {
-  for (auto& modifier : table_modifiers_[TableOf(op)]) {
+  for (auto& modifier : GetTableActions(TableOf(op)).modifiers) {
     ZETASQL_RETURN_IF_ERROR(modifier->Modify(ctx, op));
   }
   return absl::OkStatus();
@@ -96,132 +103,204 @@ absl::Status ActionRegistry::ExecuteModifiers(const ActionContext* ctx,
 
 absl::Status ActionRegistry::ExecuteVerifiers(const ActionContext* ctx,
                                               const WriteOp& op) {
-  for (auto& verifier : table_verifiers_[TableOf(op)]) {
+  for (auto& verifier : GetTableActions(TableOf(op)).verifiers) {
     ZETASQL_RETURN_IF_ERROR(verifier->Verify(ctx, op));
   }
   return absl::OkStatus();
 }
 
+absl::Status ActionRegistry::ExecuteVerifiers(const ActionContext* ctx,
+                                              absl::Span<const WriteOp> ops) {
+  for (int begin = 0; begin < ops.size();) {
+    const Table* table = TableOf(ops[begin]);
+    int end = begin + 1;
+    while (end < ops.size() && TableOf(ops[end]) == table) {
+      ++end;
+    }
+    for (auto& verifier : GetTableActions(table).verifiers) {
+      ZETASQL_RETURN_IF_ERROR(
+          verifier->VerifyBatch(ctx, ops.subspan(begin, end - begin)));
+    }
+    begin = end;
+  }
+  return absl::OkStatus();
+}
+
 ActionRegistry::ActionRegistry(const Schema* schema,
                                const FunctionCatalog* function_catalog,
-                               zetasql::TypeFactory* type_factory_)
+                               zetasql::TypeFactory* type_factory)
     : schema_(schema),
-      catalog_(schema, function_catalog, type_factory_,
-               MakeGoogleSqlAnalyzerOptions(schema->default_time_zone())) {
-  BuildActionRegistry();
-}
+      function_catalog_(function_catalog),
+      type_factory_(type_factory) {}
 
-void ActionRegistry::BuildActionRegistry() {
-  for (const Table* table : schema_->tables()) {
-    // Column value checks for all tables.
-    absl::flat_hash_set<std::string> placements;
-    for (const Placement* placement : schema_->placements()) {
-      placements.insert(placement->PlacementName());
+const TableActions& ActionRegistry::GetTableActions(const Table* table) {
+  {
+    // Actions are only built once per table, so writes to tables whose
+    // actions exist only need a shared lock.
+    absl::ReaderMutexLock l(&mutex_);
+    auto it = table_actions_.find(table);
+    if (it != table_actions_.end()) {
+      return *it->second;
     }
-    table_validators_[table].emplace_back(
-        std::make_unique<ColumnValueValidator>(placements));
+  }
+  absl::MutexLock l(&mutex_);
+  std::unique_ptr<TableActions>& actions = table_actions_[table];
+  if (actions == nullptr) {
+    actions = BuildTableActions(table);
+  }
+  return *actions;
+}
+
+int ActionRegistry::num_built_tables() const {
+  absl::ReaderMutexLock l(&mutex_);
+  return table_actions_.size();
+}
 
-    // Row existence checks for all tables.
-    table_validators_[table].emplace_back(
-        std::make_unique<RowExistenceValidator>());
+Catalog* ActionRegistry::catalog() {
+  if (catalog_ == nullptr) {
+    catalog_ = std::make_unique<Catalog>(
+        schema_, function_catalog_, type_factory_,
+        MakeGoogleSqlAnalyzerOptions(schema_->default_time_zone()));
+  }
+  return catalog_.get();
+}
 
-    // Interleave actions for child tables.
-    for (const Table* child : table->children()) {
-      table_validators_[table].emplace_back(
-          std::make_unique<InterleaveParentValidator>(table, child));
+std::unique_ptr<TableActions> ActionRegistry::BuildTableActions(
+    const Table* table) {
+  auto actions = std::make_unique<TableActions>();
 
-      table_effectors_[table].emplace_back(
-          std::make_unique<InterleaveParentEffector>(table, child));
-    }
+  // Verifiers on index data tables are owned by the indexed table, and
+  // verifiers on a table's own key (e.g. a foreign key using the primary key)
+  // are owned by the table itself.
+  const Table* base_table = table->owner_index() != nullptr
+                                ? table->owner_index()->indexed_table()
+                                : table;
 
-    // Interleave actions for parent table.
-    if (table->parent() != nullptr) {
-      table_validators_[table].emplace_back(
-          std::make_unique<InterleaveChildValidator>(table->parent(), table));
+  // Index uniqueness checks.
+  for (const Index* index : base_table->indexes()) {
+    if (index->is_search_index()) {
+      continue;
     }
-
-    // Actions for Index.
-    for (const Index* index : table->indexes()) {
-      // Index effects.
-      if (index->is_search_index()) {
-        continue;
-      }
-      table_effectors_[table].emplace_back(
-          std::make_unique<IndexEffector>(index));
-
-      // Index uniqueness checks.
-      if (index->is_unique()) {
-        table_verifiers_[index->index_data_table()].emplace_back(
-            std::make_unique<UniqueIndexVerifier>(index));
-      }
+    if (index->is_unique() && index->index_data_table() == table) {
+      actions->verifiers.emplace_back(
+          std::make_unique<UniqueIndexVerifier>(index));
     }
+  }
 
-    // Actions for foreign keys.
-    for (const ForeignKey* foreign_key : table->foreign_keys()) {
-      if (!foreign_key->enforced()) {
-        // Not enforced foreign keys doesn't verify referential integrity on
-        // data.
-        continue;
-      }
-      table_verifiers_[foreign_key->referencing_data_table()].emplace_back(
+  // Actions for foreign keys.
+  for (const ForeignKey* foreign_key : base_table->foreign_keys()) {
+    if (!foreign_key->enforced()) {
+      // Not enforced foreign keys doesn't verify referential integrity on
+      // data.
+      continue;
+    }
+    if (foreign_key->referencing_data_table() == table) {
+      actions->verifiers.emplace_back(
           std::make_unique<ForeignKeyReferencingVerifier>(foreign_key));
     }
-    for (const ForeignKey* foreign_key : table->referencing_foreign_keys()) {
-      if (!foreign_key->enforced()) {
-        // Not enforced foreign keys has no actions, and doesn't verify
-        // referential integrity on data.
-        continue;
-      }
-      table_verifiers_[foreign_key->referenced_data_table()].emplace_back(
+  }
+  for (const ForeignKey* foreign_key : base_table->referencing_foreign_keys()) {
+    if (!foreign_key->enforced()) {
+      // Not enforced foreign keys has no actions, and doesn't verify
+      // referential integrity on data.
+      continue;
+    }
+    if (foreign_key->referenced_data_table() == table) {
+      actions->verifiers.emplace_back(
           std::make_unique<ForeignKeyReferencedVerifier>(foreign_key));
+    }
+  }
+
+  // The remaining actions only apply to user tables.
+  if (!table->is_public()) {
+    return actions;
+  }
+
+  // Column value checks for all tables.
+  absl::flat_hash_set<std::string> placements;
+  for (const Placement* placement : schema_->placements()) {
+    placements.insert(placement->PlacementName());
+  }
+  actions->validators.emplace_back(
+      std::make_unique<ColumnValueValidator>(placements));
+
+  // Row existence checks for all tables.
+  actions->validators.emplace_back(std::make_unique<RowExistenceValidator>());
+
+  // Interleave actions for child tables.
+  for (const Table* child : table->children()) {
+    actions->validators.emplace_back(
+        std::make_unique<InterleaveParentValidator>(table, child));
 
-      if (foreign_key->on_delete_action() == ForeignKey::Action::kCascade) {
-        table_effectors_[table].emplace_back(
-            std::make_unique<ForeignKeyActionEffector>(foreign_key));
-      }
+    actions->effectors.emplace_back(
+        std::make_unique<InterleaveParentEffector>(table, child));
+  }
+
+  // Interleave actions for parent table.
+  if (table->parent() != nullptr) {
+    actions->validators.emplace_back(
+        std::make_unique<InterleaveChildValidator>(table->parent(), table));
+  }
+
+  // Index effects.
+  for (const Index* index : table->indexes()) {
+    if (index->is_search_index()) {
+      actions->effectors.emplace_back(
+          std::make_unique<SearchIndexEffector>(index));
+      continue;
+    }
+    actions->effectors.emplace_back(std::make_unique<IndexEffector>(index));
+    if (index->ann_index() != nullptr) {
+      actions->effectors.emplace_back(
+          std::make_unique<VectorIndexEffector>(index));
     }
+  }
 
-    // Actions for check constraints.
-    for (const CheckConstraint* check_constraint : table->check_constraints()) {
-      table_verifiers_[table].emplace_back(
-          std::make_unique<CheckConstraintVerifier>(
-              check_constraint,
-              MakeGoogleSqlAnalyzerOptions(schema_->default_time_zone()),
-              &catalog_));
+  // Foreign key actions.
+  for (const ForeignKey* foreign_key : table->referencing_foreign_keys()) {
+    if (foreign_key->enforced() &&
+        foreign_key->on_delete_action() == ForeignKey::Action::kCascade) {
+      actions->effectors.emplace_back(
+          std::make_unique<ForeignKeyActionEffector>(foreign_key));
     }
+  }
 
-    // A set containing key columns with default/generated values.
-    absl::flat_hash_set<std::string> default_or_generated_key_columns;
-    // Effector for primary key default and generated columns.
-    for (const Column* column : table->columns()) {
-      if ((column->has_default_value()
-           || column->is_generated()
-           ) &&
-          table->FindKeyColumn(column->Name()) != nullptr) {
-        default_or_generated_key_columns.insert(column->Name());
-        table_generated_key_effectors_[table->Name()] =
-            std::make_unique<GeneratedColumnEffector>(
-                table,
-                MakeGoogleSqlAnalyzerOptions(schema_->default_time_zone()),
-                &catalog_,
-                /*for_keys=*/true);
-        break;
-      }
+  // Actions for check constraints.
+  for (const CheckConstraint* check_constraint : table->check_constraints()) {
+    actions->verifiers.emplace_back(std::make_unique<CheckConstraintVerifier>(
+        check_constraint,
+        MakeGoogleSqlAnalyzerOptions(schema_->default_time_zone()), catalog()));
+  }
+
+  // A set containing key columns with default/generated values.
+  absl::flat_hash_set<std::string> default_or_generated_key_columns;
+  // Effector for primary key default and generated columns.
+  for (const Column* column : table->columns()) {
+    if ((column->has_default_value()
+         || column->is_generated()
+         ) &&
+        table->FindKeyColumn(column->Name()) != nullptr) {
+      default_or_generated_key_columns.insert(column->Name());
+      actions->generated_key_effector =
+          std::make_unique<GeneratedColumnEffector>(
+              table, MakeGoogleSqlAnalyzerOptions(schema_->default_time_zone()),
+              catalog(),
+              /*for_keys=*/true);
+      break;
     }
+  }
 
-    // Effector for non-key generated and default columns.
-    for (const Column* column : table->columns()) {
-      if (!default_or_generated_key_columns.contains(column->Name()) &&
-          (column->is_generated() || column->has_default_value())) {
-        table_effectors_[table].emplace_back(
-            std::make_unique<GeneratedColumnEffector>(
-                table,
-                MakeGoogleSqlAnalyzerOptions(schema_->default_time_zone()),
-                &catalog_));
-        break;
-      }
+  // Effector for non-key generated and default columns.
+  for (const Column* column : table->columns()) {
+    if (!default_or_generated_key_columns.contains(column->Name()) &&
+        (column->is_generated() || column->has_default_value())) {
+      actions->effectors.emplace_back(std::make_unique<GeneratedColumnEffector>(
+          table, MakeGoogleSqlAnalyzerOptions(schema_->default_time_zone()),
+          catalog()));
+      break;
     }
   }
+  return actions;
 }
 
 void ActionManager::AddActionsForSchema(const Schema* schema,
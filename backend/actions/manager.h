@@ -28,6 +28,7 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
 #include "backend/access/write.h"
 #include "backend/actions/action.h"
 #include "backend/actions/context.h"
@@ -44,10 +45,28 @@ namespace spanner {
 namespace emulator {
 namespace backend {
 
+// TableActions is the set of actions which apply to writes on a single table.
+struct TableActions {
+  std::vector<std::unique_ptr<Validator>> validators;
+  std::vector<std::unique_ptr<Effector>> effectors;
+  std::vector<std::unique_ptr<Modifier>> modifiers;
+  std::vector<std::unique_ptr<Verifier>> verifiers;
+
+  // Effector for primary key columns with default or generated values.
+  std::unique_ptr<GeneratedColumnEffector> generated_key_effector;
+};
+
 // ActionRegistry is a collection of actions for a given schema.
 //
 // Transactions use this registry for constraint checking the writes to a
 // database.
+//
+// Actions are built lazily, per table, the first time a table is written to
+// with this schema. Registering a new schema version is therefore cheap, and
+// its cost is only paid for the tables which are actually written to. Actions
+// refer to the tables, indexes and constraints of their schema, so they are
+// not shared across schema versions: a table written to after a schema change
+// has its actions, including its prepared check constraints, built again.
 class ActionRegistry {
  public:
   explicit ActionRegistry(const Schema* schema,
@@ -72,36 +91,47 @@ class ActionRegistry {
   // Executes the list of verifiers that apply to the given operation.
   absl::Status ExecuteVerifiers(const ActionContext* ctx, const WriteOp& op);
 
- private:
-  // Initialize the validators, effectors, modifiers and verifiers for each
-  // table in the given schema.
-  void BuildActionRegistry();
+  // Executes the verifiers that apply to each of the given operations. The ops
+  // of each table must be contiguous and sorted in key order, as returned by
+  // TransactionStore::GetBufferedOps, so that verifiers can check all the ops
+  // of a table in a single batch.
+  absl::Status ExecuteVerifiers(const ActionContext* ctx,
+                                absl::Span<const WriteOp> ops);
 
-  // Schema used to define the registry of actions.
-  const Schema* schema_;
+  // Returns the actions for the given table, building them on first use. The
+  // returned actions live as long as the registry.
+  const TableActions& GetTableActions(const Table* table)
+      ABSL_LOCKS_EXCLUDED(mutex_);
 
-  // List of validators per table.
-  absl::node_hash_map<const Table*, std::vector<std::unique_ptr<Validator>>>
-      table_validators_;
+  // Returns the number of tables whose actions have been built.
+  int num_built_tables() const ABSL_LOCKS_EXCLUDED(mutex_);
 
-  // List of effectors per table.
-  absl::node_hash_map<const Table*, std::vector<std::unique_ptr<Effector>>>
-      table_effectors_;
+ private:
+
+  // Initializes the validators, effectors, modifiers and verifiers for the
+  // given table. The table may be a user table or an index data table.
+  std::unique_ptr<TableActions> BuildTableActions(const Table* table)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
-  // List of effectors for primary key columns per table.
-  absl::node_hash_map<std::string, std::unique_ptr<GeneratedColumnEffector>>
-      table_generated_key_effectors_;
+  // Returns the catalog used for function resolution in actions, creating it
+  // on first use.
+  Catalog* catalog() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
-  // List of modifiers per table.
-  absl::node_hash_map<const Table*, std::vector<std::unique_ptr<Modifier>>>
-      table_modifiers_;
+  // Schema used to define the registry of actions.
+  const Schema* schema_;
 
-  // List of verifiers per table.
-  absl::node_hash_map<const Table*, std::vector<std::unique_ptr<Verifier>>>
-      table_verifiers_;
+  // Used to create the catalog.
+  const FunctionCatalog* function_catalog_;
+  zetasql::TypeFactory* type_factory_;
+
+  // Actions per table, built on first use.
+  absl::node_hash_map<const Table*, std::unique_ptr<TableActions>>
+      table_actions_ ABSL_GUARDED_BY(mutex_);
 
   // Used for function resolution in actions.
-  Catalog catalog_;
+  std::unique_ptr<Catalog> catalog_ ABSL_GUARDED_BY(mutex_);
+
+  mutable absl::Mutex mutex_;
 };
 
 // ActionManager manages the registry of actions for each schema in the
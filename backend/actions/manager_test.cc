@@ -0,0 +1,117 @@
+//
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#include "backend/actions/manager.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "zetasql/public/types/type_factory.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "zetasql/base/testing/status_matchers.h"
+#include "backend/query/function_catalog.h"
+#include "backend/schema/catalog/schema.h"
+#include "tests/common/schema_constructor.h"
+
+namespace google {
+namespace spanner {
+namespace emulator {
+namespace backend {
+namespace {
+
+class ActionManagerTest : public testing::Test {
+ public:
+  ActionManagerTest() : function_catalog_(&type_factory_) {}
+
+ protected:
+  std::unique_ptr<const Schema> CreateSchema(bool with_index) {
+    std::vector<std::string> statements = {R"(
+        CREATE TABLE T (
+          A INT64,
+          B INT64,
+        ) PRIMARY KEY(A)
+      )",
+                                           R"(
+        CREATE TABLE U (
+          X INT64,
+        ) PRIMARY KEY(X)
+      )"};
+    if (with_index) {
+      statements.push_back("CREATE INDEX TByB ON T(B)");
+    }
+    return test::CreateSchemaFromDDL(statements, &type_factory_).value();
+  }
+
+  zetasql::TypeFactory type_factory_;
+  FunctionCatalog function_catalog_;
+  ActionManager action_manager_;
+};
+
+TEST_F(ActionManagerTest, BuildsActionsOncePerTable) {
+  std::unique_ptr<const Schema> schema = CreateSchema(/*with_index=*/false);
+  action_manager_.AddActionsForSchema(schema.get(), &function_catalog_,
+                                      &type_factory_);
+  ZETASQL_ASSERT_OK_AND_ASSIGN(ActionRegistry * registry,
+                       action_manager_.GetActionsForSchema(schema.get()));
+
+  // No actions are built until a table is written to.
+  EXPECT_EQ(registry->num_built_tables(), 0);
+
+  const Table* table = schema->FindTable("T");
+  const TableActions& actions = registry->GetTableActions(table);
+  EXPECT_FALSE(actions.validators.empty());
+  EXPECT_EQ(&registry->GetTableActions(table), &actions);
+  EXPECT_EQ(registry->num_built_tables(), 1);
+}
+
+TEST_F(ActionManagerTest, RebuildsActionsForNewSchema) {
+  std::unique_ptr<const Schema> old_schema =
+      CreateSchema(/*with_index=*/false);
+  std::unique_ptr<const Schema> new_schema = CreateSchema(/*with_index=*/true);
+  action_manager_.AddActionsForSchema(old_schema.get(), &function_catalog_,
+                                      &type_factory_);
+  action_manager_.AddActionsForSchema(new_schema.get(), &function_catalog_,
+                                      &type_factory_);
+  ZETASQL_ASSERT_OK_AND_ASSIGN(ActionRegistry * old_registry,
+                       action_manager_.GetActionsForSchema(old_schema.get()));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(ActionRegistry * new_registry,
+                       action_manager_.GetActionsForSchema(new_schema.get()));
+
+  // The new index adds an effector to the writes on T in the new schema only.
+  const TableActions& old_actions =
+      old_registry->GetTableActions(old_schema->FindTable("T"));
+  const TableActions& new_actions =
+      new_registry->GetTableActions(new_schema->FindTable("T"));
+  EXPECT_NE(&old_actions, &new_actions);
+  EXPECT_EQ(new_actions.effectors.size(), old_actions.effectors.size() + 1);
+
+  // Each schema builds its own actions, even for the unchanged table U, since
+  // they refer to the tables of that schema. They are built once per schema.
+  const TableActions& u_actions =
+      new_registry->GetTableActions(new_schema->FindTable("U"));
+  EXPECT_EQ(&new_registry->GetTableActions(new_schema->FindTable("U")),
+            &u_actions);
+  EXPECT_EQ(new_registry->num_built_tables(), 2);
+}
+
+}  // namespace
+}  // namespace backend
+}  // namespace emulator
+}  // namespace spanner
+}  // namespace google
@@ -0,0 +1,79 @@
+//
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "backend/actions/search_index.h"
+
+#include <vector>
+
+#include "zetasql/public/value.h"
+#include "absl/algorithm/container.h"
+#include "absl/status/status.h"
+#include "backend/common/inverted_index.h"
+#include "backend/schema/catalog/column.h"
+#include "backend/schema/catalog/index.h"
+#include "zetasql/base/ret_check.h"
+#include "zetasql/base/status_macros.h"
+
+namespace google {
+namespace spanner {
+namespace emulator {
+namespace backend {
+
+SearchIndexEffector::SearchIndexEffector(const Index* index) : index_(index) {
+  // Save the indexed table columns holding the token lists the index is keyed
+  // by.
+  for (const KeyColumn* key_column : index->key_columns()) {
+    const Column* column = key_column->column()->source_column();
+    if (column->GetType()->IsTokenList()) {
+      token_columns_.emplace_back(column);
+    }
+  }
+}
+
+absl::Status SearchIndexEffector::AddTokenLists(
+    const Key& key, const std::vector<const Column*>& columns,
+    const std::vector<zetasql::Value>& values) const {
+  InvertedIndex* inverted_index = index_->inverted_index();
+  ZETASQL_RET_CHECK_NE(inverted_index, nullptr);
+  for (int i = 0; i < columns.size(); ++i) {
+    if (!absl::c_linear_search(token_columns_, columns[i])) {
+      continue;
+    }
+    ZETASQL_RETURN_IF_ERROR(
+        inverted_index->AddTokenList(columns[i]->id(), key, values[i]));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status SearchIndexEffector::Effect(const ActionContext* ctx,
+                                         const InsertOp& op) const {
+  return AddTokenLists(op.key, op.columns, op.values);
+}
+
+absl::Status SearchIndexEffector::Effect(const ActionContext* ctx,
+                                         const UpdateOp& op) const {
+  return AddTokenLists(op.key, op.columns, op.values);
+}
+
+absl::Status SearchIndexEffector::Effect(const ActionContext* ctx,
+                                         const DeleteOp& op) const {
+  return absl::OkStatus();
+}
+
+}  // namespace backend
+}  // namespace emulator
+}  // namespace spanner
+}  // namespace google
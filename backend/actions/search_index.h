@@ -0,0 +1,68 @@
+//
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_ACTIONS_SEARCH_INDEX_H_
+#define THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_ACTIONS_SEARCH_INDEX_H_
+
+#include <vector>
+
+#include "absl/status/status.h"
+#include "backend/actions/action.h"
+#include "backend/actions/ops.h"
+#include "backend/schema/catalog/column.h"
+#include "backend/schema/catalog/index.h"
+
+namespace google {
+namespace spanner {
+namespace emulator {
+namespace backend {
+
+// SearchIndexEffector triggers on mutations to a table with a search index.
+//
+// The token lists written to the indexed table by Insert & Update operations
+// are added to the posting lists of the search index as uncommitted token
+// lists. The transaction replaces them with the committed token lists, and
+// removes the token lists of deleted rows, when it commits; queries re-check
+// the rows found through the posting lists.
+class SearchIndexEffector : public Effector {
+ public:
+  explicit SearchIndexEffector(const Index* index);
+
+ private:
+  absl::Status Effect(const ActionContext* ctx,
+                      const InsertOp& op) const override;
+  absl::Status Effect(const ActionContext* ctx,
+                      const UpdateOp& op) const override;
+  absl::Status Effect(const ActionContext* ctx,
+                      const DeleteOp& op) const override;
+
+  // Adds the token lists among `columns` to the posting lists of the index.
+  absl::Status AddTokenLists(const Key& key,
+                             const std::vector<const Column*>& columns,
+                             const std::vector<zetasql::Value>& values) const;
+
+  const Index* index_;
+
+  // List of indexed table TOKENLIST columns relevant to the index.
+  std::vector<const Column*> token_columns_;
+};
+
+}  // namespace backend
+}  // namespace emulator
+}  // namespace spanner
+}  // namespace google
+
+#endif  // THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_ACTIONS_SEARCH_INDEX_H_
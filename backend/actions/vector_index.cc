@@ -0,0 +1,68 @@
+//
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "backend/actions/vector_index.h"
+
+#include <vector>
+
+#include "zetasql/public/value.h"
+#include "absl/status/status.h"
+#include "backend/common/ann_index.h"
+#include "backend/schema/catalog/column.h"
+#include "backend/schema/catalog/index.h"
+#include "zetasql/base/ret_check.h"
+
+namespace google {
+namespace spanner {
+namespace emulator {
+namespace backend {
+
+VectorIndexEffector::VectorIndexEffector(const Index* index)
+    : index_(index),
+      vector_column_(index->key_columns()[0]->column()->source_column()) {}
+
+absl::Status VectorIndexEffector::AddVector(
+    const Key& key, const std::vector<const Column*>& columns,
+    const std::vector<zetasql::Value>& values) const {
+  AnnIndex* ann_index = index_->ann_index();
+  ZETASQL_RET_CHECK_NE(ann_index, nullptr);
+  for (int i = 0; i < columns.size(); ++i) {
+    if (columns[i] == vector_column_) {
+      return ann_index->AddVector(key, values[i]);
+    }
+  }
+  return absl::OkStatus();
+}
+
+absl::Status VectorIndexEffector::Effect(const ActionContext* ctx,
+                                         const InsertOp& op) const {
+  return AddVector(op.key, op.columns, op.values);
+}
+
+absl::Status VectorIndexEffector::Effect(const ActionContext* ctx,
+                                         const UpdateOp& op) const {
+  return AddVector(op.key, op.columns, op.values);
+}
+
+absl::Status VectorIndexEffector::Effect(const ActionContext* ctx,
+                                         const DeleteOp& op) const {
+  return absl::OkStatus();
+}
+
+}  // namespace backend
+}  // namespace emulator
+}  // namespace spanner
+}  // namespace google
@@ -0,0 +1,69 @@
+//
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_ACTIONS_VECTOR_INDEX_H_
+#define THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_ACTIONS_VECTOR_INDEX_H_
+
+#include <vector>
+
+#include "absl/status/status.h"
+#include "backend/actions/action.h"
+#include "backend/actions/ops.h"
+#include "backend/schema/catalog/column.h"
+#include "backend/schema/catalog/index.h"
+
+namespace google {
+namespace spanner {
+namespace emulator {
+namespace backend {
+
+// VectorIndexEffector triggers on mutations to a table with a vector index
+// that has a distance type.
+//
+// The vectors written to the indexed table by Insert & Update operations are
+// added to the AnnIndex of the vector index as uncommitted vectors. The
+// transaction replaces them with the committed vectors, and removes the vectors
+// of deleted rows, when it commits; queries re-check the rows found through the
+// AnnIndex. The index data table itself is maintained by IndexEffector.
+class VectorIndexEffector : public Effector {
+ public:
+  explicit VectorIndexEffector(const Index* index);
+
+ private:
+  absl::Status Effect(const ActionContext* ctx,
+                      const InsertOp& op) const override;
+  absl::Status Effect(const ActionContext* ctx,
+                      const UpdateOp& op) const override;
+  absl::Status Effect(const ActionContext* ctx,
+                      const DeleteOp& op) const override;
+
+  // Adds the vector among `columns`, if any, to the AnnIndex of the index.
+  absl::Status AddVector(const Key& key,
+                         const std::vector<const Column*>& columns,
+                         const std::vector<zetasql::Value>& values) const;
+
+  const Index* index_;
+
+  // The indexed table column holding the vectors the index is keyed by.
+  const Column* vector_column_;
+};
+
+}  // namespace backend
+}  // namespace emulator
+}  // namespace spanner
+}  // namespace google
+
+#endif  // THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_ACTIONS_VECTOR_INDEX_H_
@@ -0,0 +1,486 @@
+//
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "backend/common/ann_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "zetasql/public/value.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "backend/common/vector_distance.h"
+#include "backend/datamodel/key.h"
+#include "zetasql/base/ret_check.h"
+#include "zetasql/base/status_macros.h"
+
+namespace google {
+namespace spanner {
+namespace emulator {
+namespace backend {
+
+namespace {
+
+// The number of sampled vectors per centroid that k-means is trained on.
+constexpr int64_t kTrainingVectorsPerCentroid = 8;
+
+// The number of k-means iterations.
+constexpr int kTrainingIterations = 4;
+
+// Scales `vector` to unit length, so that the cosine distance between
+// normalized vectors is ordered like the opposite of their dot product. Zero
+// vectors are left as is.
+void Normalize(std::vector<float>& vector) {
+  float norm = std::sqrt(DotProduct(vector, vector));
+  if (norm == 0) {
+    return;
+  }
+  for (float& element : vector) {
+    element /= norm;
+  }
+}
+
+int64_t SquareRoot(int64_t n) {
+  return std::max<int64_t>(1, std::ceil(std::sqrt(static_cast<double>(n))));
+}
+
+}  // namespace
+
+absl::StatusOr<std::optional<std::vector<float>>> AnnIndex::GetElements(
+    const zetasql::Value& vector) const {
+  ZETASQL_RET_CHECK(vector.type()->IsArray());
+  if (vector.is_null()) {
+    return std::optional<std::vector<float>>();
+  }
+  std::vector<float> elements;
+  elements.reserve(vector.num_elements());
+  for (const zetasql::Value& element : vector.elements()) {
+    if (element.is_null()) {
+      return std::optional<std::vector<float>>();
+    }
+    if (element.type()->IsFloat()) {
+      elements.push_back(element.float_value());
+    } else {
+      ZETASQL_RET_CHECK(element.type()->IsDouble());
+      elements.push_back(static_cast<float>(element.double_value()));
+    }
+  }
+  if (distance_ == Distance::kCosine) {
+    Normalize(elements);
+  }
+  return std::optional<std::vector<float>>(std::move(elements));
+}
+
+absl::Status AnnIndex::AddVector(const Key& key, const zetasql::Value& vector) {
+  ZETASQL_ASSIGN_OR_RETURN(std::optional<std::vector<float>> elements,
+                   GetElements(vector));
+  if (!elements.has_value()) {
+    return absl::OkStatus();
+  }
+
+  absl::MutexLock l(&mu_);
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    for (const Entry& entry : it->second) {
+      if (entry.removed_at == absl::InfiniteFuture() &&
+          *entry.vector == *elements) {
+        return absl::OkStatus();
+      }
+    }
+  }
+  AddEntryLocked(key, *std::move(elements), /*committed=*/false);
+  return absl::OkStatus();
+}
+
+absl::Status AnnIndex::CommitVector(const Key& key,
+                                    const zetasql::Value& vector,
+                                    absl::Time commit_timestamp) {
+  ZETASQL_ASSIGN_OR_RETURN(std::optional<std::vector<float>> elements,
+                   GetElements(vector));
+  absl::MutexLock l(&mu_);
+  CommitLocked(key, std::move(elements), commit_timestamp);
+  return absl::OkStatus();
+}
+
+void AnnIndex::CommitDelete(const Key& key, absl::Time commit_timestamp) {
+  absl::MutexLock l(&mu_);
+  CommitLocked(key, std::nullopt, commit_timestamp);
+}
+
+void AnnIndex::DiscardUncommittedVectors(const Key& key) {
+  absl::MutexLock l(&mu_);
+  RemoveEntriesLocked(key, [](const Entry& entry) { return !entry.committed; });
+}
+
+void AnnIndex::AddEntryLocked(const Key& key, std::vector<float> vector,
+                              bool committed) {
+  Entry entry;
+  entry.vector = std::make_shared<const std::vector<float>>(std::move(vector));
+  entry.committed = committed;
+  if (!leaves_.empty()) {
+    entry.leaf = NearestLeaf(partitioning_, *entry.vector);
+    leaves_[entry.leaf].insert(key);
+  }
+  entries_[key].push_back(std::move(entry));
+  ++num_current_vectors_;
+}
+
+void AnnIndex::RemoveEntriesLocked(
+    const Key& key, const std::function<bool(const Entry&)>& remove) {
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    return;
+  }
+  std::vector<Entry>& entries = it->second;
+  std::vector<int> removed_leaves;
+  for (auto entry = entries.begin(); entry != entries.end();) {
+    if (!remove(*entry)) {
+      ++entry;
+      continue;
+    }
+    if (entry->removed_at == absl::InfiniteFuture()) {
+      --num_current_vectors_;
+    }
+    removed_leaves.push_back(entry->leaf);
+    entry = entries.erase(entry);
+  }
+  // The row stays in the leaves it has other vectors in.
+  for (int leaf : removed_leaves) {
+    auto in_leaf = [leaf](const Entry& entry) { return entry.leaf == leaf; };
+    if (leaf >= 0 && std::none_of(entries.begin(), entries.end(), in_leaf)) {
+      leaves_[leaf].erase(key);
+    }
+  }
+  if (entries.empty()) {
+    entries_.erase(it);
+  }
+}
+
+void AnnIndex::CommitLocked(const Key& key,
+                            std::optional<std::vector<float>> vector,
+                            absl::Time commit_timestamp) {
+  bool found = false;
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    for (Entry& entry : it->second) {
+      if (entry.removed_at != absl::InfiniteFuture()) {
+        continue;
+      }
+      if (!found && vector.has_value() && *entry.vector == *vector) {
+        entry.committed = true;
+        found = true;
+      } else if (entry.committed) {
+        entry.removed_at = commit_timestamp;
+        --num_current_vectors_;
+        removals_.emplace_back(commit_timestamp, key);
+      }
+    }
+    // Other uncommitted vectors of the row were overwritten or rolled back,
+    // so no reader can see them.
+    RemoveEntriesLocked(key,
+                        [](const Entry& entry) { return !entry.committed; });
+  }
+  if (vector.has_value() && !found) {
+    AddEntryLocked(key, *std::move(vector), /*committed=*/true);
+  }
+
+  // Reads older than the retention fail, so no reader needs the vectors
+  // replaced before it anymore.
+  const absl::Time cutoff = commit_timestamp - kRemovedVectorRetention;
+  while (!removals_.empty() && removals_.front().first <= cutoff) {
+    const Key removed_key = std::move(removals_.front().second);
+    removals_.pop_front();
+    RemoveEntriesLocked(removed_key, [cutoff](const Entry& entry) {
+      return entry.removed_at <= cutoff;
+    });
+  }
+}
+
+bool AnnIndex::HasCurrentVectorInLeafLocked(const Key& key, int leaf) const {
+  auto it = entries_.find(key);
+  return it != entries_.end() &&
+         std::any_of(it->second.begin(), it->second.end(),
+                     [leaf](const Entry& entry) {
+                       return entry.leaf == leaf &&
+                              entry.removed_at == absl::InfiniteFuture();
+                     });
+}
+
+std::optional<std::vector<Key>> AnnIndex::FindNeighborCandidates(
+    absl::Span<const double> query, int64_t num_neighbors) {
+  std::vector<float> query_vector(query.begin(), query.end());
+  if (distance_ == Distance::kCosine) {
+    Normalize(query_vector);
+  }
+
+  bool partition;
+  {
+    absl::ReaderMutexLock l(&mu_);
+    partition = NumLeavesToPartitionLocked() > 0;
+  }
+  if (partition) {
+    MaybePartition();
+  }
+
+  absl::ReaderMutexLock l(&mu_);
+  if (leaves_.empty()) {
+    return std::nullopt;
+  }
+  const std::vector<std::vector<float>>& leaf_centroids =
+      partitioning_.leaf_centroids;
+  std::vector<std::pair<float, int>> leaves_by_distance;
+  leaves_by_distance.reserve(leaf_centroids.size());
+  for (int leaf = 0; leaf < leaf_centroids.size(); ++leaf) {
+    leaves_by_distance.emplace_back(
+        ComputeDistance(query_vector, leaf_centroids[leaf]), leaf);
+  }
+  std::sort(leaves_by_distance.begin(), leaves_by_distance.end());
+
+  // Replaced vectors do not count towards the candidates, so that rows which
+  // changed do not crowd out the nearest neighbors.
+  const int64_t num_candidates = kCandidatesPerNeighbor * num_neighbors;
+  int64_t num_current_candidates = 0;
+  std::vector<Key> candidates;
+  for (const auto& [distance, leaf] : leaves_by_distance) {
+    if (num_current_candidates >= num_candidates) {
+      break;
+    }
+    for (const Key& key : leaves_[leaf]) {
+      candidates.push_back(key);
+      if (HasCurrentVectorInLeafLocked(key, leaf)) {
+        ++num_current_candidates;
+      }
+    }
+  }
+  // Rows with several vectors may be in several leaves.
+  std::sort(candidates.begin(), candidates.end());
+  candidates.erase(std::unique(candidates.begin(), candidates.end()),
+                   candidates.end());
+  return candidates;
+}
+
+float AnnIndex::ComputeDistance(absl::Span<const float> a,
+                                absl::Span<const float> b) const {
+  // Vectors of different lengths are compared on their common prefix.
+  const size_t size = std::min(a.size(), b.size());
+  if (distance_ == Distance::kEuclidean) {
+    return SquaredEuclideanDistance(a.first(size), b.first(size));
+  }
+  // Vectors are normalized for the cosine distance.
+  return -DotProduct(a.first(size), b.first(size));
+}
+
+int AnnIndex::NearestCentroid(absl::Span<const float> vector,
+                              const std::vector<std::vector<float>>& centroids,
+                              const std::vector<int>* candidates) const {
+  int nearest = -1;
+  float nearest_distance = std::numeric_limits<float>::infinity();
+  auto visit = [&](int centroid) {
+    float distance = ComputeDistance(vector, centroids[centroid]);
+    if (nearest < 0 || distance < nearest_distance) {
+      nearest = centroid;
+      nearest_distance = distance;
+    }
+  };
+  if (candidates != nullptr) {
+    for (int centroid : *candidates) {
+      visit(centroid);
+    }
+  } else {
+    for (int centroid = 0; centroid < centroids.size(); ++centroid) {
+      visit(centroid);
+    }
+  }
+  return nearest;
+}
+
+std::vector<std::vector<float>> AnnIndex::ComputeCentroids(
+    const std::vector<const std::vector<float>*>& vectors,
+    int64_t num_centroids) const {
+  // Trains on an evenly strided sample of the vectors, starting from evenly
+  // spaced vectors of the sample as centroids.
+  const int64_t stride = std::max<int64_t>(
+      1, vectors.size() / (num_centroids * kTrainingVectorsPerCentroid));
+  std::vector<const std::vector<float>*> samples;
+  for (int64_t i = 0; i < vectors.size(); i += stride) {
+    samples.push_back(vectors[i]);
+  }
+  num_centroids = std::min<int64_t>(num_centroids, samples.size());
+  std::vector<std::vector<float>> centroids;
+  centroids.reserve(num_centroids);
+  for (int64_t i = 0; i < num_centroids; ++i) {
+    centroids.push_back(*samples[i * samples.size() / num_centroids]);
+  }
+
+  const size_t dimensions = centroids.empty() ? 0 : centroids.front().size();
+  for (int iteration = 0; iteration < kTrainingIterations; ++iteration) {
+    std::vector<std::vector<double>> sums(num_centroids,
+                                          std::vector<double>(dimensions));
+    std::vector<int64_t> counts(num_centroids);
+    for (const std::vector<float>* sample : samples) {
+      if (sample->size() != dimensions) {
+        continue;
+      }
+      int centroid = NearestCentroid(*sample, centroids);
+      for (size_t i = 0; i < dimensions; ++i) {
+        sums[centroid][i] += (*sample)[i];
+      }
+      ++counts[centroid];
+    }
+    // Centroids no sample is nearest to are kept as is.
+    for (int64_t centroid = 0; centroid < num_centroids; ++centroid) {
+      if (counts[centroid] == 0) {
+        continue;
+      }
+      for (size_t i = 0; i < dimensions; ++i) {
+        centroids[centroid][i] = sums[centroid][i] / counts[centroid];
+      }
+      if (distance_ == Distance::kCosine) {
+        Normalize(centroids[centroid]);
+      }
+    }
+  }
+  return centroids;
+}
+
+int AnnIndex::NearestLeaf(const Partitioning& partitioning,
+                          absl::Span<const float> vector) const {
+  int branch = NearestCentroid(vector, partitioning.branch_centroids);
+  return NearestCentroid(vector, partitioning.leaf_centroids,
+                         &partitioning.branches[branch]);
+}
+
+int64_t AnnIndex::NumLeavesToPartitionLocked() const {
+  const int64_t num_vectors = num_current_vectors_;
+  const int64_t num_leaves =
+      std::max<int64_t>(1, num_leaves_.value_or(SquareRoot(num_vectors)));
+  if (num_vectors < num_leaves * kMinVectorsPerLeaf) {
+    return 0;
+  }
+  if (!leaves_.empty() && num_vectors < 2 * num_partitioned_vectors_) {
+    return 0;
+  }
+  return num_leaves;
+}
+
+void AnnIndex::MaybePartition() {
+  // Lookups that find another thread partitioning use the current leaves.
+  if (!partition_mu_.TryLock()) {
+    return;
+  }
+  int64_t num_leaves;
+  // Replaced vectors are left out of the centroids, as they only matter to
+  // stale reads.
+  std::vector<std::shared_ptr<const std::vector<float>>> current_vectors;
+  {
+    absl::ReaderMutexLock l(&mu_);
+    // The vectors may have been partitioned since the caller checked.
+    num_leaves = NumLeavesToPartitionLocked();
+    if (num_leaves > 0) {
+      current_vectors.reserve(num_current_vectors_);
+      for (const auto& [key, entries] : entries_) {
+        for (const Entry& entry : entries) {
+          if (entry.removed_at == absl::InfiniteFuture()) {
+            current_vectors.push_back(entry.vector);
+          }
+        }
+      }
+    }
+  }
+  if (num_leaves == 0) {
+    partition_mu_.Unlock();
+    return;
+  }
+  std::vector<const std::vector<float>*> vectors;
+  vectors.reserve(current_vectors.size());
+  for (const auto& vector : current_vectors) {
+    vectors.push_back(vector.get());
+  }
+
+  Partitioning partitioning;
+  partitioning.leaf_centroids = ComputeCentroids(vectors, num_leaves);
+
+  // Groups the leaves into branches by clustering their centroids, so that
+  // vectors are compared with the centroids of a single branch of leaves.
+  std::vector<const std::vector<float>*> leaf_centroids;
+  leaf_centroids.reserve(partitioning.leaf_centroids.size());
+  for (const std::vector<float>& centroid : partitioning.leaf_centroids) {
+    leaf_centroids.push_back(&centroid);
+  }
+  partitioning.branch_centroids = ComputeCentroids(
+      leaf_centroids,
+      std::max<int64_t>(1, num_branches_.value_or(SquareRoot(
+                               partitioning.leaf_centroids.size()))));
+  std::vector<std::vector<int>>& branches = partitioning.branches;
+  branches.assign(partitioning.branch_centroids.size(), {});
+  for (int leaf = 0; leaf < partitioning.leaf_centroids.size(); ++leaf) {
+    branches[NearestCentroid(partitioning.leaf_centroids[leaf],
+                             partitioning.branch_centroids)]
+        .push_back(leaf);
+  }
+  // A branch no leaf is nearest to would have no leaf to assign vectors to.
+  for (int branch = branches.size() - 1; branch >= 0; --branch) {
+    if (branches[branch].empty()) {
+      branches.erase(branches.begin() + branch);
+      partitioning.branch_centroids.erase(
+          partitioning.branch_centroids.begin() + branch);
+    }
+  }
+
+  // The vectors are shared with the entries, which cannot be destroyed while
+  // `current_vectors` holds them, so their addresses identify them.
+  absl::flat_hash_map<const std::vector<float>*, int> vector_leaves;
+  vector_leaves.reserve(vectors.size());
+  for (const std::vector<float>* vector : vectors) {
+    vector_leaves[vector] = NearestLeaf(partitioning, *vector);
+  }
+
+  {
+    absl::MutexLock l(&mu_);
+    partitioning_ = std::move(partitioning);
+    leaves_.assign(partitioning_.leaf_centroids.size(), {});
+    for (auto& [key, entries] : entries_) {
+      for (Entry& entry : entries) {
+        // Vectors added while partitioning, and replaced vectors, are assigned
+        // to a leaf now.
+        auto leaf = vector_leaves.find(entry.vector.get());
+        entry.leaf = leaf != vector_leaves.end()
+                         ? leaf->second
+                         : NearestLeaf(partitioning_, *entry.vector);
+        leaves_[entry.leaf].insert(key);
+      }
+    }
+    num_partitioned_vectors_ = vectors.size();
+  }
+  partition_mu_.Unlock();
+}
+
+}  // namespace backend
+}  // namespace emulator
+}  // namespace spanner
+}  // namespace google
@@ -0,0 +1,238 @@
+//
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_COMMON_ANN_INDEX_H_
+#define THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_COMMON_ANN_INDEX_H_
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "zetasql/public/value.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/btree_map.h"
+#include "absl/container/btree_set.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "backend/datamodel/key.h"
+
+namespace google {
+namespace spanner {
+namespace emulator {
+namespace backend {
+
+// AnnIndex holds the vectors of a vector index in an inverted file (IVF): the
+// vectors are partitioned into leaves around centroids computed by k-means,
+// and approximate nearest neighbors of a query vector are looked up in the
+// leaves with the nearest centroids only. Like the search tree of a vector
+// index with depth 3, leaves are grouped into branches, and vectors are
+// assigned to the nearest leaf of their nearest branch.
+//
+// The vectors are partitioned once the index holds enough of them to fill the
+// leaves, and are partitioned again each time their number doubles. Vectors
+// written in between are added to the leaf with the nearest centroid.
+// Partitioning computes the centroids without holding the lock lookups and
+// writes take, which only wait for the new leaves to be installed.
+//
+// Vectors are added as rows are written, before the writing transaction
+// commits, so that it can read its own writes. Once the transaction commits,
+// the vector it wrote replaces the previous vector of the row, and deleted rows
+// lose theirs; if it rolls back, the vectors it wrote are discarded. Replaced
+// vectors are kept for kRemovedVectorRetention, so that stale reads still find
+// the rows which had them. The index thus holds the vectors rows had at any
+// timestamp readers may read at, and readers must re-check the rows it
+// returns: read their current vectors to compute the distance to the query
+// vector, and skip rows that do not exist.
+//
+// AnnIndex is thread-safe.
+class AnnIndex {
+ public:
+  // The distance the nearest neighbors are computed with.
+  enum class Distance { kCosine, kEuclidean, kDotProduct };
+
+  // `num_leaves` is the number of leaves to partition the vectors into, and
+  // `num_branches` the number of branches to group the leaves into. If unset,
+  // the square root of the number of vectors, respectively of leaves, is used.
+  AnnIndex(Distance distance, std::optional<int64_t> num_leaves,
+           std::optional<int64_t> num_branches)
+      : distance_(distance),
+        num_leaves_(num_leaves),
+        num_branches_(num_branches) {}
+
+  Distance distance() const { return distance_; }
+
+  // Adds `vector`, an ARRAY<FLOAT32> or ARRAY<FLOAT64> written to the row with
+  // `key` by a transaction which has not committed yet, to the vectors of the
+  // row. NULL vectors and vectors with NULL elements are not indexed.
+  absl::Status AddVector(const Key& key, const zetasql::Value& vector)
+      ABSL_LOCKS_EXCLUDED(mu_);
+
+  // Makes `vector` the vector of the row with `key` as of `commit_timestamp`,
+  // replacing the vectors the row had before.
+  absl::Status CommitVector(const Key& key, const zetasql::Value& vector,
+                            absl::Time commit_timestamp)
+      ABSL_LOCKS_EXCLUDED(mu_);
+
+  // Removes the vectors of the row with `key`, deleted at `commit_timestamp`.
+  void CommitDelete(const Key& key, absl::Time commit_timestamp)
+      ABSL_LOCKS_EXCLUDED(mu_);
+
+  // Discards the vectors added to the row with `key` by a transaction which
+  // rolled back.
+  void DiscardUncommittedVectors(const Key& key) ABSL_LOCKS_EXCLUDED(mu_);
+
+  // Returns, in key order, the keys of the rows whose vectors are likely to be
+  // among the `num_neighbors` nearest to `query`: the rows in the leaves with
+  // the nearest centroids, probed until they hold kCandidatesPerNeighbor times
+  // `num_neighbors` current vectors. Rows whose vectors in these leaves have
+  // been replaced are returned as well, but do not count towards the
+  // candidates. Returns std::nullopt if there are too few vectors to
+  // partition, in which case readers must compare every vector with `query`.
+  std::optional<std::vector<Key>> FindNeighborCandidates(
+      absl::Span<const double> query, int64_t num_neighbors)
+      ABSL_LOCKS_EXCLUDED(partition_mu_, mu_);
+
+  // The number of candidates FindNeighborCandidates looks up per neighbor.
+  static constexpr int64_t kCandidatesPerNeighbor = 10;
+
+  // The minimum average number of vectors per leaf to partition the vectors.
+  static constexpr int64_t kMinVectorsPerLeaf = 16;
+
+  // How long replaced vectors are kept, the maximum staleness of reads.
+  static constexpr absl::Duration kRemovedVectorRetention = absl::Hours(1);
+
+ private:
+  // A vector of a row.
+  struct Entry {
+    // Never modified once the entry is added, and shared with partitioning,
+    // which reads it without holding mu_.
+    std::shared_ptr<const std::vector<float>> vector;
+
+    // False until the transaction which wrote the vector commits.
+    bool committed = false;
+
+    // When the vector was replaced or its row deleted, or InfiniteFuture if it
+    // is a current vector of the row.
+    absl::Time removed_at = absl::InfiniteFuture();
+
+    // The leaf the vector is in, or -1 if the vectors are not partitioned.
+    int leaf = -1;
+  };
+
+  // The centroids the vectors are partitioned around.
+  struct Partitioning {
+    std::vector<std::vector<float>> leaf_centroids;
+
+    // The centroids of the branches, and the leaves in each branch.
+    std::vector<std::vector<float>> branch_centroids;
+    std::vector<std::vector<int>> branches;
+  };
+
+  // Returns the elements of `vector`, normalized for the cosine distance, or
+  // std::nullopt if it is not indexed.
+  absl::StatusOr<std::optional<std::vector<float>>> GetElements(
+      const zetasql::Value& vector) const;
+
+  // Returns the distance between `a` and `b`. Lower is nearer.
+  float ComputeDistance(absl::Span<const float> a,
+                        absl::Span<const float> b) const;
+
+  // Returns the index of the centroid among `centroids` (or among the
+  // `candidates` of them if given) which is the nearest to `vector`.
+  int NearestCentroid(absl::Span<const float> vector,
+                      const std::vector<std::vector<float>>& centroids,
+                      const std::vector<int>* candidates = nullptr) const;
+
+  // Computes `num_centroids` centroids of `vectors` with k-means.
+  std::vector<std::vector<float>> ComputeCentroids(
+      const std::vector<const std::vector<float>*>& vectors,
+      int64_t num_centroids) const;
+
+  // Returns the leaf whose centroid is the nearest to `vector` in the branch
+  // whose centroid is the nearest to `vector`.
+  int NearestLeaf(const Partitioning& partitioning,
+                  absl::Span<const float> vector) const;
+
+  // Adds `vector` to the vectors of the row with `key`.
+  void AddEntryLocked(const Key& key, std::vector<float> vector, bool committed)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Removes the vectors of the row with `key` for which `remove` is true.
+  void RemoveEntriesLocked(const Key& key,
+                           const std::function<bool(const Entry&)>& remove)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Makes `vector` the only current vector of the row with `key`, or removes
+  // its vectors if std::nullopt.
+  void CommitLocked(const Key& key, std::optional<std::vector<float>> vector,
+                    absl::Time commit_timestamp)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Returns true if the row with `key` has a current vector in `leaf`.
+  bool HasCurrentVectorInLeafLocked(const Key& key, int leaf) const
+      ABSL_SHARED_LOCKS_REQUIRED(mu_);
+
+  // Returns the number of leaves to partition the vectors into if there are
+  // enough vectors since the last partitioning, or 0 otherwise.
+  int64_t NumLeavesToPartitionLocked() const ABSL_SHARED_LOCKS_REQUIRED(mu_);
+
+  // Partitions the vectors if there are enough vectors since the last
+  // partitioning, unless another thread is partitioning them already.
+  void MaybePartition() ABSL_LOCKS_EXCLUDED(partition_mu_, mu_);
+
+  const Distance distance_;
+
+  const std::optional<int64_t> num_leaves_;
+
+  const std::optional<int64_t> num_branches_;
+
+  // Serializes partitioning.
+  absl::Mutex partition_mu_ ABSL_ACQUIRED_BEFORE(mu_);
+
+  absl::Mutex mu_;
+
+  // The vectors of each row.
+  absl::btree_map<Key, std::vector<Entry>> entries_ ABSL_GUARDED_BY(mu_);
+
+  // The number of current vectors, which are the ones partitioned.
+  int64_t num_current_vectors_ ABSL_GUARDED_BY(mu_) = 0;
+
+  // The rows with replaced vectors, in the order the vectors were replaced.
+  std::deque<std::pair<absl::Time, Key>> removals_ ABSL_GUARDED_BY(mu_);
+
+  Partitioning partitioning_ ABSL_GUARDED_BY(mu_);
+
+  // The keys of the vectors in each leaf. Empty if the vectors are not
+  // partitioned.
+  std::vector<absl::btree_set<Key>> leaves_ ABSL_GUARDED_BY(mu_);
+
+  // The number of vectors at the last partitioning.
+  int64_t num_partitioned_vectors_ ABSL_GUARDED_BY(mu_) = 0;
+};
+
+}  // namespace backend
+}  // namespace emulator
+}  // namespace spanner
+}  // namespace google
+
+#endif  // THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_COMMON_ANN_INDEX_H_
@@ -0,0 +1,250 @@
+//
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "backend/common/ann_index.h"
+
+#include <cstdint>
+#include <optional>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "zetasql/public/value.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "zetasql/base/testing/status_matchers.h"
+#include "absl/time/time.h"
+#include "backend/datamodel/key.h"
+
+namespace google {
+namespace spanner {
+namespace emulator {
+namespace backend {
+namespace {
+
+using ::testing::Contains;
+using ::testing::Each;
+using ::testing::Not;
+using ::testing::Optional;
+using ::testing::SizeIs;
+
+Key MakeKey(int64_t value) {
+  return Key({zetasql::Value::Int64(value)});
+}
+
+// The corners the vectors of AnnIndexTest are clustered around.
+constexpr double kCorners[4][2] = {
+    {100, 100}, {100, -100}, {-100, 100}, {-100, -100}};
+
+constexpr int64_t kVectorsPerCorner = 64;
+
+class AnnIndexTest : public testing::Test {
+ protected:
+  // Sets the vectors of rows 0 to 4 * kVectorsPerCorner - 1, the vectors of
+  // rows [i * kVectorsPerCorner, (i + 1) * kVectorsPerCorner) being close to
+  // the i-th corner.
+  void SetClusteredVectors() {
+    for (int64_t row = 0; row < 4 * kVectorsPerCorner; ++row) {
+      const double* corner = kCorners[row / kVectorsPerCorner];
+      ZETASQL_ASSERT_OK(index_.AddVector(
+          MakeKey(row), zetasql::values::DoubleArray(
+                            {corner[0] + row % 8, corner[1] + row / 8 % 8})));
+    }
+  }
+
+  // Commits the vectors set by SetClusteredVectors at `commit_timestamp`.
+  void CommitClusteredVectors(absl::Time commit_timestamp) {
+    for (int64_t row = 0; row < 4 * kVectorsPerCorner; ++row) {
+      const double* corner = kCorners[row / kVectorsPerCorner];
+      ZETASQL_ASSERT_OK(index_.CommitVector(
+          MakeKey(row),
+          zetasql::values::DoubleArray(
+              {corner[0] + row % 8, corner[1] + row / 8 % 8}),
+          commit_timestamp));
+    }
+  }
+
+  // Returns the keys of the rows whose vectors are close to the i-th corner.
+  std::vector<Key> CornerKeys(int i) {
+    std::vector<Key> keys;
+    for (int64_t row = i * kVectorsPerCorner;
+         row < (i + 1) * kVectorsPerCorner; ++row) {
+      keys.push_back(MakeKey(row));
+    }
+    return keys;
+  }
+
+  AnnIndex index_{AnnIndex::Distance::kEuclidean, /*num_leaves=*/4,
+                  /*num_branches=*/std::nullopt};
+};
+
+TEST_F(AnnIndexTest, ReturnsNoCandidatesWithTooFewVectors) {
+  ZETASQL_ASSERT_OK(
+      index_.AddVector(MakeKey(1), zetasql::values::DoubleArray({1, 2})));
+
+  EXPECT_EQ(index_.FindNeighborCandidates({1, 2}, 1), std::nullopt);
+}
+
+TEST_F(AnnIndexTest, ReturnsVectorsOfNearestLeaves) {
+  SetClusteredVectors();
+
+  EXPECT_THAT(index_.FindNeighborCandidates({99, 98}, 1),
+              Optional(CornerKeys(0)));
+  EXPECT_THAT(index_.FindNeighborCandidates({-101, -97}, 1),
+              Optional(CornerKeys(3)));
+}
+
+TEST_F(AnnIndexTest, ProbesLeavesUntilEnoughCandidates) {
+  SetClusteredVectors();
+
+  std::optional<std::vector<Key>> candidates =
+      index_.FindNeighborCandidates({99, 98}, kVectorsPerCorner);
+  ASSERT_NE(candidates, std::nullopt);
+  EXPECT_THAT(*candidates, SizeIs(4 * kVectorsPerCorner));
+}
+
+TEST_F(AnnIndexTest, KeepsPreviousVectorsOfRows) {
+  SetClusteredVectors();
+  ASSERT_NE(index_.FindNeighborCandidates({0, 0}, 1), std::nullopt);
+
+  // The write may not commit, so the vector the row had is kept as well.
+  ZETASQL_ASSERT_OK(index_.AddVector(MakeKey(0),
+                             zetasql::values::DoubleArray({-100, -100})));
+  ZETASQL_ASSERT_OK(index_.AddVector(
+      MakeKey(1), zetasql::Value::Null(zetasql::types::DoubleArrayType())));
+
+  EXPECT_THAT(index_.FindNeighborCandidates({100, 100}, 1),
+              Optional(CornerKeys(0)));
+  std::optional<std::vector<Key>> candidates =
+      index_.FindNeighborCandidates({-100, -100}, 1);
+  ASSERT_NE(candidates, std::nullopt);
+  EXPECT_THAT(*candidates, Contains(MakeKey(0)));
+  EXPECT_THAT(*candidates, Each(Not(MakeKey(1))));
+}
+
+TEST_F(AnnIndexTest, ReplacesVectorsOfRowsOnCommit) {
+  const absl::Time t0 = absl::FromUnixSeconds(1000);
+  CommitClusteredVectors(t0);
+  ASSERT_NE(index_.FindNeighborCandidates({0, 0}, 1), std::nullopt);
+
+  ZETASQL_ASSERT_OK(index_.CommitVector(
+      MakeKey(0), zetasql::values::DoubleArray({-100, -100}),
+      t0 + absl::Seconds(1)));
+
+  // Stale reads may still see the vector the row had before.
+  EXPECT_THAT(index_.FindNeighborCandidates({100, 100}, 1),
+              Optional(CornerKeys(0)));
+  std::optional<std::vector<Key>> candidates =
+      index_.FindNeighborCandidates({-100, -100}, 1);
+  ASSERT_NE(candidates, std::nullopt);
+  EXPECT_THAT(*candidates, Contains(MakeKey(0)));
+
+  // Once no read can see it anymore, it is removed.
+  ZETASQL_ASSERT_OK(index_.CommitVector(
+      MakeKey(1), zetasql::values::DoubleArray({101, 100}),
+      t0 + absl::Seconds(1) + AnnIndex::kRemovedVectorRetention));
+  candidates = index_.FindNeighborCandidates({100, 100}, 1);
+  ASSERT_NE(candidates, std::nullopt);
+  EXPECT_THAT(*candidates, Not(Contains(MakeKey(0))));
+  EXPECT_THAT(*candidates, Contains(MakeKey(1)));
+}
+
+TEST_F(AnnIndexTest, DeletedRowsDoNotCrowdOutCandidates) {
+  const absl::Time t0 = absl::FromUnixSeconds(1000);
+  CommitClusteredVectors(t0);
+  ASSERT_NE(index_.FindNeighborCandidates({0, 0}, 1), std::nullopt);
+
+  // Leaves 4 rows near the first corner.
+  for (int64_t row = 4; row < kVectorsPerCorner; ++row) {
+    index_.CommitDelete(MakeKey(row), t0 + absl::Seconds(1));
+  }
+
+  // The lookup probes another leaf to find enough rows which still exist.
+  constexpr int64_t kNumNeighbors = 6;
+  std::optional<std::vector<Key>> candidates =
+      index_.FindNeighborCandidates({100, 100}, kNumNeighbors);
+  ASSERT_NE(candidates, std::nullopt);
+  EXPECT_THAT(*candidates, SizeIs(2 * kVectorsPerCorner));
+  EXPECT_THAT(*candidates, Contains(MakeKey(0)));
+}
+
+TEST_F(AnnIndexTest, DiscardsVectorsOfRolledBackWrites) {
+  const absl::Time t0 = absl::FromUnixSeconds(1000);
+  CommitClusteredVectors(t0);
+  ASSERT_NE(index_.FindNeighborCandidates({0, 0}, 1), std::nullopt);
+
+  ZETASQL_ASSERT_OK(index_.AddVector(MakeKey(0),
+                             zetasql::values::DoubleArray({-100, -100})));
+  index_.DiscardUncommittedVectors(MakeKey(0));
+
+  EXPECT_THAT(index_.FindNeighborCandidates({-100, -100}, 1),
+              Optional(CornerKeys(3)));
+  EXPECT_THAT(index_.FindNeighborCandidates({100, 100}, 1),
+              Optional(CornerKeys(0)));
+}
+
+TEST_F(AnnIndexTest, RepartitionsWhileVectorsAreAddedAndLookedUp) {
+  SetClusteredVectors();
+  ASSERT_NE(index_.FindNeighborCandidates({0, 0}, 1), std::nullopt);
+
+  // Doubles the number of vectors near the first corner, which partitions the
+  // vectors again during one of the lookups.
+  std::thread writer([this] {
+    for (int64_t row = 4 * kVectorsPerCorner; row < 8 * kVectorsPerCorner;
+         ++row) {
+      ZETASQL_ASSERT_OK(index_.AddVector(
+          MakeKey(row), zetasql::values::DoubleArray(
+                            {100.0 + row % 8, 100.0 + row / 8 % 8})));
+    }
+  });
+  for (int i = 0; i < 100; ++i) {
+    std::optional<std::vector<Key>> candidates =
+        index_.FindNeighborCandidates({-100, -100}, 1);
+    ASSERT_NE(candidates, std::nullopt);
+    EXPECT_THAT(*candidates, Contains(MakeKey(3 * kVectorsPerCorner)));
+  }
+  writer.join();
+
+  std::optional<std::vector<Key>> candidates =
+      index_.FindNeighborCandidates({100, 100}, 8 * kVectorsPerCorner);
+  ASSERT_NE(candidates, std::nullopt);
+  EXPECT_THAT(*candidates, SizeIs(8 * kVectorsPerCorner));
+}
+
+TEST(AnnIndexCosineTest, ComparesDirectionsOfVectors) {
+  AnnIndex index(AnnIndex::Distance::kCosine, /*num_leaves=*/2,
+                 /*num_branches=*/1);
+  for (int64_t row = 0; row < 64; ++row) {
+    // Vectors of even rows point along the x axis, of odd rows along the y
+    // axis, with varying lengths.
+    float length = row + 1;
+    ZETASQL_ASSERT_OK(index.AddVector(
+        MakeKey(row), row % 2 == 0
+                          ? zetasql::values::FloatArray({length, 1})
+                          : zetasql::values::FloatArray({1, length})));
+  }
+
+  std::optional<std::vector<Key>> candidates =
+      index.FindNeighborCandidates({1000, 0}, 1);
+  ASSERT_NE(candidates, std::nullopt);
+  EXPECT_THAT(*candidates, Contains(MakeKey(62)));
+  EXPECT_THAT(*candidates, Not(Contains(MakeKey(63))));
+}
+
+}  // namespace
+}  // namespace backend
+}  // namespace emulator
+}  // namespace spanner
+}  // namespace google
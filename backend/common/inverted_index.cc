@@ -0,0 +1,274 @@
+//
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "backend/common/inverted_index.h"
+
+#include <algorithm>
+#include <functional>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "zetasql/public/value.h"
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "backend/common/ids.h"
+#include "backend/datamodel/key.h"
+#include "backend/query/search/tokenizer.h"
+#include "zetasql/base/ret_check.h"
+#include "zetasql/base/status_macros.h"
+
+namespace google {
+namespace spanner {
+namespace emulator {
+namespace backend {
+
+namespace {
+
+// Splits the tokens of `token_list` into the tokenizer signatures and the
+// other tokens, leaving out gaps. The other tokens are returned in
+// lexicographic order.
+absl::Status SplitTokenList(const zetasql::Value& token_list,
+                            std::vector<std::string>* signatures,
+                            std::vector<std::string>* tokens) {
+  ZETASQL_RET_CHECK(token_list.type()->IsTokenList());
+  if (token_list.is_null()) {
+    return absl::OkStatus();
+  }
+  ZETASQL_ASSIGN_OR_RETURN(std::vector<std::string> strings,
+                   query::search::StringsFromTokenList(token_list));
+  for (std::string& token : strings) {
+    if (query::search::IsTokenizerSignature(token)) {
+      signatures->push_back(std::move(token));
+    } else if (token != query::search::kGapString) {
+      tokens->push_back(std::move(token));
+    }
+  }
+  std::sort(tokens->begin(), tokens->end());
+  tokens->erase(std::unique(tokens->begin(), tokens->end()), tokens->end());
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+absl::Status InvertedIndex::AddTokenList(const ColumnID& column,
+                                         const Key& key,
+                                         const zetasql::Value& token_list) {
+  std::vector<std::string> signatures;
+  std::vector<std::string> tokens;
+  ZETASQL_RETURN_IF_ERROR(SplitTokenList(token_list, &signatures, &tokens));
+  if (token_list.is_null()) {
+    return absl::OkStatus();
+  }
+
+  absl::MutexLock l(&mu_);
+  ColumnPostings& postings = columns_[column];
+  postings.signatures.insert(signatures.begin(), signatures.end());
+  auto it = postings.token_lists.find(key);
+  if (it != postings.token_lists.end()) {
+    for (const TokenList& existing : it->second) {
+      if (existing.removed_at == absl::InfiniteFuture() &&
+          existing.tokens == tokens) {
+        return absl::OkStatus();
+      }
+    }
+  }
+  AddTokensLocked(postings, key, std::move(tokens), /*committed=*/false);
+  return absl::OkStatus();
+}
+
+absl::Status InvertedIndex::CommitTokenList(const ColumnID& column,
+                                            const Key& key,
+                                            const zetasql::Value& token_list,
+                                            absl::Time commit_timestamp) {
+  std::vector<std::string> signatures;
+  std::vector<std::string> tokens;
+  ZETASQL_RETURN_IF_ERROR(SplitTokenList(token_list, &signatures, &tokens));
+
+  absl::MutexLock l(&mu_);
+  if (token_list.is_null()) {
+    CommitLocked(column, key, std::nullopt, commit_timestamp);
+  } else {
+    columns_[column].signatures.insert(signatures.begin(), signatures.end());
+    CommitLocked(column, key, std::move(tokens), commit_timestamp);
+  }
+  PurgeRemovedTokenListsLocked(commit_timestamp - kRemovedTokenListRetention);
+  return absl::OkStatus();
+}
+
+void InvertedIndex::CommitDelete(const Key& key, absl::Time commit_timestamp) {
+  absl::MutexLock l(&mu_);
+  for (const auto& [column, postings] : columns_) {
+    CommitLocked(column, key, std::nullopt, commit_timestamp);
+  }
+  PurgeRemovedTokenListsLocked(commit_timestamp - kRemovedTokenListRetention);
+}
+
+void InvertedIndex::DiscardUncommittedTokenLists(const Key& key) {
+  absl::MutexLock l(&mu_);
+  for (auto& [column, postings] : columns_) {
+    RemoveTokenListsLocked(
+        postings, key,
+        [](const TokenList& token_list) { return !token_list.committed; });
+  }
+}
+
+void InvertedIndex::AddTokensLocked(ColumnPostings& postings, const Key& key,
+                                    std::vector<std::string> tokens,
+                                    bool committed) {
+  for (const std::string& token : tokens) {
+    postings.posting_lists[token].insert(key);
+  }
+  postings.token_lists[key].push_back(
+      TokenList{.tokens = std::move(tokens), .committed = committed});
+}
+
+void InvertedIndex::RemoveTokenListsLocked(
+    ColumnPostings& postings, const Key& key,
+    const std::function<bool(const TokenList&)>& remove) {
+  auto it = postings.token_lists.find(key);
+  if (it == postings.token_lists.end()) {
+    return;
+  }
+  std::vector<TokenList>& token_lists = it->second;
+  std::vector<std::string> removed_tokens;
+  for (auto token_list = token_lists.begin();
+       token_list != token_lists.end();) {
+    if (!remove(*token_list)) {
+      ++token_list;
+      continue;
+    }
+    removed_tokens.insert(removed_tokens.end(), token_list->tokens.begin(),
+                          token_list->tokens.end());
+    token_list = token_lists.erase(token_list);
+  }
+  // The row stays in the posting lists of the tokens of its other token lists.
+  for (const std::string& token : removed_tokens) {
+    auto has_token = [&token](const TokenList& token_list) {
+      return std::binary_search(token_list.tokens.begin(),
+                                token_list.tokens.end(), token);
+    };
+    if (std::any_of(token_lists.begin(), token_lists.end(), has_token)) {
+      continue;
+    }
+    auto posting_list = postings.posting_lists.find(token);
+    if (posting_list == postings.posting_lists.end()) {
+      continue;
+    }
+    posting_list->second.erase(key);
+    if (posting_list->second.empty()) {
+      postings.posting_lists.erase(posting_list);
+    }
+  }
+  if (token_lists.empty()) {
+    postings.token_lists.erase(it);
+  }
+}
+
+void InvertedIndex::CommitLocked(const ColumnID& column, const Key& key,
+                                 std::optional<std::vector<std::string>> tokens,
+                                 absl::Time commit_timestamp) {
+  ColumnPostings& postings = columns_[column];
+  bool found = false;
+  auto it = postings.token_lists.find(key);
+  if (it != postings.token_lists.end()) {
+    for (TokenList& token_list : it->second) {
+      if (token_list.removed_at != absl::InfiniteFuture()) {
+        continue;
+      }
+      if (!found && tokens.has_value() && token_list.tokens == *tokens) {
+        token_list.committed = true;
+        found = true;
+      } else if (token_list.committed) {
+        token_list.removed_at = commit_timestamp;
+        removals_.push_back(Removal{commit_timestamp, column, key});
+      }
+    }
+    // Other uncommitted token lists of the row were overwritten or rolled
+    // back, so no reader can see them.
+    RemoveTokenListsLocked(
+        postings, key,
+        [](const TokenList& token_list) { return !token_list.committed; });
+  }
+  if (tokens.has_value() && !found) {
+    AddTokensLocked(postings, key, *std::move(tokens), /*committed=*/true);
+  }
+}
+
+void InvertedIndex::PurgeRemovedTokenListsLocked(absl::Time cutoff) {
+  // Reads older than the retention fail, so no reader needs the token lists
+  // replaced before it anymore.
+  while (!removals_.empty() && removals_.front().removed_at <= cutoff) {
+    const Removal removal = std::move(removals_.front());
+    removals_.pop_front();
+    auto postings = columns_.find(removal.column);
+    if (postings == columns_.end()) {
+      continue;
+    }
+    RemoveTokenListsLocked(postings->second, removal.key,
+                           [cutoff](const TokenList& token_list) {
+                             return token_list.removed_at <= cutoff;
+                           });
+  }
+}
+
+std::optional<std::string> InvertedIndex::GetTokenizer(
+    const ColumnID& column) const {
+  std::optional<std::string> tokenizer;
+  for (absl::string_view signature : GetTokenizerSignatures(column)) {
+    absl::string_view name = signature.substr(0, signature.find('-'));
+    if (!tokenizer.has_value()) {
+      tokenizer = std::string(name);
+    } else if (*tokenizer != name) {
+      return std::nullopt;
+    }
+  }
+  return tokenizer;
+}
+
+std::vector<std::string> InvertedIndex::GetTokenizerSignatures(
+    const ColumnID& column) const {
+  absl::ReaderMutexLock l(&mu_);
+  auto it = columns_.find(column);
+  if (it == columns_.end()) {
+    return {};
+  }
+  return std::vector<std::string>(it->second.signatures.begin(),
+                                  it->second.signatures.end());
+}
+
+std::vector<Key> InvertedIndex::GetPostingList(const ColumnID& column,
+                                               absl::string_view token) const {
+  absl::ReaderMutexLock l(&mu_);
+  auto it = columns_.find(column);
+  if (it == columns_.end()) {
+    return {};
+  }
+  auto posting_list = it->second.posting_lists.find(token);
+  if (posting_list == it->second.posting_lists.end()) {
+    return {};
+  }
+  return std::vector<Key>(posting_list->second.begin(),
+                          posting_list->second.end());
+}
+
+}  // namespace backend
+}  // namespace emulator
+}  // namespace spanner
+}  // namespace google
@@ -0,0 +1,167 @@
+//
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_COMMON_INVERTED_INDEX_H_
+#define THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_COMMON_INVERTED_INDEX_H_
+
+#include <deque>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "zetasql/public/value.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/btree_map.h"
+#include "absl/container/btree_set.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "backend/common/ids.h"
+#include "backend/datamodel/key.h"
+
+namespace google {
+namespace spanner {
+namespace emulator {
+namespace backend {
+
+// InvertedIndex holds the posting lists of a search index: for each TOKENLIST
+// column of the indexed table, it maps every token to the keys of the rows
+// whose value of the column contains the token.
+//
+// Keys are added to posting lists as rows are written, before the writing
+// transaction commits, so that it can read its own writes. Once the
+// transaction commits, the token list it wrote replaces the previous token
+// list of the row, and deleted rows lose theirs; if it rolls back, the token
+// lists it wrote are discarded. Replaced token lists are kept for
+// kRemovedTokenListRetention, so that stale reads still find the rows which
+// had them. The posting list of a token is thus a superset of the rows
+// containing the token at any timestamp readers may read at, and readers must
+// re-check the rows it returns.
+//
+// InvertedIndex is thread-safe.
+class InvertedIndex {
+ public:
+  // Adds `key` to the posting lists of the tokens in `token_list`, the value
+  // of `column` written to the row with that key by a transaction which has
+  // not committed yet. NULL values have no tokens.
+  absl::Status AddTokenList(const ColumnID& column, const Key& key,
+                            const zetasql::Value& token_list)
+      ABSL_LOCKS_EXCLUDED(mu_);
+
+  // Makes `token_list` the value of `column` in the row with `key` as of
+  // `commit_timestamp`, replacing the token lists the row had before.
+  absl::Status CommitTokenList(const ColumnID& column, const Key& key,
+                               const zetasql::Value& token_list,
+                               absl::Time commit_timestamp)
+      ABSL_LOCKS_EXCLUDED(mu_);
+
+  // Removes the token lists of the row with `key`, deleted at
+  // `commit_timestamp`.
+  void CommitDelete(const Key& key, absl::Time commit_timestamp)
+      ABSL_LOCKS_EXCLUDED(mu_);
+
+  // Discards the token lists added to the row with `key` by a transaction
+  // which rolled back.
+  void DiscardUncommittedTokenLists(const Key& key) ABSL_LOCKS_EXCLUDED(mu_);
+
+  // Returns the tokenizer (e.g. "fulltext") that produced all the token lists
+  // added for `column`, or std::nullopt if none were added or if they were
+  // produced by different tokenizers.
+  std::optional<std::string> GetTokenizer(const ColumnID& column) const
+      ABSL_LOCKS_EXCLUDED(mu_);
+
+  // Returns the distinct tokenizer signatures (e.g. "ngrams-4-2-0") of the
+  // token lists added for `column`, in lexicographic order.
+  std::vector<std::string> GetTokenizerSignatures(const ColumnID& column) const
+      ABSL_LOCKS_EXCLUDED(mu_);
+
+  // Returns the keys in the posting list of `token` for `column`, in key
+  // order.
+  std::vector<Key> GetPostingList(const ColumnID& column,
+                                  absl::string_view token) const
+      ABSL_LOCKS_EXCLUDED(mu_);
+
+  // How long replaced token lists are kept, the maximum staleness of reads.
+  static constexpr absl::Duration kRemovedTokenListRetention = absl::Hours(1);
+
+ private:
+  // A token list of a row.
+  struct TokenList {
+    // The tokens other than signatures and gaps, in lexicographic order.
+    std::vector<std::string> tokens;
+
+    // False until the transaction which wrote the token list commits.
+    bool committed = false;
+
+    // When the token list was replaced or its row deleted, or InfiniteFuture
+    // if it is a current token list of the row.
+    absl::Time removed_at = absl::InfiniteFuture();
+  };
+
+  struct ColumnPostings {
+    // The signatures of the token lists of the column. Token lists built by
+    // TOKENLIST_CONCAT have a signature per concatenated token list. Kept when
+    // token lists are replaced, as there are few of them.
+    absl::btree_set<std::string> signatures;
+
+    absl::flat_hash_map<std::string, absl::btree_set<Key>> posting_lists;
+
+    // The token lists of each row.
+    absl::btree_map<Key, std::vector<TokenList>> token_lists;
+  };
+
+  // Adds `tokens` to the token lists of the row with `key`.
+  static void AddTokensLocked(ColumnPostings& postings, const Key& key,
+                              std::vector<std::string> tokens, bool committed);
+
+  // Removes the token lists of the row with `key` for which `remove` is true.
+  static void RemoveTokenListsLocked(
+      ColumnPostings& postings, const Key& key,
+      const std::function<bool(const TokenList&)>& remove);
+
+  // Makes `tokens` the only current token list of `column` in the row with
+  // `key`, or removes its token lists if std::nullopt.
+  void CommitLocked(const ColumnID& column, const Key& key,
+                    std::optional<std::vector<std::string>> tokens,
+                    absl::Time commit_timestamp)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Removes the token lists replaced before `cutoff`.
+  void PurgeRemovedTokenListsLocked(absl::Time cutoff)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  mutable absl::Mutex mu_;
+
+  absl::flat_hash_map<ColumnID, ColumnPostings> columns_ ABSL_GUARDED_BY(mu_);
+
+  // The rows with replaced token lists, in the order they were replaced.
+  struct Removal {
+    absl::Time removed_at;
+    ColumnID column;
+    Key key;
+  };
+  std::deque<Removal> removals_ ABSL_GUARDED_BY(mu_);
+};
+
+}  // namespace backend
+}  // namespace emulator
+}  // namespace spanner
+}  // namespace google
+
+#endif  // THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_COMMON_INVERTED_INDEX_H_
@@ -0,0 +1,162 @@
+//
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "backend/common/inverted_index.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "zetasql/public/value.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "zetasql/base/testing/status_matchers.h"
+#include "absl/time/time.h"
+#include "backend/datamodel/key.h"
+#include "backend/query/search/tokenizer.h"
+
+namespace google {
+namespace spanner {
+namespace emulator {
+namespace backend {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+using ::testing::Optional;
+using query::search::TokenListFromStrings;
+
+Key MakeKey(int64_t value) {
+  return Key({zetasql::Value::Int64(value)});
+}
+
+TEST(InvertedIndexTest, ReturnsPostingListsInKeyOrder) {
+  InvertedIndex index;
+  ZETASQL_ASSERT_OK(index.AddTokenList(
+      "C1", MakeKey(2), TokenListFromStrings({"fulltext-0", "foo", "bar"})));
+  ZETASQL_ASSERT_OK(index.AddTokenList(
+      "C1", MakeKey(1), TokenListFromStrings({"fulltext-0", "foo"})));
+  ZETASQL_ASSERT_OK(index.AddTokenList(
+      "C2", MakeKey(3), TokenListFromStrings({"fulltext-0", "foo"})));
+
+  EXPECT_THAT(index.GetPostingList("C1", "foo"),
+              ElementsAre(MakeKey(1), MakeKey(2)));
+  EXPECT_THAT(index.GetPostingList("C1", "bar"), ElementsAre(MakeKey(2)));
+  EXPECT_THAT(index.GetPostingList("C2", "foo"), ElementsAre(MakeKey(3)));
+  EXPECT_THAT(index.GetPostingList("C1", "baz"), IsEmpty());
+  EXPECT_THAT(index.GetPostingList("C3", "foo"), IsEmpty());
+}
+
+TEST(InvertedIndexTest, KeepsKeysOfRewrittenRows) {
+  InvertedIndex index;
+  ZETASQL_ASSERT_OK(index.AddTokenList(
+      "C1", MakeKey(1), TokenListFromStrings({"fulltext-0", "foo"})));
+  ZETASQL_ASSERT_OK(index.AddTokenList(
+      "C1", MakeKey(1), TokenListFromStrings({"fulltext-0", "bar"})));
+
+  EXPECT_THAT(index.GetPostingList("C1", "foo"), ElementsAre(MakeKey(1)));
+  EXPECT_THAT(index.GetPostingList("C1", "bar"), ElementsAre(MakeKey(1)));
+}
+
+TEST(InvertedIndexTest, ReplacesTokenListsOfRowsOnCommit) {
+  InvertedIndex index;
+  const absl::Time t0 = absl::FromUnixSeconds(1000);
+  ZETASQL_ASSERT_OK(index.CommitTokenList(
+      "C1", MakeKey(1), TokenListFromStrings({"fulltext-0", "foo"}), t0));
+  ZETASQL_ASSERT_OK(index.CommitTokenList(
+      "C1", MakeKey(1), TokenListFromStrings({"fulltext-0", "bar"}),
+      t0 + absl::Seconds(1)));
+
+  // Stale reads may still see the token list the row had before.
+  EXPECT_THAT(index.GetPostingList("C1", "foo"), ElementsAre(MakeKey(1)));
+  EXPECT_THAT(index.GetPostingList("C1", "bar"), ElementsAre(MakeKey(1)));
+
+  // Once no read can see it anymore, it is removed.
+  ZETASQL_ASSERT_OK(index.CommitTokenList(
+      "C1", MakeKey(2), TokenListFromStrings({"fulltext-0", "bar"}),
+      t0 + absl::Seconds(1) + InvertedIndex::kRemovedTokenListRetention));
+  EXPECT_THAT(index.GetPostingList("C1", "foo"), IsEmpty());
+  EXPECT_THAT(index.GetPostingList("C1", "bar"),
+              ElementsAre(MakeKey(1), MakeKey(2)));
+}
+
+TEST(InvertedIndexTest, RemovesTokenListsOfDeletedRows) {
+  InvertedIndex index;
+  const absl::Time t0 = absl::FromUnixSeconds(1000);
+  ZETASQL_ASSERT_OK(index.CommitTokenList(
+      "C1", MakeKey(1), TokenListFromStrings({"fulltext-0", "foo"}), t0));
+  ZETASQL_ASSERT_OK(index.CommitTokenList(
+      "C2", MakeKey(1), TokenListFromStrings({"fulltext-0", "foo"}), t0));
+  index.CommitDelete(MakeKey(1), t0 + absl::Seconds(1));
+  index.CommitDelete(
+      MakeKey(2),
+      t0 + absl::Seconds(1) + InvertedIndex::kRemovedTokenListRetention);
+
+  EXPECT_THAT(index.GetPostingList("C1", "foo"), IsEmpty());
+  EXPECT_THAT(index.GetPostingList("C2", "foo"), IsEmpty());
+}
+
+TEST(InvertedIndexTest, DiscardsTokenListsOfRolledBackWrites) {
+  InvertedIndex index;
+  const absl::Time t0 = absl::FromUnixSeconds(1000);
+  ZETASQL_ASSERT_OK(index.CommitTokenList(
+      "C1", MakeKey(1), TokenListFromStrings({"fulltext-0", "foo"}), t0));
+  ZETASQL_ASSERT_OK(index.AddTokenList(
+      "C1", MakeKey(1), TokenListFromStrings({"fulltext-0", "foo", "bar"})));
+  EXPECT_THAT(index.GetPostingList("C1", "bar"), ElementsAre(MakeKey(1)));
+
+  index.DiscardUncommittedTokenLists(MakeKey(1));
+
+  EXPECT_THAT(index.GetPostingList("C1", "foo"), ElementsAre(MakeKey(1)));
+  EXPECT_THAT(index.GetPostingList("C1", "bar"), IsEmpty());
+}
+
+TEST(InvertedIndexTest, SkipsSignaturesAndGaps) {
+  InvertedIndex index;
+  ZETASQL_ASSERT_OK(index.AddTokenList(
+      "C1", MakeKey(1),
+      TokenListFromStrings({"fulltext-0", "foo",
+                            query::search::kGapString, "bar"})));
+
+  EXPECT_THAT(index.GetPostingList("C1", "fulltext-0"), IsEmpty());
+  EXPECT_THAT(index.GetPostingList("C1", query::search::kGapString),
+              IsEmpty());
+  EXPECT_THAT(index.GetPostingList("C1", "bar"), ElementsAre(MakeKey(1)));
+}
+
+TEST(InvertedIndexTest, TracksTokenizerOfColumn) {
+  InvertedIndex index;
+  EXPECT_EQ(index.GetTokenizer("C1"), std::nullopt);
+
+  ZETASQL_ASSERT_OK(index.AddTokenList(
+      "C1", MakeKey(1), TokenListFromStrings({"fulltext-0", "foo"})));
+  ZETASQL_ASSERT_OK(index.AddTokenList(
+      "C1", MakeKey(2),
+      TokenListFromStrings({"fulltext-0", "foo", "fulltext-0", "bar"})));
+  EXPECT_THAT(index.GetTokenizer("C1"), Optional(std::string("fulltext")));
+
+  ZETASQL_ASSERT_OK(index.AddTokenList(
+      "C1", MakeKey(3), TokenListFromStrings({"exact_match-0", "foo"})));
+  EXPECT_EQ(index.GetTokenizer("C1"), std::nullopt);
+  EXPECT_THAT(index.GetTokenizerSignatures("C1"),
+              ElementsAre("exact_match-0", "fulltext-0"));
+}
+
+}  // namespace
+}  // namespace backend
+}  // namespace emulator
+}  // namespace spanner
+}  // namespace google
@@ -0,0 +1,165 @@
+//
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "backend/common/parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <thread>  // NOLINT(build/c++11)
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/blocking_counter.h"
+#include "absl/synchronization/mutex.h"
+#include "third_party/spanner_pg/interface/pg_arena.h"
+#include "third_party/spanner_pg/shims/memory_context_pg_arena.h"
+
+namespace google {
+namespace spanner {
+namespace emulator {
+namespace backend {
+
+namespace {
+
+// Upper bound on the number of worker threads used by DefaultParallelism. The
+// emulator is typically run next to the application under test, so we avoid
+// taking over every core of the machine.
+constexpr int kMaxDefaultParallelism = 8;
+
+// True on the threads of the WorkerPool.
+thread_local bool is_worker_thread = false;
+
+// A fixed set of threads which run the worker loops of ParallelFor calls. The
+// threads are started on first use and live until the process exits.
+class WorkerPool {
+ public:
+  static WorkerPool& Get() {
+    static WorkerPool* const pool = new WorkerPool(DefaultParallelism());
+    return *pool;
+  }
+
+  int num_threads() const { return num_threads_; }
+
+  // Runs `task` on a thread of the pool.
+  void Schedule(std::function<void()> task) ABSL_LOCKS_EXCLUDED(mu_) {
+    absl::MutexLock lock(&mu_);
+    tasks_.push_back(std::move(task));
+  }
+
+ private:
+  explicit WorkerPool(int num_threads) : num_threads_(num_threads) {
+    for (int i = 0; i < num_threads_; ++i) {
+      std::thread(&WorkerPool::Run, this).detach();
+    }
+  }
+
+  void Run() ABSL_LOCKS_EXCLUDED(mu_) {
+    is_worker_thread = true;
+    while (true) {
+      std::function<void()> task;
+      {
+        absl::MutexLock lock(&mu_);
+        mu_.Await(absl::Condition(
+            +[](std::deque<std::function<void()>>* tasks) {
+              return !tasks->empty();
+            },
+            &tasks_));
+        task = std::move(tasks_.front());
+        tasks_.pop_front();
+      }
+      task();
+    }
+  }
+
+  const int num_threads_;
+  absl::Mutex mu_;
+  std::deque<std::function<void()>> tasks_ ABSL_GUARDED_BY(mu_);
+};
+
+}  // namespace
+
+int DefaultParallelism() {
+  int num_cores = static_cast<int>(std::thread::hardware_concurrency());
+  return std::clamp(num_cores, 1, kMaxDefaultParallelism);
+}
+
+absl::Status ParallelFor(int num_tasks, int max_parallelism,
+                         const std::function<absl::Status(int)>& fn) {
+  if (num_tasks <= 0) {
+    return absl::OkStatus();
+  }
+
+  // A nested call runs on a worker thread, which already owns an arena.
+  if (is_worker_thread) {
+    for (int task = 0; task < num_tasks; ++task) {
+      absl::Status status = fn(task);
+      if (!status.ok()) {
+        return status;
+      }
+    }
+    return absl::OkStatus();
+  }
+
+  WorkerPool& pool = WorkerPool::Get();
+  int num_threads =
+      std::clamp(max_parallelism, 1, std::min(num_tasks, pool.num_threads()));
+
+  std::vector<absl::Status> statuses(num_tasks);
+  std::atomic<int> next_task = 0;
+  std::atomic<bool> failed = false;
+  absl::BlockingCounter done(num_threads);
+  auto worker = [&]() {
+    {
+      absl::StatusOr<
+          std::unique_ptr<postgres_translator::interfaces::PGArena>>
+          arena = postgres_translator::spangres::MemoryContextPGArena::Init(
+              nullptr);
+      while (!failed.load(std::memory_order_relaxed)) {
+        int task = next_task.fetch_add(1);
+        if (task >= num_tasks) {
+          break;
+        }
+        statuses[task] = arena.ok() ? fn(task) : arena.status();
+        if (!statuses[task].ok()) {
+          failed.store(true, std::memory_order_relaxed);
+        }
+      }
+    }
+    done.DecrementCount();
+  };
+  for (int i = 0; i < num_threads; ++i) {
+    pool.Schedule(worker);
+  }
+  done.Wait();
+
+  for (const absl::Status& status : statuses) {
+    if (!status.ok()) {
+      return status;
+    }
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace backend
+}  // namespace emulator
+}  // namespace spanner
+}  // namespace google
@@ -0,0 +1,56 @@
+//
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_COMMON_PARALLEL_H_
+#define THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_COMMON_PARALLEL_H_
+
+#include <functional>
+
+#include "absl/status/status.h"
+
+namespace google {
+namespace spanner {
+namespace emulator {
+namespace backend {
+
+// Returns the number of worker threads to use for CPU-bound work such as
+// schema backfills and verifications.
+int DefaultParallelism();
+
+// Runs fn(i) for each i in [0, num_tasks) on up to `max_parallelism` threads of
+// a process-wide worker pool and blocks until all of them are done. The pool
+// has DefaultParallelism() threads, which are started on first use and reused
+// by every call.
+//
+// Tasks are claimed in increasing order. Once a task fails no further tasks
+// are started, and the status of the lowest-numbered failing task is returned,
+// so callers observe the same error as a sequential loop over the tasks would.
+//
+// Each call sets up a PostgreSQL memory arena on every worker thread it uses,
+// so tasks may compare or evaluate PG extended type values. Tasks do not run on
+// the calling thread, which may already own an arena, except when ParallelFor
+// is called from a task of another ParallelFor: such nested calls run their
+// tasks sequentially on the calling worker thread, so that they cannot wait on
+// workers that are busy running their callers.
+absl::Status ParallelFor(int num_tasks, int max_parallelism,
+                         const std::function<absl::Status(int)>& fn);
+
+}  // namespace backend
+}  // namespace emulator
+}  // namespace spanner
+}  // namespace google
+
+#endif  // THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_COMMON_PARALLEL_H_
@@ -0,0 +1,98 @@
+//
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "backend/common/parallel.h"
+
+#include <atomic>
+#include <set>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "zetasql/base/testing/status_matchers.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
+
+namespace google {
+namespace spanner {
+namespace emulator {
+namespace backend {
+namespace {
+
+using zetasql_base::testing::StatusIs;
+
+TEST(ParallelForTest, RunsEveryTaskOnce) {
+  std::vector<std::atomic<int>> runs(100);
+  ZETASQL_EXPECT_OK(ParallelFor(runs.size(), /*max_parallelism=*/4, [&](int i) {
+    runs[i].fetch_add(1);
+    return absl::OkStatus();
+  }));
+  for (const auto& run : runs) {
+    EXPECT_EQ(run.load(), 1);
+  }
+}
+
+TEST(ParallelForTest, NoTasks) {
+  ZETASQL_EXPECT_OK(ParallelFor(0, /*max_parallelism=*/4,
+                        [](int i) { return absl::InternalError("unused"); }));
+}
+
+TEST(ParallelForTest, ReturnsErrorOfLowestFailingTask) {
+  EXPECT_THAT(ParallelFor(100, /*max_parallelism=*/4,
+                          [](int i) {
+                            if (i % 10 == 7) {
+                              return absl::InvalidArgumentError(
+                                  absl::StrCat("task ", i));
+                            }
+                            return absl::OkStatus();
+                          }),
+              StatusIs(absl::StatusCode::kInvalidArgument, "task 7"));
+}
+
+TEST(ParallelForTest, ReusesWorkerThreads) {
+  absl::Mutex mu;
+  std::set<std::thread::id> thread_ids;
+  for (int call = 0; call < 10; ++call) {
+    ZETASQL_EXPECT_OK(ParallelFor(100, DefaultParallelism(), [&](int i) {
+      absl::MutexLock lock(&mu);
+      thread_ids.insert(std::this_thread::get_id());
+      return absl::OkStatus();
+    }));
+  }
+  EXPECT_LE(thread_ids.size(), DefaultParallelism());
+  EXPECT_EQ(thread_ids.count(std::this_thread::get_id()), 0);
+}
+
+TEST(ParallelForTest, RunsNestedCalls) {
+  std::vector<std::atomic<int>> runs(100);
+  ZETASQL_EXPECT_OK(ParallelFor(10, DefaultParallelism(), [&](int i) {
+    return ParallelFor(10, DefaultParallelism(), [&](int j) {
+      runs[10 * i + j].fetch_add(1);
+      return absl::OkStatus();
+    });
+  }));
+  for (const auto& run : runs) {
+    EXPECT_EQ(run.load(), 1);
+  }
+}
+
+}  // namespace
+}  // namespace backend
+}  // namespace emulator
+}  // namespace spanner
+}  // namespace google
@@ -0,0 +1,326 @@
+//
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "backend/common/vector_distance.h"
+
+#include <cstddef>
+
+#include "absl/types/span.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define EMULATOR_VECTOR_DISTANCE_X86 1
+#include <immintrin.h>
+#endif
+
+namespace google {
+namespace spanner {
+namespace emulator {
+namespace backend {
+
+namespace {
+
+template <typename T>
+double ScalarDotProduct(const T* a, const T* b, size_t size) {
+  double result = 0;
+  for (size_t i = 0; i < size; ++i) {
+    result += static_cast<double>(a[i]) * static_cast<double>(b[i]);
+  }
+  return result;
+}
+
+template <typename T>
+double ScalarSquaredEuclideanDistance(const T* a, const T* b, size_t size) {
+  double result = 0;
+  for (size_t i = 0; i < size; ++i) {
+    double difference = static_cast<double>(a[i]) - static_cast<double>(b[i]);
+    result += difference * difference;
+  }
+  return result;
+}
+
+template <typename T>
+CosineTerms ScalarCosineTerms(const T* a, const T* b, size_t size) {
+  CosineTerms result;
+  for (size_t i = 0; i < size; ++i) {
+    double x = a[i];
+    double y = b[i];
+    result.dot_product += x * y;
+    result.squared_norm_a += x * x;
+    result.squared_norm_b += y * y;
+  }
+  return result;
+}
+
+constexpr VectorKernels kScalarKernels = {
+    &ScalarDotProduct<float>,
+    &ScalarDotProduct<double>,
+    &ScalarSquaredEuclideanDistance<float>,
+    &ScalarSquaredEuclideanDistance<double>,
+    &ScalarCosineTerms<float>,
+    &ScalarCosineTerms<double>,
+};
+
+#ifdef EMULATOR_VECTOR_DISTANCE_X86
+
+// AVX2 kernels, processing 4 doubles per instruction and two independent
+// accumulators per sum.
+
+#define EMULATOR_AVX2 __attribute__((target("avx2,fma")))
+
+EMULATOR_AVX2 inline __m256d Load4(const double* p) {
+  return _mm256_loadu_pd(p);
+}
+
+EMULATOR_AVX2 inline __m256d Load4(const float* p) {
+  return _mm256_cvtps_pd(_mm_loadu_ps(p));
+}
+
+EMULATOR_AVX2 inline double Sum4(__m256d v) {
+  __m128d sum = _mm_add_pd(_mm256_castpd256_pd128(v),
+                           _mm256_extractf128_pd(v, 1));
+  return _mm_cvtsd_f64(_mm_add_sd(sum, _mm_unpackhi_pd(sum, sum)));
+}
+
+template <typename T>
+EMULATOR_AVX2 double Avx2DotProduct(const T* a, const T* b, size_t size) {
+  __m256d sum0 = _mm256_setzero_pd();
+  __m256d sum1 = _mm256_setzero_pd();
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    sum0 = _mm256_fmadd_pd(Load4(a + i), Load4(b + i), sum0);
+    sum1 = _mm256_fmadd_pd(Load4(a + i + 4), Load4(b + i + 4), sum1);
+  }
+  if (i + 4 <= size) {
+    sum0 = _mm256_fmadd_pd(Load4(a + i), Load4(b + i), sum0);
+    i += 4;
+  }
+  double result = Sum4(_mm256_add_pd(sum0, sum1));
+  return result + ScalarDotProduct(a + i, b + i, size - i);
+}
+
+template <typename T>
+EMULATOR_AVX2 double Avx2SquaredEuclideanDistance(const T* a, const T* b,
+                                                  size_t size) {
+  __m256d sum0 = _mm256_setzero_pd();
+  __m256d sum1 = _mm256_setzero_pd();
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    __m256d difference0 = _mm256_sub_pd(Load4(a + i), Load4(b + i));
+    __m256d difference1 = _mm256_sub_pd(Load4(a + i + 4), Load4(b + i + 4));
+    sum0 = _mm256_fmadd_pd(difference0, difference0, sum0);
+    sum1 = _mm256_fmadd_pd(difference1, difference1, sum1);
+  }
+  if (i + 4 <= size) {
+    __m256d difference = _mm256_sub_pd(Load4(a + i), Load4(b + i));
+    sum0 = _mm256_fmadd_pd(difference, difference, sum0);
+    i += 4;
+  }
+  double result = Sum4(_mm256_add_pd(sum0, sum1));
+  return result + ScalarSquaredEuclideanDistance(a + i, b + i, size - i);
+}
+
+template <typename T>
+EMULATOR_AVX2 CosineTerms Avx2CosineTerms(const T* a, const T* b,
+                                          size_t size) {
+  __m256d dot_product = _mm256_setzero_pd();
+  __m256d squared_norm_a = _mm256_setzero_pd();
+  __m256d squared_norm_b = _mm256_setzero_pd();
+  size_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    __m256d x = Load4(a + i);
+    __m256d y = Load4(b + i);
+    dot_product = _mm256_fmadd_pd(x, y, dot_product);
+    squared_norm_a = _mm256_fmadd_pd(x, x, squared_norm_a);
+    squared_norm_b = _mm256_fmadd_pd(y, y, squared_norm_b);
+  }
+  CosineTerms result = ScalarCosineTerms(a + i, b + i, size - i);
+  result.dot_product += Sum4(dot_product);
+  result.squared_norm_a += Sum4(squared_norm_a);
+  result.squared_norm_b += Sum4(squared_norm_b);
+  return result;
+}
+
+constexpr VectorKernels kAvx2Kernels = {
+    &Avx2DotProduct<float>,
+    &Avx2DotProduct<double>,
+    &Avx2SquaredEuclideanDistance<float>,
+    &Avx2SquaredEuclideanDistance<double>,
+    &Avx2CosineTerms<float>,
+    &Avx2CosineTerms<double>,
+};
+
+// AVX-512 kernels, processing 8 doubles per instruction.
+
+#define EMULATOR_AVX512 __attribute__((target("avx512f")))
+
+EMULATOR_AVX512 inline __m512d Load8(const double* p) {
+  return _mm512_loadu_pd(p);
+}
+
+EMULATOR_AVX512 inline __m512d Load8(const float* p) {
+  return _mm512_maskz_cvtps_pd(0xff, _mm256_loadu_ps(p));
+}
+
+EMULATOR_AVX512 inline double Sum8(__m512d v) {
+  double lanes[8];
+  _mm512_storeu_pd(lanes, v);
+  return ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) +
+         ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+}
+
+template <typename T>
+EMULATOR_AVX512 double Avx512DotProduct(const T* a, const T* b, size_t size) {
+  __m512d sum0 = _mm512_setzero_pd();
+  __m512d sum1 = _mm512_setzero_pd();
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    sum0 = _mm512_fmadd_pd(Load8(a + i), Load8(b + i), sum0);
+    sum1 = _mm512_fmadd_pd(Load8(a + i + 8), Load8(b + i + 8), sum1);
+  }
+  if (i + 8 <= size) {
+    sum0 = _mm512_fmadd_pd(Load8(a + i), Load8(b + i), sum0);
+    i += 8;
+  }
+  double result = Sum8(_mm512_add_pd(sum0, sum1));
+  return result + ScalarDotProduct(a + i, b + i, size - i);
+}
+
+template <typename T>
+EMULATOR_AVX512 double Avx512SquaredEuclideanDistance(const T* a, const T* b,
+                                                      size_t size) {
+  __m512d sum0 = _mm512_setzero_pd();
+  __m512d sum1 = _mm512_setzero_pd();
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    __m512d difference0 = _mm512_sub_pd(Load8(a + i), Load8(b + i));
+    __m512d difference1 = _mm512_sub_pd(Load8(a + i + 8), Load8(b + i + 8));
+    sum0 = _mm512_fmadd_pd(difference0, difference0, sum0);
+    sum1 = _mm512_fmadd_pd(difference1, difference1, sum1);
+  }
+  if (i + 8 <= size) {
+    __m512d difference = _mm512_sub_pd(Load8(a + i), Load8(b + i));
+    sum0 = _mm512_fmadd_pd(difference, difference, sum0);
+    i += 8;
+  }
+  double result = Sum8(_mm512_add_pd(sum0, sum1));
+  return result + ScalarSquaredEuclideanDistance(a + i, b + i, size - i);
+}
+
+template <typename T>
+EMULATOR_AVX512 CosineTerms Avx512CosineTerms(const T* a, const T* b,
+                                              size_t size) {
+  __m512d dot_product = _mm512_setzero_pd();
+  __m512d squared_norm_a = _mm512_setzero_pd();
+  __m512d squared_norm_b = _mm512_setzero_pd();
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    __m512d x = Load8(a + i);
+    __m512d y = Load8(b + i);
+    dot_product = _mm512_fmadd_pd(x, y, dot_product);
+    squared_norm_a = _mm512_fmadd_pd(x, x, squared_norm_a);
+    squared_norm_b = _mm512_fmadd_pd(y, y, squared_norm_b);
+  }
+  CosineTerms result = ScalarCosineTerms(a + i, b + i, size - i);
+  result.dot_product += Sum8(dot_product);
+  result.squared_norm_a += Sum8(squared_norm_a);
+  result.squared_norm_b += Sum8(squared_norm_b);
+  return result;
+}
+
+constexpr VectorKernels kAvx512Kernels = {
+    &Avx512DotProduct<float>,
+    &Avx512DotProduct<double>,
+    &Avx512SquaredEuclideanDistance<float>,
+    &Avx512SquaredEuclideanDistance<double>,
+    &Avx512CosineTerms<float>,
+    &Avx512CosineTerms<double>,
+};
+
+#undef EMULATOR_AVX2
+#undef EMULATOR_AVX512
+
+#endif  // EMULATOR_VECTOR_DISTANCE_X86
+
+}  // namespace
+
+const VectorKernels* GetVectorKernels(SimdLevel level) {
+  switch (level) {
+    case SimdLevel::kScalar:
+      return &kScalarKernels;
+    case SimdLevel::kAvx2:
+#ifdef EMULATOR_VECTOR_DISTANCE_X86
+      if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return &kAvx2Kernels;
+      }
+#endif
+      return nullptr;
+    case SimdLevel::kAvx512:
+#ifdef EMULATOR_VECTOR_DISTANCE_X86
+      if (__builtin_cpu_supports("avx512f")) {
+        return &kAvx512Kernels;
+      }
+#endif
+      return nullptr;
+  }
+  return nullptr;
+}
+
+const VectorKernels& GetVectorKernels() {
+  static const VectorKernels* const kernels = [] {
+    for (SimdLevel level : {SimdLevel::kAvx512, SimdLevel::kAvx2}) {
+      if (const VectorKernels* kernels = GetVectorKernels(level)) {
+        return kernels;
+      }
+    }
+    return &kScalarKernels;
+  }();
+  return *kernels;
+}
+
+double DotProduct(absl::Span<const float> a, absl::Span<const float> b) {
+  return GetVectorKernels().dot_product_float(a.data(), b.data(), a.size());
+}
+
+double DotProduct(absl::Span<const double> a, absl::Span<const double> b) {
+  return GetVectorKernels().dot_product_double(a.data(), b.data(), a.size());
+}
+
+double SquaredEuclideanDistance(absl::Span<const float> a,
+                                absl::Span<const float> b) {
+  return GetVectorKernels().squared_euclidean_distance_float(
+      a.data(), b.data(), a.size());
+}
+
+double SquaredEuclideanDistance(absl::Span<const double> a,
+                                absl::Span<const double> b) {
+  return GetVectorKernels().squared_euclidean_distance_double(
+      a.data(), b.data(), a.size());
+}
+
+CosineTerms ComputeCosineTerms(absl::Span<const float> a,
+                               absl::Span<const float> b) {
+  return GetVectorKernels().cosine_terms_float(a.data(), b.data(), a.size());
+}
+
+CosineTerms ComputeCosineTerms(absl::Span<const double> a,
+                               absl::Span<const double> b) {
+  return GetVectorKernels().cosine_terms_double(a.data(), b.data(), a.size());
+}
+
+}  // namespace backend
+}  // namespace emulator
+}  // namespace spanner
+}  // namespace google
@@ -0,0 +1,93 @@
+//
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_COMMON_VECTOR_DISTANCE_H_
+#define THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_COMMON_VECTOR_DISTANCE_H_
+
+#include <cstddef>
+
+#include "absl/types/span.h"
+
+namespace google {
+namespace spanner {
+namespace emulator {
+namespace backend {
+
+// Kernels computing the distances between dense vectors stored contiguously.
+// The kernels use the widest SIMD instruction set supported by the CPU
+// (AVX-512 or AVX2 with FMA on x86-64), and fall back to scalar code
+// elsewhere. Elements of FLOAT vectors are widened to double before being
+// accumulated, and all kernels accumulate in double precision. Since SIMD
+// kernels sum the products in a different order, their results may differ
+// from the scalar ones in the last bits.
+
+// The instruction sets the kernels are implemented with.
+enum class SimdLevel { kScalar, kAvx2, kAvx512 };
+
+// The sums of products needed to compute the cosine distance of two vectors.
+struct CosineTerms {
+  double dot_product = 0;
+  double squared_norm_a = 0;
+  double squared_norm_b = 0;
+};
+
+// The kernels implemented with an instruction set. All kernels take two
+// vectors of `size` elements.
+struct VectorKernels {
+  double (*dot_product_float)(const float* a, const float* b, size_t size);
+  double (*dot_product_double)(const double* a, const double* b, size_t size);
+  double (*squared_euclidean_distance_float)(const float* a, const float* b,
+                                             size_t size);
+  double (*squared_euclidean_distance_double)(const double* a,
+                                              const double* b, size_t size);
+  CosineTerms (*cosine_terms_float)(const float* a, const float* b,
+                                    size_t size);
+  CosineTerms (*cosine_terms_double)(const double* a, const double* b,
+                                     size_t size);
+};
+
+// Returns the kernels implemented with `level`, or nullptr if the CPU does not
+// support it.
+const VectorKernels* GetVectorKernels(SimdLevel level);
+
+// Returns the kernels implemented with the widest instruction set the CPU
+// supports.
+const VectorKernels& GetVectorKernels();
+
+// Returns the dot product of `a` and `b`, which must have the same size.
+double DotProduct(absl::Span<const float> a, absl::Span<const float> b);
+double DotProduct(absl::Span<const double> a, absl::Span<const double> b);
+
+// Returns the squared euclidean distance between `a` and `b`, which must have
+// the same size.
+double SquaredEuclideanDistance(absl::Span<const float> a,
+                                absl::Span<const float> b);
+double SquaredEuclideanDistance(absl::Span<const double> a,
+                                absl::Span<const double> b);
+
+// Returns the terms of the cosine distance between `a` and `b`, which must
+// have the same size.
+CosineTerms ComputeCosineTerms(absl::Span<const float> a,
+                               absl::Span<const float> b);
+CosineTerms ComputeCosineTerms(absl::Span<const double> a,
+                               absl::Span<const double> b);
+
+}  // namespace backend
+}  // namespace emulator
+}  // namespace spanner
+}  // namespace google
+
+#endif  // THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_COMMON_VECTOR_DISTANCE_H_
@@ -0,0 +1,117 @@
+//
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "backend/common/vector_distance.h"
+
+#include <cstddef>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace google {
+namespace spanner {
+namespace emulator {
+namespace backend {
+namespace {
+
+using ::testing::DoubleNear;
+using ::testing::NotNull;
+
+// Sizes covering the unrolled loops and the remainders of every kernel.
+constexpr size_t kSizes[] = {0, 1, 3, 4, 7, 8, 15, 16, 17, 33, 768, 1537};
+
+class VectorKernelsTest : public testing::TestWithParam<SimdLevel> {
+ protected:
+  // Returns vectors of `size` elements with varied signs and magnitudes.
+  static std::vector<double> MakeVector(size_t size, int seed) {
+    std::vector<double> vector(size);
+    for (size_t i = 0; i < size; ++i) {
+      vector[i] = static_cast<double>((i * 7 + seed * 13) % 19) / 4 - 2;
+    }
+    return vector;
+  }
+};
+
+TEST_P(VectorKernelsTest, MatchesScalarKernels) {
+  const VectorKernels* kernels = GetVectorKernels(GetParam());
+  if (kernels == nullptr) {
+    GTEST_SKIP() << "Instruction set not supported by the CPU.";
+  }
+  const VectorKernels* scalar = GetVectorKernels(SimdLevel::kScalar);
+  ASSERT_THAT(scalar, NotNull());
+
+  for (size_t size : kSizes) {
+    SCOPED_TRACE(size);
+    std::vector<double> a = MakeVector(size, 1);
+    std::vector<double> b = MakeVector(size, 2);
+    std::vector<float> float_a(a.begin(), a.end());
+    std::vector<float> float_b(b.begin(), b.end());
+
+    EXPECT_THAT(kernels->dot_product_double(a.data(), b.data(), size),
+                DoubleNear(scalar->dot_product_double(a.data(), b.data(), size),
+                           1e-9));
+    EXPECT_THAT(
+        kernels->dot_product_float(float_a.data(), float_b.data(), size),
+        DoubleNear(
+            scalar->dot_product_float(float_a.data(), float_b.data(), size),
+            1e-9));
+    EXPECT_THAT(
+        kernels->squared_euclidean_distance_double(a.data(), b.data(), size),
+        DoubleNear(scalar->squared_euclidean_distance_double(a.data(),
+                                                             b.data(), size),
+                   1e-9));
+    EXPECT_THAT(
+        kernels->squared_euclidean_distance_float(float_a.data(),
+                                                  float_b.data(), size),
+        DoubleNear(scalar->squared_euclidean_distance_float(
+                       float_a.data(), float_b.data(), size),
+                   1e-9));
+
+    CosineTerms terms = kernels->cosine_terms_float(float_a.data(),
+                                                    float_b.data(), size);
+    CosineTerms expected_terms =
+        scalar->cosine_terms_double(a.data(), b.data(), size);
+    EXPECT_THAT(terms.dot_product,
+                DoubleNear(expected_terms.dot_product, 1e-9));
+    EXPECT_THAT(terms.squared_norm_a,
+                DoubleNear(expected_terms.squared_norm_a, 1e-9));
+    EXPECT_THAT(terms.squared_norm_b,
+                DoubleNear(expected_terms.squared_norm_b, 1e-9));
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(SimdLevels, VectorKernelsTest,
+                         testing::Values(SimdLevel::kScalar, SimdLevel::kAvx2,
+                                         SimdLevel::kAvx512));
+
+TEST(VectorDistanceTest, ComputesDistances) {
+  std::vector<double> a = {1, 2, 3};
+  std::vector<double> b = {4, -5, 6};
+
+  EXPECT_DOUBLE_EQ(DotProduct(a, b), 12);
+  EXPECT_DOUBLE_EQ(SquaredEuclideanDistance(a, b), 67);
+  CosineTerms terms = ComputeCosineTerms(a, b);
+  EXPECT_DOUBLE_EQ(terms.dot_product, 12);
+  EXPECT_DOUBLE_EQ(terms.squared_norm_a, 14);
+  EXPECT_DOUBLE_EQ(terms.squared_norm_b, 77);
+}
+
+}  // namespace
+}  // namespace backend
+}  // namespace emulator
+}  // namespace spanner
+}  // namespace google
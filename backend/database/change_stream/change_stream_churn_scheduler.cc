@@ -0,0 +1,192 @@
+//
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "backend/database/change_stream/change_stream_churn_scheduler.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+
+namespace google {
+namespace spanner {
+namespace emulator {
+namespace backend {
+
+namespace {
+
+// Granularity of the shared scheduler. Churning and purge intervals are in the
+// order of seconds, so this is well below the precision they need.
+constexpr absl::Duration kDefaultTick = absl::Milliseconds(10);
+
+// One revolution of the shared wheel covers a little over 5 seconds.
+constexpr int kDefaultNumSlots = 512;
+
+}  // namespace
+
+ChangeStreamChurnScheduler* ChangeStreamChurnScheduler::Default() {
+  static ChangeStreamChurnScheduler* scheduler =
+      new ChangeStreamChurnScheduler(kDefaultTick, kDefaultNumSlots);
+  return scheduler;
+}
+
+ChangeStreamChurnScheduler::ChangeStreamChurnScheduler(absl::Duration tick,
+                                                       int num_slots)
+    : tick_(tick), slots_(num_slots) {}
+
+ChangeStreamChurnScheduler::~ChangeStreamChurnScheduler() {
+  std::thread thread;
+  {
+    absl::MutexLock l(&mu_);
+    stop_ = true;
+    thread = std::move(thread_);
+  }
+  if (thread.joinable()) {
+    thread.join();
+  }
+}
+
+ChangeStreamChurnScheduler::TaskId ChangeStreamChurnScheduler::Schedule(
+    Task task, absl::Duration delay) {
+  absl::MutexLock l(&mu_);
+  if (tasks_.empty()) {
+    // The wheel does not advance while it is empty.
+    next_tick_time_ = absl::Now() + tick_;
+  }
+  const TaskId id = next_task_id_++;
+  tasks_.emplace(id, std::move(task));
+  InsertLocked(id, delay);
+  rescheduled_ = true;
+  if (!thread_.joinable()) {
+    thread_ = std::thread(&ChangeStreamChurnScheduler::Run, this);
+  }
+  return id;
+}
+
+void ChangeStreamChurnScheduler::Cancel(TaskId id) {
+  absl::MutexLock l(&mu_);
+  tasks_.erase(id);
+  auto not_running = [this, id]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    return running_task_ != id;
+  };
+  mu_.Await(absl::Condition(&not_running));
+}
+
+int ChangeStreamChurnScheduler::NumTasks() {
+  absl::MutexLock l(&mu_);
+  return tasks_.size();
+}
+
+void ChangeStreamChurnScheduler::InsertLocked(TaskId id,
+                                              absl::Duration delay) {
+  const int64_t num_slots = slots_.size();
+  // The current slot was reached at `next_tick_time_ - tick_`, which may be
+  // well before now if the wheel has not caught up yet.
+  const absl::Duration from_current_slot =
+      absl::Now() + delay - (next_tick_time_ - tick_);
+  const int64_t ticks = std::max<int64_t>(
+      1, absl::ToInt64Nanoseconds(from_current_slot + tick_ -
+                                  absl::Nanoseconds(1)) /
+             absl::ToInt64Nanoseconds(tick_));
+  slots_[(current_slot_ + ticks) % num_slots].push_back(
+      WheelEntry{.id = id, .rounds = (ticks - 1) / num_slots});
+}
+
+absl::Time ChangeStreamChurnScheduler::NextBusyTickTimeLocked() const {
+  const int num_slots = slots_.size();
+  for (int ticks = 1; ticks <= num_slots; ++ticks) {
+    if (!slots_[(current_slot_ + ticks) % num_slots].empty()) {
+      return next_tick_time_ + (ticks - 1) * tick_;
+    }
+  }
+  return absl::InfiniteFuture();
+}
+
+void ChangeStreamChurnScheduler::AdvanceLocked(std::vector<TaskId>* due) {
+  current_slot_ = (current_slot_ + 1) % slots_.size();
+  std::vector<WheelEntry>& slot = slots_[current_slot_];
+  auto it = std::remove_if(slot.begin(), slot.end(), [&](WheelEntry& entry) {
+    if (!tasks_.contains(entry.id)) {
+      return true;
+    }
+    if (entry.rounds > 0) {
+      --entry.rounds;
+      return false;
+    }
+    due->push_back(entry.id);
+    return true;
+  });
+  slot.erase(it, slot.end());
+}
+
+void ChangeStreamChurnScheduler::Run() {
+  absl::MutexLock l(&mu_);
+  auto has_tasks_or_stopped = [this]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    return stop_ || !tasks_.empty();
+  };
+  auto rescheduled_or_stopped = [this]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    return stop_ || rescheduled_;
+  };
+  while (true) {
+    mu_.Await(absl::Condition(&has_tasks_or_stopped));
+    // Sleep through the empty slots, unless a task due earlier is scheduled.
+    rescheduled_ = false;
+    mu_.AwaitWithDeadline(absl::Condition(&rescheduled_or_stopped),
+                          NextBusyTickTimeLocked());
+    if (stop_) {
+      return;
+    }
+
+    // Catch up with the ticks that elapsed while waiting or running tasks.
+    std::vector<TaskId> due;
+    const absl::Time now = absl::Now();
+    while (next_tick_time_ <= now) {
+      AdvanceLocked(&due);
+      next_tick_time_ += tick_;
+    }
+
+    for (TaskId id : due) {
+      auto it = tasks_.find(id);
+      if (it == tasks_.end()) {
+        continue;
+      }
+      Task task = it->second;
+      running_task_ = id;
+      mu_.Unlock();
+      const absl::Duration delay = task();
+      mu_.Lock();
+      running_task_ = 0;
+      if (stop_) {
+        return;
+      }
+      if (delay == absl::InfiniteDuration()) {
+        tasks_.erase(id);
+      } else if (tasks_.contains(id)) {
+        InsertLocked(id, delay);
+      }
+    }
+  }
+}
+
+}  // namespace backend
+}  // namespace emulator
+}  // namespace spanner
+}  // namespace google
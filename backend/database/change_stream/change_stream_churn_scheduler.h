@@ -0,0 +1,138 @@
+//
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_DATABASE_CHANGE_STREAM_CHANGE_STREAM_CHURN_SCHEDULER_H_
+#define THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_DATABASE_CHANGE_STREAM_CHANGE_STREAM_CHURN_SCHEDULER_H_
+
+#include <cstdint>
+#include <functional>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+
+namespace google {
+namespace spanner {
+namespace emulator {
+namespace backend {
+
+// ChangeStreamChurnScheduler runs the periodic change stream maintenance
+// (partition churning and retention purges) of all databases, and the deadline
+// timers of the change stream queries waiting for commits, on a single
+// background thread.
+//
+// Tasks are kept in a hashed timer wheel: each slot covers one tick, and a
+// task whose delay exceeds a full revolution of the wheel stays in its slot
+// for the corresponding number of rounds. Scheduling and cancelling a task are
+// O(1). The scheduler thread sleeps until the next slot holding tasks, so idle
+// ticks cost nothing but the slots skipped when it wakes up.
+//
+// A task returns the delay until it should run again, so that it can back off
+// or retry without blocking the scheduler thread, or absl::InfiniteDuration()
+// to run only once. Tasks run one at a time and should not block for long.
+//
+// This class is thread-safe.
+class ChangeStreamChurnScheduler {
+ public:
+  using TaskId = int64_t;
+
+  // Runs a periodic task and returns the delay until its next run.
+  using Task = std::function<absl::Duration()>;
+
+  // Returns the scheduler shared by all databases in the process.
+  static ChangeStreamChurnScheduler* Default();
+
+  ChangeStreamChurnScheduler(absl::Duration tick, int num_slots);
+
+  // Stops the scheduler thread. Pending tasks are dropped.
+  ~ChangeStreamChurnScheduler();
+
+  // Schedules `task` to run after `delay`, and then repeatedly after the delay
+  // it returns until cancelled or it returns absl::InfiniteDuration(). Delays
+  // are rounded up to a whole tick.
+  TaskId Schedule(Task task, absl::Duration delay) ABSL_LOCKS_EXCLUDED(mu_);
+
+  // Cancels the task and waits for a running invocation of it to finish. Must
+  // not be called from within the task itself.
+  void Cancel(TaskId id) ABSL_LOCKS_EXCLUDED(mu_);
+
+  // Returns the number of scheduled tasks.
+  int NumTasks() ABSL_LOCKS_EXCLUDED(mu_);
+
+ private:
+  struct WheelEntry {
+    TaskId id;
+
+    // Number of full revolutions of the wheel left before the task is due.
+    int64_t rounds;
+  };
+
+  // Places the task in the slot covering `delay` from now. The slot is
+  // computed from the deadline rather than from the current slot, which lags
+  // behind while the scheduler thread sleeps or runs tasks.
+  void InsertLocked(TaskId id, absl::Duration delay)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Returns the time at which the wheel reaches the next slot holding tasks,
+  // or absl::InfiniteFuture() if all slots are empty.
+  absl::Time NextBusyTickTimeLocked() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Advances the wheel by one tick and appends the tasks that became due.
+  void AdvanceLocked(std::vector<TaskId>* due)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Body of the scheduler thread.
+  void Run() ABSL_LOCKS_EXCLUDED(mu_);
+
+  const absl::Duration tick_;
+
+  absl::Mutex mu_;
+
+  std::vector<std::vector<WheelEntry>> slots_ ABSL_GUARDED_BY(mu_);
+
+  // Index of the slot that was visited last.
+  int current_slot_ ABSL_GUARDED_BY(mu_) = 0;
+
+  // Time at which the wheel advances to the next slot.
+  absl::Time next_tick_time_ ABSL_GUARDED_BY(mu_);
+
+  // Scheduled tasks. Wheel entries of cancelled tasks are skipped lazily.
+  absl::flat_hash_map<TaskId, Task> tasks_ ABSL_GUARDED_BY(mu_);
+
+  TaskId next_task_id_ ABSL_GUARDED_BY(mu_) = 1;
+
+  // Task that is currently running, or 0 if none.
+  TaskId running_task_ ABSL_GUARDED_BY(mu_) = 0;
+
+  bool stop_ ABSL_GUARDED_BY(mu_) = false;
+
+  // Set when a task is scheduled, to wake up the scheduler thread in case the
+  // task is due before the slot it sleeps until.
+  bool rescheduled_ ABSL_GUARDED_BY(mu_) = false;
+
+  // Started when the first task is scheduled.
+  std::thread thread_ ABSL_GUARDED_BY(mu_);
+};
+
+}  // namespace backend
+}  // namespace emulator
+}  // namespace spanner
+}  // namespace google
+
+#endif  // THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_DATABASE_CHANGE_STREAM_CHANGE_STREAM_CHURN_SCHEDULER_H_
@@ -0,0 +1,140 @@
+//
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "backend/database/change_stream/change_stream_churn_scheduler.h"
+
+#include <atomic>
+
+#include "gtest/gtest.h"
+#include "absl/synchronization/notification.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+
+namespace google {
+namespace spanner {
+namespace emulator {
+namespace backend {
+namespace {
+
+constexpr absl::Duration kTick = absl::Milliseconds(1);
+
+TEST(ChangeStreamChurnSchedulerTest, RunsTaskAfterDelay) {
+  ChangeStreamChurnScheduler scheduler(kTick, /*num_slots=*/8);
+  absl::Notification ran;
+  const absl::Time start = absl::Now();
+  scheduler.Schedule(
+      [&ran]() {
+        if (!ran.HasBeenNotified()) {
+          ran.Notify();
+        }
+        return absl::InfiniteDuration();
+      },
+      // Longer than a revolution of the wheel.
+      absl::Milliseconds(20));
+  ASSERT_TRUE(ran.WaitForNotificationWithTimeout(absl::Seconds(10)));
+  EXPECT_GE(absl::Now() - start, absl::Milliseconds(20));
+}
+
+TEST(ChangeStreamChurnSchedulerTest, ReschedulesTaskWithReturnedDelay) {
+  ChangeStreamChurnScheduler scheduler(kTick, /*num_slots=*/8);
+  std::atomic<int> num_runs = 0;
+  absl::Notification ran_three_times;
+  scheduler.Schedule(
+      [&]() {
+        if (++num_runs == 3) {
+          ran_three_times.Notify();
+        }
+        return num_runs < 3 ? absl::Milliseconds(2) : absl::Hours(1);
+      },
+      absl::ZeroDuration());
+  ASSERT_TRUE(ran_three_times.WaitForNotificationWithTimeout(absl::Seconds(10)));
+  absl::SleepFor(absl::Milliseconds(20));
+  EXPECT_EQ(num_runs, 3);
+}
+
+TEST(ChangeStreamChurnSchedulerTest, DelaysCountFromSchedulingWhileBehind) {
+  ChangeStreamChurnScheduler scheduler(kTick, /*num_slots=*/8);
+  absl::Notification ran;
+  absl::Time scheduled_at;
+  absl::Time ran_at;
+  scheduler.Schedule(
+      [&]() {
+        // The wheel does not advance while the task runs.
+        absl::SleepFor(absl::Milliseconds(20));
+        scheduled_at = absl::Now();
+        scheduler.Schedule(
+            [&]() {
+              ran_at = absl::Now();
+              ran.Notify();
+              return absl::InfiniteDuration();
+            },
+            absl::Milliseconds(10));
+        return absl::InfiniteDuration();
+      },
+      absl::ZeroDuration());
+  ASSERT_TRUE(ran.WaitForNotificationWithTimeout(absl::Seconds(10)));
+  EXPECT_GE(ran_at - scheduled_at, absl::Milliseconds(10));
+}
+
+TEST(ChangeStreamChurnSchedulerTest, RemovesTasksReturningInfiniteDelay) {
+  ChangeStreamChurnScheduler scheduler(kTick, /*num_slots=*/8);
+  absl::Notification ran;
+  scheduler.Schedule(
+      [&ran]() {
+        ran.Notify();
+        return absl::InfiniteDuration();
+      },
+      absl::ZeroDuration());
+  ASSERT_TRUE(ran.WaitForNotificationWithTimeout(absl::Seconds(10)));
+  // The task is removed once it returns.
+  for (int i = 0; i < 1000 && scheduler.NumTasks() > 0; ++i) {
+    absl::SleepFor(kTick);
+  }
+  EXPECT_EQ(scheduler.NumTasks(), 0);
+}
+
+TEST(ChangeStreamChurnSchedulerTest, CancelledTaskDoesNotRun) {
+  ChangeStreamChurnScheduler scheduler(kTick, /*num_slots=*/8);
+  std::atomic<int> num_runs_cancelled = 0;
+  absl::Notification other_ran;
+  auto id = scheduler.Schedule(
+      [&]() {
+        ++num_runs_cancelled;
+        return absl::Milliseconds(1);
+      },
+      absl::Milliseconds(5));
+  scheduler.Schedule(
+      [&]() {
+        if (!other_ran.HasBeenNotified()) {
+          other_ran.Notify();
+        }
+        return absl::InfiniteDuration();
+      },
+      absl::Milliseconds(10));
+  EXPECT_EQ(scheduler.NumTasks(), 2);
+
+  scheduler.Cancel(id);
+  const int num_runs_at_cancel = num_runs_cancelled;
+  EXPECT_EQ(scheduler.NumTasks(), 1);
+  ASSERT_TRUE(other_ran.WaitForNotificationWithTimeout(absl::Seconds(10)));
+  EXPECT_EQ(num_runs_cancelled, num_runs_at_cancel);
+}
+
+}  // namespace
+}  // namespace backend
+}  // namespace emulator
+}  // namespace spanner
+}  // namespace google
@@ -0,0 +1,221 @@
+//
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "backend/database/change_stream/change_stream_commit_notifier.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "backend/database/change_stream/change_stream_churn_scheduler.h"
+#include "common/clock.h"
+
+namespace google {
+namespace spanner {
+namespace emulator {
+namespace backend {
+
+ChangeStreamCommitNotifier::ChangeStreamCommitNotifier(Clock* clock)
+    : clock_(clock), scheduler_(ChangeStreamChurnScheduler::Default()) {}
+
+ChangeStreamCommitNotifier::~ChangeStreamCommitNotifier() {
+  std::vector<ChangeStreamChurnScheduler::TaskId> timer_tasks;
+  {
+    absl::MutexLock lock(&mu_);
+    stop_ = true;
+    for (const auto& [generation, task_id] : timer_tasks_) {
+      timer_tasks.push_back(task_id);
+    }
+  }
+  // Cancelling waits for a running timer task, which needs mu_.
+  for (ChangeStreamChurnScheduler::TaskId task_id : timer_tasks) {
+    scheduler_->Cancel(task_id);
+  }
+}
+
+void ChangeStreamCommitNotifier::NotifyPartition(
+    absl::string_view change_stream_name, absl::string_view partition_token,
+    absl::Time commit_timestamp) {
+  std::vector<Callback> callbacks;
+  {
+    absl::MutexLock lock(&mu_);
+    ChangeStreamCommits& commits = change_streams_[change_stream_name];
+    if (commit_timestamp <= commits.last_commit) {
+      return;
+    }
+    absl::Time& last_commit = commits.partitions
+                                  .try_emplace(std::string(partition_token),
+                                               absl::InfinitePast())
+                                  .first->second;
+    last_commit = std::max(last_commit, commit_timestamp);
+    TakeCommittedWaitersLocked(change_stream_name, &callbacks);
+  }
+  for (Callback& callback : callbacks) {
+    callback(/*committed=*/true);
+  }
+}
+
+void ChangeStreamCommitNotifier::NotifyChangeStream(
+    absl::string_view change_stream_name, absl::Time commit_timestamp) {
+  std::vector<Callback> callbacks;
+  {
+    absl::MutexLock lock(&mu_);
+    ChangeStreamCommits& commits = change_streams_[change_stream_name];
+    commits.last_commit = std::max(commits.last_commit, commit_timestamp);
+    absl::erase_if(commits.partitions, [&](const auto& partition) {
+      return partition.second <= commits.last_commit;
+    });
+    TakeCommittedWaitersLocked(change_stream_name, &callbacks);
+  }
+  for (Callback& callback : callbacks) {
+    callback(/*committed=*/true);
+  }
+}
+
+absl::Time ChangeStreamCommitNotifier::LastCommit(
+    absl::string_view change_stream_name,
+    absl::string_view partition_token) const {
+  auto commits = change_streams_.find(change_stream_name);
+  if (commits == change_streams_.end()) {
+    return absl::InfinitePast();
+  }
+  auto partition = commits->second.partitions.find(partition_token);
+  if (partition == commits->second.partitions.end()) {
+    return commits->second.last_commit;
+  }
+  return std::max(commits->second.last_commit, partition->second);
+}
+
+bool ChangeStreamCommitNotifier::WaitForCommit(
+    absl::string_view change_stream_name, absl::string_view partition_token,
+    absl::Time since, absl::Time deadline) {
+  absl::MutexLock lock(&mu_);
+  auto committed = [&]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    return LastCommit(change_stream_name, partition_token) >= since;
+  };
+  mu_.AwaitWithDeadline(absl::Condition(&committed), deadline);
+  return committed();
+}
+
+void ChangeStreamCommitNotifier::NotifyOnCommit(
+    absl::string_view change_stream_name, absl::string_view partition_token,
+    absl::Time since, absl::Time deadline, Callback callback) {
+  bool committed;
+  {
+    absl::MutexLock lock(&mu_);
+    committed = LastCommit(change_stream_name, partition_token) >= since;
+    if (!committed && deadline > clock_->Now()) {
+      const WaiterId id = next_waiter_id_++;
+      waiters_.emplace(id, Waiter{std::string(change_stream_name),
+                                  std::string(partition_token), since,
+                                  deadline, std::move(callback)});
+      waiters_by_change_stream_[change_stream_name].insert(id);
+      if (deadline != absl::InfiniteFuture()) {
+        deadlines_.emplace(deadline, id);
+        ScheduleTimerLocked(deadline);
+      }
+      return;
+    }
+  }
+  callback(committed);
+}
+
+void ChangeStreamCommitNotifier::TakeCommittedWaitersLocked(
+    absl::string_view change_stream_name, std::vector<Callback>* callbacks) {
+  auto ids = waiters_by_change_stream_.find(change_stream_name);
+  if (ids == waiters_by_change_stream_.end()) {
+    return;
+  }
+  std::vector<WaiterId> committed;
+  for (WaiterId id : ids->second) {
+    const Waiter& waiter = waiters_.at(id);
+    if (LastCommit(waiter.change_stream_name, waiter.partition_token) >=
+        waiter.since) {
+      committed.push_back(id);
+    }
+  }
+  for (WaiterId id : committed) {
+    callbacks->push_back(RemoveWaiterLocked(id));
+  }
+}
+
+ChangeStreamCommitNotifier::Callback
+ChangeStreamCommitNotifier::RemoveWaiterLocked(WaiterId id) {
+  auto it = waiters_.find(id);
+  Waiter waiter = std::move(it->second);
+  waiters_.erase(it);
+  auto ids = waiters_by_change_stream_.find(waiter.change_stream_name);
+  ids->second.erase(id);
+  if (ids->second.empty()) {
+    waiters_by_change_stream_.erase(ids);
+  }
+  deadlines_.erase({waiter.deadline, id});
+  return std::move(waiter.callback);
+}
+
+void ChangeStreamCommitNotifier::ScheduleTimerLocked(absl::Time deadline) {
+  if (deadline >= timer_deadline_) {
+    return;
+  }
+  timer_deadline_ = deadline;
+  const int64_t generation = ++timer_generation_;
+  timer_tasks_[generation] = scheduler_->Schedule(
+      [this, generation]() { return RunTimer(generation); },
+      deadline - clock_->Now());
+}
+
+absl::Duration ChangeStreamCommitNotifier::RunTimer(int64_t generation) {
+  std::vector<Callback> expired;
+  absl::Duration delay;
+  {
+    absl::MutexLock lock(&mu_);
+    if (stop_) {
+      return absl::InfiniteDuration();
+    }
+    if (generation != timer_generation_) {
+      timer_tasks_.erase(generation);
+      return absl::InfiniteDuration();
+    }
+    const absl::Time now = clock_->Now();
+    while (!deadlines_.empty() && deadlines_.begin()->first <= now) {
+      expired.push_back(RemoveWaiterLocked(deadlines_.begin()->second));
+    }
+    if (deadlines_.empty()) {
+      timer_deadline_ = absl::InfiniteFuture();
+      timer_tasks_.erase(generation);
+      delay = absl::InfiniteDuration();
+    } else {
+      timer_deadline_ = deadlines_.begin()->first;
+      delay = timer_deadline_ - now;
+    }
+  }
+  for (Callback& callback : expired) {
+    callback(/*committed=*/false);
+  }
+  return delay;
+}
+
+}  // namespace backend
+}  // namespace emulator
+}  // namespace spanner
+}  // namespace google
@@ -0,0 +1,175 @@
+//
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_DATABASE_CHANGE_STREAM_CHANGE_STREAM_COMMIT_NOTIFIER_H_
+#define THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_DATABASE_CHANGE_STREAM_CHANGE_STREAM_COMMIT_NOTIFIER_H_
+
+#include <cstdint>
+#include <functional>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "backend/database/change_stream/change_stream_churn_scheduler.h"
+#include "common/clock.h"
+
+namespace google {
+namespace spanner {
+namespace emulator {
+namespace backend {
+
+// ChangeStreamCommitNotifier lets change stream partition queries block until
+// new records may be available instead of polling the change stream internal
+// tables at a fixed interval.
+//
+// Read-write transactions notify this class after they have committed writes
+// to a change stream data table (per partition token) or partition table (per
+// change stream). Partition queries wait on it until a commit at or after the
+// start of their next scan has been notified, or until their next heartbeat is
+// due. Queries served by the gRPC server register a callback instead of
+// blocking, so that waiting queries do not hold a thread.
+//
+// This class is thread-safe.
+class ChangeStreamCommitNotifier {
+ public:
+  // Called once with true if a commit the caller waits for was notified, or
+  // with false if the deadline passed first.
+  using Callback = std::function<void(bool committed)>;
+
+  // `clock` tells when the deadlines of callbacks have passed.
+  explicit ChangeStreamCommitNotifier(Clock* clock);
+
+  // Cancels the deadline timers. Callbacks that did not run yet are dropped.
+  ~ChangeStreamCommitNotifier();
+
+  // Records a commit of data change records for `partition_token`.
+  void NotifyPartition(absl::string_view change_stream_name,
+                       absl::string_view partition_token,
+                       absl::Time commit_timestamp) ABSL_LOCKS_EXCLUDED(mu_);
+
+  // Records a commit to the partition table of the change stream, e.g. when a
+  // partition is churned. This wakes up every query on the change stream.
+  void NotifyChangeStream(absl::string_view change_stream_name,
+                          absl::Time commit_timestamp)
+      ABSL_LOCKS_EXCLUDED(mu_);
+
+  // Blocks until a commit with a timestamp at or after `since` has been
+  // notified for `partition_token` or its change stream, or until `deadline`
+  // has passed. Returns true if such a commit was notified.
+  bool WaitForCommit(absl::string_view change_stream_name,
+                     absl::string_view partition_token, absl::Time since,
+                     absl::Time deadline) ABSL_LOCKS_EXCLUDED(mu_);
+
+  // Same as WaitForCommit, but calls `callback` with the outcome instead of
+  // blocking. The callback runs inline if the outcome is already known, and
+  // otherwise on the thread notifying the commit or, once `deadline` has
+  // passed, on the thread of the ChangeStreamChurnScheduler shared by all
+  // databases. It must not block.
+  void NotifyOnCommit(absl::string_view change_stream_name,
+                      absl::string_view partition_token, absl::Time since,
+                      absl::Time deadline, Callback callback)
+      ABSL_LOCKS_EXCLUDED(mu_);
+
+ private:
+  using WaiterId = int64_t;
+
+  struct Waiter {
+    std::string change_stream_name;
+    std::string partition_token;
+    absl::Time since;
+    absl::Time deadline;
+    Callback callback;
+  };
+
+  struct ChangeStreamCommits {
+    // Timestamp of the last commit to the change stream partition table.
+    absl::Time last_commit = absl::InfinitePast();
+
+    // Timestamp of the last commit of data change records per partition
+    // token. Entries older than `last_commit` are dropped since they no longer
+    // affect the outcome of a wait.
+    absl::flat_hash_map<std::string, absl::Time> partitions;
+  };
+
+  // Returns the timestamp of the last commit that is relevant to queries on
+  // `partition_token`.
+  absl::Time LastCommit(absl::string_view change_stream_name,
+                        absl::string_view partition_token) const
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Removes the waiters on `change_stream_name` whose commit has been notified
+  // and appends their callbacks to `callbacks`.
+  void TakeCommittedWaitersLocked(absl::string_view change_stream_name,
+                                  std::vector<Callback>* callbacks)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Removes the waiter and returns its callback.
+  Callback RemoveWaiterLocked(WaiterId id) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Schedules a timer task for `deadline` unless one is due by then.
+  void ScheduleTimerLocked(absl::Time deadline)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Body of the timer task of `generation`: calls the callbacks of expired
+  // waiters and returns the delay until the next deadline. Timer tasks
+  // superseded by a later generation stop running.
+  absl::Duration RunTimer(int64_t generation) ABSL_LOCKS_EXCLUDED(mu_);
+
+  Clock* const clock_;
+
+  ChangeStreamChurnScheduler* const scheduler_;
+
+  mutable absl::Mutex mu_;
+
+  // Notified commits, keyed by change stream name.
+  absl::flat_hash_map<std::string, ChangeStreamCommits> change_streams_
+      ABSL_GUARDED_BY(mu_);
+
+  // Registered callbacks, and their ids per change stream and by deadline.
+  absl::flat_hash_map<WaiterId, Waiter> waiters_ ABSL_GUARDED_BY(mu_);
+  absl::flat_hash_map<std::string, absl::flat_hash_set<WaiterId>>
+      waiters_by_change_stream_ ABSL_GUARDED_BY(mu_);
+  std::set<std::pair<absl::Time, WaiterId>> deadlines_ ABSL_GUARDED_BY(mu_);
+
+  WaiterId next_waiter_id_ ABSL_GUARDED_BY(mu_) = 1;
+
+  bool stop_ ABSL_GUARDED_BY(mu_) = false;
+
+  // When the current timer task runs next, or absl::InfiniteFuture() if there
+  // is none. A waiter with an earlier deadline starts a new generation of the
+  // timer task rather than cancelling the current one, which could deadlock
+  // while it waits for mu_.
+  absl::Time timer_deadline_ ABSL_GUARDED_BY(mu_) = absl::InfiniteFuture();
+  int64_t timer_generation_ ABSL_GUARDED_BY(mu_) = 0;
+
+  // Scheduled timer tasks that did not stop yet, keyed by generation.
+  absl::flat_hash_map<int64_t, ChangeStreamChurnScheduler::TaskId> timer_tasks_
+      ABSL_GUARDED_BY(mu_);
+};
+
+}  // namespace backend
+}  // namespace emulator
+}  // namespace spanner
+}  // namespace google
+
+#endif  // THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_DATABASE_CHANGE_STREAM_CHANGE_STREAM_COMMIT_NOTIFIER_H_
@@ -0,0 +1,157 @@
+//
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "backend/database/change_stream/change_stream_commit_notifier.h"
+
+#include <thread>  // NOLINT
+
+#include "gtest/gtest.h"
+#include "absl/synchronization/notification.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "common/clock.h"
+
+namespace google {
+namespace spanner {
+namespace emulator {
+namespace backend {
+namespace {
+
+const absl::Time kCommitTime = absl::FromUnixSeconds(1000);
+
+class ChangeStreamCommitNotifierTest : public testing::Test {
+ protected:
+  Clock clock_;
+};
+
+TEST_F(ChangeStreamCommitNotifierTest, TimesOutWithoutCommits) {
+  ChangeStreamCommitNotifier notifier(&clock_);
+  EXPECT_FALSE(notifier.WaitForCommit("stream", "token", kCommitTime,
+                                      absl::Now() + absl::Milliseconds(10)));
+}
+
+TEST_F(ChangeStreamCommitNotifierTest, ReturnsForEarlierPartitionCommit) {
+  ChangeStreamCommitNotifier notifier(&clock_);
+  notifier.NotifyPartition("stream", "token", kCommitTime);
+  EXPECT_TRUE(notifier.WaitForCommit("stream", "token", kCommitTime,
+                                     absl::InfiniteFuture()));
+  // Commits before the start of the wait or to other partitions and change
+  // streams are not relevant.
+  EXPECT_FALSE(notifier.WaitForCommit("stream", "token",
+                                      kCommitTime + absl::Microseconds(1),
+                                      absl::InfinitePast()));
+  EXPECT_FALSE(notifier.WaitForCommit("stream", "other_token", kCommitTime,
+                                      absl::InfinitePast()));
+  EXPECT_FALSE(notifier.WaitForCommit("other_stream", "token", kCommitTime,
+                                      absl::InfinitePast()));
+}
+
+TEST_F(ChangeStreamCommitNotifierTest, ChangeStreamCommitWakesAllPartitions) {
+  ChangeStreamCommitNotifier notifier(&clock_);
+  notifier.NotifyPartition("stream", "token", kCommitTime);
+  notifier.NotifyChangeStream("stream", kCommitTime + absl::Seconds(1));
+  EXPECT_TRUE(notifier.WaitForCommit("stream", "token",
+                                     kCommitTime + absl::Seconds(1),
+                                     absl::InfinitePast()));
+  EXPECT_TRUE(notifier.WaitForCommit("stream", "other_token",
+                                     kCommitTime + absl::Seconds(1),
+                                     absl::InfinitePast()));
+}
+
+TEST_F(ChangeStreamCommitNotifierTest, WakesUpWaiterOnCommit) {
+  ChangeStreamCommitNotifier notifier(&clock_);
+  std::thread committer([&notifier] {
+    absl::SleepFor(absl::Milliseconds(10));
+    notifier.NotifyPartition("stream", "token", kCommitTime);
+  });
+  EXPECT_TRUE(notifier.WaitForCommit("stream", "token", kCommitTime,
+                                     absl::InfiniteFuture()));
+  committer.join();
+}
+
+TEST_F(ChangeStreamCommitNotifierTest, CallsBackInlineForEarlierCommit) {
+  ChangeStreamCommitNotifier notifier(&clock_);
+  notifier.NotifyPartition("stream", "token", kCommitTime);
+  bool committed = false;
+  notifier.NotifyOnCommit("stream", "token", kCommitTime,
+                          absl::InfiniteFuture(),
+                          [&committed](bool result) { committed = result; });
+  EXPECT_TRUE(committed);
+}
+
+TEST_F(ChangeStreamCommitNotifierTest, CallsBackOnCommit) {
+  ChangeStreamCommitNotifier notifier(&clock_);
+  int calls = 0;
+  bool committed = false;
+  notifier.NotifyOnCommit("stream", "token", kCommitTime,
+                          absl::InfiniteFuture(), [&](bool result) {
+                            ++calls;
+                            committed = result;
+                          });
+  // Commits to other partitions or before the start of the wait do not run
+  // the callback.
+  notifier.NotifyPartition("stream", "other_token", kCommitTime);
+  notifier.NotifyPartition("stream", "token",
+                           kCommitTime - absl::Microseconds(1));
+  EXPECT_EQ(calls, 0);
+
+  notifier.NotifyChangeStream("stream", kCommitTime);
+  EXPECT_EQ(calls, 1);
+  EXPECT_TRUE(committed);
+
+  notifier.NotifyPartition("stream", "token", kCommitTime + absl::Seconds(1));
+  EXPECT_EQ(calls, 1);
+}
+
+TEST_F(ChangeStreamCommitNotifierTest, CallsBackAtDeadline) {
+  ChangeStreamCommitNotifier notifier(&clock_);
+  absl::Notification done;
+  bool committed = true;
+  notifier.NotifyOnCommit("stream", "token", kCommitTime,
+                          absl::Now() + absl::Milliseconds(10),
+                          [&](bool result) {
+                            committed = result;
+                            done.Notify();
+                          });
+  // A waiter with an earlier deadline is called back first.
+  absl::Notification earlier_done;
+  notifier.NotifyOnCommit(
+      "stream", "token", kCommitTime, absl::Now() + absl::Milliseconds(1),
+      [&](bool result) {
+        EXPECT_FALSE(done.HasBeenNotified());
+        earlier_done.Notify();
+      });
+  earlier_done.WaitForNotification();
+  done.WaitForNotification();
+  EXPECT_FALSE(committed);
+}
+
+TEST_F(ChangeStreamCommitNotifierTest, DropsPendingCallbacksOnDestruction) {
+  bool called = false;
+  {
+    ChangeStreamCommitNotifier notifier(&clock_);
+    notifier.NotifyOnCommit("stream", "token", kCommitTime,
+                            absl::Now() + absl::Hours(1),
+                            [&called](bool result) { called = true; });
+  }
+  EXPECT_FALSE(called);
+}
+
+}  // namespace
+}  // namespace backend
+}  // namespace emulator
+}  // namespace spanner
+}  // namespace google
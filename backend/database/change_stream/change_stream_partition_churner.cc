@@ -18,23 +18,21 @@
 
 #include <memory>  // NOLINT
 #include <string>
-#include <thread>  // NOLINT
 #include <utility>
 #include <vector>
 
 #include "zetasql/public/value.h"
 #include "absl/container/flat_hash_map.h"
-#include "absl/container/flat_hash_set.h"
 #include "absl/flags/flag.h"
 #include "absl/log/log.h"
 #include "absl/random/random.h"
 #include "absl/status/status.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
-#include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "backend/access/read.h"
 #include "backend/access/write.h"
+#include "backend/database/change_stream/change_stream_churn_scheduler.h"
 #include "backend/datamodel/key_set.h"
 #include "backend/schema/backfills/change_stream_backfill.h"
 #include "backend/schema/catalog/change_stream.h"
@@ -61,9 +59,27 @@ ABSL_FLAG(
     int, change_stream_churn_thread_retry_jitter, 100,
     "How long to sleep when retrying a failed change stream transaction.");
 
+ABSL_FLAG(absl::Duration, change_stream_churn_deferral_interval,
+          absl::Milliseconds(50),
+          "How long to wait before checking again whether change stream "
+          "churning can proceed while user transactions are writing.");
+
+ABSL_FLAG(absl::Duration, change_stream_churn_max_deferral, absl::Seconds(5),
+          "Upper bound on how long change stream churning is deferred while "
+          "user transactions are writing.");
+
 ABSL_FLAG(bool, enable_change_stream_churning, true,
           "Whether to enable change stream churning.");
 
+ABSL_FLAG(bool, enable_change_stream_retention_purge, true,
+          "Whether to purge change stream records that are older than the "
+          "retention period of their change stream.");
+
+ABSL_FLAG(absl::Duration, change_stream_retention_purge_interval,
+          absl::Minutes(1),
+          "How often to purge change stream records that are older than the "
+          "retention period of their change stream.");
+
 ABSL_FLAG(
     int, override_change_stream_partition_token_alive_seconds, -1,
     "If set to X seconds, and it's greater than 0, then override the default "
@@ -78,9 +94,15 @@ using zetasql::values::String;
 using zetasql::values::StringArray;
 
 ChangeStreamPartitionChurner::ChangeStreamPartitionChurner(
-    CreateReadWriteTransactionFn create_read_write_transaction_fn, Clock* clock)
+    CreateReadWriteTransactionFn create_read_write_transaction_fn, Clock* clock,
+    PurgeExpiredRecordsFn purge_expired_records_fn,
+    IsUnderWriteLoadFn is_under_write_load_fn)
     : create_read_write_transaction_fn_(create_read_write_transaction_fn),
-      clock_(clock) {
+      purge_expired_records_fn_(std::move(purge_expired_records_fn)),
+      is_under_write_load_fn_(std::move(is_under_write_load_fn)),
+      clock_(clock),
+      scheduler_(ChangeStreamChurnScheduler::Default()),
+      last_purge_time_(clock->Now()) {
   int oerridden_partition_token_alive_seconds =
       absl::GetFlag(FLAGS_override_change_stream_partition_token_alive_seconds);
   if (oerridden_partition_token_alive_seconds > 0) {
@@ -93,75 +115,98 @@ ChangeStreamPartitionChurner::ChangeStreamPartitionChurner(
   }
 }
 
-void ChangeStreamPartitionChurner::CreateChurningThread(
-    absl::string_view change_stream_name) {
-  mu_.AssertHeld();
-  if (!absl::GetFlag(FLAGS_enable_change_stream_churning)) {
-    return;
+ChangeStreamPartitionChurner::~ChangeStreamPartitionChurner() {
+  ChangeStreamChurnScheduler::TaskId task_id;
+  {
+    absl::MutexLock l(&mu_);
+    task_id = task_id_;
+    task_id_ = 0;
+  }
+  if (task_id != 0) {
+    scheduler_->Cancel(task_id);
   }
-  auto churning_thread = std::make_unique<ChurningThread>();
-  auto thread =
-      std::thread(&ChangeStreamPartitionChurner::PeriodicChurnPartitions, this,
-                  std::string(change_stream_name), churning_thread.get());
-  churning_thread->thread = std::move(thread);
-  churn_threads_.try_emplace(change_stream_name, std::move(churning_thread));
 }
 
-void ChangeStreamPartitionChurner::ClearChurningThread(
-    absl::string_view change_stream_name) {
-  mu_.AssertHeld();
-  churn_threads_.erase(change_stream_name);
+std::vector<std::string> ChangeStreamPartitionChurner::GetAllChangeStreamNames()
+    const {
+  absl::MutexLock l(&mu_);
+  return change_stream_names_;
 }
 
-void ChangeStreamPartitionChurner::ClearAllChurningThreads() {
-  absl::MutexLock l(&mu_);
-  churn_threads_.clear();
+absl::Duration ChangeStreamPartitionChurner::RunScheduledChurn() {
+  const std::vector<std::string> change_stream_names =
+      GetAllChangeStreamNames();
+  if (change_stream_names.empty()) {
+    return absl::GetFlag(FLAGS_change_stream_churn_thread_sleep_interval);
+  }
+
+  // In the current state, the emulator only allows one ongoing transaction at
+  // a time, so the churn transaction aborts concurrent user transactions (or
+  // is aborted by them). Hold off while users are writing, but not
+  // indefinitely since change stream queries rely on partitions being churned.
+  const absl::Time now = clock_->Now();
+  if (is_under_write_load_fn_ != nullptr && is_under_write_load_fn_()) {
+    if (deferred_since_ == absl::InfiniteFuture()) {
+      deferred_since_ = now;
+    }
+    if (now - deferred_since_ <
+        absl::GetFlag(FLAGS_change_stream_churn_max_deferral)) {
+      return absl::GetFlag(FLAGS_change_stream_churn_deferral_interval);
+    }
+  }
+
+  absl::Status s = ChurnPartitions(change_stream_names);
+  if (!s.ok()) {
+    if (!absl::IsAborted(s)) {
+      ABSL_LOG(ERROR) << "Failed to churn change streams with status: " << s;
+    }
+    const auto delay =
+        absl::GetFlag(FLAGS_change_stream_churn_thread_retry_jitter) *
+        absl::Uniform<double>(absl::BitGen(), 0, 1);
+    return absl::GetFlag(FLAGS_change_stream_churn_thread_retry_sleep_interval) +
+           absl::Milliseconds(delay);
+  }
+  deferred_since_ = absl::InfiniteFuture();
+
+  MaybePurgeExpiredRecords(change_stream_names);
+  return absl::GetFlag(FLAGS_change_stream_churn_thread_sleep_interval);
 }
 
-void ChangeStreamPartitionChurner::PeriodicChurnPartitions(
-    absl::string_view change_stream_name, ChurningThread* churning_thread) {
-  while (true) {
-    {
-      absl::MutexLock l(&churning_thread->mu);
-      churning_thread->mu.AwaitWithTimeout(
-          absl::Condition(&churning_thread->stop_thread),
-          absl::GetFlag(FLAGS_change_stream_churn_thread_sleep_interval));
-      if (churning_thread->stop_thread) {
-        return;
-      }
+void ChangeStreamPartitionChurner::MaybePurgeExpiredRecords(
+    const std::vector<std::string>& change_stream_names) {
+  if (purge_expired_records_fn_ == nullptr ||
+      !absl::GetFlag(FLAGS_enable_change_stream_retention_purge) ||
+      clock_->Now() - last_purge_time_ <
+          absl::GetFlag(FLAGS_change_stream_retention_purge_interval)) {
+    return;
+  }
+  for (const std::string& change_stream_name : change_stream_names) {
+    absl::Status s = purge_expired_records_fn_(change_stream_name);
+    if (!s.ok()) {
+      ABSL_LOG(ERROR) << "Failed to purge expired records of change stream "
+                      << change_stream_name << " with status: " << s;
     }
-    absl::Status s;
-    // In the current state, the emulator only allows one ongoing transaction
-    // at a time. Thus, churn might fail occasionally due to conflict with
-    // another ongoing transaction. We should retry the churn in cases of
-    // failure.
-    do {
-      s = ChurnPartitions(change_stream_name);
-
-      const auto delay =
-          absl::GetFlag(FLAGS_change_stream_churn_thread_retry_jitter) *
-          absl::Uniform<double>(absl::BitGen(), 0, 1);
-      absl::SleepFor(
-          absl::GetFlag(FLAGS_change_stream_churn_thread_retry_sleep_interval) +
-          absl::Milliseconds(delay));
-      if (!s.ok() && !absl::IsAborted(s)) {
-        ABSL_LOG(ERROR) << "Failed to churn change stream " << change_stream_name
-                   << " with status: " << s;
-      }
-    } while (!s.ok());
   }
+  last_purge_time_ = clock_->Now();
 }
 
 // TODO: Change stream churn transactions can potentially cause
 // user transactions to abort, since there can only be one concurrent
-// transaction at a time in the emulator. We need to either update to
-// table-level locking, or we need to implement waiting instead of aborting in
-// the transaction lock manager.
+// transaction at a time in the emulator. Churning is deferred while users are
+// writing, but we need to either update to table-level locking, or we need to
+// implement waiting instead of aborting in the transaction lock manager.
 absl::Status ChangeStreamPartitionChurner::ChurnPartitions(
-    absl::string_view change_stream_name) {
+    const std::vector<std::string>& change_stream_names) {
   ZETASQL_ASSIGN_OR_RETURN(auto txn, create_read_write_transaction_fn_(
                                  ReadWriteOptions(), RetryState()));
+  for (const std::string& change_stream_name : change_stream_names) {
+    ZETASQL_RETURN_IF_ERROR(ChurnPartitions(change_stream_name, txn.get()));
+  }
+  return txn->Commit();
+}
 
+absl::Status ChangeStreamPartitionChurner::ChurnPartitions(
+    absl::string_view change_stream_name, ReadWriteTransaction* txn) {
   const Schema* schema = txn->schema();
 
   ZETASQL_RET_CHECK(schema != nullptr);
@@ -211,12 +256,12 @@ absl::Status ChangeStreamPartitionChurner::ChurnPartitions(
       // Make sure to move each partition.
       for (const auto& partition_token : partition_tokens) {
         ZETASQL_RETURN_IF_ERROR(
-            MovePartition(change_stream_name, partition_token, txn.get()));
+            MovePartition(change_stream_name, partition_token, txn));
       }
     } else if (churn_type == "SPLIT") {
       for (const auto& partition_token : partition_tokens) {
         ZETASQL_RETURN_IF_ERROR(
-            SplitPartition(change_stream_name, partition_token, txn.get()));
+            SplitPartition(change_stream_name, partition_token, txn));
       }
     } else {
       int number_of_tokens = partition_tokens.size();
@@ -224,10 +269,10 @@ absl::Status ChangeStreamPartitionChurner::ChurnPartitions(
       ZETASQL_RET_CHECK(churn_type == "MERGE");
       ZETASQL_RET_CHECK(number_of_tokens == 2);
       ZETASQL_RETURN_IF_ERROR(MergePartition(change_stream_name, partition_tokens[0],
-                                     partition_tokens[1], txn.get()));
+                                     partition_tokens[1], txn));
     }
   }
-  return txn->Commit();
+  return absl::OkStatus();
 }
 
 absl::Status ChangeStreamPartitionChurner::MovePartition(
@@ -330,31 +375,36 @@ absl::Status ChangeStreamPartitionChurner::MergePartition(
 }
 
 void ChangeStreamPartitionChurner::Update(const Schema* schema) {
-  // Iterate through the change streams in the schema.
-  absl::MutexLock l(&mu_);
-  absl::flat_hash_set<std::string> change_stream_names;
-  for (const auto& [change_stream_name, churn_thread] : churn_threads_) {
-    change_stream_names.insert(change_stream_name);
-  }
-
-  for (const auto* change_stream : schema->change_streams()) {
-    // If the thread does not exist in the factory.
-    if (!change_stream_names.contains(change_stream->Name())) {
-      CreateChurningThread(change_stream->Name());
+  std::vector<std::string> change_stream_names;
+  if (absl::GetFlag(FLAGS_enable_change_stream_churning)) {
+    for (const auto* change_stream : schema->change_streams()) {
+      change_stream_names.push_back(change_stream->Name());
     }
   }
 
-  // Remove all nonexistent change stream threads.
-  for (auto& change_stream_name : change_stream_names) {
-    if (schema->FindChangeStream(change_stream_name) == nullptr) {
-      ClearChurningThread(change_stream_name);
+  ChangeStreamChurnScheduler::TaskId task_to_cancel = 0;
+  {
+    absl::MutexLock l(&mu_);
+    change_stream_names_ = std::move(change_stream_names);
+    if (!change_stream_names_.empty() && task_id_ == 0) {
+      task_id_ = scheduler_->Schedule(
+          [this]() { return RunScheduledChurn(); },
+          absl::GetFlag(FLAGS_change_stream_churn_thread_sleep_interval));
+    } else if (change_stream_names_.empty() && task_id_ != 0) {
+      task_to_cancel = task_id_;
+      task_id_ = 0;
     }
   }
+  // The periodic task reads the change stream names, so it must be cancelled
+  // without holding the lock.
+  if (task_to_cancel != 0) {
+    scheduler_->Cancel(task_to_cancel);
+  }
 }
 
-int ChangeStreamPartitionChurner::GetNumThreads() {
+int ChangeStreamPartitionChurner::GetNumChurnedChangeStreams() {
   absl::MutexLock l(&mu_);
-  return churn_threads_.size();
+  return change_stream_names_.size();
 }
 
 }  // namespace backend
@@ -20,18 +20,16 @@
 #include <functional>
 #include <memory>
 #include <string>
-#include <thread>  // NOLINT
 #include <vector>
 
 #include "absl/base/thread_annotations.h"
-#include "absl/container/flat_hash_map.h"
 #include "absl/flags/declare.h"
-#include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
+#include "backend/database/change_stream/change_stream_churn_scheduler.h"
 #include "backend/schema/catalog/schema.h"
 #include "backend/transaction/options.h"
 #include "backend/transaction/read_write_transaction.h"
@@ -40,20 +38,36 @@
 // How often to terminate currently active change stream partitions.
 ABSL_DECLARE_FLAG(absl::Duration, change_stream_churning_interval);
 
-// How often to run the thread with the change stream churning logic.
+// How often to run the change stream churning logic of a database.
 ABSL_DECLARE_FLAG(absl::Duration, change_stream_churn_thread_sleep_interval);
 
-// How long to sleep before retrying a failed change stream churn transaction.
+// How long to wait before retrying a failed change stream churn transaction.
 ABSL_DECLARE_FLAG(absl::Duration,
                   change_stream_churn_thread_retry_sleep_interval);
 
-// Jitter injected when sleeping before retrying a failed change stream
+// Jitter injected when waiting before retrying a failed change stream
 // churn transaction.
 ABSL_DECLARE_FLAG(int, change_stream_churn_thread_retry_jitter);
 
+// How long to wait before checking again whether change stream churning can
+// proceed, while it is deferred because of user write load.
+ABSL_DECLARE_FLAG(absl::Duration, change_stream_churn_deferral_interval);
+
+// Upper bound on how long change stream churning is deferred because of user
+// write load.
+ABSL_DECLARE_FLAG(absl::Duration, change_stream_churn_max_deferral);
+
 // Whether the change stream churning should be enabled.
 ABSL_DECLARE_FLAG(bool, enable_change_stream_churning);
 
+// Whether records that fell out of the change stream retention period should
+// be purged.
+ABSL_DECLARE_FLAG(bool, enable_change_stream_retention_purge);
+
+// How often to purge records that fell out of the change stream retention
+// period.
+ABSL_DECLARE_FLAG(absl::Duration, change_stream_retention_purge_interval);
+
 // If set to X seconds, and it's greater than 0, then
 // override the default partition token alive seconds from 20-40 seconds to X-2X
 // seconds.
@@ -64,7 +78,7 @@ namespace spanner {
 namespace emulator {
 namespace backend {
 
-// This class churns partitions for each change stream.
+// This class churns partitions for each change stream of a database.
 //
 // Change stream queries in the emulator will run forever unless they are
 // churned. Churning means terminating old partitions (start time is more than
@@ -74,56 +88,62 @@ namespace backend {
 // relationship, the parent partition will contain the child in the children
 // columns, and the child partition should contain the parent in the parent
 //  columns. The end timestamp of the parent should be the same as the start
-// timestamp of the child. We will run the churning logic for each change
-// stream in a per-change stream background thread that will be cached
-// in this class. We will add background threads or remove background threads
-// from ChangeStreamChurningFactory every time there is a schema change that
-// adds or removes change streams.
+// timestamp of the child.
+//
+// Rather than running a background thread per change stream, each database
+// registers a single periodic task with the process-wide
+// ChangeStreamChurnScheduler. The task churns all change streams of the
+// database in one read-write transaction, and defers churning while user
+// transactions are writing to the database since the churn transaction would
+// otherwise abort them. The set of churned change streams is updated every time
+// there is a schema change that adds or removes change streams.
 class ChangeStreamPartitionChurner {
  public:
   using CreateReadWriteTransactionFn =
       std::function<absl::StatusOr<std::unique_ptr<ReadWriteTransaction>>(
           const ReadWriteOptions& options, const RetryState& retry_state)>;
 
+  // Purges the records of the given change stream that fell out of its
+  // retention period.
+  using PurgeExpiredRecordsFn =
+      std::function<absl::Status(absl::string_view change_stream_name)>;
+
+  // Returns true if user transactions are currently writing to the database.
+  using IsUnderWriteLoadFn = std::function<bool()>;
+
+  // If `purge_expired_records_fn` is set, the expired records of each change
+  // stream are purged periodically as well. If `is_under_write_load_fn` is
+  // set, churning is deferred while it returns true.
   ChangeStreamPartitionChurner(
       CreateReadWriteTransactionFn create_read_write_transaction_fn,
-      Clock* clock);
+      Clock* clock, PurgeExpiredRecordsFn purge_expired_records_fn = nullptr,
+      IsUnderWriteLoadFn is_under_write_load_fn = nullptr);
 
-  ~ChangeStreamPartitionChurner() { ClearAllChurningThreads(); }
+  ~ChangeStreamPartitionChurner();
 
   void Update(const Schema* schema);
 
-  int GetNumThreads();
+  // Returns the number of change streams that are churned in the background.
+  int GetNumChurnedChangeStreams();
 
  private:
   std::vector<std::string> GetAllChangeStreamNames() const;
 
-  struct ChurningThread {
-    std::thread thread;
-    bool stop_thread ABSL_GUARDED_BY(mu) = false;
-    absl::Mutex mu;
-
-    ~ChurningThread() {
-      {
-        absl::MutexLock l(&mu);
-        ABSL_LOG(INFO) << "Stopping ChurningThread ";
-        stop_thread = true;
-      }
-      // Join the thread.
-      thread.join();
-    }
-  };
+  // Churns the partitions of all the given change streams in a single
+  // read-write transaction.
+  absl::Status ChurnPartitions(
+      const std::vector<std::string>& change_stream_names);
 
-  void CreateChurningThread(absl::string_view change_stream_name);
+  absl::Status ChurnPartitions(absl::string_view change_stream_name,
+                               ReadWriteTransaction* txn);
 
-  void ClearChurningThread(absl::string_view change_stream_name);
+  // Periodic task run by the scheduler. Returns the delay until its next run.
+  absl::Duration RunScheduledChurn();
 
-  void ClearAllChurningThreads();
-
-  absl::Status ChurnPartitions(absl::string_view change_stream_name);
-
-  void PeriodicChurnPartitions(absl::string_view change_stream_name,
-                               ChurningThread* churning_thread);
+  // Purges the expired records of all change streams if the purge interval
+  // has elapsed.
+  void MaybePurgeExpiredRecords(
+      const std::vector<std::string>& change_stream_names);
 
   absl::Status MovePartition(absl::string_view change_stream_name,
                              absl::string_view partition_token,
@@ -142,13 +162,33 @@ class ChangeStreamPartitionChurner {
 
   CreateReadWriteTransactionFn create_read_write_transaction_fn_;
 
+  PurgeExpiredRecordsFn purge_expired_records_fn_;
+
+  IsUnderWriteLoadFn is_under_write_load_fn_;
+
   // Clock shared across emulator components.
   Clock* clock_;
 
+  // Scheduler shared by all databases in the process.
+  ChangeStreamChurnScheduler* scheduler_;
+
   mutable absl::Mutex mu_;
 
-  absl::flat_hash_map<std::string, std::unique_ptr<ChurningThread>>
-      churn_threads_ ABSL_GUARDED_BY(mu_);
+  // Names of the change streams churned in the background.
+  std::vector<std::string> change_stream_names_ ABSL_GUARDED_BY(mu_);
+
+  // Id of the periodic task in the scheduler, or 0 if there is none.
+  ChangeStreamChurnScheduler::TaskId task_id_ ABSL_GUARDED_BY(mu_) = 0;
+
+  // Only accessed by the periodic task, which never runs concurrently with
+  // itself.
+  //
+  // Time at which churning was first deferred because of user write load, or
+  // InfiniteFuture if churning is not being deferred.
+  absl::Time deferred_since_ = absl::InfiniteFuture();
+
+  // Time of the last purge of expired records.
+  absl::Time last_purge_time_;
 };
 
 }  // namespace backend
@@ -31,11 +31,14 @@
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "backend/access/read.h"
+#include "backend/access/write.h"
 #include "backend/database/database.h"
 #include "backend/datamodel/key_set.h"
 #include "backend/schema/updater/schema_updater.h"
+#include "backend/storage/storage.h"
 #include "backend/transaction/options.h"
 #include "backend/transaction/read_only_transaction.h"
+#include "backend/transaction/read_write_transaction.h"
 #include "common/clock.h"
 #include "zetasql/base/status_macros.h"
 
@@ -251,7 +254,7 @@ class ChangeStreamPartitionChurnerTest : public ::testing::Test {
     absl::Status s;
     do {
       s = db_->get_change_stream_partition_churner()->ChurnPartitions(
-          change_stream_name);
+          std::vector<std::string>{change_stream_name});
     } while (!s.ok());
   }
 
@@ -261,7 +264,8 @@ class ChangeStreamPartitionChurnerTest : public ::testing::Test {
 
 TEST_F(ChangeStreamPartitionChurnerTest, ChangeStreamChurning) {
   std::string change_stream_one = "change_stream_one";
-  ASSERT_EQ(1, db_->get_change_stream_partition_churner()->GetNumThreads());
+  ASSERT_EQ(1, db_->get_change_stream_partition_churner()
+                   ->GetNumChurnedChangeStreams());
 
   absl::SleepFor(
       absl::GetFlag(FLAGS_change_stream_churn_thread_sleep_interval) * 5);
@@ -277,7 +281,8 @@ TEST_F(ChangeStreamPartitionChurnerTest, ChangeStreamChurning) {
 
   std::string change_stream_two = "change_stream_two";
   AddChangeStream(change_stream_two);
-  ASSERT_EQ(2, db_->get_change_stream_partition_churner()->GetNumThreads());
+  ASSERT_EQ(2, db_->get_change_stream_partition_churner()
+                   ->GetNumChurnedChangeStreams());
 
   absl::SleepFor(
       absl::GetFlag(FLAGS_change_stream_churn_thread_sleep_interval) * 5);
@@ -302,7 +307,8 @@ TEST_F(ChangeStreamPartitionChurnerTest, ChangeStreamChurning) {
 
   std::string change_stream_three = "change_stream_three";
   AddChangeStream(change_stream_three);
-  ASSERT_EQ(3, db_->get_change_stream_partition_churner()->GetNumThreads());
+  ASSERT_EQ(3, db_->get_change_stream_partition_churner()
+                   ->GetNumChurnedChangeStreams());
 
   absl::SleepFor(absl::Seconds(5));
 
@@ -336,13 +342,16 @@ TEST_F(ChangeStreamPartitionChurnerTest, ChangeStreamChurning) {
   VerifyStaleAndActivePartitions(stale_and_active_partitions);
 
   DropChangeStream(change_stream_three);
-  ASSERT_EQ(2, db_->get_change_stream_partition_churner()->GetNumThreads());
+  ASSERT_EQ(2, db_->get_change_stream_partition_churner()
+                   ->GetNumChurnedChangeStreams());
 
   DropChangeStream(change_stream_two);
-  ASSERT_EQ(1, db_->get_change_stream_partition_churner()->GetNumThreads());
+  ASSERT_EQ(1, db_->get_change_stream_partition_churner()
+                   ->GetNumChurnedChangeStreams());
 
   DropChangeStream(change_stream_one);
-  ASSERT_EQ(0, db_->get_change_stream_partition_churner()->GetNumThreads());
+  ASSERT_EQ(0, db_->get_change_stream_partition_churner()
+                   ->GetNumChurnedChangeStreams());
 }
 
 TEST_F(ChangeStreamPartitionChurnerTest, ChangeStreamSplitAndMerge) {
@@ -530,6 +539,73 @@ TEST_F(ChangeStreamPartitionChurnerTest, ChangeStreamSplitAndMerge) {
   }
 }
 
+TEST_F(ChangeStreamPartitionChurnerTest, PurgeExpiredChangeStreamRecords) {
+  absl::SetFlag(&FLAGS_cloud_spanner_emulator_disable_cs_retention_check, true);
+  std::vector<std::string> update_statements = {R"(
+    ALTER CHANGE STREAM change_stream_one SET OPTIONS ( retention_period='1s' )
+  )"};
+  absl::Status backfill_status;
+  int completed_statements;
+  absl::Time commit_ts;
+  absl::Status s;
+  do {
+    s = db_->UpdateSchema(
+        SchemaChangeOperation{.statements = update_statements},
+        &completed_statements, &commit_ts, &backfill_status);
+  } while (!s.ok());
+
+  // Write a data change record to the initial partition.
+  do {
+    ZETASQL_ASSERT_OK_AND_ASSIGN(
+        std::unique_ptr<ReadWriteTransaction> txn,
+        db_->CreateReadWriteTransaction(ReadWriteOptions(), RetryState()));
+    Mutation m;
+    m.AddWriteOp(MutationOpType::kInsert, "T", {"k1", "k2"},
+                 {{zetasql::values::Int64(1), zetasql::values::Int64(1)}});
+    s = txn->Write(m);
+    if (s.ok()) {
+      s = txn->Commit();
+    }
+  } while (!s.ok());
+  const absl::Time write_time = clock_.Now();
+
+  // End the initial partition, and wait until both the data change record and
+  // the initial partition fell out of the retention period.
+  absl::SleepFor(absl::Seconds(2));
+  ChurnPartitionsForChangeStream("change_stream_one");
+  absl::SleepFor(absl::Seconds(2));
+
+  const absl::Time purge_time = clock_.Now();
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      PurgeStats stats,
+      db_->PurgeExpiredChangeStreamRecords("change_stream_one"));
+  EXPECT_GT(stats.num_rows, 0);
+  EXPECT_GT(stats.num_bytes, 0);
+
+  // Only partitions that ended within the retention period are left. The
+  // background churning thread may have churned partitions in the meantime.
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      StaleAndActivePartitions partitions,
+      GetChangeStreamPartitions("change_stream_one", db_.get()));
+  EXPECT_FALSE(partitions.active_partitions.empty());
+  for (const auto& partition : partitions.stale_partitions) {
+    EXPECT_GE(partition.end_time, purge_time - absl::Seconds(1));
+  }
+
+  // The data change record is gone.
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ReadOnlyTransaction> txn,
+                       db_->CreateReadOnlyTransaction(ReadOnlyOptions()));
+  std::unique_ptr<backend::RowCursor> cursor;
+  backend::ReadArg read_arg;
+  read_arg.change_stream_for_data_table = "change_stream_one";
+  read_arg.columns = {"commit_timestamp"};
+  read_arg.key_set = KeySet::All();
+  ZETASQL_ASSERT_OK(txn->Read(read_arg, &cursor));
+  while (cursor->Next()) {
+    EXPECT_GT(cursor->ColumnValue(0).ToTime(), write_time);
+  }
+}
+
 }  // namespace backend
 }  // namespace emulator
 }  // namespace spanner
@@ -0,0 +1,87 @@
+//
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "backend/database/change_stream/change_stream_retention.h"
+
+#include <memory>
+#include <vector>
+
+#include "zetasql/public/value.h"
+#include "absl/status/status.h"
+#include "absl/time/time.h"
+#include "backend/datamodel/key.h"
+#include "backend/datamodel/key_range.h"
+#include "backend/schema/catalog/change_stream.h"
+#include "backend/schema/catalog/column.h"
+#include "backend/schema/catalog/table.h"
+#include "backend/storage/iterator.h"
+#include "backend/storage/storage.h"
+#include "zetasql/base/ret_check.h"
+#include "zetasql/base/status_macros.h"
+
+namespace google {
+namespace spanner {
+namespace emulator {
+namespace backend {
+
+absl::Status PurgeExpiredChangeStreamRecords(const ChangeStream* change_stream,
+                                             absl::Time now, Storage* storage,
+                                             PurgeStats* stats) {
+  const absl::Time gc_time =
+      now - absl::Seconds(change_stream->parsed_retention_period());
+  const Table* partition_table = change_stream->change_stream_partition_table();
+  const Table* data_table = change_stream->change_stream_data_table();
+  const Column* end_time_column = partition_table->FindColumn("end_time");
+  ZETASQL_RET_CHECK(end_time_column != nullptr);
+
+  std::unique_ptr<StorageIterator> itr;
+  ZETASQL_RETURN_IF_ERROR(storage->Read(now, partition_table->id(), KeyRange::All(),
+                                {end_time_column->id()}, &itr));
+  std::vector<Key> partitions;
+  std::vector<Key> expired_partitions;
+  while (itr->Next()) {
+    const zetasql::Value& end_time = itr->ColumnValue(0);
+    if (!end_time.is_null() && end_time.ToTime() < gc_time) {
+      expired_partitions.push_back(itr->Key());
+    } else {
+      partitions.push_back(itr->Key());
+    }
+  }
+  ZETASQL_RETURN_IF_ERROR(itr->Status());
+
+  // The data table is keyed by (partition_token, commit_timestamp, ...), so
+  // the expired records of each partition form a single key range.
+  for (const Key& partition : partitions) {
+    Key gc_key = partition;
+    gc_key.AddColumn(zetasql::values::Timestamp(gc_time));
+    ZETASQL_RETURN_IF_ERROR(storage->Purge(data_table->id(),
+                                   KeyRange::ClosedOpen(partition, gc_key),
+                                   stats));
+  }
+  for (const Key& partition : expired_partitions) {
+    const KeyRange partition_range = KeyRange::Prefix(partition);
+    ZETASQL_RETURN_IF_ERROR(
+        storage->Purge(data_table->id(), partition_range, stats));
+    ZETASQL_RETURN_IF_ERROR(
+        storage->Purge(partition_table->id(), partition_range, stats));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace backend
+}  // namespace emulator
+}  // namespace spanner
+}  // namespace google
@@ -0,0 +1,48 @@
+//
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_DATABASE_CHANGE_STREAM_CHANGE_STREAM_RETENTION_H_
+#define THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_DATABASE_CHANGE_STREAM_CHANGE_STREAM_RETENTION_H_
+
+#include "absl/status/status.h"
+#include "absl/time/time.h"
+#include "backend/schema/catalog/change_stream.h"
+#include "backend/storage/storage.h"
+
+namespace google {
+namespace spanner {
+namespace emulator {
+namespace backend {
+
+// Purges the records of `change_stream` that have fallen out of its retention
+// period as of `now` from `storage`:
+// - data change records with a commit timestamp before the retention window.
+// - partitions that ended before the retention window, with all their data
+//   change records.
+// Active partitions are never purged. The reclaimed space is added to `stats`.
+//
+// Change stream queries reject start timestamps before the retention window,
+// so purged records are never read again.
+absl::Status PurgeExpiredChangeStreamRecords(const ChangeStream* change_stream,
+                                             absl::Time now, Storage* storage,
+                                             PurgeStats* stats);
+
+}  // namespace backend
+}  // namespace emulator
+}  // namespace spanner
+}  // namespace google
+
+#endif  // THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_DATABASE_CHANGE_STREAM_CHANGE_STREAM_RETENTION_H_
@@ -17,24 +17,35 @@
 #include "backend/database/database.h"
 
 #include <memory>
+#include <string>
 #include <thread>  // NOLINT
 #include <utility>
+#include <vector>
 
 #include "google/spanner/admin/database/v1/common.pb.h"
 #include "zetasql/public/types/type_factory.h"
+#include "absl/flags/flag.h"
 #include "absl/functional/bind_front.h"
+#include "absl/log/log.h"
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
+#include "absl/types/span.h"
 #include "absl/types/variant.h"
 #include "backend/actions/manager.h"
 #include "backend/common/ids.h"
 #include "backend/database/change_stream/change_stream_partition_churner.h"
+#include "backend/database/change_stream/change_stream_retention.h"
 #include "backend/database/pg_oid_assigner/pg_oid_assigner.h"
+#include "backend/datamodel/key_range.h"
 #include "backend/locking/manager.h"
 #include "backend/query/query_engine.h"
+#include "backend/schema/backfills/index_backfill.h"
+#include "backend/schema/catalog/change_stream.h"
+#include "backend/schema/catalog/index.h"
 #include "backend/schema/catalog/proto_bundle.h"
 #include "backend/schema/catalog/schema.h"
 #include "backend/schema/catalog/versioned_catalog.h"
@@ -42,6 +53,7 @@
 #include "backend/schema/updater/schema_updater.h"
 #include "backend/schema/updater/scoped_schema_change_lock.h"
 #include "backend/storage/in_memory_storage.h"
+#include "backend/storage/storage.h"
 #include "backend/transaction/options.h"
 #include "backend/transaction/read_only_transaction.h"
 #include "backend/transaction/read_write_transaction.h"
@@ -55,10 +67,47 @@ namespace spanner {
 namespace emulator {
 namespace backend {
 
+namespace {
+
+// How long an asynchronous schema change waits before trying again to acquire
+// the database lock held by a transaction.
+constexpr absl::Duration kSchemaChangeLockRetryInterval = absl::Milliseconds(5);
+
+}  // namespace
+
+struct Database::PendingSchemaChange {
+  // Copies of the statements of the schema change and of its proto
+  // descriptors, which outlive the request that started it.
+  std::vector<std::string> statements;
+  std::string proto_descriptor_bytes;
+  database_api::DatabaseDialect dialect;
+
+  // The index of the first statement that remains to be applied.
+  int next_statement_index = 0;
+
+  // The write-only indexes to backfill before applying the next statement.
+  std::vector<std::string> write_only_indexes;
+
+  SchemaChangeProgress progress;
+  SchemaChangeProgressCallback on_progress;
+};
+
 // TransactionIDGenerator is initialized to 1 because 0 is used as a sentinel
 // value for an invalid transaction.
 Database::Database() : transaction_id_generator_(1) {}
 
+Database::~Database() {
+  std::thread schema_change_thread;
+  {
+    absl::MutexLock lock(&schema_change_mu_);
+    shutting_down_ = true;
+    schema_change_thread = std::move(schema_change_thread_);
+  }
+  if (schema_change_thread.joinable()) {
+    schema_change_thread.join();
+  }
+}
+
 absl::StatusOr<std::unique_ptr<Database>> Database::Create(
     Clock* clock, std::string_view database_id,
     const SchemaChangeOperation& schema_change_operation) {
@@ -67,6 +116,8 @@ absl::StatusOr<std::unique_ptr<Database>> Database::Create(
   database->database_id_ = database_id;
   database->storage_ = std::make_unique<InMemoryStorage>();
   database->lock_manager_ = std::make_unique<LockManager>(clock);
+  database->change_stream_commit_notifier_ =
+      std::make_unique<ChangeStreamCommitNotifier>(clock);
   database->type_factory_ = std::make_unique<zetasql::TypeFactory>();
   database->query_engine_ =
       std::make_unique<QueryEngine>(database->type_factory_.get());
@@ -105,7 +156,18 @@ absl::StatusOr<std::unique_ptr<Database>> Database::Create(
       std::make_unique<ChangeStreamPartitionChurner>(
           absl::bind_front(&Database::CreateReadWriteTransaction,
                            database.get()),
-          database->clock_);
+          database->clock_,
+          [database = database.get()](absl::string_view change_stream_name) {
+            return database->PurgeExpiredChangeStreamRecords(change_stream_name)
+                .status();
+          },
+          [database = database.get()]() {
+            return database->lock_manager_->HasActiveTransaction() ||
+                   database->clock_->Now() -
+                           database->lock_manager_->LastCommitTimestamp() <
+                       absl::GetFlag(
+                           FLAGS_change_stream_churn_deferral_interval);
+          });
 
   database->change_stream_partition_churner_->Update(
       database->versioned_catalog_->GetLatestSchema());
@@ -130,7 +192,25 @@ Database::CreateReadWriteTransaction(const ReadWriteOptions& options,
   return std::make_unique<ReadWriteTransaction>(
       options, retry_state, transaction_id_generator_.NextId(), clock_,
       storage_.get(), lock_manager_.get(), versioned_catalog_.get(),
-      action_manager_.get());
+      action_manager_.get(), change_stream_commit_notifier_.get());
+}
+
+absl::StatusOr<PurgeStats> Database::PurgeExpiredChangeStreamRecords(
+    absl::string_view change_stream_name) {
+  PurgeStats stats;
+  const ChangeStream* change_stream =
+      GetLatestSchema()->FindChangeStream(std::string(change_stream_name));
+  if (change_stream == nullptr) {
+    return stats;
+  }
+  ZETASQL_RETURN_IF_ERROR(backend::PurgeExpiredChangeStreamRecords(
+      change_stream, clock_->Now(), storage_.get(), &stats));
+  if (stats.num_rows > 0) {
+    ABSL_LOG(INFO) << "Purged " << stats.num_rows << " expired rows ("
+                   << stats.num_bytes << " bytes) of change stream "
+                   << change_stream_name << " in database " << database_id_;
+  }
+  return stats;
 }
 
 SchemaChangeContext Database::GetSchemaChangeContext() {
@@ -144,6 +224,39 @@ SchemaChangeContext Database::GetSchemaChangeContext() {
   };
 }
 
+absl::Status Database::BeginSchemaChange() {
+  absl::MutexLock lock(&schema_change_mu_);
+  if (schema_change_in_progress_) {
+    return error::ConcurrentSchemaChangeOrReadWriteTxnInProgress();
+  }
+  schema_change_in_progress_ = true;
+  return absl::OkStatus();
+}
+
+void Database::EndSchemaChange() {
+  absl::MutexLock lock(&schema_change_mu_);
+  schema_change_in_progress_ = false;
+}
+
+absl::Status Database::PublishSchema(absl::Time commit_timestamp,
+                                     std::unique_ptr<const Schema> schema) {
+  if (schema != nullptr) {
+    ZETASQL_RETURN_IF_ERROR(
+        versioned_catalog_->AddSchema(commit_timestamp, std::move(schema)));
+    action_manager_->AddActionsForSchema(versioned_catalog_->GetLatestSchema(),
+                                         query_engine_->function_catalog(),
+                                         query_engine_->type_factory());
+  }
+  change_stream_partition_churner_->Update(
+      versioned_catalog_->GetLatestSchema());
+
+  // Some functions need to access the schema (e.g. sequence functions), so
+  // set the latest schema to the function catalog here.
+  query_engine_->SetLatestSchemaForFunctionCatalog(
+      versioned_catalog_->GetLatestSchema());
+  return absl::OkStatus();
+}
+
 absl::Status Database::UpdateSchema(
     const SchemaChangeOperation& schema_change_operation,
     int* num_succesful_statements, absl::Time* commit_timestamp,
@@ -157,6 +270,13 @@ absl::Status Database::UpdateSchema(
   ScopedSchemaChangeLock lock{transaction_id_generator_.NextId(),
                               lock_manager_.get()};
   ZETASQL_RETURN_IF_ERROR(lock.Wait());
+  {
+    // Asynchronous schema changes release the lock between their steps.
+    absl::MutexLock schema_change_lock(&schema_change_mu_);
+    if (schema_change_in_progress_) {
+      return error::ConcurrentSchemaChangeOrReadWriteTxnInProgress();
+    }
+  }
 
   // Reserve a commit timestamp for the schema changes. Even if the
   // schema change fails, it will result in a no-op commit that will
@@ -177,21 +297,218 @@ absl::Status Database::UpdateSchema(
   // We update the schema even if the backfill status was not OK, the returned
   // schema will be the schema for the last valid statement before the statement
   // for which the backfill/verification failed.
-  if (result.updated_schema != nullptr) {
-    ZETASQL_RETURN_IF_ERROR(versioned_catalog_->AddSchema(
-        update_timestamp, std::move(result.updated_schema)));
-    action_manager_->AddActionsForSchema(versioned_catalog_->GetLatestSchema(),
-                                         query_engine_->function_catalog(),
-                                         query_engine_->type_factory());
+  return PublishSchema(update_timestamp, std::move(result.updated_schema));
+}
+
+std::unique_ptr<ScopedSchemaChangeLock> Database::AcquireSchemaChangeLock() {
+  absl::MutexLock lock(&schema_change_mu_);
+  while (!shutting_down_) {
+    auto schema_change_lock = std::make_unique<ScopedSchemaChangeLock>(
+        transaction_id_generator_.NextId(), lock_manager_.get());
+    if (schema_change_lock->Wait().ok()) {
+      return schema_change_lock;
+    }
+    schema_change_lock.reset();
+    schema_change_mu_.AwaitWithTimeout(absl::Condition(&shutting_down_),
+                                       kSchemaChangeLockRetryInterval);
   }
-  change_stream_partition_churner_->Update(
-      versioned_catalog_->GetLatestSchema());
+  return nullptr;
+}
 
-  // Some functions need to access the schema (e.g. sequence functions), so
-  // set the latest schema to the function catalog here.
-  query_engine_->SetLatestSchemaForFunctionCatalog(
-      versioned_catalog_->GetLatestSchema());
+absl::Status Database::ApplySchemaChangeStatements(
+    PendingSchemaChange* change, ScopedSchemaChangeLock* lock) {
+  ZETASQL_ASSIGN_OR_RETURN(absl::Time update_timestamp,
+                   lock->ReserveCommitTimestamp());
+  auto context = GetSchemaChangeContext();
+  context.schema_change_timestamp = update_timestamp;
+  absl::Span<const std::string> statements =
+      absl::MakeConstSpan(change->statements)
+          .subspan(change->next_statement_index);
+  SchemaUpdater updater;
+  ZETASQL_ASSIGN_OR_RETURN(
+      SchemaChangeResult result,
+      updater.UpdateSchemaFromDDL(
+          versioned_catalog_->GetLatestSchema(),
+          SchemaChangeOperation{
+              .statements = statements,
+              .proto_descriptor_bytes = change->proto_descriptor_bytes,
+              .database_dialect = change->dialect,
+              .backfill_indexes_in_background = true},
+          context));
+  ZETASQL_RETURN_IF_ERROR(
+      PublishSchema(update_timestamp, std::move(result.updated_schema)));
+
+  // A statement that adds write-only indexes is only reported as applied once
+  // they have been backfilled.
+  change->write_only_indexes = std::move(result.write_only_indexes);
+  int num_applied_statements = result.num_successful_statements;
+  if (!change->write_only_indexes.empty()) {
+    --num_applied_statements;
+    change->next_statement_index += result.next_statement_index;
+  }
+  change->progress.commit_timestamps.insert(
+      change->progress.commit_timestamps.end(), num_applied_statements,
+      update_timestamp);
+  change->progress.backfill_progress_percent = 0;
+  if (!result.backfill_status.ok() || change->write_only_indexes.empty()) {
+    change->progress.done = true;
+    change->progress.backfill_status = result.backfill_status;
+  }
+  return absl::OkStatus();
+}
+
+bool Database::BackfillWriteOnlyIndexes(PendingSchemaChange* change) {
+  absl::Status backfill_status;
+  const Schema* schema = versioned_catalog_->GetLatestSchema();
+  int num_indexes = change->write_only_indexes.size();
+  for (int i = 0; i < num_indexes && backfill_status.ok(); ++i) {
+    const Index* index =
+        schema->FindIndexCaseSensitive(change->write_only_indexes[i]);
+    if (index == nullptr) {
+      backfill_status = error::IndexNotFound(change->write_only_indexes[i]);
+      break;
+    }
+    std::vector<KeyRange> key_ranges;
+    // Each key range is backfilled at a timestamp of its own, so that the
+    // database lock is only held briefly. Transactions committing in between
+    // maintain the entries of the write-only index themselves.
+    for (int j = 0; j == 0 || j < static_cast<int>(key_ranges.size()); ++j) {
+      std::unique_ptr<ScopedSchemaChangeLock> lock = AcquireSchemaChangeLock();
+      if (lock == nullptr) {
+        return false;
+      }
+      absl::StatusOr<absl::Time> timestamp = lock->ReserveCommitTimestamp();
+      if (!timestamp.ok()) {
+        backfill_status = timestamp.status();
+        break;
+      }
+      if (j == 0) {
+        absl::StatusOr<std::vector<KeyRange>> maybe_key_ranges =
+            GetIndexBackfillKeyRanges(index, *timestamp, storage_.get());
+        if (!maybe_key_ranges.ok()) {
+          backfill_status = maybe_key_ranges.status();
+          break;
+        }
+        key_ranges = *std::move(maybe_key_ranges);
+      }
+      backfill_status = BackfillIndexKeyRange(index, key_ranges[j], *timestamp,
+                                              storage_.get());
+      if (!backfill_status.ok()) {
+        break;
+      }
+      lock.reset();
+      change->progress.backfill_progress_percent =
+          (100 * i + 100 * (j + 1) / key_ranges.size()) / num_indexes;
+      change->on_progress(change->progress);
+    }
+  }
+
+  // Make the indexes readable, or drop them if their backfill failed.
+  std::unique_ptr<ScopedSchemaChangeLock> lock = AcquireSchemaChangeLock();
+  if (lock == nullptr) {
+    return false;
+  }
+  absl::Status status = [&]() -> absl::Status {
+    ZETASQL_ASSIGN_OR_RETURN(absl::Time update_timestamp,
+                     lock->ReserveCommitTimestamp());
+    auto context = GetSchemaChangeContext();
+    context.schema_change_timestamp = update_timestamp;
+    SchemaUpdater updater;
+    std::unique_ptr<const Schema> new_schema;
+    if (backfill_status.ok()) {
+      ZETASQL_ASSIGN_OR_RETURN(new_schema, updater.MakeIndexesReadable(
+                                       versioned_catalog_->GetLatestSchema(),
+                                       change->write_only_indexes, context));
+      change->progress.commit_timestamps.push_back(update_timestamp);
+    } else {
+      ZETASQL_ASSIGN_OR_RETURN(new_schema, updater.DropWriteOnlyIndexes(
+                                       versioned_catalog_->GetLatestSchema(),
+                                       change->write_only_indexes, context));
+    }
+    change->write_only_indexes.clear();
+    return PublishSchema(update_timestamp, std::move(new_schema));
+  }();
+  if (!backfill_status.ok() || !status.ok()) {
+    change->progress.done = true;
+    change->progress.backfill_status =
+        backfill_status.ok() ? status : backfill_status;
+  } else if (change->next_statement_index ==
+             static_cast<int>(change->statements.size())) {
+    change->progress.done = true;
+  } else {
+    // Apply the following statements. Errors in them no longer fail the
+    // request, but end the schema change.
+    absl::Status apply_status =
+        ApplySchemaChangeStatements(change, lock.get());
+    if (!apply_status.ok()) {
+      change->progress.done = true;
+      change->progress.backfill_status = apply_status;
+    }
+  }
+  return true;
+}
+
+void Database::RunSchemaChange(std::unique_ptr<PendingSchemaChange> change) {
+  while (!change->progress.done) {
+    if (!BackfillWriteOnlyIndexes(change.get())) {
+      return;
+    }
+    if (!change->progress.done) {
+      change->on_progress(change->progress);
+    }
+  }
+  // Allow new schema changes before reporting completion, so that callers can
+  // start one as soon as they observe it.
+  EndSchemaChange();
+  change->on_progress(change->progress);
+}
+
+absl::Status Database::UpdateSchemaAsync(
+    const SchemaChangeOperation& schema_change_operation,
+    SchemaChangeProgressCallback on_progress) {
+  if (schema_change_operation.statements.empty()) {
+    return error::UpdateDatabaseMissingStatements();
+  }
+  ZETASQL_RETURN_IF_ERROR(BeginSchemaChange());
+
+  auto change = std::make_unique<PendingSchemaChange>();
+  change->statements.assign(schema_change_operation.statements.begin(),
+                            schema_change_operation.statements.end());
+  change->proto_descriptor_bytes =
+      std::string(schema_change_operation.proto_descriptor_bytes);
+  change->dialect = schema_change_operation.database_dialect;
+  change->on_progress = std::move(on_progress);
 
+  // Apply the statements up to the first one that adds write-only indexes
+  // right away, so that errors for invalid statements are returned.
+  absl::Status status;
+  {
+    ScopedSchemaChangeLock lock{transaction_id_generator_.NextId(),
+                                lock_manager_.get()};
+    status = lock.Wait();
+    if (status.ok()) {
+      status = ApplySchemaChangeStatements(change.get(), &lock);
+    }
+  }
+  if (!status.ok() || change->progress.done) {
+    EndSchemaChange();
+    if (status.ok()) {
+      change->on_progress(change->progress);
+    }
+    return status;
+  }
+
+  change->on_progress(change->progress);
+  absl::MutexLock lock(&schema_change_mu_);
+  // The previous schema change has ended, and its thread is only left to
+  // report completion.
+  if (schema_change_thread_.joinable()) {
+    schema_change_thread_.join();
+  }
+  schema_change_thread_ =
+      std::thread([this, change = std::move(change)]() mutable {
+        RunSchemaChange(std::move(change));
+      });
   return absl::OkStatus();
 }
 
@@ -17,8 +17,10 @@
 #ifndef THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_DATABASE_DATABASE_H_
 #define THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_DATABASE_DATABASE_H_
 
+#include <functional>
 #include <memory>
 #include <string>
+#include <thread>  // NOLINT
 #include <vector>
 
 #include "google/spanner/admin/database/v1/common.pb.h"
@@ -26,17 +28,21 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
 #include "absl/types/variant.h"
 #include "backend/actions/manager.h"
 #include "backend/common/ids.h"
+#include "backend/database/change_stream/change_stream_commit_notifier.h"
 #include "backend/database/change_stream/change_stream_partition_churner.h"
+#include "backend/database/change_stream/change_stream_retention.h"
 #include "backend/database/pg_oid_assigner/pg_oid_assigner.h"
 #include "backend/locking/manager.h"
 #include "backend/query/query_engine.h"
 #include "backend/schema/catalog/schema.h"
 #include "backend/schema/catalog/versioned_catalog.h"
 #include "backend/schema/updater/schema_updater.h"
+#include "backend/schema/updater/scoped_schema_change_lock.h"
 #include "backend/storage/storage.h"
 #include "backend/transaction/options.h"
 #include "backend/transaction/read_only_transaction.h"
@@ -51,6 +57,26 @@ namespace backend {
 
 namespace database_api = ::google::spanner::admin::database::v1;
 
+// Progress of a schema change started with Database::UpdateSchemaAsync.
+struct SchemaChangeProgress {
+  // The commit timestamps of the statements applied so far. A statement that
+  // creates an index is applied once the index has been backfilled.
+  std::vector<absl::Time> commit_timestamps;
+
+  // The progress of the backfill of the index created by the next statement,
+  // in percent.
+  int backfill_progress_percent = 0;
+
+  // Set once the schema change has finished.
+  bool done = false;
+
+  // The error that ended the schema change early, set once done.
+  absl::Status backfill_status;
+};
+
+using SchemaChangeProgressCallback =
+    std::function<void(const SchemaChangeProgress&)>;
+
 // Database represents a database in the emulator backend.
 //
 // Database largely ties together various subsystems - transactions, locking,
@@ -64,6 +90,9 @@ class Database {
       Clock* clock, std::string_view database_id,
       const SchemaChangeOperation& schema_change_operation);
 
+  // Stops the schema change running in the background, if any.
+  ~Database();
+
   // Creates a read only transaction attached to this database.
   absl::StatusOr<std::unique_ptr<ReadOnlyTransaction>>
   CreateReadOnlyTransaction(const ReadOnlyOptions& options);
@@ -107,6 +136,27 @@ class Database {
       int* num_succesful_statements, absl::Time* commit_timestamp,
       absl::Status* backfill_status);
 
+  // Updates the schema for this database like UpdateSchema, except that indexes
+  // created by CREATE INDEX statements are backfilled in the background.
+  //
+  // Such an index is added in a write-only state, in which transactions
+  // maintain its entries but it cannot be read from, and UpdateSchemaAsync
+  // returns. The index is then backfilled one key range at a time, holding the
+  // database lock only while a key range is written, so reads and writes
+  // continue in between. Once backfilled, the index becomes readable and the
+  // following statements are applied, which may add another write-only index.
+  // If the backfill fails, e.g. on a unique index violation, the index is
+  // dropped and the following statements are not applied.
+  //
+  // Errors for invalid statements are returned as with UpdateSchema. After
+  // that, `on_progress` is invoked as the statements are applied and the
+  // backfills progress, and a last time with `done` set, possibly before
+  // UpdateSchemaAsync returns. Other schema changes are rejected with a
+  // FAILED_PRECONDITION error until then.
+  absl::Status UpdateSchemaAsync(
+      const SchemaChangeOperation& schema_change_operation,
+      SchemaChangeProgressCallback on_progress);
+
   // Retrives the current version of the schema.
   const Schema* GetLatestSchema() const;
 
@@ -116,10 +166,21 @@ class Database {
   // Returns the database dialect.
   database_api::DatabaseDialect dialect() { return dialect_; }
 
+  // Purges the records of the change stream that fell out of its retention
+  // period and returns the space reclaimed. This is done periodically in the
+  // background as well.
+  absl::StatusOr<PurgeStats> PurgeExpiredChangeStreamRecords(
+      absl::string_view change_stream_name);
+
   ChangeStreamPartitionChurner* get_change_stream_partition_churner() {
     return change_stream_partition_churner_.get();
   }
 
+  // Used by change stream queries to wait for new change records.
+  ChangeStreamCommitNotifier* change_stream_commit_notifier() {
+    return change_stream_commit_notifier_.get();
+  }
+
   PgOidAssigner* get_pg_oid_assigner() { return pg_oid_assigner_.get(); }
 
  private:
@@ -128,8 +189,39 @@ class Database {
   Database(const Database&) = delete;
   Database& operator=(const Database&) = delete;
 
+  // State of an asynchronous schema change.
+  struct PendingSchemaChange;
+
   SchemaChangeContext GetSchemaChangeContext();
 
+  // Marks a schema change as in progress, or returns a FAILED_PRECONDITION
+  // error if one already is.
+  absl::Status BeginSchemaChange();
+  void EndSchemaChange();
+
+  // Adds `schema` as the schema of the database from `commit_timestamp` on.
+  absl::Status PublishSchema(absl::Time commit_timestamp,
+                             std::unique_ptr<const Schema> schema);
+
+  // Acquires the database lock for a step of an asynchronous schema change,
+  // retrying while transactions hold it. Returns nullptr once the database is
+  // being destroyed.
+  std::unique_ptr<ScopedSchemaChangeLock> AcquireSchemaChangeLock();
+
+  // Applies the remaining statements of `change` under `lock`, up to the first
+  // one that adds write-only indexes. Semantic errors are returned, other
+  // errors end the schema change.
+  absl::Status ApplySchemaChangeStatements(PendingSchemaChange* change,
+                                           ScopedSchemaChangeLock* lock);
+
+  // Backfills the write-only indexes of `change` and then makes them readable,
+  // or drops them if the backfill fails. Returns false if the database is being
+  // destroyed.
+  bool BackfillWriteOnlyIndexes(PendingSchemaChange* change);
+
+  // Runs an asynchronous schema change until it is done.
+  void RunSchemaChange(std::unique_ptr<PendingSchemaChange> change);
+
   // Clock to provide commit timestamps.
   Clock* clock_;
 
@@ -169,11 +261,26 @@ class Database {
   // The database dialect.
   database_api::DatabaseDialect dialect_;
 
+  // Notified by read-write transactions that write to change stream internal
+  // tables. Must outlive the partition churner, which commits such writes.
+  std::unique_ptr<ChangeStreamCommitNotifier> change_stream_commit_notifier_;
+
   std::unique_ptr<ChangeStreamPartitionChurner>
       change_stream_partition_churner_;
 
   // Assigns OIDs to database objects when dialect is POSTGRESQL.
   std::unique_ptr<PgOidAssigner> pg_oid_assigner_;
+
+  absl::Mutex schema_change_mu_;
+
+  // Whether a schema change is in progress.
+  bool schema_change_in_progress_ ABSL_GUARDED_BY(schema_change_mu_) = false;
+
+  // Set when the database is being destroyed, to stop the background thread.
+  bool shutting_down_ ABSL_GUARDED_BY(schema_change_mu_) = false;
+
+  // Runs the last asynchronous schema change that did not finish right away.
+  std::thread schema_change_thread_ ABSL_GUARDED_BY(schema_change_mu_);
 };
 
 }  // namespace backend
@@ -26,8 +26,10 @@
 #include "zetasql/base/testing/status_matchers.h"
 #include "tests/common/proto_matchers.h"
 #include "absl/status/status.h"
+#include "absl/synchronization/notification.h"
 #include "backend/access/read.h"
 #include "backend/datamodel/key_set.h"
+#include "backend/schema/catalog/index.h"
 #include "backend/schema/updater/schema_updater.h"
 #include "backend/transaction/options.h"
 #include "common/clock.h"
@@ -302,6 +304,163 @@ TEST_F(DatabaseTest, SchemaChangeLocksSuccesfullyReleased) {
   ZETASQL_EXPECT_OK(txn->Commit());
 }
 
+TEST_F(DatabaseTest, UpdateSchemaAsyncBackfillsIndexInBackground) {
+  std::vector<std::string> create_statements = {R"(
+    CREATE TABLE T(
+      k1 INT64,
+      k2 INT64,
+    ) PRIMARY KEY(k1)
+  )"};
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      auto db,
+      Database::Create(&clock_, kDatabaseId,
+                       SchemaChangeOperation{.statements = create_statements}));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<ReadWriteTransaction> txn,
+      db->CreateReadWriteTransaction(ReadWriteOptions(), RetryState()));
+  Mutation m;
+  m.AddWriteOp(MutationOpType::kInsert, "T", {"k1", "k2"},
+               {{Int64(1), Int64(30)}, {Int64(2), Int64(20)},
+                {Int64(3), Int64(10)}});
+  ZETASQL_ASSERT_OK(txn->Write(m));
+  ZETASQL_ASSERT_OK(txn->Commit());
+
+  std::vector<std::string> update_statements = {R"(
+    CREATE INDEX Idx on T(k2)
+  )",
+                                                R"(
+    CREATE TABLE T1(
+      a INT64,
+    ) PRIMARY KEY(a)
+  )"};
+  absl::Notification done;
+  SchemaChangeProgress progress;
+  ZETASQL_ASSERT_OK(db->UpdateSchemaAsync(
+      SchemaChangeOperation{.statements = update_statements},
+      [&](const SchemaChangeProgress& p) {
+        progress = p;
+        if (p.done) {
+          done.Notify();
+        }
+      }));
+  done.WaitForNotification();
+
+  // The index is readable once the schema change is done, and the statement
+  // following it is applied after that.
+  ZETASQL_EXPECT_OK(progress.backfill_status);
+  ASSERT_EQ(progress.commit_timestamps.size(), 2);
+  EXPECT_LT(progress.commit_timestamps[0], progress.commit_timestamps[1]);
+  const Index* index = db->GetLatestSchema()->FindIndex("Idx");
+  ASSERT_NE(index, nullptr);
+  EXPECT_FALSE(index->is_write_only());
+  EXPECT_NE(db->GetLatestSchema()->FindTable("T1"), nullptr);
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ReadOnlyTransaction> read_txn,
+                       db->CreateReadOnlyTransaction(ReadOnlyOptions()));
+  ReadArg read_arg = read_column("T", "k1");
+  read_arg.index = "Idx";
+  std::unique_ptr<RowCursor> row_cursor;
+  ZETASQL_ASSERT_OK(read_txn->Read(read_arg, &row_cursor));
+  std::vector<int64_t> keys;
+  while (row_cursor->Next()) {
+    keys.push_back(row_cursor->ColumnValue(0).int64_value());
+  }
+  ZETASQL_EXPECT_OK(row_cursor->Status());
+  EXPECT_THAT(keys, testing::ElementsAre(3, 2, 1));
+}
+
+TEST_F(DatabaseTest, UpdateSchemaAsyncDropsIndexOnFailedBackfill) {
+  std::vector<std::string> create_statements = {R"(
+    CREATE TABLE T(
+      k1 INT64,
+      k2 INT64,
+    ) PRIMARY KEY(k1)
+  )"};
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      auto db,
+      Database::Create(&clock_, kDatabaseId,
+                       SchemaChangeOperation{.statements = create_statements}));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<ReadWriteTransaction> txn,
+      db->CreateReadWriteTransaction(ReadWriteOptions(), RetryState()));
+  Mutation m;
+  m.AddWriteOp(MutationOpType::kInsert, "T", {"k1", "k2"},
+               {{Int64(1), Int64(2)}, {Int64(2), Int64(2)}});
+  ZETASQL_ASSERT_OK(txn->Write(m));
+  ZETASQL_ASSERT_OK(txn->Commit());
+
+  std::vector<std::string> update_statements = {R"(
+    CREATE TABLE T1(
+      a INT64,
+    ) PRIMARY KEY(a)
+  )",
+                                                R"(
+    CREATE UNIQUE INDEX Idx on T(k2)
+  )",
+                                                R"(
+    CREATE TABLE T2(
+      b INT64,
+    ) PRIMARY KEY(b)
+  )"};
+  absl::Notification done;
+  SchemaChangeProgress progress;
+  ZETASQL_ASSERT_OK(db->UpdateSchemaAsync(
+      SchemaChangeOperation{.statements = update_statements},
+      [&](const SchemaChangeProgress& p) {
+        progress = p;
+        if (p.done) {
+          done.Notify();
+        }
+      }));
+  done.WaitForNotification();
+
+  EXPECT_EQ(progress.backfill_status,
+            error::UniqueIndexViolationOnIndexCreation("Idx", "{Int64(2)}"));
+  EXPECT_EQ(progress.commit_timestamps.size(), 1);
+  EXPECT_NE(db->GetLatestSchema()->FindTable("T1"), nullptr);
+  EXPECT_EQ(db->GetLatestSchema()->FindIndex("Idx"), nullptr);
+  EXPECT_EQ(db->GetLatestSchema()->FindTable("T2"), nullptr);
+}
+
+TEST_F(DatabaseTest, UpdateSchemaAsyncReturnsInvalidStatementErrors) {
+  std::vector<std::string> create_statements = {R"(
+    CREATE TABLE T(
+      k1 INT64,
+      k2 INT64,
+    ) PRIMARY KEY(k1)
+  )"};
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      auto db,
+      Database::Create(&clock_, kDatabaseId,
+                       SchemaChangeOperation{.statements = create_statements}));
+
+  // The second statement is invalid, so no statement is applied.
+  std::vector<std::string> update_statements = {R"(
+    CREATE INDEX Idx on T(k2)
+  )",
+                                                R"(
+    CREATE INDEX Idx2 on NonExistent(k2)
+  )"};
+  bool called = false;
+  EXPECT_THAT(db->UpdateSchemaAsync(
+                  SchemaChangeOperation{.statements = update_statements},
+                  [&](const SchemaChangeProgress& p) { called = true; }),
+              StatusIs(absl::StatusCode::kNotFound));
+  EXPECT_FALSE(called);
+  EXPECT_EQ(db->GetLatestSchema()->FindIndex("Idx"), nullptr);
+
+  // Other schema changes can run.
+  absl::Status backfill_status;
+  int completed_statements;
+  absl::Time commit_ts;
+  ZETASQL_EXPECT_OK(db->UpdateSchema(
+      SchemaChangeOperation{.statements = {update_statements[0]}},
+      &completed_statements, &commit_ts, &backfill_status));
+  ZETASQL_EXPECT_OK(backfill_status);
+}
+
 }  // namespace
 }  // namespace backend
 }  // namespace emulator
@@ -148,6 +148,11 @@ absl::Time LockManager::LastCommitTimestamp() {
   return last_commit_timestamp_;
 }
 
+bool LockManager::HasActiveTransaction() {
+  absl::ReaderMutexLock lock(&mu_);
+  return active_handle_ != nullptr;
+}
+
 }  // namespace backend
 }  // namespace emulator
 }  // namespace spanner
@@ -57,6 +57,9 @@ class LockManager {
   // Returns the timestamp at which last schema update or commit completed.
   absl::Time LastCommitTimestamp();
 
+  // Returns true if a transaction currently holds the database lock.
+  bool HasActiveTransaction();
+
  private:
   // LockHandle simply forwards requests to the LockManager.
   friend class LockHandle;
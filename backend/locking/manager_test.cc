@@ -116,6 +116,20 @@ TEST_F(LockManagerTest, SequentialTransactionAcquiresLock) {
   ZETASQL_EXPECT_OK(lh3->Wait());
 }
 
+TEST_F(LockManagerTest, ReportsActiveTransaction) {
+  EXPECT_FALSE(manager()->HasActiveTransaction());
+
+  std::unique_ptr<LockHandle> lh =
+      manager()->CreateHandle(TransactionID(1),
+                              /*try_abort_fn=*/nullptr, TransactionPriority(1));
+  lh->EnqueueLock(request());
+  ZETASQL_EXPECT_OK(lh->Wait());
+  EXPECT_TRUE(manager()->HasActiveTransaction());
+
+  lh->UnlockAll();
+  EXPECT_FALSE(manager()->HasActiveTransaction());
+}
+
 TEST_F(LockManagerTest, TransactionsThatDidNotAcquireLockCanReleaseIt) {
   std::unique_ptr<LockHandle> lh1 =
       manager()->CreateHandle(TransactionID(1),
@@ -47,6 +47,10 @@ bool SupportsSafeErrorMode(const zetasql::Function* function) {
       new absl::flat_hash_set<absl::string_view>{
           "$safe_array_at_offset",
           "$safe_array_at_ordinal",
+          // Evaluated with vector kernels, see AddVectorDistanceFunctions.
+          "cosine_distance",
+          "dot_product",
+          "euclidean_distance",
           "st_expr_eval",
           "supported_optimizer_versions",
           "test_fn_nondeterministic_value",
@@ -46,6 +46,7 @@
 #include "backend/query/ml/ml_predict_row_function.h"
 #include "backend/query/ml/ml_predict_table_valued_function.h"
 #include "backend/query/search/search_function_catalog.h"
+#include "backend/query/vector_distance_functions.h"
 #include "backend/schema/catalog/column.h"
 #include "backend/schema/catalog/table.h"
 #include "third_party/spanner_pg/datatypes/extended/pg_jsonb_type.h"
@@ -186,6 +187,8 @@ FunctionCatalog::FunctionCatalog(zetasql::TypeFactory* type_factory,
     : catalog_name_(catalog_name), latest_schema_(schema) {
   // Add the subset of ZetaSQL built-in functions supported by Cloud Spanner.
   AddZetaSQLBuiltInFunctions(type_factory);
+  // Evaluate the exact vector distance functions with vector kernels.
+  AddVectorDistanceFunctions();
   // Add Cloud Spanner specific functions.
   AddSpannerFunctions();
   // Add aliases for the functions.
@@ -218,6 +221,25 @@ void FunctionCatalog::AddZetaSQLBuiltInFunctions(
   }
 }
 
+void FunctionCatalog::AddVectorDistanceFunctions() {
+  for (absl::string_view name : kVectorDistanceFunctionNames) {
+    auto it = functions_.find(std::string(name));
+    if (it == functions_.end()) {
+      continue;
+    }
+    // The reference implementation only calls the evaluators of functions
+    // which are not ZetaSQL built-ins, so the function is replaced by a
+    // Spanner function with the same signatures and options.
+    const zetasql::Function* builtin_function = it->second.get();
+    zetasql::FunctionOptions function_options =
+        builtin_function->function_options().Copy();
+    function_options.set_evaluator(VectorDistanceEvaluator(name));
+    it->second = std::make_unique<zetasql::Function>(
+        builtin_function->Name(), catalog_name_, builtin_function->mode(),
+        builtin_function->signatures(), function_options);
+  }
+}
+
 void FunctionCatalog::AddSpannerFunctions() {
   // Add pending commit timestamp function to the list of known functions.
   auto pending_commit_ts_func = PendingCommitTimestampFunction(catalog_name_);
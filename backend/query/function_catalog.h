@@ -63,6 +63,7 @@ class FunctionCatalog {
 
  private:
   void AddZetaSQLBuiltInFunctions(zetasql::TypeFactory* type_factory);
+  void AddVectorDistanceFunctions();
   void AddSpannerFunctions();
   void AddMlFunctions();
   void AddSearchFunctions(zetasql::TypeFactory* type_factory);
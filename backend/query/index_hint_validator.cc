@@ -131,6 +131,8 @@ absl::Status IndexHintValidator::ValidateIndexesForTables() {
       return error::QueryHintIndexNotFound(schema_table->Name(), index_name);
     } else if (HasGeneratedEmulatorName(index)) {
       return error::QueryHintManagedIndexNotSupported(index_name);
+    } else if (index->is_write_only()) {
+      return error::IndexNotReadable(index_name);
     }
 
     if (index->is_search_index()) {
@@ -0,0 +1,547 @@
+//
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "backend/query/index_scan_rewriter.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "zetasql/public/catalog.h"
+#include "zetasql/public/evaluator_table_iterator.h"
+#include "zetasql/public/value.h"
+#include "zetasql/resolved_ast/resolved_ast.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/match.h"
+#include "absl/types/span.h"
+#include "backend/common/ann_index.h"
+#include "backend/common/inverted_index.h"
+#include "backend/datamodel/key.h"
+#include "backend/datamodel/key_set.h"
+#include "backend/query/queryable_column.h"
+#include "backend/query/queryable_table.h"
+#include "backend/query/search/search_index_candidates.h"
+#include "backend/schema/catalog/column.h"
+#include "backend/schema/catalog/index.h"
+#include "backend/schema/catalog/table.h"
+#include "zetasql/base/status_macros.h"
+
+namespace google {
+namespace spanner {
+namespace emulator {
+namespace backend {
+
+namespace {
+
+// Wraps a QueryableTable to only read the rows with keys in a given key set.
+class KeyRestrictedTable : public zetasql::Table {
+ public:
+  KeyRestrictedTable(const QueryableTable* table, KeySet key_set)
+      : table_(table), key_set_(std::move(key_set)) {}
+
+  std::string Name() const override { return table_->Name(); }
+
+  std::string FullName() const override { return table_->FullName(); }
+
+  int NumColumns() const override { return table_->NumColumns(); }
+
+  const zetasql::Column* GetColumn(int i) const override {
+    return table_->GetColumn(i);
+  }
+
+  const zetasql::Column* FindColumnByName(
+      const std::string& name) const override {
+    return table_->FindColumnByName(name);
+  }
+
+  std::optional<std::vector<int>> PrimaryKey() const override {
+    return table_->PrimaryKey();
+  }
+
+  absl::StatusOr<std::unique_ptr<zetasql::EvaluatorTableIterator>>
+  CreateEvaluatorTableIterator(
+      absl::Span<const int> column_idxs) const override {
+    return table_->CreateEvaluatorTableIteratorForKeys(column_idxs, key_set_);
+  }
+
+ private:
+  const QueryableTable* table_;
+  const KeySet key_set_;
+};
+
+std::vector<Key> Intersect(const std::vector<Key>& a,
+                           const std::vector<Key>& b) {
+  std::vector<Key> result;
+  std::set_intersection(a.begin(), a.end(), b.begin(), b.end(),
+                        std::back_inserter(result));
+  return result;
+}
+
+std::vector<Key> Union(const std::vector<Key>& a, const std::vector<Key>& b) {
+  std::vector<Key> result;
+  std::set_union(a.begin(), a.end(), b.begin(), b.end(),
+                 std::back_inserter(result));
+  return result;
+}
+
+// Returns true if keys of rows of `table` can be buffered before the commit
+// timestamp they hold is known, in which case indexes hold keys which differ
+// from the committed ones.
+bool HasCommitTimestampKey(const Table* table) {
+  return std::any_of(table->primary_key().begin(), table->primary_key().end(),
+                     [](const KeyColumn* key_column) {
+                       return key_column->column()->allows_commit_timestamp();
+                     });
+}
+
+// Returns the index of the column of `table` that `scan` reads into
+// `resolved_column`, or std::nullopt if `scan` does not read it.
+std::optional<int> FindScannedColumnIndex(
+    const zetasql::ResolvedTableScan* scan,
+    const zetasql::ResolvedColumn& resolved_column) {
+  for (int i = 0; i < scan->column_list_size() &&
+                  i < scan->column_index_list_size();
+       ++i) {
+    if (scan->column_list(i).column_id() == resolved_column.column_id()) {
+      return scan->column_index_list(i);
+    }
+  }
+  return std::nullopt;
+}
+
+// Returns the column of `table` that `scan` reads into `resolved_column`, or
+// nullptr if `scan` does not read it.
+const Column* FindScannedColumn(
+    const zetasql::ResolvedTableScan* scan, const QueryableTable* table,
+    const zetasql::ResolvedColumn& resolved_column) {
+  std::optional<int> column_index =
+      FindScannedColumnIndex(scan, resolved_column);
+  if (!column_index.has_value()) {
+    return nullptr;
+  }
+  const auto* queryable_column =
+      dynamic_cast<const QueryableColumn*>(table->GetColumn(*column_index));
+  return queryable_column != nullptr ? queryable_column->wrapped_column()
+                                     : nullptr;
+}
+
+// Returns the number of rows of `table` with `keys` in which the column at
+// `column_index` is not NULL, or std::nullopt if the rows cannot be read.
+std::optional<int64_t> CountNonNullValues(const QueryableTable* table,
+                                          int column_index,
+                                          const std::vector<Key>& keys) {
+  KeySet key_set;
+  for (const Key& key : keys) {
+    key_set.AddKey(key);
+  }
+  absl::StatusOr<std::unique_ptr<zetasql::EvaluatorTableIterator>> iterator =
+      table->CreateEvaluatorTableIteratorForKeys({column_index}, key_set);
+  if (!iterator.ok()) {
+    return std::nullopt;
+  }
+  int64_t count = 0;
+  while ((*iterator)->NextRow()) {
+    if (!(*iterator)->GetValue(0).is_null()) {
+      ++count;
+    }
+  }
+  if (!(*iterator)->Status().ok()) {
+    return std::nullopt;
+  }
+  return count;
+}
+
+// Returns the distance computed by `function_name` if it is an approximate
+// distance function.
+std::optional<AnnIndex::Distance> GetApproxDistance(
+    const std::string& function_name) {
+  if (function_name == "approx_cosine_distance") {
+    return AnnIndex::Distance::kCosine;
+  }
+  if (function_name == "approx_euclidean_distance") {
+    return AnnIndex::Distance::kEuclidean;
+  }
+  if (function_name == "approx_dot_product") {
+    return AnnIndex::Distance::kDotProduct;
+  }
+  return std::nullopt;
+}
+
+// Returns true if `expr` is `column IS NOT NULL`.
+bool IsNotNullCheck(const zetasql::ResolvedExpr* expr,
+                    const zetasql::ResolvedColumn& column) {
+  if (!expr->Is<zetasql::ResolvedFunctionCall>()) {
+    return false;
+  }
+  const auto* not_call = expr->GetAs<zetasql::ResolvedFunctionCall>();
+  if (not_call->function()->Name() != "$not" ||
+      not_call->argument_list_size() != 1 ||
+      !not_call->argument_list(0)->Is<zetasql::ResolvedFunctionCall>()) {
+    return false;
+  }
+  const auto* is_null_call =
+      not_call->argument_list(0)->GetAs<zetasql::ResolvedFunctionCall>();
+  return is_null_call->function()->Name() == "$is_null" &&
+         is_null_call->argument_list_size() == 1 &&
+         is_null_call->argument_list(0)->Is<zetasql::ResolvedColumnRef>() &&
+         is_null_call->argument_list(0)
+                 ->GetAs<zetasql::ResolvedColumnRef>()
+                 ->column() == column;
+}
+
+// Returns true if `expr` only rejects the rows where `column` is NULL.
+bool OnlyFiltersNulls(const zetasql::ResolvedExpr* expr,
+                      const zetasql::ResolvedColumn& column) {
+  if (IsNotNullCheck(expr, column)) {
+    return true;
+  }
+  if (!expr->Is<zetasql::ResolvedFunctionCall>()) {
+    return false;
+  }
+  const auto* and_call = expr->GetAs<zetasql::ResolvedFunctionCall>();
+  return and_call->function()->Name() == "$and" &&
+         std::all_of(and_call->argument_list().begin(),
+                     and_call->argument_list().end(),
+                     [&column](const auto& argument) {
+                       return IsNotNullCheck(argument.get(), column);
+                     });
+}
+
+}  // namespace
+
+std::optional<zetasql::Value> IndexScanRewriter::GetConstantValue(
+    const zetasql::ResolvedExpr* expr) const {
+  if (expr->Is<zetasql::ResolvedLiteral>()) {
+    return expr->GetAs<zetasql::ResolvedLiteral>()->value();
+  }
+  if (expr->Is<zetasql::ResolvedParameter>()) {
+    const std::string& name = expr->GetAs<zetasql::ResolvedParameter>()->name();
+    for (const auto& [param_name, value] : params_) {
+      if (absl::EqualsIgnoreCase(param_name, name)) {
+        return value;
+      }
+    }
+  }
+  return std::nullopt;
+}
+
+std::optional<std::vector<Key>> IndexScanRewriter::FindFunctionCandidates(
+    const zetasql::ResolvedFunctionCall* function_call,
+    const zetasql::ResolvedTableScan* scan, const QueryableTable* table) const {
+  if (function_call->argument_list_size() < 2 ||
+      !function_call->argument_list(0)->Is<zetasql::ResolvedColumnRef>()) {
+    return std::nullopt;
+  }
+
+  // The arguments other than the token list must be known before evaluating
+  // the filter.
+  std::vector<zetasql::Value> args = {zetasql::Value::NullTokenList()};
+  for (int i = 1; i < function_call->argument_list_size(); ++i) {
+    std::optional<zetasql::Value> value =
+        GetConstantValue(function_call->argument_list(i));
+    if (!value.has_value() || !value->is_valid()) {
+      return std::nullopt;
+    }
+    args.push_back(*std::move(value));
+  }
+
+  // Find the column of the table the token list is read from.
+  const Column* column = FindScannedColumn(
+      scan, table,
+      function_call->argument_list(0)
+          ->GetAs<zetasql::ResolvedColumnRef>()
+          ->column());
+  if (column == nullptr) {
+    return std::nullopt;
+  }
+
+  // Find the posting lists of the column.
+  const InvertedIndex* inverted_index = nullptr;
+  for (const Index* index : table->wrapped_table()->indexes()) {
+    if (index->inverted_index() == nullptr) {
+      continue;
+    }
+    for (const KeyColumn* key_column : index->key_columns()) {
+      if (key_column->column()->source_column() == column) {
+        inverted_index = index->inverted_index();
+      }
+    }
+  }
+  if (inverted_index == nullptr) {
+    return std::nullopt;
+  }
+
+  const std::string& name = function_call->function()->Name();
+  if (name == "search") {
+    if (!args[1].type()->IsString() || args[1].is_null()) {
+      return std::nullopt;
+    }
+    return query::search::FindSearchCandidates(*inverted_index, column->id(),
+                                               args[1].string_value());
+  }
+  return query::search::FindSearchNgramsCandidates(*inverted_index,
+                                                   column->id(), args);
+}
+
+std::optional<std::vector<Key>> IndexScanRewriter::FindCandidates(
+    const zetasql::ResolvedExpr* expr, const zetasql::ResolvedTableScan* scan,
+    const QueryableTable* table) const {
+  if (!expr->Is<zetasql::ResolvedFunctionCall>()) {
+    return std::nullopt;
+  }
+  const auto* function_call = expr->GetAs<zetasql::ResolvedFunctionCall>();
+  const std::string& name = function_call->function()->Name();
+  if (name == "$and") {
+    // Any conjunct narrows down the rows.
+    std::optional<std::vector<Key>> result;
+    for (const auto& argument : function_call->argument_list()) {
+      std::optional<std::vector<Key>> candidates =
+          FindCandidates(argument.get(), scan, table);
+      if (!candidates.has_value()) continue;
+      result = result.has_value() ? Intersect(*result, *candidates)
+                                  : std::move(candidates);
+    }
+    return result;
+  }
+  if (name == "$or") {
+    // Each disjunct must narrow down the rows.
+    std::vector<Key> result;
+    for (const auto& argument : function_call->argument_list()) {
+      std::optional<std::vector<Key>> candidates =
+          FindCandidates(argument.get(), scan, table);
+      if (!candidates.has_value()) return std::nullopt;
+      result = Union(result, *candidates);
+    }
+    return result;
+  }
+  if (name == "search" || name == "search_ngrams") {
+    return FindFunctionCandidates(function_call, scan, table);
+  }
+  return std::nullopt;
+}
+
+std::optional<std::vector<Key>> IndexScanRewriter::FindNeighborCandidates(
+    const zetasql::ResolvedLimitOffsetScan* node,
+    const zetasql::ResolvedTableScan** scan) const {
+  // The number of rows to return must be known before evaluating the scan.
+  std::optional<zetasql::Value> limit =
+      node->limit() != nullptr ? GetConstantValue(node->limit())
+                               : std::nullopt;
+  if (!limit.has_value() || !limit->is_valid() ||
+      !limit->type()->IsInt64() || limit->is_null() ||
+      limit->int64_value() <= 0) {
+    return std::nullopt;
+  }
+  int64_t num_neighbors = limit->int64_value();
+  if (node->offset() != nullptr) {
+    std::optional<zetasql::Value> offset = GetConstantValue(node->offset());
+    if (!offset.has_value() || !offset->is_valid() ||
+        !offset->type()->IsInt64() || offset->is_null() ||
+        offset->int64_value() < 0 ||
+        offset->int64_value() >
+            std::numeric_limits<int64_t>::max() - num_neighbors) {
+      return std::nullopt;
+    }
+    num_neighbors += offset->int64_value();
+  }
+
+  // Find the approximate distance the rows are ordered by, as in the queries
+  // accepted by ANNValidator.
+  if (!node->input_scan()->Is<zetasql::ResolvedOrderByScan>()) {
+    return std::nullopt;
+  }
+  const auto* order_by_scan =
+      node->input_scan()->GetAs<zetasql::ResolvedOrderByScan>();
+  if (order_by_scan->order_by_item_list_size() != 1 ||
+      !order_by_scan->input_scan()->Is<zetasql::ResolvedProjectScan>()) {
+    return std::nullopt;
+  }
+  const zetasql::ResolvedOrderByItem* order_by_item =
+      order_by_scan->order_by_item_list(0);
+  const auto* project_scan =
+      order_by_scan->input_scan()->GetAs<zetasql::ResolvedProjectScan>();
+  const zetasql::ResolvedFunctionCall* function_call = nullptr;
+  for (const auto& computed_column : project_scan->expr_list()) {
+    if (computed_column->column() == order_by_item->column_ref()->column() &&
+        computed_column->expr()->Is<zetasql::ResolvedFunctionCall>()) {
+      function_call =
+          computed_column->expr()->GetAs<zetasql::ResolvedFunctionCall>();
+    }
+  }
+  if (function_call == nullptr || function_call->argument_list_size() != 2) {
+    return std::nullopt;
+  }
+  std::optional<AnnIndex::Distance> distance =
+      GetApproxDistance(function_call->function()->Name());
+  if (!distance.has_value()) {
+    return std::nullopt;
+  }
+  // The nearest neighbors come first in ascending order of distance, but in
+  // descending order of dot product.
+  const bool descending = order_by_item->is_descending();
+  if (descending != (*distance == AnnIndex::Distance::kDotProduct)) {
+    return std::nullopt;
+  }
+
+  // Find the vector column and the constant query vector.
+  const zetasql::ResolvedExpr* column_arg = function_call->argument_list(0);
+  const zetasql::ResolvedExpr* query_arg = function_call->argument_list(1);
+  if (!column_arg->Is<zetasql::ResolvedColumnRef>()) {
+    std::swap(column_arg, query_arg);
+  }
+  if (!column_arg->Is<zetasql::ResolvedColumnRef>()) {
+    return std::nullopt;
+  }
+  const zetasql::ResolvedColumn& vector_column =
+      column_arg->GetAs<zetasql::ResolvedColumnRef>()->column();
+  std::optional<zetasql::Value> query = GetConstantValue(query_arg);
+  if (!query.has_value() || !query->is_valid() || !query->type()->IsArray() ||
+      query->is_null()) {
+    return std::nullopt;
+  }
+  std::vector<double> query_vector;
+  query_vector.reserve(query->num_elements());
+  for (const zetasql::Value& element : query->elements()) {
+    if (element.is_null() ||
+        (!element.type()->IsFloat() && !element.type()->IsDouble())) {
+      return std::nullopt;
+    }
+    query_vector.push_back(element.ToDouble());
+  }
+
+  // The vector index has no rows with NULL vectors. These come first unless
+  // the scan filters them out or orders them last, and no other filter may
+  // reject the nearest neighbors.
+  const zetasql::ResolvedScan* input_scan = project_scan->input_scan();
+  bool filters_nulls = false;
+  if (input_scan->Is<zetasql::ResolvedFilterScan>()) {
+    const auto* filter_scan = input_scan->GetAs<zetasql::ResolvedFilterScan>();
+    if (!OnlyFiltersNulls(filter_scan->filter_expr(), vector_column)) {
+      return std::nullopt;
+    }
+    filters_nulls = true;
+    input_scan = filter_scan->input_scan();
+  }
+  const auto null_order = order_by_item->null_order();
+  const bool nulls_first =
+      null_order == zetasql::ResolvedOrderByItemEnums::NULLS_FIRST ||
+      (!descending &&
+       null_order != zetasql::ResolvedOrderByItemEnums::NULLS_LAST);
+  if (nulls_first && !filters_nulls) {
+    return std::nullopt;
+  }
+  if (!input_scan->Is<zetasql::ResolvedTableScan>()) {
+    return std::nullopt;
+  }
+  *scan = input_scan->GetAs<zetasql::ResolvedTableScan>();
+  const auto* table = dynamic_cast<const QueryableTable*>((*scan)->table());
+  if (table == nullptr || HasCommitTimestampKey(table->wrapped_table())) {
+    return std::nullopt;
+  }
+
+  // Find the vector index of the column computing the same distance.
+  std::optional<int> column_index =
+      FindScannedColumnIndex(*scan, vector_column);
+  const Column* column = FindScannedColumn(*scan, table, vector_column);
+  if (!column_index.has_value() || column == nullptr) {
+    return std::nullopt;
+  }
+  for (const Index* index : table->wrapped_table()->indexes()) {
+    AnnIndex* ann_index = index->ann_index();
+    if (ann_index == nullptr || ann_index->distance() != *distance ||
+        index->key_columns()[0]->column()->source_column() != column) {
+      continue;
+    }
+    std::optional<std::vector<Key>> candidates =
+        ann_index->FindNeighborCandidates(query_vector, num_neighbors);
+    if (!candidates.has_value()) {
+      return std::nullopt;
+    }
+    // The candidates may include rows deleted or rewritten since the read
+    // timestamp of the query, or not yet visible to it. Scan the whole table
+    // unless enough of them can be returned.
+    std::optional<int64_t> num_rows =
+        CountNonNullValues(table, *column_index, *candidates);
+    if (!num_rows.has_value() || *num_rows < num_neighbors) {
+      return std::nullopt;
+    }
+    return candidates;
+  }
+  return std::nullopt;
+}
+
+void IndexScanRewriter::RestrictTableScan(
+    const zetasql::ResolvedTableScan* scan, const std::vector<Key>& keys) {
+  KeySet key_set;
+  for (const Key& key : keys) {
+    key_set.AddKey(key);
+  }
+  key_sets_[scan] = std::move(key_set);
+}
+
+absl::Status IndexScanRewriter::VisitResolvedFilterScan(
+    const zetasql::ResolvedFilterScan* node) {
+  if (node->input_scan()->Is<zetasql::ResolvedTableScan>()) {
+    const auto* scan = node->input_scan()->GetAs<zetasql::ResolvedTableScan>();
+    const auto* table = dynamic_cast<const QueryableTable*>(scan->table());
+    if (table != nullptr && !HasCommitTimestampKey(table->wrapped_table())) {
+      std::optional<std::vector<Key>> candidates =
+          FindCandidates(node->filter_expr(), scan, table);
+      if (candidates.has_value()) {
+        RestrictTableScan(scan, *candidates);
+      }
+    }
+  }
+  return CopyVisitResolvedFilterScan(node);
+}
+
+absl::Status IndexScanRewriter::VisitResolvedLimitOffsetScan(
+    const zetasql::ResolvedLimitOffsetScan* node) {
+  const zetasql::ResolvedTableScan* scan = nullptr;
+  std::optional<std::vector<Key>> candidates =
+      FindNeighborCandidates(node, &scan);
+  if (candidates.has_value()) {
+    RestrictTableScan(scan, *candidates);
+  }
+  return CopyVisitResolvedLimitOffsetScan(node);
+}
+
+absl::Status IndexScanRewriter::VisitResolvedTableScan(
+    const zetasql::ResolvedTableScan* node) {
+  ZETASQL_RETURN_IF_ERROR(CopyVisitResolvedTableScan(node));
+  auto it = key_sets_.find(node);
+  if (it == key_sets_.end()) {
+    return absl::OkStatus();
+  }
+  tables_.push_back(std::make_unique<KeyRestrictedTable>(
+      dynamic_cast<const QueryableTable*>(node->table()),
+      std::move(it->second)));
+  GetUnownedTopOfStack<zetasql::ResolvedTableScan>()->set_table(
+      tables_.back().get());
+  return absl::OkStatus();
+}
+
+}  // namespace backend
+}  // namespace emulator
+}  // namespace spanner
+}  // namespace google
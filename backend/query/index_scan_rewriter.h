@@ -0,0 +1,115 @@
+//
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_QUERY_INDEX_SCAN_REWRITER_H_
+#define THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_QUERY_INDEX_SCAN_REWRITER_H_
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "zetasql/public/catalog.h"
+#include "zetasql/public/evaluator.h"
+#include "zetasql/public/value.h"
+#include "zetasql/resolved_ast/resolved_ast.h"
+#include "zetasql/resolved_ast/resolved_ast_deep_copy_visitor.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "backend/datamodel/key.h"
+#include "backend/datamodel/key_set.h"
+#include "backend/query/queryable_table.h"
+
+namespace google {
+namespace spanner {
+namespace emulator {
+namespace backend {
+
+// Implements ResolvedASTDeepCopyVisitor to restrict table scans to the rows
+// found in the indexes of the scanned table:
+//
+// - Table scans filtered by SEARCH or SEARCH_NGRAMS on a column of a search
+//   index are restricted to the rows found in the posting lists of the index.
+//   The filter still evaluates the functions on each of these rows, and
+//   functions computed above the filter, such as SCORE_NGRAMS, are only
+//   computed on the rows which pass it.
+// - Table scans whose rows are ordered by an approximate distance, such as
+//   APPROX_COSINE_DISTANCE, to a constant vector and limited to the first k
+//   rows are restricted to the candidate nearest neighbors found in the vector
+//   index of the column. The distance is still computed on each of these rows
+//   to order them.
+//
+// The rewritten tree references tables owned by the rewriter, which must
+// outlive the evaluation of the tree.
+class IndexScanRewriter : public zetasql::ResolvedASTDeepCopyVisitor {
+ public:
+  explicit IndexScanRewriter(const zetasql::ParameterValueMap& params)
+      : params_(params) {}
+
+  absl::Status VisitResolvedFilterScan(
+      const zetasql::ResolvedFilterScan* node) override;
+
+  absl::Status VisitResolvedLimitOffsetScan(
+      const zetasql::ResolvedLimitOffsetScan* node) override;
+
+  absl::Status VisitResolvedTableScan(
+      const zetasql::ResolvedTableScan* node) override;
+
+ private:
+  // Returns the keys of the rows of `table` scanned by `scan` that may satisfy
+  // `expr`, or std::nullopt if the search indexes cannot narrow down the rows.
+  std::optional<std::vector<Key>> FindCandidates(
+      const zetasql::ResolvedExpr* expr, const zetasql::ResolvedTableScan* scan,
+      const QueryableTable* table) const;
+
+  // Returns the keys of the rows of `table` scanned by `scan` for which
+  // `function_call`, a call to SEARCH or SEARCH_NGRAMS, may be TRUE.
+  std::optional<std::vector<Key>> FindFunctionCandidates(
+      const zetasql::ResolvedFunctionCall* function_call,
+      const zetasql::ResolvedTableScan* scan,
+      const QueryableTable* table) const;
+
+  // Returns the keys of the rows of the table scanned by `*scan` that may be
+  // among the first rows returned by `node`, a scan limiting the rows ordered
+  // by an approximate distance, or std::nullopt if the vector indexes cannot
+  // narrow down the rows, including when fewer of the candidates than the
+  // rows to return exist with a vector.
+  std::optional<std::vector<Key>> FindNeighborCandidates(
+      const zetasql::ResolvedLimitOffsetScan* node,
+      const zetasql::ResolvedTableScan** scan) const;
+
+  // Restricts `scan` to the rows with `keys`.
+  void RestrictTableScan(const zetasql::ResolvedTableScan* scan,
+                         const std::vector<Key>& keys);
+
+  // Returns the value of `expr` if it is a literal or a query parameter.
+  std::optional<zetasql::Value> GetConstantValue(
+      const zetasql::ResolvedExpr* expr) const;
+
+  const zetasql::ParameterValueMap& params_;
+
+  // The keys to read for the table scans to restrict.
+  absl::flat_hash_map<const zetasql::ResolvedTableScan*, KeySet> key_sets_;
+
+  // The tables read by the restricted table scans.
+  std::vector<std::unique_ptr<const zetasql::Table>> tables_;
+};
+
+}  // namespace backend
+}  // namespace emulator
+}  // namespace spanner
+}  // namespace google
+
+#endif  // THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_QUERY_INDEX_SCAN_REWRITER_H_
@@ -151,6 +151,7 @@ static constexpr char kIsNullFiltered[] = "IS_NULL_FILTERED";
 static constexpr char kIndexState[] = "INDEX_STATE";
 static constexpr char kSpannerIsManaged[] = "SPANNER_IS_MANAGED";
 static constexpr char kReadWrite[] = "READ_WRITE";
+static constexpr char kWriteOnly[] = "WRITE_ONLY";
 static constexpr char kColumnOrdering[] = "COLUMN_ORDERING";
 static constexpr char kConstraintCatalog[] = "CONSTRAINT_CATALOG";
 static constexpr char kConstraintSchema[] = "CONSTRAINT_SCHEMA";
@@ -1157,7 +1158,7 @@ void InformationSchemaCatalog::FillIndexesTable() {
           // is_null_filtered
           DialectBoolValue(index->is_null_filtered()),
           // index_state
-          String(kReadWrite),
+          String(index->is_write_only() ? kWriteOnly : kReadWrite),
           // spanner_is_managed
           DialectBoolValue(index->is_managed()),
       });
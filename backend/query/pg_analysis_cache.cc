@@ -0,0 +1,192 @@
+//
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "backend/query/pg_analysis_cache.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "zetasql/base/logging.h"
+#include "zetasql/public/analyzer_options.h"
+#include "zetasql/public/analyzer_output.h"
+#include "zetasql/public/analyzer_output_properties.h"
+#include "zetasql/public/catalog.h"
+#include "zetasql/public/type.h"
+#include "zetasql/public/types/type_factory.h"
+#include "zetasql/resolved_ast/resolved_ast.h"
+#include "zetasql/resolved_ast/resolved_node.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "backend/schema/catalog/schema.h"
+#include "common/feature_flags.h"
+#include "farmhash.h"
+#include "third_party/spanner_pg/datatypes/extended/spanner_extended_type_deserializer.h"
+#include "zetasql/base/ret_check.h"
+#include "zetasql/base/status_macros.h"
+
+namespace google {
+namespace spanner {
+namespace emulator {
+namespace backend {
+
+namespace {
+
+// Returns the cache key for a statement. Besides the schema and the declared
+// parameter types, the default time zone (used to fold TIMESTAMPTZ literals)
+// and column pruning change the resolved AST that is produced, and feature
+// flags enable or disable parts of the supported SQL.
+std::string CacheKey(absl::string_view sql, const Schema* schema,
+                     const zetasql::AnalyzerOptions& options) {
+  using Flags = EmulatorFeatureFlags::Flags;
+  static_assert(std::is_trivially_copyable_v<Flags>);
+  const Flags flags = EmulatorFeatureFlags::instance().flags();
+  const uint64_t flags_fingerprint = farmhash::Fingerprint64(
+      reinterpret_cast<const char*>(&flags), sizeof(flags));
+  std::string key =
+      absl::StrCat(absl::Hex(schema), ":", flags_fingerprint, ":",
+                   options.default_time_zone().name(), ":",
+                   options.prune_unused_columns(), ":");
+  for (const auto& [name, type] : options.query_parameters()) {
+    absl::StrAppend(&key, name, "=", type->DebugString(), ",");
+  }
+  absl::StrAppend(&key, ":", sql);
+  return key;
+}
+
+}  // namespace
+
+absl::StatusOr<std::unique_ptr<const zetasql::AnalyzerOutput>>
+PGAnalysisCache::GetOrAnalyze(absl::string_view sql, const Schema* schema,
+                              const zetasql::AnalyzerOptions& options,
+                              zetasql::Catalog* catalog,
+                              zetasql::TypeFactory* type_factory,
+                              const AnalyzeFn& analyze_fn) {
+  std::string key = CacheKey(sql, schema, options);
+  bool known = false;
+  std::shared_ptr<const Entry> entry;
+  {
+    absl::MutexLock lock(&mu_);
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+      known = true;
+      entry = it->second;
+    }
+    if (entry != nullptr) {
+      ++hits_;
+    } else {
+      ++misses_;
+    }
+  }
+
+  if (entry != nullptr) {
+    absl::StatusOr<std::unique_ptr<const zetasql::AnalyzerOutput>> output =
+        Restore(*entry, options, catalog, type_factory);
+    if (output.ok()) {
+      return output;
+    }
+    ZETASQL_VLOG(1) << "Failed to restore cached PostgreSQL statement: "
+            << output.status();
+    known = false;
+  }
+
+  // Analyze outside of the lock so that concurrent misses don't serialize.
+  ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<const zetasql::AnalyzerOutput> output,
+                   analyze_fn());
+  if (known) {
+    return output;
+  }
+  absl::StatusOr<std::shared_ptr<const Entry>> saved = Save(*output);
+  if (!saved.ok()) {
+    ZETASQL_VLOG(1) << "PostgreSQL statement is not cacheable: " << saved.status();
+  }
+  absl::MutexLock lock(&mu_);
+  if (entries_.size() >= max_entries_) {
+    entries_.clear();
+  }
+  entries_.insert_or_assign(std::move(key),
+                            saved.ok() ? *std::move(saved) : nullptr);
+  return output;
+}
+
+absl::StatusOr<std::shared_ptr<const PGAnalysisCache::Entry>>
+PGAnalysisCache::Save(const zetasql::AnalyzerOutput& output) {
+  ZETASQL_RET_CHECK_NE(output.resolved_statement(), nullptr);
+  auto entry = std::make_shared<Entry>();
+  zetasql::FileDescriptorSetMap file_descriptor_set_map;
+  ZETASQL_RETURN_IF_ERROR(output.resolved_statement()->SaveTo(
+      &file_descriptor_set_map, &entry->statement));
+  // PostgreSQL-dialect statements don't use proto types. Supporting them would
+  // mean keeping their descriptor pools alive for restoring.
+  if (!file_descriptor_set_map.empty()) {
+    return absl::UnimplementedError(
+        "statements using proto types are not cached");
+  }
+  entry->undeclared_parameters = output.undeclared_parameters();
+  entry->max_column_id = output.max_column_id();
+  return entry;
+}
+
+absl::StatusOr<std::unique_ptr<const zetasql::AnalyzerOutput>>
+PGAnalysisCache::Restore(const Entry& entry,
+                         const zetasql::AnalyzerOptions& options,
+                         zetasql::Catalog* catalog,
+                         zetasql::TypeFactory* type_factory) {
+  static const auto* extended_type_deserializer =
+      new postgres_translator::spangres::datatypes::
+          SpannerExtendedTypeDeserializer();
+  ZETASQL_RET_CHECK_NE(options.id_string_pool(), nullptr);
+  zetasql::ResolvedNode::RestoreParams params(
+      /*pools=*/{}, catalog, type_factory, options.id_string_pool().get(),
+      extended_type_deserializer);
+  ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<zetasql::ResolvedStatement> statement,
+                   zetasql::ResolvedStatement::RestoreFrom(entry.statement,
+                                                             params));
+  return std::make_unique<const zetasql::AnalyzerOutput>(
+      options.id_string_pool(), options.arena(), std::move(statement),
+      zetasql::AnalyzerOutputProperties(),
+      /*parser_output=*/nullptr,
+      /*deprecation_warnings=*/std::vector<absl::Status>(),
+      entry.undeclared_parameters,
+      /*undeclared_positional_parameters=*/
+      std::vector<const zetasql::Type*>(), entry.max_column_id);
+}
+
+void PGAnalysisCache::Clear() {
+  absl::MutexLock lock(&mu_);
+  entries_.clear();
+}
+
+int64_t PGAnalysisCache::hits() const {
+  absl::MutexLock lock(&mu_);
+  return hits_;
+}
+
+int64_t PGAnalysisCache::misses() const {
+  absl::MutexLock lock(&mu_);
+  return misses_;
+}
+
+}  // namespace backend
+}  // namespace emulator
+}  // namespace spanner
+}  // namespace google
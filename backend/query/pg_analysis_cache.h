@@ -0,0 +1,123 @@
+//
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_QUERY_PG_ANALYSIS_CACHE_H_
+#define THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_QUERY_PG_ANALYSIS_CACHE_H_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "zetasql/public/analyzer_options.h"
+#include "zetasql/public/analyzer_output.h"
+#include "zetasql/public/catalog.h"
+#include "zetasql/public/types/type_factory.h"
+#include "zetasql/resolved_ast/serialization.pb.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "backend/schema/catalog/schema.h"
+
+namespace google {
+namespace spanner {
+namespace emulator {
+namespace backend {
+
+// PGAnalysisCache caches the ZetaSQL resolved AST that the PostgreSQL parser,
+// analyzer and forward transformer produce for a PostgreSQL-dialect statement,
+// so that statements repeated byte-for-byte, as is typical of ORM traffic, skip
+// the PostgreSQL pipeline.
+//
+// A resolved AST points to the tables, columns and functions of the catalog it
+// was analyzed against, and that catalog is built per request. Entries thus
+// hold the serialized statement, which is restored against the catalog of the
+// request that hits it. Statements that cannot be serialized or restored are
+// remembered and always analyzed.
+//
+// Entries are keyed by the statement text, the schema, the declared parameter
+// types, the analyzer options that change the output and the emulator feature
+// flags. Schemas are identified by address: a database keeps every version of
+// its schema for its lifetime, so one cache must only be used with the schemas
+// of one database. The PostgreSQL bootstrap catalog is compiled into the
+// binary, so it cannot change under this in-memory cache.
+//
+// This class is thread safe.
+class PGAnalysisCache {
+ public:
+  using AnalyzeFn = std::function<
+      absl::StatusOr<std::unique_ptr<const zetasql::AnalyzerOutput>>()>;
+
+  // Default maximum number of cached statements per database.
+  static constexpr int kDefaultMaxEntries = 1000;
+
+  explicit PGAnalysisCache(int max_entries = kDefaultMaxEntries)
+      : max_entries_(max_entries) {}
+
+  // Returns the analyzer output for `sql` in `schema`, restored against
+  // `catalog` and `type_factory` using the id string pool and arena of
+  // `options`. On a miss, calls `analyze_fn` to run the PostgreSQL pipeline
+  // and caches its output if that succeeded.
+  absl::StatusOr<std::unique_ptr<const zetasql::AnalyzerOutput>> GetOrAnalyze(
+      absl::string_view sql, const Schema* schema,
+      const zetasql::AnalyzerOptions& options, zetasql::Catalog* catalog,
+      zetasql::TypeFactory* type_factory, const AnalyzeFn& analyze_fn)
+      ABSL_LOCKS_EXCLUDED(mu_);
+
+  // Removes all cached statements.
+  void Clear() ABSL_LOCKS_EXCLUDED(mu_);
+
+  // Number of lookups served from and missed by the cache.
+  int64_t hits() const ABSL_LOCKS_EXCLUDED(mu_);
+  int64_t misses() const ABSL_LOCKS_EXCLUDED(mu_);
+
+ private:
+  struct Entry {
+    zetasql::AnyResolvedStatementProto statement;
+    zetasql::QueryParametersMap undeclared_parameters;
+    int max_column_id = 0;
+  };
+
+  // Serializes `output`. Fails if it could not be restored later on.
+  static absl::StatusOr<std::shared_ptr<const Entry>> Save(
+      const zetasql::AnalyzerOutput& output);
+
+  // Restores the analyzer output held by `entry`.
+  static absl::StatusOr<std::unique_ptr<const zetasql::AnalyzerOutput>>
+  Restore(const Entry& entry, const zetasql::AnalyzerOptions& options,
+          zetasql::Catalog* catalog, zetasql::TypeFactory* type_factory);
+
+  // Maximum number of cached statements. The cache is cleared when full.
+  const int max_entries_;
+
+  // Cached statements. A null entry marks a statement that is not cacheable.
+  absl::flat_hash_map<std::string, std::shared_ptr<const Entry>> entries_
+      ABSL_GUARDED_BY(mu_);
+
+  int64_t hits_ ABSL_GUARDED_BY(mu_) = 0;
+  int64_t misses_ ABSL_GUARDED_BY(mu_) = 0;
+
+  mutable absl::Mutex mu_;
+};
+
+}  // namespace backend
+}  // namespace emulator
+}  // namespace spanner
+}  // namespace google
+
+#endif  // THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_QUERY_PG_ANALYSIS_CACHE_H_
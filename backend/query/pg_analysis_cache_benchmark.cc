@@ -0,0 +1,166 @@
+//
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Measures the throughput of translating a repeated PostgreSQL-dialect
+// statement with and without the PGAnalysisCache.
+//
+// Usage:
+//   bazel run -c opt //backend/query:pg_analysis_cache_benchmark -- \
+//     --iterations=10000
+
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <string>
+
+#include "google/spanner/admin/database/v1/common.pb.h"
+#include "zetasql/public/analyzer_options.h"
+#include "zetasql/public/analyzer_output.h"
+#include "zetasql/public/types/type_factory.h"
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "backend/query/analyzer_options.h"
+#include "backend/query/catalog.h"
+#include "backend/query/function_catalog.h"
+#include "backend/query/pg_analysis_cache.h"
+#include "backend/schema/catalog/schema.h"
+#include "common/constants.h"
+#include "tests/common/schema_constructor.h"
+#include "third_party/spanner_pg/interface/emulator_parser.h"
+#include "third_party/spanner_pg/interface/pg_arena.h"
+#include "third_party/spanner_pg/shims/memory_context_pg_arena.h"
+#include "zetasql/base/status_macros.h"
+
+ABSL_FLAG(int64_t, iterations, 2000,
+          "Number of times each statement is translated.");
+
+namespace google {
+namespace spanner {
+namespace emulator {
+namespace backend {
+namespace {
+
+namespace database_api = ::google::spanner::admin::database::v1;
+
+constexpr const char* kStatements[] = {
+    "SELECT int64_col, string_col FROM test_table WHERE int64_col = $1",
+    "SELECT COUNT(*) FROM test_table WHERE string_col LIKE 'a%'",
+    "UPDATE test_table SET string_col = $2 WHERE int64_col = $1",
+};
+
+class Translator {
+ public:
+  Translator()
+      : options_(MakeGoogleSqlAnalyzerOptions(kDefaultTimeZone)),
+        function_catalog_(&type_factory_),
+        schema_(test::CreateSchemaWithOneTable(
+            &type_factory_, database_api::DatabaseDialect::POSTGRESQL)),
+        catalog_(schema_.get(), &function_catalog_, &type_factory_,
+                 options_) {
+    options_.CreateDefaultArenasIfNotSet();
+  }
+
+  // Declares the parameters used by the statements.
+  absl::Status Init() {
+    ZETASQL_RETURN_IF_ERROR(
+        options_.AddQueryParameter("p1", type_factory_.get_int64()));
+    return options_.AddQueryParameter("p2", type_factory_.get_string());
+  }
+
+  absl::StatusOr<std::unique_ptr<const zetasql::AnalyzerOutput>> Translate(
+      const std::string& sql) {
+    ZETASQL_ASSIGN_OR_RETURN(
+        std::unique_ptr<postgres_translator::interfaces::PGArena> arena,
+        postgres_translator::spangres::MemoryContextPGArena::Init(nullptr));
+    return postgres_translator::spangres::ParseAndAnalyzePostgreSQL(
+        sql, &catalog_, options_, &type_factory_,
+        std::make_unique<FunctionCatalog>(&type_factory_));
+  }
+
+  absl::StatusOr<std::unique_ptr<const zetasql::AnalyzerOutput>>
+  TranslateCached(const std::string& sql) {
+    return cache_.GetOrAnalyze(sql, schema_.get(), options_, &catalog_,
+                               &type_factory_,
+                               [&]() { return Translate(sql); });
+  }
+
+  const PGAnalysisCache& cache() const { return cache_; }
+
+ private:
+  zetasql::TypeFactory type_factory_;
+  zetasql::AnalyzerOptions options_;
+  const FunctionCatalog function_catalog_;
+  std::unique_ptr<const Schema> schema_;
+  Catalog catalog_;
+  PGAnalysisCache cache_;
+};
+
+// Translates every statement `iterations` times and prints the throughput.
+template <typename TranslateFn>
+absl::Status Run(const std::string& name, int64_t iterations,
+                 TranslateFn translate) {
+  const absl::Time start = absl::Now();
+  for (int64_t i = 0; i < iterations; ++i) {
+    for (const char* sql : kStatements) {
+      ZETASQL_RETURN_IF_ERROR(translate(sql).status());
+    }
+  }
+  const absl::Duration elapsed = absl::Now() - start;
+  const int64_t statements = iterations * std::size(kStatements);
+  std::cout << absl::StrFormat(
+      "%-10s %8d statements in %10s: %10.0f statements/s\n", name, statements,
+      absl::FormatDuration(elapsed),
+      statements / absl::ToDoubleSeconds(elapsed));
+  return absl::OkStatus();
+}
+
+absl::Status RunBenchmark(int64_t iterations) {
+  Translator translator;
+  ZETASQL_RETURN_IF_ERROR(translator.Init());
+  ZETASQL_RETURN_IF_ERROR(
+      Run("uncached", iterations,
+          [&](const std::string& sql) { return translator.Translate(sql); }));
+  ZETASQL_RETURN_IF_ERROR(Run("cached", iterations, [&](const std::string& sql) {
+        return translator.TranslateCached(sql);
+      }));
+  std::cout << absl::StrFormat("cache hits: %d, misses: %d\n",
+                               translator.cache().hits(),
+                               translator.cache().misses());
+  return absl::OkStatus();
+}
+
+}  // namespace
+}  // namespace backend
+}  // namespace emulator
+}  // namespace spanner
+}  // namespace google
+
+int main(int argc, char* argv[]) {
+  absl::ParseCommandLine(argc, argv);
+  absl::Status status = google::spanner::emulator::backend::RunBenchmark(
+      absl::GetFlag(FLAGS_iterations));
+  if (!status.ok()) {
+    std::cerr << status << std::endl;
+    return 1;
+  }
+  return 0;
+}
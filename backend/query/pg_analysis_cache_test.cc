@@ -0,0 +1,164 @@
+//
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "backend/query/pg_analysis_cache.h"
+
+#include <memory>
+#include <string>
+
+#include "google/spanner/admin/database/v1/common.pb.h"
+#include "zetasql/public/analyzer_options.h"
+#include "zetasql/public/analyzer_output.h"
+#include "zetasql/public/types/type_factory.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "zetasql/base/testing/status_matchers.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "backend/query/analyzer_options.h"
+#include "backend/query/catalog.h"
+#include "backend/query/function_catalog.h"
+#include "backend/schema/catalog/schema.h"
+#include "common/constants.h"
+#include "tests/common/schema_constructor.h"
+#include "third_party/spanner_pg/interface/emulator_parser.h"
+#include "third_party/spanner_pg/interface/pg_arena.h"
+#include "third_party/spanner_pg/shims/memory_context_pg_arena.h"
+#include "zetasql/base/status_macros.h"
+
+namespace google {
+namespace spanner {
+namespace emulator {
+namespace backend {
+namespace {
+
+namespace database_api = ::google::spanner::admin::database::v1;
+
+class PGAnalysisCacheTest : public testing::Test {
+ public:
+  PGAnalysisCacheTest()
+      : analyzer_options_(MakeGoogleSqlAnalyzerOptions(kDefaultTimeZone)),
+        fn_catalog_(&type_factory_),
+        schema_(test::CreateSchemaWithOneTable(
+            &type_factory_, database_api::DatabaseDialect::POSTGRESQL)),
+        catalog_(std::make_unique<Catalog>(
+            schema_.get(), &fn_catalog_, &type_factory_, analyzer_options_)) {
+    analyzer_options_.CreateDefaultArenasIfNotSet();
+  }
+
+ protected:
+  // Analyzes `sql` through `cache`, counting the PostgreSQL analyses.
+  absl::StatusOr<std::unique_ptr<const zetasql::AnalyzerOutput>> Analyze(
+      PGAnalysisCache& cache, const std::string& sql,
+      const Schema* schema = nullptr) {
+    return cache.GetOrAnalyze(
+        sql, schema == nullptr ? schema_.get() : schema, analyzer_options_,
+        catalog_.get(), &type_factory_,
+        [&]() -> absl::StatusOr<
+                  std::unique_ptr<const zetasql::AnalyzerOutput>> {
+          ++num_analyses_;
+          ZETASQL_ASSIGN_OR_RETURN(
+              std::unique_ptr<postgres_translator::interfaces::PGArena> arena,
+              postgres_translator::spangres::MemoryContextPGArena::Init(
+                  nullptr));
+          return postgres_translator::spangres::ParseAndAnalyzePostgreSQL(
+              sql, catalog_.get(), analyzer_options_, &type_factory_,
+              std::make_unique<FunctionCatalog>(&type_factory_));
+        });
+  }
+
+  zetasql::TypeFactory type_factory_;
+
+  zetasql::AnalyzerOptions analyzer_options_;
+
+  const FunctionCatalog fn_catalog_;
+
+  std::unique_ptr<const Schema> schema_;
+
+  std::unique_ptr<Catalog> catalog_;
+
+  int num_analyses_ = 0;
+};
+
+TEST_F(PGAnalysisCacheTest, RestoresCachedStatement) {
+  PGAnalysisCache cache;
+  const std::string sql =
+      "SELECT int64_col, string_col FROM test_table WHERE int64_col > 1";
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto analyzed, Analyze(cache, sql));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto restored, Analyze(cache, sql));
+
+  EXPECT_EQ(num_analyses_, 1);
+  EXPECT_EQ(cache.hits(), 1);
+  EXPECT_EQ(cache.misses(), 1);
+  EXPECT_EQ(restored->resolved_statement()->DebugString(),
+            analyzed->resolved_statement()->DebugString());
+  EXPECT_EQ(restored->max_column_id(), analyzed->max_column_id());
+}
+
+TEST_F(PGAnalysisCacheTest, KeysOnSchema) {
+  PGAnalysisCache cache;
+  std::unique_ptr<const Schema> other_schema = test::CreateSchemaWithOneTable(
+      &type_factory_, database_api::DatabaseDialect::POSTGRESQL);
+  ZETASQL_ASSERT_OK(Analyze(cache, "SELECT int64_col FROM test_table"));
+  ZETASQL_ASSERT_OK(Analyze(cache, "SELECT int64_col FROM test_table",
+                    other_schema.get()));
+
+  EXPECT_EQ(num_analyses_, 2);
+  EXPECT_EQ(cache.hits(), 0);
+}
+
+TEST_F(PGAnalysisCacheTest, KeysOnParameterTypes) {
+  PGAnalysisCache cache;
+  const std::string sql = "SELECT $1";
+  ZETASQL_ASSERT_OK(
+      analyzer_options_.AddQueryParameter("p1", type_factory_.get_int64()));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto int64_output, Analyze(cache, sql));
+
+  analyzer_options_.clear_query_parameters();
+  ZETASQL_ASSERT_OK(
+      analyzer_options_.AddQueryParameter("p1", type_factory_.get_string()));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto string_output, Analyze(cache, sql));
+
+  EXPECT_EQ(num_analyses_, 2);
+  EXPECT_NE(string_output->resolved_statement()->DebugString(),
+            int64_output->resolved_statement()->DebugString());
+}
+
+TEST_F(PGAnalysisCacheTest, DoesNotCacheErrors) {
+  PGAnalysisCache cache;
+  EXPECT_FALSE(Analyze(cache, "SELECT missing_col FROM test_table").ok());
+  EXPECT_FALSE(Analyze(cache, "SELECT missing_col FROM test_table").ok());
+
+  EXPECT_EQ(num_analyses_, 2);
+  EXPECT_EQ(cache.hits(), 0);
+}
+
+TEST_F(PGAnalysisCacheTest, ClearsWhenFull) {
+  PGAnalysisCache cache(/*max_entries=*/1);
+  ZETASQL_ASSERT_OK(Analyze(cache, "SELECT 1"));
+  ZETASQL_ASSERT_OK(Analyze(cache, "SELECT 2"));
+  ZETASQL_ASSERT_OK(Analyze(cache, "SELECT 2"));
+  ZETASQL_ASSERT_OK(Analyze(cache, "SELECT 1"));
+
+  EXPECT_EQ(num_analyses_, 3);
+  EXPECT_EQ(cache.hits(), 1);
+}
+
+}  // namespace
+}  // namespace backend
+}  // namespace emulator
+}  // namespace spanner
+}  // namespace google
@@ -71,8 +71,10 @@
 #include "backend/query/function_catalog.h"
 #include "backend/query/hint_rewriter.h"
 #include "backend/query/index_hint_validator.h"
+#include "backend/query/index_scan_rewriter.h"
 #include "backend/query/partitionability_validator.h"
 #include "backend/query/partitioned_dml_validator.h"
+#include "backend/query/pg_analysis_cache.h"
 #include "backend/query/query_context.h"
 #include "backend/query/query_engine_options.h"
 #include "backend/query/query_validator.h"
@@ -194,26 +196,36 @@ absl::StatusOr<std::unique_ptr<const zetasql::AnalyzerOutput>>
 AnalyzePostgreSQL(const std::string& sql, zetasql::EnumerableCatalog* catalog,
                   zetasql::AnalyzerOptions& options,
                   zetasql::TypeFactory* type_factory,
-                  const FunctionCatalog* function_catalog) {
+                  const FunctionCatalog* function_catalog,
+                  const Schema* schema = nullptr,
+                  PGAnalysisCache* cache = nullptr) {
   // Check the overall length of the query string.
   if (sql.size() > limits::kMaxQueryStringSize) {
     return error::QueryStringTooLong(sql.size(), limits::kMaxQueryStringSize);
   }
 
   options.CreateDefaultArenasIfNotSet();
-  ZETASQL_ASSIGN_OR_RETURN(
-      std::unique_ptr<postgres_translator::interfaces::PGArena> arena,
-      postgres_translator::spangres::MemoryContextPGArena::Init(nullptr));
   // PG needs ASC NULLS LAST and DESC NULLS FIRST for functions implemented as
   // a SQL rewrite.
   options.mutable_language()->EnableLanguageFeature(
       zetasql::FEATURE_V_1_3_NULLS_FIRST_LAST_IN_ORDER_BY);
-  return postgres_translator::spangres::ParseAndAnalyzePostgreSQL(
-      sql, catalog, options, type_factory,
-      std::make_unique<FunctionCatalog>(
-          type_factory,
-          /*catalog_name=*/kCloudSpannerEmulatorFunctionCatalogName,
-          /*schema=*/function_catalog->GetLatestSchema()));
+  auto analyze = [&]()
+      -> absl::StatusOr<std::unique_ptr<const zetasql::AnalyzerOutput>> {
+    ZETASQL_ASSIGN_OR_RETURN(
+        std::unique_ptr<postgres_translator::interfaces::PGArena> arena,
+        postgres_translator::spangres::MemoryContextPGArena::Init(nullptr));
+    return postgres_translator::spangres::ParseAndAnalyzePostgreSQL(
+        sql, catalog, options, type_factory,
+        std::make_unique<FunctionCatalog>(
+            type_factory,
+            /*catalog_name=*/kCloudSpannerEmulatorFunctionCatalogName,
+            /*schema=*/function_catalog->GetLatestSchema()));
+  };
+  if (cache == nullptr || schema == nullptr) {
+    return analyze();
+  }
+  return cache->GetOrAnalyze(sql, schema, options, catalog, type_factory,
+                             analyze);
 }
 
 // TODO : Replace with a better error transforming mechanism,
@@ -709,6 +721,19 @@ absl::StatusOr<std::unique_ptr<RowCursor>> EvaluateQuery(
   ZETASQL_RET_CHECK_EQ(resolved_statement->node_kind(), zetasql::RESOLVED_QUERY_STMT)
       << "input is not a query statement";
 
+  // Restrict the scans filtered by SEARCH, or ordered by an approximate vector
+  // distance, to the rows found in search and vector indexes. The rewriter
+  // owns the tables read by the rewritten statement.
+  IndexScanRewriter index_scan_rewriter(params);
+  std::unique_ptr<zetasql::ResolvedStatement> rewritten_statement;
+  if (query_mode != v1::ExecuteSqlRequest::PLAN) {
+    ZETASQL_RETURN_IF_ERROR(resolved_statement->Accept(&index_scan_rewriter));
+    ZETASQL_ASSIGN_OR_RETURN(
+        rewritten_statement,
+        index_scan_rewriter.ConsumeRootNode<zetasql::ResolvedStatement>());
+    resolved_statement = rewritten_statement.get();
+  }
+
   auto prepared_query = std::make_unique<zetasql::PreparedQuery>(
       resolved_statement->GetAs<zetasql::ResolvedQueryStmt>(),
       CommonEvaluatorOptions(type_factory, time_zone));
@@ -999,7 +1024,8 @@ absl::StatusOr<QueryResult> QueryEngine::ExecuteSql(
       !query.change_stream_internal_lookup.has_value()) {
     ZETASQL_ASSIGN_OR_RETURN(analyzer_output,
                      AnalyzePostgreSQL(query.sql, &catalog, analyzer_options,
-                                       type_factory_, &function_catalog_));
+                                       type_factory_, &function_catalog_,
+                                       context.schema, &pg_analysis_cache_));
 
   } else {
     ZETASQL_ASSIGN_OR_RETURN(analyzer_output, Analyze(query.sql, &catalog,
@@ -1041,7 +1067,8 @@ absl::StatusOr<QueryResult> QueryEngine::ExecuteSql(
         database_api::DatabaseDialect::POSTGRESQL) {
       ZETASQL_ASSIGN_OR_RETURN(analyzer_output,
                        AnalyzePostgreSQL(query.sql, &catalog, analyzer_options,
-                                         type_factory_, &function_catalog_));
+                                         type_factory_, &function_catalog_,
+                                         context.schema, &pg_analysis_cache_));
     } else {
       ZETASQL_ASSIGN_OR_RETURN(
           analyzer_output,
@@ -1125,7 +1152,8 @@ absl::Status QueryEngine::IsPartitionable(const Query& query,
   if (context.schema->dialect() == database_api::DatabaseDialect::POSTGRESQL) {
     ZETASQL_ASSIGN_OR_RETURN(analyzer_output,
                      AnalyzePostgreSQL(query.sql, &catalog, analyzer_options,
-                                       type_factory_, &function_catalog_));
+                                       type_factory_, &function_catalog_,
+                                       context.schema, &pg_analysis_cache_));
   } else {
     ZETASQL_ASSIGN_OR_RETURN(analyzer_output, Analyze(query.sql, &catalog,
                                               analyzer_options, type_factory_));
@@ -31,6 +31,7 @@
 #include "absl/status/statusor.h"
 #include "backend/query/change_stream/change_stream_query_validator.h"
 #include "backend/query/function_catalog.h"
+#include "backend/query/pg_analysis_cache.h"
 #include "backend/query/query_context.h"
 #include "backend/schema/catalog/schema.h"
 #include "absl/status/status.h"
@@ -135,6 +136,9 @@ class QueryEngine {
 
   zetasql::TypeFactory* type_factory_;
   FunctionCatalog function_catalog_;
+
+  // Translated PostgreSQL-dialect statements of this database.
+  mutable PGAnalysisCache pg_analysis_cache_;
 };
 
 }  // namespace backend
@@ -188,6 +188,12 @@ QueryableTable::QueryableTable(
 absl::StatusOr<std::unique_ptr<zetasql::EvaluatorTableIterator>>
 QueryableTable::CreateEvaluatorTableIterator(
     absl::Span<const int> column_idxs) const {
+  return CreateEvaluatorTableIteratorForKeys(column_idxs, KeySet::All());
+}
+
+absl::StatusOr<std::unique_ptr<zetasql::EvaluatorTableIterator>>
+QueryableTable::CreateEvaluatorTableIteratorForKeys(
+    absl::Span<const int> column_idxs, const KeySet& key_set) const {
   ZETASQL_RET_CHECK_NE(reader_, nullptr);
 
   std::vector<std::string> column_names;
@@ -197,7 +203,7 @@ QueryableTable::CreateEvaluatorTableIterator(
 
   ReadArg read_arg;
   read_arg.table = FullName();
-  read_arg.key_set = KeySet::All();
+  read_arg.key_set = key_set;
   read_arg.columns = column_names;
   // Pending commit timestamp restrictions for queries are implemented in
   // QueryValidator so we do not need enforcement during the read here.
@@ -27,6 +27,7 @@
 #include "absl/status/statusor.h"
 #include "absl/types/span.h"
 #include "backend/access/read.h"
+#include "backend/datamodel/key_set.h"
 #include "backend/query/queryable_column.h"
 #include "backend/schema/catalog/change_stream.h"
 #include "backend/schema/catalog/schema.h"
@@ -79,6 +80,12 @@ class QueryableTable : public zetasql::Table {
   CreateEvaluatorTableIterator(
       absl::Span<const int> column_idxs) const override;
 
+  // Same as CreateEvaluatorTableIterator, but only reads the rows of the table
+  // with keys in `key_set`.
+  absl::StatusOr<std::unique_ptr<zetasql::EvaluatorTableIterator>>
+  CreateEvaluatorTableIteratorForKeys(absl::Span<const int> column_idxs,
+                                      const KeySet& key_set) const;
+
  private:
   absl::StatusOr<std::unique_ptr<const zetasql::AnalyzerOutput>>
   AnalyzeColumnExpression(
@@ -16,6 +16,7 @@
 
 #include "backend/query/search/score_evaluator.h"
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -48,23 +49,24 @@ absl::StatusOr<zetasql::Value> ScoreEvaluator::Evaluate(
     return error::InvalidQueryType(query_string.type()->DebugString());
   }
 
-  TokenMap token_map;
-  bool source_is_null = false;
+  std::shared_ptr<const TokenMapCache::DecodedTokenList> decoded;
   if (!tokenlist.is_null()) {
-    ZETASQL_ASSIGN_OR_RETURN(token_map, SearchHelper::BuildTokenMap(tokenlist, "SCORE",
-                                                            source_is_null));
+    ZETASQL_ASSIGN_OR_RETURN(decoded,
+                     TokenMapCache::instance().GetOrBuild(tokenlist, "SCORE"));
   }
 
   double score = 0.0;
-  if (!source_is_null && !query_string.is_null()) {
+  if (decoded != nullptr && !decoded->source_is_null &&
+      !query_string.is_null()) {
     std::vector<std::string> terms =
         absl::StrSplit(query_string.string_value(), absl::ByAnyChar(kDelimiter),
                        absl::SkipWhitespace());
 
     for (const std::string& term : terms) {
       // Add the number of occurrences of each queried term in the tokenlist.
-      if (token_map.find(term) != token_map.end()) {
-        score += token_map[term].size();
+      auto it = decoded->token_map.find(term);
+      if (it != decoded->token_map.end()) {
+        score += it->second.size();
       }
     }
   }
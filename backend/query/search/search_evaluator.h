@@ -17,13 +17,9 @@
 #ifndef THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_QUERY_SEARCH_SEARCH_EVALUATOR_H_
 #define THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_QUERY_SEARCH_SEARCH_EVALUATOR_H_
 
-#include <vector>
-
 #include "zetasql/public/value.h"
 #include "absl/status/statusor.h"
 #include "absl/types/span.h"
-#include "backend/query/search/SimpleNode.h"
-#include "backend/query/search/search_evaluator_helpers.h"
 
 namespace google {
 namespace spanner {
@@ -33,33 +29,14 @@ namespace query {
 namespace search {
 
 // Evaluate the SEARCH(TOKENLIST, STRING) function. The STRING query will be
-// parsed into a evaluation tree. Then the tree will be traversed to evaluate
-// each of the sub query string is a match in the TOKENLIST. If TOKENLIST is
-// NULL, always return FALSE. If STRING query is NULL, always return TRUE.
+// parsed and compiled into a SearchQueryMatcher once per query string. Then
+// the matcher evaluates whether the query matches the tokens in the TOKENLIST,
+// which are decoded once per TOKENLIST value. If TOKENLIST is NULL, always
+// return FALSE. If STRING query is NULL, always return TRUE.
 class SearchEvaluator {
  public:
   static absl::StatusOr<zetasql::Value> Evaluate(
       absl::Span<const zetasql::Value> args);
-
- private:
-  // Default Around distance if it cannot be determined from user input.
-  static const int kDefaultMaxAllowedGap = 5;
-
-  // If the the node is a term, check if there are matches in the tokenmap.
-  // Return matched positions if there are matches and in_phrase is true. Or
-  // just return match if in_phrase is false. Otherwise, returns no match.
-  static absl::StatusOr<MatchResult> MatchQueryTerm(const SimpleNode* root,
-                                                    const TokenMap& tokenmap,
-                                                    bool in_phrase);
-
-  // Recursively check matches of each children.
-  static absl::StatusOr<std::vector<MatchResult>> MatchChildren(
-      const SimpleNode* root, const TokenMap& tokenmap, bool in_phrase);
-
-  // Evaluate if a given query node has matches in the given tokenmap.
-  static absl::StatusOr<MatchResult> MatchQueryNode(const SimpleNode* root,
-                                                    const TokenMap& tokenmap,
-                                                    bool in_phrase = false);
 };
 
 }  // namespace search
@@ -19,16 +19,21 @@
 #include <algorithm>
 #include <cstdint>
 #include <limits>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "zetasql/public/value.h"
 #include "absl/algorithm/container.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/numbers.h"
 #include "absl/strings/str_split.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
+#include "backend/query/search/SearchQueryParserTreeConstants.h"
 #include "backend/query/search/query_parser.h"
 #include "backend/query/search/tokenizer.h"
 #include "common/errors.h"
@@ -42,6 +47,26 @@ namespace backend {
 namespace query {
 namespace search {
 
+namespace {
+
+// Maximum total size of the token lists in the process-wide TokenMapCache.
+constexpr int64_t kMaxCachedTokenListBytes = 64 << 20;
+
+// Returns the estimated memory used by caching `decoded` under `bytes`.
+int64_t CachedTokenListBytes(const std::string& bytes,
+                             const TokenMapCache::DecodedTokenList& decoded) {
+  // The bytes are held both as the key of the cache and in its clock.
+  int64_t size = 2 * bytes.capacity() + sizeof(decoded) +
+                 decoded.token_map.capacity() *
+                     (sizeof(TokenMap::value_type) + sizeof(int8_t));
+  for (const auto& [token, positions] : decoded.token_map) {
+    size += token.capacity() + positions.capacity() * sizeof(int);
+  }
+  return size;
+}
+
+}  // namespace
+
 absl::StatusOr<TokenMap> SearchHelper::BuildTokenMap(
     const zetasql::Value& token_list, absl::string_view func_name,
     bool& source_is_null) {
@@ -81,18 +106,6 @@ absl::StatusOr<TokenMap> SearchHelper::BuildTokenMap(
   return token_map;
 }
 
-absl::StatusOr<SimpleNode*> SearchQueryCache::GetParsedQuery(
-    const std::string& query_string) {
-  if (query_cache_.find(query_string) == query_cache_.end()) {
-    QueryParser parser(query_string);
-    ZETASQL_RETURN_IF_ERROR(parser.ParseSearchQuery());
-
-    query_cache_[query_string] = std::move(parser.ReleaseTree());
-  }
-
-  return query_cache_[query_string].get();
-}
-
 MatchResult MatchResult::Match(std::vector<Hit> hits) {
   MatchResult match_result;
   match_result.result_ = SortedUnique(std::move(hits));
@@ -248,6 +261,278 @@ bool PhraseMatcher::CurrentMatchContainsOverlap() const {
   return false;
 }
 
+absl::StatusOr<SearchQueryMatcher> SearchQueryMatcher::Compile(
+    const SimpleNode* root) {
+  ZETASQL_RET_CHECK(root != nullptr);
+  ZETASQL_ASSIGN_OR_RETURN(Node compiled_root, CompileNode(root));
+  return SearchQueryMatcher(std::move(compiled_root));
+}
+
+absl::StatusOr<SearchQueryMatcher::Node> SearchQueryMatcher::CompileNode(
+    const SimpleNode* node) {
+  Node compiled;
+  compiled.id = node->getId();
+  compiled.is_wildcard = node->image() == "*";
+  switch (compiled.id) {
+    case JJTTERM:
+      compiled.term = node->image();
+      return compiled;
+    case JJTNOT:
+      ZETASQL_RET_CHECK_EQ(1, node->jjtGetNumChildren());
+      break;
+    case JJTOR:
+    case JJTAND:
+    case JJTAROUND:
+    case JJTPHRASE:
+      break;
+    default:
+      ZETASQL_RET_CHECK_FAIL() << "Bad query: unsupported search query node type "
+                       << compiled.id;
+  }
+
+  for (int i = 0; i < node->jjtGetNumChildren(); ++i) {
+    const SimpleNode* child =
+        dynamic_cast<const SimpleNode*>(node->jjtGetChild(i));
+    ZETASQL_RET_CHECK(child != nullptr);
+
+    if (child->getId() == JJTNUMBER) {
+      // Number nodes are used only as children of AROUND node for the
+      // distance.
+      int gap;
+      if (compiled.id == JJTAROUND && absl::SimpleAtoi(child->image(), &gap)) {
+        if (compiled.max_allowed_gap == -1) {
+          // First distance child
+          compiled.max_allowed_gap = gap;
+        } else if (gap != compiled.max_allowed_gap) {
+          // Multiple distance specified, drop them all but using the
+          // default distance 5
+          compiled.max_allowed_gap = kDefaultMaxAllowedGap;
+        }
+      }
+      continue;
+    }
+    ZETASQL_ASSIGN_OR_RETURN(Node compiled_child, CompileNode(child));
+    compiled.children.push_back(std::move(compiled_child));
+  }
+
+  if (compiled.id == JJTPHRASE) {
+    // In phrases, wildcards increments the next offset, rather than being
+    // matched directly. Offsets before the first non-wildcard term have no
+    // effect. exterior_gaps indicates the gaps (denoted by wildcards) before
+    // and after literal terms. e.g. "* cloud spanner *" has exterior_gaps of
+    // (1, 1).
+    int current_offset = 0;
+    for (const Node& child : compiled.children) {
+      if (!child.is_wildcard) {
+        if (compiled.offsets.empty()) {
+          compiled.exterior_gaps.first = current_offset;
+        }
+        compiled.offsets.push_back(current_offset);
+      }
+      ++current_offset;
+    }
+    // current_offset is incremented after each term, so we need to subtract
+    // 1 from the difference to find the number of star terms after the last
+    // non-star term.
+    compiled.exterior_gaps.second =
+        compiled.offsets.empty()
+            ? 0
+            : current_offset - compiled.offsets.back() - 1;
+  }
+  return compiled;
+}
+
+absl::StatusOr<bool> SearchQueryMatcher::Matches(
+    const TokenMap& token_map) const {
+  ZETASQL_ASSIGN_OR_RETURN(MatchResult match_result,
+                   MatchNode(root_, token_map, /*in_phrase=*/false));
+  return match_result.is_match();
+}
+
+absl::StatusOr<MatchResult> SearchQueryMatcher::MatchNode(
+    const Node& node, const TokenMap& token_map, bool in_phrase) {
+  switch (node.id) {
+    case JJTTERM: {
+      auto it = token_map.find(node.term);
+      if (it == token_map.end()) {
+        return MatchResult::NoMatch();
+      }
+      if (!in_phrase) {
+        // No position info is needed if not in phrase.
+        return MatchResult::Match();
+      }
+      std::vector<Hit> hits;
+      hits.reserve(it->second.size());
+      for (int pos : it->second) {
+        hits.push_back({pos, 1});
+      }
+      return MatchResult::Match(std::move(hits));
+    }
+    case JJTOR: {
+      bool did_match = false;
+      std::vector<Hit> hits;
+      for (const Node& child : node.children) {
+        ZETASQL_ASSIGN_OR_RETURN(MatchResult result,
+                         MatchNode(child, token_map, in_phrase));
+        if (!result.is_match()) continue;
+        if (in_phrase) {
+          hits.insert(hits.end(), result.hits().begin(), result.hits().end());
+        }
+        did_match = true;
+      }
+      if (!did_match) return MatchResult::NoMatch();
+      return MatchResult::Match(std::move(hits));
+    }
+    case JJTNOT: {
+      // NOT cannot appear in a phrase, so we never need to report hit position.
+      ZETASQL_RET_CHECK(!in_phrase) << "NOT nodes cannot appear in phrases";
+      ZETASQL_ASSIGN_OR_RETURN(MatchResult child_matches,
+                       MatchNode(node.children[0], token_map,
+                                 /*in_phrase=*/false));
+      if (child_matches.is_match()) return MatchResult::NoMatch();
+      return MatchResult::Match();
+    }
+    case JJTAND: {
+      // AND cannot appear in a phrase, so there is no need to report hit
+      // positions.
+      ZETASQL_RET_CHECK(!in_phrase) << "AND nodes cannot appear in phrases";
+      bool did_match = true;
+      for (const Node& child : node.children) {
+        ZETASQL_ASSIGN_OR_RETURN(MatchResult result,
+                         MatchNode(child, token_map, in_phrase));
+        did_match = did_match && result.is_match();
+      }
+      if (!did_match) return MatchResult::NoMatch();
+      return MatchResult::Match();
+    }
+    case JJTAROUND:
+    case JJTPHRASE: {
+      // All non-wildcard children must match. No need to record wildcard
+      // positions.
+      bool did_match = true;
+      std::vector<std::vector<Hit>> hits;
+      hits.reserve(node.children.size());
+      for (const Node& child : node.children) {
+        if (child.is_wildcard) continue;
+        ZETASQL_ASSIGN_OR_RETURN(MatchResult result,
+                         MatchNode(child, token_map, /*in_phrase=*/true));
+        if (!result.is_match()) {
+          did_match = false;
+        } else if (did_match) {
+          hits.emplace_back(std::move(result.hits()));
+        }
+      }
+      if (!did_match) return MatchResult::NoMatch();
+
+      std::vector<Hit> result;
+      if (node.id == JJTAROUND) {
+        if (node.max_allowed_gap == -1) {
+          return absl::InvalidArgumentError(
+              "Invalid distance specified in AROUND expression.");
+        }
+        result = PhraseMatcher(hits, node.max_allowed_gap).FindMatchingHits();
+      } else {
+        result = PhraseMatcher(hits, node.offsets, node.exterior_gaps)
+                     .FindMatchingHits();
+      }
+      return result.empty() ? MatchResult::NoMatch()
+                            : MatchResult::Match(std::move(result));
+    }
+    default:
+      ZETASQL_RET_CHECK_FAIL() << "Bad query: unsupported search query node type "
+                       << node.id;
+  }
+}
+
+absl::StatusOr<std::shared_ptr<const SearchQueryMatcher>>
+SearchQueryCache::GetMatcher(absl::string_view query_string) {
+  {
+    absl::ReaderMutexLock lock(&mu_);
+    auto it = query_cache_.find(query_string);
+    if (it != query_cache_.end()) {
+      return it->second;
+    }
+  }
+
+  // Parse outside of the lock so that concurrent misses don't serialize.
+  QueryParser parser(query_string);
+  ZETASQL_RETURN_IF_ERROR(parser.ParseSearchQuery());
+  ZETASQL_ASSIGN_OR_RETURN(SearchQueryMatcher matcher,
+                   SearchQueryMatcher::Compile(parser.Tree()));
+  auto compiled =
+      std::make_shared<const SearchQueryMatcher>(std::move(matcher));
+  absl::MutexLock lock(&mu_);
+  return query_cache_.try_emplace(query_string, std::move(compiled))
+      .first->second;
+}
+
+TokenMapCache& TokenMapCache::instance() {
+  static TokenMapCache* instance = new TokenMapCache(kMaxCachedTokenListBytes);
+  return *instance;
+}
+
+absl::StatusOr<std::shared_ptr<const TokenMapCache::DecodedTokenList>>
+TokenMapCache::GetOrBuild(const zetasql::Value& token_list,
+                          absl::string_view func_name) {
+  ZETASQL_RET_CHECK(token_list.type()->IsTokenList() && !token_list.is_null());
+  const std::string& bytes = token_list.tokenlist_value().GetBytes();
+  {
+    absl::ReaderMutexLock lock(&mu_);
+    auto it = token_lists_.find(bytes);
+    if (it != token_lists_.end()) {
+      hits_.fetch_add(1, std::memory_order_relaxed);
+      if (!it->second.referenced.load(std::memory_order_relaxed)) {
+        it->second.referenced.store(true, std::memory_order_relaxed);
+      }
+      return it->second.decoded;
+    }
+  }
+  misses_.fetch_add(1, std::memory_order_relaxed);
+
+  auto decoded = std::make_shared<DecodedTokenList>();
+  ZETASQL_ASSIGN_OR_RETURN(decoded->token_map,
+                   SearchHelper::BuildTokenMap(token_list, func_name,
+                                               decoded->source_is_null));
+  const int64_t size = CachedTokenListBytes(bytes, *decoded);
+  if (size > max_bytes_) {
+    return decoded;
+  }
+  absl::MutexLock lock(&mu_);
+  // Another thread may have cached the same token list meanwhile.
+  auto it = token_lists_.find(bytes);
+  if (it != token_lists_.end()) {
+    return it->second.decoded;
+  }
+  EvictLocked(size);
+  bytes_ += size;
+  Entry& entry = token_lists_[bytes];
+  entry.decoded = std::move(decoded);
+  entry.bytes = size;
+  clock_.push_back(bytes);
+  return entry.decoded;
+}
+
+void TokenMapCache::EvictLocked(int64_t size) {
+  // Each pass of the hand clears the referenced bits, so the loop ends within
+  // two passes.
+  while (bytes_ + size > max_bytes_ && !clock_.empty()) {
+    std::string key = std::move(clock_.front());
+    clock_.pop_front();
+    auto it = token_lists_.find(key);
+    if (it->second.referenced.exchange(false, std::memory_order_relaxed)) {
+      clock_.push_back(std::move(key));
+      continue;
+    }
+    bytes_ -= it->second.bytes;
+    token_lists_.erase(it);
+  }
+}
+
+int64_t TokenMapCache::bytes() const {
+  absl::ReaderMutexLock lock(&mu_);
+  return bytes_;
+}
+
 }  // namespace search
 }  // namespace query
 }  // namespace backend
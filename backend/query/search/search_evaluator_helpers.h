@@ -17,7 +17,9 @@
 #ifndef THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_QUERY_SEARCH_SEARCH_EVALUATOR_HELPER_H_
 #define THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_QUERY_SEARCH_SEARCH_EVALUATOR_HELPER_H_
 
+#include <atomic>
 #include <cstdint>
+#include <deque>
 #include <memory>
 #include <optional>
 #include <string>
@@ -25,9 +27,12 @@
 #include <vector>
 
 #include "zetasql/public/value.h"
+#include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/node_hash_map.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "backend/query/search/SearchQueryParserTree.h"
 
 // Define the helper classes that paricipate in search evaluation.
@@ -100,26 +105,6 @@ class MatchResult {
   std::optional<std::vector<Hit>> result_;
 };
 
-// singleton that caches the parsed query so that it doesn't need to be
-// parsed on every search evaluation.
-class SearchQueryCache {
- public:
-  SearchQueryCache(SearchQueryCache& other) = delete;
-  void operator=(const SearchQueryCache&) = delete;
-
-  static SearchQueryCache* GetInstance() {
-    static SearchQueryCache* instance_ = new SearchQueryCache();
-    return instance_;
-  }
-
-  absl::StatusOr<SimpleNode*> GetParsedQuery(const std::string& query_string);
-
- private:
-  SearchQueryCache() = default;
-
-  absl::flat_hash_map<std::string, std::unique_ptr<SimpleNode>> query_cache_;
-};
-
 class PhraseMatcher {
  public:
   // Matches an exact phrase. 'inputs' is a sorted list of hits for each child
@@ -199,6 +184,153 @@ class PhraseMatcher {
   std::vector<Hit> partial_match_;
 };
 
+// A search query compiled from its parse tree: the terms, the gaps of AROUND
+// expressions and the offsets of phrases are extracted once, so that matching
+// a row only looks up the terms in its TokenMap.
+class SearchQueryMatcher {
+ public:
+  // Compiles the tree of a parsed search query.
+  static absl::StatusOr<SearchQueryMatcher> Compile(const SimpleNode* root);
+
+  // Returns whether the document with `token_map` matches the query.
+  absl::StatusOr<bool> Matches(const TokenMap& token_map) const;
+
+ private:
+  // Default Around distance if it cannot be determined from user input.
+  static const int kDefaultMaxAllowedGap = 5;
+
+  struct Node {
+    // The JJT id of the parsed node.
+    int id = 0;
+
+    // The token looked up for terms.
+    std::string term;
+
+    // Whether the node is a wildcard, which is not matched in phrases and
+    // AROUND expressions.
+    bool is_wildcard = false;
+
+    // The children of the node, without the distances of AROUND expressions.
+    std::vector<Node> children;
+
+    // For AROUND expressions, the maximum gap between terms, or -1 if the
+    // distance is invalid.
+    int max_allowed_gap = -1;
+
+    // For phrases, the offsets of the non-wildcard children, and the
+    // wildcards before and after them.
+    std::vector<int> offsets;
+    std::pair<int, int> exterior_gaps = {0, 0};
+  };
+
+  explicit SearchQueryMatcher(Node root) : root_(std::move(root)) {}
+
+  static absl::StatusOr<Node> CompileNode(const SimpleNode* node);
+
+  // Returns the matches of `node` in `token_map`, with their positions if
+  // `in_phrase` is true.
+  static absl::StatusOr<MatchResult> MatchNode(const Node& node,
+                                               const TokenMap& token_map,
+                                               bool in_phrase);
+
+  Node root_;
+};
+
+// Process-wide cache of the compiled search queries, so that a query is
+// parsed and compiled once rather than on every search evaluation.
+//
+// This class is thread safe.
+class SearchQueryCache {
+ public:
+  SearchQueryCache(SearchQueryCache& other) = delete;
+  void operator=(const SearchQueryCache&) = delete;
+
+  static SearchQueryCache* GetInstance() {
+    static SearchQueryCache* instance_ = new SearchQueryCache();
+    return instance_;
+  }
+
+  // Returns the compiled `query_string`, parsing and compiling it on a miss.
+  absl::StatusOr<std::shared_ptr<const SearchQueryMatcher>> GetMatcher(
+      absl::string_view query_string) ABSL_LOCKS_EXCLUDED(mu_);
+
+ private:
+  SearchQueryCache() = default;
+
+  absl::Mutex mu_;
+
+  absl::flat_hash_map<std::string, std::shared_ptr<const SearchQueryMatcher>>
+      query_cache_ ABSL_GUARDED_BY(mu_);
+};
+
+// Process-wide cache of the TokenMaps built from TOKENLIST values, keyed by
+// the bytes of the values. TOKENLIST columns are generated columns, so the
+// bytes of a column do not change until its row is rewritten, and repeated
+// searches over the same rows do not decode the token lists again.
+//
+// The estimated size of the cached token lists, including their decoded
+// TokenMaps, is kept within `max_bytes` by evicting token lists with the clock
+// algorithm: lookups mark the token lists they hit as referenced, and a miss
+// evicts the token lists the clock hand finds unreferenced since it last
+// passed them. Lookups thus only need a shared lock.
+//
+// This class is thread safe.
+class TokenMapCache {
+ public:
+  // A token list decoded by SearchHelper::BuildTokenMap.
+  struct DecodedTokenList {
+    TokenMap token_map;
+    bool source_is_null = false;
+  };
+
+  explicit TokenMapCache(int64_t max_bytes) : max_bytes_(max_bytes) {}
+
+  static TokenMapCache& instance();
+
+  // Returns the decoded non-NULL `token_list`, building it with
+  // SearchHelper::BuildTokenMap on a miss. Errors are not cached.
+  absl::StatusOr<std::shared_ptr<const DecodedTokenList>> GetOrBuild(
+      const zetasql::Value& token_list, absl::string_view func_name)
+      ABSL_LOCKS_EXCLUDED(mu_);
+
+  // Number of lookups served from and missed by the cache.
+  int64_t hits() const { return hits_.load(std::memory_order_relaxed); }
+  int64_t misses() const { return misses_.load(std::memory_order_relaxed); }
+
+  // Estimated size of the cached token lists and their TokenMaps.
+  int64_t bytes() const ABSL_LOCKS_EXCLUDED(mu_);
+
+ private:
+  const int64_t max_bytes_;
+
+  mutable absl::Mutex mu_;
+
+  struct Entry {
+    std::shared_ptr<const DecodedTokenList> decoded;
+
+    // Estimated size of the token list and its TokenMap.
+    int64_t bytes = 0;
+
+    // Set by lookups hitting the entry, and cleared by the clock hand.
+    mutable std::atomic<bool> referenced{false};
+  };
+
+  // Evicts token lists until `size` more bytes fit in the cache.
+  void EvictLocked(int64_t size) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  absl::node_hash_map<std::string, Entry> token_lists_ ABSL_GUARDED_BY(mu_);
+
+  // The keys of token_lists_, in the order the clock hand visits them, the
+  // hand pointing at the front.
+  std::deque<std::string> clock_ ABSL_GUARDED_BY(mu_);
+
+  // Estimated size of the cached token lists and their TokenMaps.
+  int64_t bytes_ ABSL_GUARDED_BY(mu_) = 0;
+
+  std::atomic<int64_t> hits_{0};
+  std::atomic<int64_t> misses_{0};
+};
+
 }  // namespace search
 }  // namespace query
 }  // namespace backend
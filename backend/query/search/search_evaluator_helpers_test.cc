@@ -16,6 +16,7 @@
 
 #include "backend/query/search/search_evaluator_helpers.h"
 
+#include <cstdint>
 #include <string>
 #include <utility>
 #include <vector>
@@ -37,6 +38,7 @@ namespace query {
 namespace search {
 
 using testing::HasSubstr;
+using zetasql_base::testing::IsOkAndHolds;
 using zetasql_base::testing::StatusIs;
 
 // The test suite focuses on verifying the code path that cannot easily
@@ -58,18 +60,36 @@ TokenMap BuildTokenMap(std::string doc) {
 
 }  // namespace
 
-TEST(SearchQueryCacheTest, GetParsedQuery) {
-  auto result =
-      SearchQueryCache::GetInstance()->GetParsedQuery("google spanner");
+TEST(SearchQueryCacheTest, GetMatcher) {
+  auto result = SearchQueryCache::GetInstance()->GetMatcher("google spanner");
   ZETASQL_EXPECT_OK(result.status());
   EXPECT_NE(result.value(), nullptr);
+  EXPECT_EQ(
+      SearchQueryCache::GetInstance()->GetMatcher("google spanner").value(),
+      result.value());
 }
 
 TEST(SearchQueryCacheTest, FailedToParseQuery) {
-  EXPECT_THAT(
-      SearchQueryCache::GetInstance()->GetParsedQuery("google| |spanner"),
-      StatusIs(absl::StatusCode::kInvalidArgument,
-               HasSubstr("Error(s) parsing search query")));
+  EXPECT_THAT(SearchQueryCache::GetInstance()->GetMatcher("google| |spanner"),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Error(s) parsing search query")));
+}
+
+TEST(SearchQueryMatcherTest, MatchesCompiledQuery) {
+  TokenMap token_map = BuildTokenMap("cloud spanner emulator for google sql");
+  auto matches = [&](absl::string_view query) {
+    return SearchQueryCache::GetInstance()->GetMatcher(query).value()->Matches(
+        token_map);
+  };
+
+  EXPECT_THAT(matches("spanner google"), IsOkAndHolds(true));
+  EXPECT_THAT(matches("spanner bigtable"), IsOkAndHolds(false));
+  EXPECT_THAT(matches("spanner | bigtable"), IsOkAndHolds(true));
+  EXPECT_THAT(matches("spanner -bigtable"), IsOkAndHolds(true));
+  EXPECT_THAT(matches("\"cloud spanner\""), IsOkAndHolds(true));
+  EXPECT_THAT(matches("\"spanner cloud\""), IsOkAndHolds(false));
+  EXPECT_THAT(matches("cloud AROUND(2) emulator"), IsOkAndHolds(true));
+  EXPECT_THAT(matches("cloud AROUND(2) google"), IsOkAndHolds(false));
 }
 
 TEST(MatchResultTest, SortedUniqueHits) {
@@ -153,6 +173,79 @@ TEST(SearchHelperTest, TestBuildTokenMap) {
                          "TOKENLIST column generated by TOKENIZE_FULLTEXT")));
 }
 
+TEST(TokenMapCacheTest, DecodesTokenListOnce) {
+  TokenMapCache cache(/*max_bytes=*/1 << 20);
+  const zetasql::Value tokenlist =
+      TokenListFromStrings({"fulltext-0", "cloud", "spanner", "cloud"});
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto decoded,
+                       cache.GetOrBuild(tokenlist, "SEARCH"));
+  EXPECT_FALSE(decoded->source_is_null);
+  EXPECT_THAT(decoded->token_map.at("cloud"), testing::ElementsAre(0, 2));
+  EXPECT_THAT(decoded->token_map.at("spanner"), testing::ElementsAre(1));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      auto cached,
+      cache.GetOrBuild(TokenListFromStrings(
+                           {"fulltext-0", "cloud", "spanner", "cloud"}),
+                       "SCORE"));
+  EXPECT_EQ(cached, decoded);
+  EXPECT_EQ(cache.hits(), 1);
+  EXPECT_EQ(cache.misses(), 1);
+}
+
+TEST(TokenMapCacheTest, DoesNotCacheErrors) {
+  TokenMapCache cache(/*max_bytes=*/1 << 20);
+  const zetasql::Value tokenlist = TokenListFromStrings({"substring-0", "a"});
+
+  EXPECT_THAT(cache.GetOrBuild(tokenlist, "SEARCH"),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(cache.GetOrBuild(tokenlist, "SCORE"),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("SCORE function's first argument")));
+  EXPECT_EQ(cache.hits(), 0);
+}
+
+TEST(TokenMapCacheTest, EvictsUnreferencedTokenListsWhenFull) {
+  const zetasql::Value a = TokenListFromStrings({"fulltext-0", "a"});
+  const zetasql::Value b = TokenListFromStrings({"fulltext-0", "b"});
+  const zetasql::Value c = TokenListFromStrings({"fulltext-0", "c"});
+  TokenMapCache unbounded_cache(/*max_bytes=*/1 << 20);
+  ZETASQL_ASSERT_OK(unbounded_cache.GetOrBuild(a, "SEARCH"));
+  // The size accounts for the decoded TokenMap, not just the bytes.
+  const int64_t tokenlist_bytes = a.tokenlist_value().GetBytes().size();
+  ASSERT_GT(unbounded_cache.bytes(), tokenlist_bytes);
+
+  // Fits two of the token lists.
+  TokenMapCache cache(/*max_bytes=*/2 * unbounded_cache.bytes());
+  ZETASQL_ASSERT_OK(cache.GetOrBuild(a, "SEARCH"));
+  ZETASQL_ASSERT_OK(cache.GetOrBuild(b, "SEARCH"));
+  ZETASQL_ASSERT_OK(cache.GetOrBuild(a, "SEARCH"));
+  // Evicts b, which was not looked up again, rather than a.
+  ZETASQL_ASSERT_OK(cache.GetOrBuild(c, "SEARCH"));
+  ZETASQL_ASSERT_OK(cache.GetOrBuild(a, "SEARCH"));
+  ZETASQL_ASSERT_OK(cache.GetOrBuild(c, "SEARCH"));
+  EXPECT_EQ(cache.hits(), 3);
+  EXPECT_EQ(cache.misses(), 3);
+  EXPECT_EQ(cache.bytes(), 2 * unbounded_cache.bytes());
+
+  ZETASQL_ASSERT_OK(cache.GetOrBuild(b, "SEARCH"));
+  EXPECT_EQ(cache.hits(), 3);
+  EXPECT_EQ(cache.misses(), 4);
+  EXPECT_EQ(cache.bytes(), 2 * unbounded_cache.bytes());
+}
+
+TEST(TokenMapCacheTest, DoesNotCacheTokenListsLargerThanCache) {
+  const zetasql::Value tokenlist =
+      TokenListFromStrings({"fulltext-0", "cloud"});
+  TokenMapCache cache(/*max_bytes=*/1);
+  ZETASQL_ASSERT_OK(cache.GetOrBuild(tokenlist, "SEARCH"));
+  ZETASQL_ASSERT_OK(cache.GetOrBuild(tokenlist, "SEARCH"));
+  EXPECT_EQ(cache.hits(), 0);
+  EXPECT_EQ(cache.misses(), 2);
+  EXPECT_EQ(cache.bytes(), 0);
+}
+
 }  // namespace search
 }  // namespace query
 }  // namespace backend
@@ -0,0 +1,214 @@
+//
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "backend/query/search/search_index_candidates.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "zetasql/public/value.h"
+#include "absl/container/btree_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "backend/common/ids.h"
+#include "backend/common/inverted_index.h"
+#include "backend/datamodel/key.h"
+#include "backend/query/search/SearchQueryParserTreeConstants.h"
+#include "backend/query/search/query_parser.h"
+#include "backend/query/search/search_ngrams_evaluator.h"
+#include "backend/query/search/tokenizer.h"
+
+namespace google {
+namespace spanner {
+namespace emulator {
+namespace backend {
+namespace query {
+namespace search {
+
+namespace {
+
+using Candidates = std::optional<std::vector<Key>>;
+
+std::vector<Key> Intersect(const std::vector<Key>& a,
+                           const std::vector<Key>& b) {
+  std::vector<Key> result;
+  std::set_intersection(a.begin(), a.end(), b.begin(), b.end(),
+                        std::back_inserter(result));
+  return result;
+}
+
+std::vector<Key> Union(const std::vector<Key>& a, const std::vector<Key>& b) {
+  std::vector<Key> result;
+  std::set_union(a.begin(), a.end(), b.begin(), b.end(),
+                 std::back_inserter(result));
+  return result;
+}
+
+// Mirrors SearchQueryMatcher::MatchNode: a row can only match `node` if it
+// is in the returned candidates.
+Candidates FindNodeCandidates(const SimpleNode* node,
+                              const InvertedIndex& inverted_index,
+                              const ColumnID& column) {
+  switch (node->getId()) {
+    case JJTTERM:
+      return inverted_index.GetPostingList(column, node->image());
+    case JJTOR: {
+      // Each child must narrow down the rows.
+      std::vector<Key> result;
+      for (int i = 0; i < node->jjtGetNumChildren(); ++i) {
+        const SimpleNode* child =
+            dynamic_cast<const SimpleNode*>(node->jjtGetChild(i));
+        if (child == nullptr) return std::nullopt;
+        Candidates candidates =
+            FindNodeCandidates(child, inverted_index, column);
+        if (!candidates.has_value()) return std::nullopt;
+        result = Union(result, *candidates);
+      }
+      return result;
+    }
+    case JJTAND:
+    case JJTAROUND:
+    case JJTPHRASE: {
+      // Any child narrows down the rows. Distances and wildcards in AROUND and
+      // phrases match every row.
+      Candidates result;
+      for (int i = 0; i < node->jjtGetNumChildren(); ++i) {
+        const SimpleNode* child =
+            dynamic_cast<const SimpleNode*>(node->jjtGetChild(i));
+        if (child == nullptr || child->getId() == JJTNUMBER ||
+            child->image() == "*") {
+          continue;
+        }
+        Candidates candidates =
+            FindNodeCandidates(child, inverted_index, column);
+        if (!candidates.has_value()) continue;
+        result = result.has_value() ? Intersect(*result, *candidates)
+                                    : std::move(candidates);
+      }
+      return result;
+    }
+    default:
+      // NOT matches the rows missing from the posting lists.
+      return std::nullopt;
+  }
+}
+
+// Returns the ngram sizes of the token lists with the given tokenizer
+// signatures, or std::nullopt if they were not all produced by an ngrams
+// tokenizer with the same ngram sizes.
+std::optional<std::pair<int64_t, int64_t>> GetNgramSizes(
+    const std::vector<std::string>& signatures) {
+  // substring and ngrams signatures start with:
+  //   [substring|ngrams]-ngram_size_max-ngram_size_min-is_source_null
+  constexpr int kNgramMaxSizeIndex = 1;
+  constexpr int kNgramMinSizeIndex = 2;
+  constexpr int kNgramsSignatureArgumentSize = 4;
+
+  std::optional<std::pair<int64_t, int64_t>> result;
+  for (const std::string& signature : signatures) {
+    std::vector<absl::string_view> parts =
+        absl::StrSplit(signature, absl::ByChar('-'), absl::SkipEmpty());
+    std::pair<int64_t, int64_t> sizes;
+    if (parts.empty() ||
+        !(parts[0] == kNgramsTokenizer || parts[0] == kSubstringTokenizer) ||
+        (parts.size() != kNgramsSignatureArgumentSize &&
+         parts.size() != kSubstringTokenizerSignatureArgumentSize) ||
+        !absl::SimpleAtoi(parts[kNgramMaxSizeIndex], &sizes.first) ||
+        !absl::SimpleAtoi(parts[kNgramMinSizeIndex], &sizes.second) ||
+        (result.has_value() && *result != sizes)) {
+      return std::nullopt;
+    }
+    result = sizes;
+  }
+  return result;
+}
+
+}  // namespace
+
+std::optional<std::vector<Key>> FindSearchCandidates(
+    const InvertedIndex& inverted_index, const ColumnID& column,
+    absl::string_view search_query) {
+  if (inverted_index.GetTokenizer(column) != kFullTextTokenizer ||
+      search_query.empty()) {
+    return std::nullopt;
+  }
+  QueryParser parser(search_query);
+  if (!parser.ParseSearchQuery().ok()) {
+    return std::nullopt;
+  }
+  return FindNodeCandidates(parser.Tree(), inverted_index, column);
+}
+
+std::optional<std::vector<Key>> FindSearchNgramsCandidates(
+    const InvertedIndex& inverted_index, const ColumnID& column,
+    absl::Span<const zetasql::Value> args) {
+  constexpr int kQuery = 1;
+  if (args.size() <= kQuery || !args[kQuery].type()->IsString() ||
+      args[kQuery].is_null()) {
+    return std::nullopt;
+  }
+  std::optional<std::pair<int64_t, int64_t>> ngram_sizes =
+      GetNgramSizes(inverted_index.GetTokenizerSignatures(column));
+  if (!ngram_sizes.has_value()) {
+    return std::nullopt;
+  }
+
+  // All rows share the same query ngrams since their token lists have the same
+  // ngram sizes.
+  absl::flat_hash_set<std::string> query_ngrams;
+  if (!SearchNgramsEvaluator::BuildQueryNgrams(
+           args[kQuery].string_value(), ngram_sizes->first,
+           ngram_sizes->second, query_ngrams)
+           .ok()) {
+    return std::nullopt;
+  }
+  int64_t min_matching_ngrams =
+      SearchNgramsEvaluator::MinMatchingNgrams(args, query_ngrams.size());
+  if (min_matching_ngrams <= 0) {
+    return std::nullopt;
+  }
+
+  // Count the query ngrams in the posting lists of each row.
+  absl::btree_map<Key, int64_t> matching_ngrams;
+  for (const std::string& ngram : query_ngrams) {
+    for (const Key& key : inverted_index.GetPostingList(column, ngram)) {
+      ++matching_ngrams[key];
+    }
+  }
+  std::vector<Key> result;
+  for (const auto& [key, count] : matching_ngrams) {
+    if (count >= min_matching_ngrams) {
+      result.push_back(key);
+    }
+  }
+  return result;
+}
+
+}  // namespace search
+}  // namespace query
+}  // namespace backend
+}  // namespace emulator
+}  // namespace spanner
+}  // namespace google
@@ -0,0 +1,69 @@
+//
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_QUERY_SEARCH_SEARCH_INDEX_CANDIDATES_H_
+#define THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_QUERY_SEARCH_SEARCH_INDEX_CANDIDATES_H_
+
+#include <optional>
+#include <vector>
+
+#include "zetasql/public/value.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "backend/common/ids.h"
+#include "backend/common/inverted_index.h"
+#include "backend/datamodel/key.h"
+
+namespace google {
+namespace spanner {
+namespace emulator {
+namespace backend {
+namespace query {
+namespace search {
+
+// Returns, in key order, the keys of the rows for which SEARCH(`column`,
+// `search_query`) may be TRUE according to the posting lists of
+// `inverted_index`. The rows must still be checked by SearchEvaluator.
+//
+// Returns std::nullopt if the posting lists cannot narrow down the rows, e.g.
+// when the query fails to parse, when it matches rows through NOT, or when the
+// token lists of `column` were not all produced by TOKENIZE_FULLTEXT (SEARCH
+// then reports an error that must not be skipped).
+std::optional<std::vector<Key>> FindSearchCandidates(
+    const InvertedIndex& inverted_index, const ColumnID& column,
+    absl::string_view search_query);
+
+// Returns, in key order, the keys of the rows for which SEARCH_NGRAMS(`column`,
+// ...) may be TRUE according to the posting lists of `inverted_index`, given
+// the remaining SEARCH_NGRAMS arguments in `args` (`args[0]`, the token list,
+// is ignored). The candidates are the rows whose posting lists hold enough of
+// the query ngrams; they must still be checked by SearchNgramsEvaluator.
+//
+// Returns std::nullopt if the posting lists cannot narrow down the rows, e.g.
+// when every row matches, or when the token lists of `column` were not all
+// produced by TOKENIZE_NGRAMS or TOKENIZE_SUBSTRING with the same ngram sizes.
+std::optional<std::vector<Key>> FindSearchNgramsCandidates(
+    const InvertedIndex& inverted_index, const ColumnID& column,
+    absl::Span<const zetasql::Value> args);
+
+}  // namespace search
+}  // namespace query
+}  // namespace backend
+}  // namespace emulator
+}  // namespace spanner
+}  // namespace google
+
+#endif  // THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_QUERY_SEARCH_SEARCH_INDEX_CANDIDATES_H_
@@ -0,0 +1,166 @@
+//
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "backend/query/search/search_index_candidates.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "zetasql/public/value.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "zetasql/base/testing/status_matchers.h"
+#include "absl/strings/string_view.h"
+#include "backend/common/inverted_index.h"
+#include "backend/datamodel/key.h"
+#include "backend/query/search/ngrams_tokenizer.h"
+#include "backend/query/search/tokenizer.h"
+
+namespace google {
+namespace spanner {
+namespace emulator {
+namespace backend {
+namespace query {
+namespace search {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+using ::testing::Optional;
+
+Key MakeKey(int64_t value) { return Key({zetasql::Value::Int64(value)}); }
+
+class SearchIndexCandidatesTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    AddRow(1, {"cloud", "spanner"});
+    AddRow(2, {"cloud", "sql"});
+    AddRow(3, {"spanner", "emulator"});
+  }
+
+  void AddRow(int64_t key, std::vector<std::string> tokens) {
+    tokens.insert(tokens.begin(), "fulltext-0");
+    ZETASQL_ASSERT_OK(index_.AddTokenList("C", MakeKey(key),
+                                  TokenListFromStrings(tokens)));
+  }
+
+  InvertedIndex index_;
+};
+
+TEST_F(SearchIndexCandidatesTest, Term) {
+  EXPECT_THAT(FindSearchCandidates(index_, "C", "spanner"),
+              Optional(ElementsAre(MakeKey(1), MakeKey(3))));
+  EXPECT_THAT(FindSearchCandidates(index_, "C", "bigtable"),
+              Optional(IsEmpty()));
+}
+
+TEST_F(SearchIndexCandidatesTest, AndIntersectsChildren) {
+  EXPECT_THAT(FindSearchCandidates(index_, "C", "cloud spanner"),
+              Optional(ElementsAre(MakeKey(1))));
+  EXPECT_THAT(FindSearchCandidates(index_, "C", "cloud -sql"),
+              Optional(ElementsAre(MakeKey(1), MakeKey(2))));
+}
+
+TEST_F(SearchIndexCandidatesTest, OrUnitesChildren) {
+  EXPECT_THAT(FindSearchCandidates(index_, "C", "sql | emulator"),
+              Optional(ElementsAre(MakeKey(2), MakeKey(3))));
+  EXPECT_EQ(FindSearchCandidates(index_, "C", "sql | -emulator"),
+            std::nullopt);
+}
+
+TEST_F(SearchIndexCandidatesTest, PhraseIntersectsTerms) {
+  EXPECT_THAT(FindSearchCandidates(index_, "C", "\"cloud * spanner\""),
+              Optional(ElementsAre(MakeKey(1))));
+  EXPECT_THAT(FindSearchCandidates(index_, "C", "cloud AROUND(2) sql"),
+              Optional(ElementsAre(MakeKey(2))));
+}
+
+TEST_F(SearchIndexCandidatesTest, DoesNotNarrowDownNot) {
+  EXPECT_EQ(FindSearchCandidates(index_, "C", "-cloud"), std::nullopt);
+}
+
+TEST_F(SearchIndexCandidatesTest, RequiresFullTextTokenLists) {
+  EXPECT_EQ(FindSearchCandidates(index_, "D", "cloud"), std::nullopt);
+
+  ZETASQL_ASSERT_OK(index_.AddTokenList(
+      "C", MakeKey(4), TokenListFromStrings({"substring-0", "cloud"})));
+  EXPECT_EQ(FindSearchCandidates(index_, "C", "cloud"), std::nullopt);
+}
+
+class SearchNgramsCandidatesTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    AddRow(1, "spanner");
+    AddRow(2, "spinner");
+    AddRow(3, "scanner");
+  }
+
+  void AddRow(int64_t key, absl::string_view text, int64_t ngram_size = 3) {
+    ZETASQL_ASSERT_OK_AND_ASSIGN(
+        zetasql::Value token_list,
+        NgramsTokenizer::Tokenize({zetasql::Value::String(text),
+                                   zetasql::Value::Int64(ngram_size),
+                                   zetasql::Value::Int64(ngram_size)}));
+    ZETASQL_ASSERT_OK(index_.AddTokenList("C", MakeKey(key), token_list));
+  }
+
+  std::optional<std::vector<Key>> FindCandidates(
+      std::vector<zetasql::Value> args) {
+    args.insert(args.begin(), zetasql::Value::NullTokenList());
+    return FindSearchNgramsCandidates(index_, "C", args);
+  }
+
+  InvertedIndex index_;
+};
+
+TEST_F(SearchNgramsCandidatesTest, DefaultMinNgrams) {
+  EXPECT_THAT(FindCandidates({zetasql::Value::String("spanner")}),
+              Optional(ElementsAre(MakeKey(1), MakeKey(2), MakeKey(3))));
+  EXPECT_THAT(FindCandidates({zetasql::Value::String("bigtable")}),
+              Optional(IsEmpty()));
+}
+
+TEST_F(SearchNgramsCandidatesTest, MinNgrams) {
+  EXPECT_THAT(FindCandidates({zetasql::Value::String("spanner"),
+                              zetasql::Value::Int64(3)}),
+              Optional(ElementsAre(MakeKey(1), MakeKey(3))));
+  EXPECT_EQ(FindCandidates({zetasql::Value::String("spanner"),
+                            zetasql::Value::Int64(0)}),
+            std::nullopt);
+}
+
+TEST_F(SearchNgramsCandidatesTest, MinNgramsPercent) {
+  EXPECT_THAT(FindCandidates({zetasql::Value::String("spanner"),
+                              zetasql::Value::NullInt64(),
+                              zetasql::Value::Double(100)}),
+              Optional(ElementsAre(MakeKey(1))));
+}
+
+TEST_F(SearchNgramsCandidatesTest, RequiresSameNgramSizes) {
+  AddRow(4, "spanner", /*ngram_size=*/2);
+  EXPECT_EQ(FindCandidates({zetasql::Value::String("spanner")}),
+            std::nullopt);
+}
+
+}  // namespace
+}  // namespace search
+}  // namespace query
+}  // namespace backend
+}  // namespace emulator
+}  // namespace spanner
+}  // namespace google
@@ -87,21 +87,8 @@ absl::Status SearchNgramsEvaluator::BuildTokenLists(
           absl::SimpleAtoi(signature[kNgramMinSizeIndex], &ngram_min_size));
       source_is_null = signature[kIsNullIndex] != "0";
 
-      // Break query into words and generate ngrams for each word.
-      std::vector<std::string> substrings = absl::StrSplit(
-          query, absl::ByAnyChar(kDelimiter), absl::SkipWhitespace());
-      for (const auto& substring : substrings) {
-        std::vector<zetasql::Value> args{
-            zetasql::Value::String(substring),
-            zetasql::Value::Int64(ngram_max_size),
-            zetasql::Value::Int64(ngram_min_size),
-            zetasql::Value::Bool(false)};
-        ZETASQL_ASSIGN_OR_RETURN(auto result, NgramsTokenizer::Tokenize(args));
-        ZETASQL_ASSIGN_OR_RETURN(auto ngrams, StringsFromTokenList(result));
-        for (auto it = ngrams.begin() + 1; it != ngrams.end(); ++it) {
-          query_ngrams.insert(*it);
-        }
-      }
+      ZETASQL_RETURN_IF_ERROR(BuildQueryNgrams(query, ngram_max_size, ngram_min_size,
+                                       query_ngrams));
     } else if (tokens[i] == kGapString) {
       continue;
     } else if (i == 0) {
@@ -114,6 +101,40 @@ absl::Status SearchNgramsEvaluator::BuildTokenLists(
   return absl::OkStatus();
 }
 
+absl::Status SearchNgramsEvaluator::BuildQueryNgrams(
+    absl::string_view query, int64_t ngram_size_max, int64_t ngram_size_min,
+    absl::flat_hash_set<std::string>& query_ngrams) {
+  // Break query into words and generate ngrams for each word.
+  std::vector<std::string> substrings = absl::StrSplit(
+      query, absl::ByAnyChar(kDelimiter), absl::SkipWhitespace());
+  for (const auto& substring : substrings) {
+    std::vector<zetasql::Value> args{zetasql::Value::String(substring),
+                                       zetasql::Value::Int64(ngram_size_max),
+                                       zetasql::Value::Int64(ngram_size_min),
+                                       zetasql::Value::Bool(false)};
+    ZETASQL_ASSIGN_OR_RETURN(auto result, NgramsTokenizer::Tokenize(args));
+    ZETASQL_ASSIGN_OR_RETURN(auto ngrams, StringsFromTokenList(result));
+    for (auto it = ngrams.begin() + 1; it != ngrams.end(); ++it) {
+      query_ngrams.insert(*it);
+    }
+  }
+  return absl::OkStatus();
+}
+
+int64_t SearchNgramsEvaluator::MinMatchingNgrams(
+    absl::Span<const zetasql::Value> args, int64_t num_query_ngrams) {
+  // argument indexes
+  constexpr int64_t kNgramMin = 2;
+  constexpr int64_t kNgramMinPercent = 3;
+
+  int64_t min_ngrams = GetIntParameterValue(args, kNgramMin, kDefaultMinNgrams);
+  double min_ngrams_percent =
+      GetDoubleParameterValue(args, kNgramMinPercent, 0);
+  return std::max(min_ngrams,
+                  static_cast<int64_t>(std::ceil(
+                      num_query_ngrams * min_ngrams_percent / 100.0)));
+}
+
 int64_t SearchNgramsEvaluator::NumMatchingNgrams(
     std::vector<std::string>& tokenlist_ngrams,
     absl::flat_hash_set<std::string>& query_ngrams) {
@@ -132,14 +153,9 @@ absl::StatusOr<zetasql::Value> SearchNgramsEvaluator::Evaluate(
   // argument indexes
   constexpr int64_t kTokenlist = 0;
   constexpr int64_t kQuery = 1;
-  constexpr int64_t kNgramMin = 2;
-  constexpr int64_t kNgramMinPercent = 3;
 
   const zetasql::Value& tokenlist = args[kTokenlist];
   const zetasql::Value& query = args[kQuery];
-  int64_t min_ngrams = GetIntParameterValue(args, kNgramMin, kDefaultMinNgrams);
-  double min_ngrams_percent =
-      GetDoubleParameterValue(args, kNgramMinPercent, 0);
 
   if (tokenlist.is_null() || query.is_null()) {
     return zetasql::Value::NullBool();
@@ -165,17 +181,8 @@ absl::StatusOr<zetasql::Value> SearchNgramsEvaluator::Evaluate(
   }
 
   int64_t matching_ngrams = NumMatchingNgrams(tokenlist_ngrams, query_ngrams);
-
-  bool matches = false;
-  if (matching_ngrams >= min_ngrams) {
-    matches = true;
-  }
-  if (matching_ngrams <
-      static_cast<int64_t>(
-          std::ceil(query_ngrams.size() * min_ngrams_percent / 100.0))) {
-    matches = false;
-  }
-  return zetasql::Value::Bool(matches);
+  return zetasql::Value::Bool(
+      matching_ngrams >= MinMatchingNgrams(args, query_ngrams.size()));
 }
 
 }  // namespace search
@@ -40,6 +40,18 @@ class SearchNgramsEvaluator {
   static absl::StatusOr<zetasql::Value> Evaluate(
       absl::Span<const zetasql::Value> args);
 
+  // Generates the set of unique ngrams of `query` matched against token lists
+  // with the given ngram sizes.
+  static absl::Status BuildQueryNgrams(
+      absl::string_view query, int64_t ngram_size_max, int64_t ngram_size_min,
+      absl::flat_hash_set<std::string>& query_ngrams);
+
+  // Returns the number of query ngrams a token list must contain to match,
+  // given the SEARCH_NGRAMS arguments `args` and the number of unique ngrams
+  // in the query.
+  static int64_t MinMatchingNgrams(absl::Span<const zetasql::Value> args,
+                                   int64_t num_query_ngrams);
+
  private:
   static constexpr int64_t kDefaultMinNgrams = 2;
 
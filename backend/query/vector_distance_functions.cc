@@ -0,0 +1,266 @@
+//
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "backend/query/vector_distance_functions.h"
+
+#include <cmath>
+#include <memory>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "zetasql/public/evaluator.h"
+#include "zetasql/public/function.h"
+#include "zetasql/public/type.h"
+#include "zetasql/public/type.pb.h"
+#include "zetasql/public/types/type_factory.h"
+#include "zetasql/public/value.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "backend/common/vector_distance.h"
+#include "backend/query/analyzer_options.h"
+#include "zetasql/base/status_macros.h"
+
+namespace google {
+namespace spanner {
+namespace emulator {
+namespace backend {
+
+namespace {
+
+enum class DistanceFunction { kCosine, kEuclidean, kDotProduct };
+
+DistanceFunction GetDistanceFunction(absl::string_view function_name) {
+  if (function_name == "cosine_distance") {
+    return DistanceFunction::kCosine;
+  }
+  if (function_name == "euclidean_distance") {
+    return DistanceFunction::kEuclidean;
+  }
+  return DistanceFunction::kDotProduct;
+}
+
+// Holds the elements of a dense vector contiguously. The last unboxed vector is
+// kept, along with a reference to its elements: constant vectors, such as the
+// query vector of a nearest neighbor search, share their elements across rows
+// and are only unboxed once.
+template <typename T>
+class UnboxedVector {
+ public:
+  // Unboxes the elements of `vector`, a non-NULL ARRAY<FLOAT> or
+  // ARRAY<DOUBLE>. Returns false if some elements are NULL or not finite.
+  bool Unbox(const zetasql::Value& vector) {
+    if (value_.is_valid() && &value_.elements() == &vector.elements()) {
+      return valid_;
+    }
+    value_ = vector;
+    elements_.clear();
+    elements_.reserve(vector.num_elements());
+    valid_ = true;
+    for (const zetasql::Value& element : vector.elements()) {
+      if (element.is_null()) {
+        valid_ = false;
+        break;
+      }
+      T value;
+      if constexpr (std::is_same_v<T, float>) {
+        value = element.float_value();
+      } else {
+        value = element.double_value();
+      }
+      if (!std::isfinite(value)) {
+        valid_ = false;
+        break;
+      }
+      elements_.push_back(value);
+    }
+    return valid_;
+  }
+
+  absl::Span<const T> elements() const { return elements_; }
+
+ private:
+  zetasql::Value value_;
+  std::vector<T> elements_;
+  bool valid_ = false;
+};
+
+// Computes `function` on dense vectors of T with the vector kernels. Returns
+// std::nullopt for the arguments left to the built-in function.
+template <typename T>
+std::optional<double> ComputeDenseDistance(DistanceFunction function,
+                                           const zetasql::Value& a,
+                                           const zetasql::Value& b) {
+  thread_local UnboxedVector<T> unboxed_a;
+  thread_local UnboxedVector<T> unboxed_b;
+  if (!unboxed_a.Unbox(a) || !unboxed_b.Unbox(b)) {
+    return std::nullopt;
+  }
+  absl::Span<const T> x = unboxed_a.elements();
+  absl::Span<const T> y = unboxed_b.elements();
+  if (x.size() != y.size() || x.empty()) {
+    return std::nullopt;
+  }
+
+  double result;
+  switch (function) {
+    case DistanceFunction::kDotProduct:
+      result = DotProduct(x, y);
+      break;
+    case DistanceFunction::kEuclidean:
+      result = std::sqrt(SquaredEuclideanDistance(x, y));
+      break;
+    case DistanceFunction::kCosine: {
+      CosineTerms terms = ComputeCosineTerms(x, y);
+      if (terms.squared_norm_a == 0 || terms.squared_norm_b == 0) {
+        return std::nullopt;
+      }
+      result = 1 - terms.dot_product / (std::sqrt(terms.squared_norm_a) *
+                                        std::sqrt(terms.squared_norm_b));
+      break;
+    }
+  }
+  if (!std::isfinite(result)) {
+    return std::nullopt;
+  }
+  return result;
+}
+
+// Evaluates a ZetaSQL built-in function, preparing it once per argument types
+// rather than on every call.
+//
+// This class is thread safe.
+class BuiltinFunctionEvaluator {
+ public:
+  explicit BuiltinFunctionEvaluator(absl::string_view function_name)
+      : function_name_(function_name) {}
+
+  absl::StatusOr<zetasql::Value> Evaluate(
+      absl::Span<const zetasql::Value> args) ABSL_LOCKS_EXCLUDED(mu_) {
+    ZETASQL_ASSIGN_OR_RETURN(zetasql::PreparedExpression * expression,
+                     GetExpression(args));
+    zetasql::ParameterValueMap parameters;
+    for (int i = 0; i < args.size(); ++i) {
+      parameters[ParameterName(i)] = args[i];
+    }
+    // Prepared expressions can be executed concurrently.
+    return expression->Execute(/*columns=*/{}, parameters);
+  }
+
+ private:
+  static std::string ParameterName(int i) { return absl::StrCat("arg", i); }
+
+  // Returns the function call prepared for the types of `args`.
+  absl::StatusOr<zetasql::PreparedExpression*> GetExpression(
+      absl::Span<const zetasql::Value> args) ABSL_LOCKS_EXCLUDED(mu_) {
+    std::string signature = absl::StrJoin(
+        args, ", ", [](std::string* out, const zetasql::Value& arg) {
+          absl::StrAppend(out, arg.type()->DebugString());
+        });
+    {
+      absl::ReaderMutexLock lock(&mu_);
+      auto it = expressions_.find(signature);
+      if (it != expressions_.end()) {
+        return it->second.get();
+      }
+    }
+
+    absl::MutexLock lock(&mu_);
+    auto it = expressions_.find(signature);
+    if (it != expressions_.end()) {
+      return it->second.get();
+    }
+    // The types of the arguments belong to the query, which the prepared
+    // expression outlives, so the parameters are declared with copies.
+    zetasql::AnalyzerOptions options = MakeGoogleSqlAnalyzerOptions();
+    std::vector<std::string> parameter_refs;
+    for (int i = 0; i < args.size(); ++i) {
+      zetasql::TypeProto type_proto;
+      ZETASQL_RETURN_IF_ERROR(
+          args[i].type()->SerializeToSelfContainedProto(&type_proto));
+      const zetasql::Type* type = nullptr;
+      ZETASQL_RETURN_IF_ERROR(
+          type_factory_.DeserializeFromSelfContainedProto(type_proto, &type));
+      ZETASQL_RETURN_IF_ERROR(options.AddQueryParameter(ParameterName(i), type));
+      parameter_refs.push_back(absl::StrCat("@", ParameterName(i)));
+    }
+    auto expression = std::make_unique<zetasql::PreparedExpression>(
+        absl::StrCat(function_name_, "(", absl::StrJoin(parameter_refs, ", "),
+                     ")"),
+        zetasql::EvaluatorOptions());
+    ZETASQL_RETURN_IF_ERROR(expression->Prepare(options));
+    return expressions_.emplace(std::move(signature), std::move(expression))
+        .first->second.get();
+  }
+
+  const std::string function_name_;
+
+  absl::Mutex mu_;
+
+  // Owns the types the expressions are prepared for.
+  zetasql::TypeFactory type_factory_ ABSL_GUARDED_BY(mu_);
+
+  // The prepared function calls, keyed by the types of their arguments.
+  absl::flat_hash_map<std::string,
+                      std::unique_ptr<zetasql::PreparedExpression>>
+      expressions_ ABSL_GUARDED_BY(mu_);
+};
+
+}  // namespace
+
+zetasql::FunctionEvaluator VectorDistanceEvaluator(
+    absl::string_view function_name) {
+  return [function = GetDistanceFunction(function_name),
+          builtin = std::make_shared<BuiltinFunctionEvaluator>(function_name)](
+             absl::Span<const zetasql::Value> args)
+             -> absl::StatusOr<zetasql::Value> {
+    // Dense vectors have the same ARRAY<FLOAT> or ARRAY<DOUBLE> type.
+    if (args.size() != 2 || !args[0].type()->IsArray() ||
+        !args[0].type()->Equals(args[1].type())) {
+      return builtin->Evaluate(args);
+    }
+    const zetasql::Type* element_type =
+        args[0].type()->AsArray()->element_type();
+    if (!element_type->IsFloat() && !element_type->IsDouble()) {
+      return builtin->Evaluate(args);
+    }
+    if (args[0].is_null() || args[1].is_null()) {
+      return zetasql::Value::NullDouble();
+    }
+    std::optional<double> result =
+        element_type->IsFloat()
+            ? ComputeDenseDistance<float>(function, args[0], args[1])
+            : ComputeDenseDistance<double>(function, args[0], args[1]);
+    if (!result.has_value()) {
+      return builtin->Evaluate(args);
+    }
+    return zetasql::Value::Double(*result);
+  };
+}
+
+}  // namespace backend
+}  // namespace emulator
+}  // namespace spanner
+}  // namespace google
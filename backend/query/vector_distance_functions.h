@@ -0,0 +1,51 @@
+//
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_QUERY_VECTOR_DISTANCE_FUNCTIONS_H_
+#define THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_QUERY_VECTOR_DISTANCE_FUNCTIONS_H_
+
+#include "zetasql/public/function.h"
+#include "absl/strings/string_view.h"
+
+namespace google {
+namespace spanner {
+namespace emulator {
+namespace backend {
+
+// The ZetaSQL built-in functions computing exact distances between vectors.
+inline constexpr absl::string_view kVectorDistanceFunctionNames[] = {
+    "cosine_distance", "euclidean_distance", "dot_product"};
+
+// Returns an evaluator for `function_name`, one of
+// kVectorDistanceFunctionNames, which computes the distance between dense
+// vectors with the SIMD kernels of backend/common/vector_distance.h instead of
+// one boxed zetasql::Value at a time.
+//
+// Arguments the kernels do not cover (sparse vectors, vectors with NULL or
+// non-finite elements, vectors of different lengths, zero vectors for the
+// cosine distance, or results which overflow) are evaluated by the ZetaSQL
+// built-in function, so that its results and errors are unchanged. The
+// built-in function is prepared once per argument types and reused by the
+// returned evaluator.
+zetasql::FunctionEvaluator VectorDistanceEvaluator(
+    absl::string_view function_name);
+
+}  // namespace backend
+}  // namespace emulator
+}  // namespace spanner
+}  // namespace google
+
+#endif  // THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_QUERY_VECTOR_DISTANCE_FUNCTIONS_H_
@@ -0,0 +1,129 @@
+//
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#include "backend/query/vector_distance_functions.h"
+
+#include <cmath>
+#include <vector>
+
+#include "zetasql/public/function.h"
+#include "zetasql/public/type.h"
+#include "zetasql/public/value.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "zetasql/base/testing/status_matchers.h"
+
+namespace google {
+namespace spanner {
+namespace emulator {
+namespace backend {
+namespace {
+
+using ::zetasql_base::testing::IsOkAndHolds;
+using ::zetasql_base::testing::StatusIs;
+
+zetasql::Value DoubleVector(const std::vector<double>& elements) {
+  std::vector<zetasql::Value> values;
+  for (double element : elements) {
+    values.push_back(zetasql::Value::Double(element));
+  }
+  return zetasql::Value::Array(zetasql::types::DoubleArrayType(), values);
+}
+
+zetasql::Value FloatVector(const std::vector<float>& elements) {
+  std::vector<zetasql::Value> values;
+  for (float element : elements) {
+    values.push_back(zetasql::Value::Float(element));
+  }
+  return zetasql::Value::Array(zetasql::types::FloatArrayType(), values);
+}
+
+TEST(VectorDistanceEvaluatorTest, ComputesDistancesOfDenseVectors) {
+  zetasql::FunctionEvaluator dot_product =
+      VectorDistanceEvaluator("dot_product");
+  zetasql::FunctionEvaluator euclidean_distance =
+      VectorDistanceEvaluator("euclidean_distance");
+  zetasql::FunctionEvaluator cosine_distance =
+      VectorDistanceEvaluator("cosine_distance");
+
+  const zetasql::Value a = DoubleVector({1, 2, 3});
+  const zetasql::Value b = DoubleVector({4, 6, 3});
+  EXPECT_THAT(dot_product({a, b}), IsOkAndHolds(zetasql::Value::Double(25)));
+  EXPECT_THAT(euclidean_distance({a, b}),
+              IsOkAndHolds(zetasql::Value::Double(5)));
+  EXPECT_THAT(cosine_distance({DoubleVector({1, 0}), DoubleVector({0, 2})}),
+              IsOkAndHolds(zetasql::Value::Double(1)));
+
+  EXPECT_THAT(dot_product({FloatVector({1, 2, 3}), FloatVector({4, 6, 3})}),
+              IsOkAndHolds(zetasql::Value::Double(25)));
+}
+
+TEST(VectorDistanceEvaluatorTest, ReturnsNullForNullVectors) {
+  zetasql::FunctionEvaluator dot_product =
+      VectorDistanceEvaluator("dot_product");
+  EXPECT_THAT(
+      dot_product({DoubleVector({1, 2}),
+                   zetasql::Value::Null(zetasql::types::DoubleArrayType())}),
+      IsOkAndHolds(zetasql::Value::NullDouble()));
+}
+
+TEST(VectorDistanceEvaluatorTest, FallsBackToBuiltinFunction) {
+  zetasql::FunctionEvaluator euclidean_distance =
+      VectorDistanceEvaluator("euclidean_distance");
+  zetasql::FunctionEvaluator cosine_distance =
+      VectorDistanceEvaluator("cosine_distance");
+
+  // Vectors of different lengths and zero vectors are errors of the built-in
+  // functions.
+  EXPECT_THAT(
+      euclidean_distance({DoubleVector({1, 2}), DoubleVector({1, 2, 3})}),
+      StatusIs(absl::StatusCode::kOutOfRange));
+  EXPECT_THAT(cosine_distance({DoubleVector({0, 0}), DoubleVector({1, 2})}),
+              StatusIs(absl::StatusCode::kOutOfRange));
+
+  // The kernels do not propagate non-finite elements.
+  absl::StatusOr<zetasql::Value> result = euclidean_distance(
+      {DoubleVector({std::nan(""), 2}), DoubleVector({1, 2})});
+  ZETASQL_ASSERT_OK(result);
+  EXPECT_TRUE(std::isnan(result->double_value()));
+}
+
+TEST(VectorDistanceEvaluatorTest, PreparesBuiltinFunctionPerArgumentTypes) {
+  zetasql::FunctionEvaluator dot_product =
+      VectorDistanceEvaluator("dot_product");
+
+  // Each call falls back to the built-in function, prepared once for FLOAT
+  // and once for DOUBLE vectors.
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_THAT(dot_product({FloatVector({1, 2}), FloatVector({1, 2, 3})}),
+                StatusIs(absl::StatusCode::kOutOfRange));
+    EXPECT_THAT(dot_product({DoubleVector({1, 2}), DoubleVector({1})}),
+                StatusIs(absl::StatusCode::kOutOfRange));
+    absl::StatusOr<zetasql::Value> result = dot_product(
+        {FloatVector({std::nanf(""), 2}), FloatVector({1, 2})});
+    ZETASQL_ASSERT_OK(result);
+    EXPECT_TRUE(std::isnan(result->double_value()));
+  }
+}
+
+}  // namespace
+}  // namespace backend
+}  // namespace emulator
+}  // namespace spanner
+}  // namespace google
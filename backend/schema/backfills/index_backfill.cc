@@ -16,9 +16,11 @@
 
 #include "backend/schema/backfills/index_backfill.h"
 
+#include <algorithm>
+#include <iterator>
 #include <memory>
 #include <queue>
-#include <set>
+#include <utility>
 #include <vector>
 
 #include "zetasql/public/functions/string.h"
@@ -26,10 +28,15 @@
 #include "zetasql/public/value.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/time/time.h"
 #include "absl/types/optional.h"
+#include "absl/types/span.h"
 #include "backend/common/ids.h"
 #include "backend/common/indexing.h"
+#include "backend/common/ann_index.h"
+#include "backend/common/inverted_index.h"
+#include "backend/common/parallel.h"
 #include "backend/common/rows.h"
 #include "backend/datamodel/key.h"
 #include "backend/datamodel/key_range.h"
@@ -50,6 +57,70 @@ namespace spanner {
 namespace emulator {
 namespace backend {
 
+namespace {
+
+// Number of base table rows for which index rows are computed by a single
+// backfill task. Large tables are split into key ranges of this many rows so
+// that the work can be spread across worker threads.
+constexpr int kBackfillChunkSize = 10000;
+
+using IndexRow = std::pair<Key, ValueList>;
+
+// Computes the index rows for the base table rows returned by `itr` and
+// returns them sorted by index data table key.
+absl::StatusOr<std::vector<IndexRow>> ComputeSortedIndexRows(
+    const Index* index, absl::Span<const Column* const> base_columns,
+    StorageIterator* itr) {
+  std::vector<IndexRow> index_rows;
+  while (itr->Next()) {
+    ValueList row_values;
+    row_values.reserve(itr->NumColumns());
+    for (int i = 0; i < itr->NumColumns(); ++i) {
+      // Storage returns invalid values if a value is not present, in which case
+      // we convert it into a typed NULL.
+      row_values.emplace_back(
+          itr->ColumnValue(i).is_valid()
+              ? itr->ColumnValue(i)
+              : zetasql::Value::Null(base_columns[i]->GetType()));
+    }
+
+    // Compute the index key and column values.
+    Row base_row = MakeRow(base_columns, row_values);
+    // Backfill should return failed precondition error for invalid index keys.
+    ZETASQL_ASSIGN_OR_RETURN(Key index_data_table_key,
+                     ComputeIndexKey(base_row, index),
+                     _.SetErrorCode(absl::StatusCode::kFailedPrecondition));
+    if (ShouldFilterIndexKeyOrValue(index, index_data_table_key, base_row)) {
+      continue;
+    }
+    index_rows.emplace_back(std::move(index_data_table_key),
+                            ComputeIndexValues(base_row, index));
+  }
+  ZETASQL_RETURN_IF_ERROR(itr->Status());
+  std::sort(index_rows.begin(), index_rows.end(),
+            [](const IndexRow& a, const IndexRow& b) {
+              return a.first < b.first;
+            });
+  return index_rows;
+}
+
+// Merges two runs of index rows sorted by index data table key.
+std::vector<IndexRow> MergeRuns(std::vector<IndexRow> a,
+                                std::vector<IndexRow> b) {
+  std::vector<IndexRow> merged;
+  merged.reserve(a.size() + b.size());
+  std::merge(std::make_move_iterator(a.begin()),
+             std::make_move_iterator(a.end()),
+             std::make_move_iterator(b.begin()),
+             std::make_move_iterator(b.end()), std::back_inserter(merged),
+             [](const IndexRow& x, const IndexRow& y) {
+               return x.first < y.first;
+             });
+  return merged;
+}
+
+}  // namespace
+
 absl::Status BackfillIndexAddedColumn(const Index* index,
                                       const Column* added_column,
                                       const SchemaValidationContext* context) {
@@ -107,53 +178,189 @@ absl::Status BackfillIndex(const Index* index,
   std::vector<ColumnID> index_column_ids = GetColumnIDs(index_columns);
 
   // TODO: Use actions framework for index backfills.
-  std::unique_ptr<StorageIterator> itr;
-  ZETASQL_RETURN_IF_ERROR(context->storage()->Read(
+  // Split the base table into key ranges of consecutive rows. Each range is
+  // read and indexed separately, so only the rows of the ranges being worked on
+  // are held in memory next to the computed index rows.
+  std::vector<Key> split_keys;
+  ZETASQL_RETURN_IF_ERROR(context->storage()->GetSplitKeys(
       context->pending_commit_timestamp(), index->indexed_table()->id(),
-      KeyRange::All(), base_column_ids, &itr));
+      kBackfillChunkSize, &split_keys));
+  int num_chunks = split_keys.size() + 1;
 
-  // List of index keys used for verifying index uniqueness.
-  std::set<Key> index_keys;
-  while (itr->Next()) {
-    std::vector<zetasql::Value> row_values;
-    row_values.reserve(itr->NumColumns());
-    for (int i = 0; i < itr->NumColumns(); ++i) {
-      // Storage returns invalid values if a value is not present, in which case
-      // we convert it into a typed NULL.
-      row_values.emplace_back(
-          itr->ColumnValue(i).is_valid()
-              ? itr->ColumnValue(i)
-              : zetasql::Value::Null(base_columns[i]->GetType()));
-    }
+  // Compute a sorted run of index rows for each chunk. A table that fits in a
+  // single chunk is processed on the calling thread.
+  std::vector<std::vector<IndexRow>> runs(num_chunks);
+  auto compute_run = [&](int i) -> absl::Status {
+    KeyRange all = KeyRange::All();
+    KeyRange chunk_range = KeyRange::ClosedOpen(
+        i == 0 ? all.start_key() : split_keys[i - 1],
+        i == split_keys.size() ? all.limit_key() : split_keys[i]);
+    std::unique_ptr<StorageIterator> itr;
+    ZETASQL_RETURN_IF_ERROR(context->storage()->Read(
+        context->pending_commit_timestamp(), index->indexed_table()->id(),
+        chunk_range, base_column_ids, &itr));
+    ZETASQL_ASSIGN_OR_RETURN(runs[i],
+                     ComputeSortedIndexRows(index, base_columns, itr.get()));
+    return absl::OkStatus();
+  };
+  if (num_chunks == 1) {
+    ZETASQL_RETURN_IF_ERROR(compute_run(0));
+  } else {
+    ZETASQL_RETURN_IF_ERROR(ParallelFor(num_chunks, DefaultParallelism(), compute_run));
+  }
 
-    // Compute the index key and column values.
-    Row base_row = MakeRow(base_columns, row_values);
-    // Backfill should return failed precondition error for invalid index keys.
-    ZETASQL_ASSIGN_OR_RETURN(Key index_data_table_key, ComputeIndexKey(base_row, index),
-                     _.SetErrorCode(absl::StatusCode::kFailedPrecondition));
-    ValueList index_values = ComputeIndexValues(base_row, index);
-    if (ShouldFilterIndexKeyOrValue(index, index_data_table_key, base_row)) {
-      continue;
+  // Merge the runs pairwise until a single sorted run of index rows is left.
+  while (runs.size() > 1) {
+    std::vector<std::vector<IndexRow>> merged_runs((runs.size() + 1) / 2);
+    ZETASQL_RETURN_IF_ERROR(ParallelFor(
+        merged_runs.size(), DefaultParallelism(), [&](int i) -> absl::Status {
+          if (2 * i + 1 == runs.size()) {
+            merged_runs[i] = std::move(runs[2 * i]);
+            return absl::OkStatus();
+          }
+          merged_runs[i] = MergeRuns(std::move(runs[2 * i]),
+                                     std::move(runs[2 * i + 1]));
+          return absl::OkStatus();
+        }));
+    runs = std::move(merged_runs);
+  }
+  if (runs.empty()) {
+    return absl::OkStatus();
+  }
+  const std::vector<IndexRow>& index_rows = runs.front();
+
+  // Check uniqueness constraints. Index rows with the same index key are
+  // adjacent in the sorted run.
+  if (index->is_unique()) {
+    int num_key_columns = index->key_columns().size();
+    for (int i = 1; i < index_rows.size(); ++i) {
+      Key index_key = index_rows[i].first.Prefix(num_key_columns);
+      if (index_rows[i - 1].first.Prefix(num_key_columns) == index_key) {
+        return error::UniqueIndexViolationOnIndexCreation(
+            index->Name(), index_key.DebugString());
+      }
     }
+  }
+
+  // Insert the new rows in the index.
+  return context->storage()->BatchWrite(context->pending_commit_timestamp(),
+                                        index->index_data_table()->id(),
+                                        index_column_ids, index_rows);
+}
 
-    // Check uniqueness constraints.
-    if (index->is_unique()) {
-      Key index_key = index_data_table_key.Prefix(index->key_columns().size());
-      if (index_keys.find(index_key) != index_keys.end()) {
+absl::StatusOr<std::vector<KeyRange>> GetIndexBackfillKeyRanges(
+    const Index* index, absl::Time timestamp, const Storage* storage) {
+  std::vector<Key> split_keys;
+  ZETASQL_RETURN_IF_ERROR(storage->GetSplitKeys(
+      timestamp, index->indexed_table()->id(), kBackfillChunkSize, &split_keys));
+  KeyRange all = KeyRange::All();
+  std::vector<KeyRange> key_ranges;
+  key_ranges.reserve(split_keys.size() + 1);
+  for (int i = 0; i <= split_keys.size(); ++i) {
+    key_ranges.push_back(KeyRange::ClosedOpen(
+        i == 0 ? all.start_key() : split_keys[i - 1],
+        i == split_keys.size() ? all.limit_key() : split_keys[i]));
+  }
+  return key_ranges;
+}
+
+absl::Status BackfillIndexKeyRange(const Index* index,
+                                   const KeyRange& key_range,
+                                   absl::Time timestamp, Storage* storage) {
+  ZETASQL_RET_CHECK(index->is_write_only());
+  absl::Span<const Column* const> base_columns =
+      index->indexed_table()->columns();
+  std::vector<ColumnID> index_column_ids =
+      GetColumnIDs(index->index_data_table()->columns());
+
+  std::unique_ptr<StorageIterator> itr;
+  ZETASQL_RETURN_IF_ERROR(storage->Read(timestamp, index->indexed_table()->id(),
+                                key_range, GetColumnIDs(base_columns), &itr));
+  ZETASQL_ASSIGN_OR_RETURN(std::vector<IndexRow> index_rows,
+                   ComputeSortedIndexRows(index, base_columns, itr.get()));
+
+  // Check uniqueness constraints within the key range, where index rows with
+  // the same index key are adjacent, and against the entries of the other
+  // rows of the indexed table that are already in the index.
+  if (index->is_unique()) {
+    int num_key_columns = index->key_columns().size();
+    for (int i = 0; i < index_rows.size(); ++i) {
+      Key index_key = index_rows[i].first.Prefix(num_key_columns);
+      if (i > 0 &&
+          index_rows[i - 1].first.Prefix(num_key_columns) == index_key) {
         return error::UniqueIndexViolationOnIndexCreation(
             index->Name(), index_key.DebugString());
       }
-      // Add key to current list of index keys.
-      index_keys.insert(index_key);
+      std::unique_ptr<StorageIterator> index_itr;
+      ZETASQL_RETURN_IF_ERROR(storage->Read(
+          timestamp, index->index_data_table()->id(),
+          KeyRange::Prefix(index_key), /*column_ids=*/{}, &index_itr));
+      while (index_itr->Next()) {
+        if (!(index_itr->Key() == index_rows[i].first)) {
+          return error::UniqueIndexViolationOnIndexCreation(
+              index->Name(), index_key.DebugString());
+        }
+      }
+      ZETASQL_RETURN_IF_ERROR(index_itr->Status());
     }
+  }
 
-    // Insert the new row in the index.
-    ZETASQL_RETURN_IF_ERROR(context->storage()->Write(
-        context->pending_commit_timestamp(), index->index_data_table()->id(),
-        index_data_table_key, index_column_ids, index_values));
+  return storage->BatchWrite(timestamp, index->index_data_table()->id(),
+                             index_column_ids, index_rows);
+}
+
+absl::Status BackfillSearchIndex(const Index* index,
+                                 const SchemaValidationContext* context) {
+  InvertedIndex* inverted_index = index->inverted_index();
+  ZETASQL_RET_CHECK_NE(inverted_index, nullptr);
+
+  // Read the TOKENLIST columns of the index from the indexed table.
+  std::vector<ColumnID> token_column_ids;
+  for (const KeyColumn* key_column : index->key_columns()) {
+    const Column* column = key_column->column()->source_column();
+    if (column->GetType()->IsTokenList()) {
+      token_column_ids.push_back(column->id());
+    }
+  }
+  std::unique_ptr<StorageIterator> itr;
+  ZETASQL_RETURN_IF_ERROR(context->storage()->Read(
+      context->pending_commit_timestamp(), index->indexed_table()->id(),
+      KeyRange::All(), token_column_ids, &itr));
+  while (itr->Next()) {
+    for (int i = 0; i < itr->NumColumns(); ++i) {
+      // Storage returns invalid values for columns that were never written.
+      if (!itr->ColumnValue(i).is_valid()) {
+        continue;
+      }
+      ZETASQL_RETURN_IF_ERROR(inverted_index->CommitTokenList(
+          token_column_ids[i], itr->Key(), itr->ColumnValue(i),
+          context->pending_commit_timestamp()));
+    }
   }
+  return itr->Status();
+}
 
-  return absl::OkStatus();
+absl::Status BackfillVectorIndex(const Index* index,
+                                 const SchemaValidationContext* context) {
+  AnnIndex* ann_index = index->ann_index();
+  ZETASQL_RET_CHECK_NE(ann_index, nullptr);
+  ZETASQL_RET_CHECK_EQ(index->key_columns().size(), 1);
+
+  // Read the embedding column of the index from the indexed table.
+  const Column* column = index->key_columns()[0]->column()->source_column();
+  std::unique_ptr<StorageIterator> itr;
+  ZETASQL_RETURN_IF_ERROR(context->storage()->Read(
+      context->pending_commit_timestamp(), index->indexed_table()->id(),
+      KeyRange::All(), {column->id()}, &itr));
+  while (itr->Next()) {
+    // Storage returns invalid values for columns that were never written.
+    if (!itr->ColumnValue(0).is_valid()) {
+      continue;
+    }
+    ZETASQL_RETURN_IF_ERROR(ann_index->CommitVector(
+        itr->Key(), itr->ColumnValue(0), context->pending_commit_timestamp()));
+  }
+  return itr->Status();
 }
 
 }  // namespace backend
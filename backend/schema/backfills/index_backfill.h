@@ -17,8 +17,14 @@
 #ifndef THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_SCHEMA_UPDATER_BACKFILL_BACKFILL_H_
 #define THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_SCHEMA_UPDATER_BACKFILL_BACKFILL_H_
 
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/time/time.h"
+#include "backend/datamodel/key_range.h"
 #include "backend/schema/catalog/index.h"
 #include "backend/schema/updater/schema_validation_context.h"
+#include "backend/storage/storage.h"
 #include "absl/status/status.h"
 
 namespace google {
@@ -30,6 +36,28 @@ namespace backend {
 absl::Status BackfillIndex(const Index* index,
                            const SchemaValidationContext* context);
 
+// Splits the indexed table of a write-only `index` into key ranges that are
+// backfilled one at a time with BackfillIndexKeyRange. Rows inserted into the
+// table later also fall into one of the ranges.
+absl::StatusOr<std::vector<KeyRange>> GetIndexBackfillKeyRanges(
+    const Index* index, absl::Time timestamp, const Storage* storage);
+
+// Backfills the entries of a write-only `index` for the indexed table rows in
+// `key_range` at `timestamp`. Entries already written by transactions since the
+// index was created are rewritten with the same values. For a unique index,
+// the new entries are also checked against the existing entries of the index.
+absl::Status BackfillIndexKeyRange(const Index* index,
+                                   const KeyRange& key_range,
+                                   absl::Time timestamp, Storage* storage);
+
+// Handles backfilling of the posting lists of a newly created search index.
+absl::Status BackfillSearchIndex(const Index* index,
+                                 const SchemaValidationContext* context);
+
+// Handles backfilling of the vectors of a newly created vector index.
+absl::Status BackfillVectorIndex(const Index* index,
+                                 const SchemaValidationContext* context);
+
 // Handles backfilling of a newly added column into the index.
 absl::Status BackfillIndexAddedColumn(const Index* index,
                                       const Column* added_column,
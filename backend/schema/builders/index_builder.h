@@ -22,10 +22,13 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "absl/memory/memory.h"
 #include "backend/common/ids.h"
+#include "backend/common/ann_index.h"
+#include "backend/common/inverted_index.h"
 #include "backend/schema/catalog/column.h"
 #include "backend/schema/catalog/locality_group.h"
 #include "backend/schema/catalog/table.h"
@@ -83,6 +86,11 @@ class Index::Builder {
     return *this;
   }
 
+  Builder& set_write_only(bool write_only) {
+    instance_->is_write_only_ = write_only;
+    return *this;
+  }
+
   Builder& add_managing_node(const SchemaNode* node) {
     instance_->managing_nodes_.push_back(node);
     return *this;
@@ -110,6 +118,16 @@ class Index::Builder {
     return *this;
   }
 
+  Builder& set_inverted_index(std::shared_ptr<InvertedIndex> inverted_index) {
+    instance_->inverted_index_ = std::move(inverted_index);
+    return *this;
+  }
+
+  Builder& set_ann_index(std::shared_ptr<AnnIndex> ann_index) {
+    instance_->ann_index_ = std::move(ann_index);
+    return *this;
+  }
+
   Builder& add_null_filtered_column(const Column* column) {
     instance_->null_filtered_columns_.push_back(column);
     return *this;
@@ -159,6 +177,11 @@ class Index::Editor {
     return *this;
   }
 
+  Editor& set_write_only(bool write_only) {
+    instance_->is_write_only_ = write_only;
+    return *this;
+  }
+
   Editor& set_locality_group(const LocalityGroup* locality_group) {
     instance_->locality_group_ = locality_group;
     return *this;
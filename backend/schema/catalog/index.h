@@ -27,6 +27,8 @@
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
 #include "absl/types/span.h"
+#include "backend/common/ann_index.h"
+#include "backend/common/inverted_index.h"
 #include "backend/schema/catalog/column.h"
 #include "backend/schema/catalog/locality_group.h"
 #include "backend/schema/catalog/table.h"
@@ -106,6 +108,11 @@ class Index : public SchemaNode {
   // Returns true if this index has NULL_FILTERED enabled.
   bool is_null_filtered() const { return is_null_filtered_; }
 
+  // Returns true if this index is still being backfilled. A write-only index
+  // is maintained by transactions writing to the indexed table, but cannot be
+  // read from until its backfill has completed.
+  bool is_write_only() const { return is_write_only_; }
+
   // Returns true if this index is managed by other schema nodes. Managed
   // indexes are regular indexes except for their lifecycles. Users cannot
   // create, alter or drop managed indexes.
@@ -131,6 +138,15 @@ class Index : public SchemaNode {
   // Returns the list of order by column defined in the search index.
   absl::Span<const KeyColumn* const> order_by() const { return order_by_; }
 
+  // Returns the posting lists of a search index, which are shared by all the
+  // versions of the schema containing it. Null for other indexes.
+  InvertedIndex* inverted_index() const { return inverted_index_.get(); }
+
+  // Returns the vectors of a vector index with a distance type, which are
+  // shared by all the versions of the schema containing it. Null for other
+  // indexes.
+  AnnIndex* ann_index() const { return ann_index_.get(); }
+
   // Returns a detailed string which lists information about this index.
   std::string FullDebugString() const;
 
@@ -216,6 +232,10 @@ class Index : public SchemaNode {
   // Whether this index has NULL_FILTERED enabled which applies to all index key
   // columns.
   bool is_null_filtered_ = false;
+
+  // Whether this index is still being backfilled, see is_write_only().
+  bool is_write_only_ = false;
+
   // Columns specified in the WHERE IS NOT NULL clause. References are
   // to the corresponding columns in 'index_data_table_'.
   std::vector<const Column*> null_filtered_columns_;
@@ -232,9 +252,17 @@ class Index : public SchemaNode {
   // is ordered by. If this is empty, then the index is unordered.
   std::vector<const KeyColumn*> order_by_;
 
+  // Applies only to search index. The posting lists of the index, maintained
+  // as the indexed table is written.
+  std::shared_ptr<InvertedIndex> inverted_index_;
+
   // Applies only to vector index. The options for the vector index.
   ddl::VectorIndexOptionsProto vector_index_options_;
 
+  // Applies only to vector index with a distance type. The vectors of the
+  // index, maintained as the indexed table is written.
+  std::shared_ptr<AnnIndex> ann_index_;
+
   // The locality group this index belongs to.
   const LocalityGroup* locality_group_ = nullptr;
 };
@@ -19,9 +19,11 @@
 #include <algorithm>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "zetasql/base/logging.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -60,7 +62,10 @@ absl::Status SchemaGraphEditor::FixupInternal(const SchemaNode* original,
   ZETASQL_VLOG(4) << std::string(depth_, ' ') << "Fixing "
           << NodeKindString(mutable_clone) << " node :" << mutable_clone;
   ++depth_;
-  ZETASQL_RETURN_IF_ERROR(mutable_clone->DeepClone(this, original));
+  fixup_stack_.push_back(mutable_clone);
+  absl::Status status = mutable_clone->DeepClone(this, original);
+  fixup_stack_.pop_back();
+  ZETASQL_RETURN_IF_ERROR(status);
   --depth_;
   ZETASQL_VLOG(4) << std::string(depth_, ' ')
           << "Finished fixing node: " << mutable_clone->DebugString();
@@ -111,6 +116,13 @@ absl::StatusOr<const SchemaNode*> SchemaGraphEditor::Clone(
             << "Finished cloning node: " << node->DebugString();
     ret = mutable_clone;
   }
+
+  // Record the reference from the node being fixed up to `ret`.
+  if (!fixup_stack_.empty() && fixup_stack_.back() != ret) {
+    neighbors_[fixup_stack_.back()].push_back(ret);
+    neighbors_[ret].push_back(fixup_stack_.back());
+    referencing_nodes_.insert(fixup_stack_.back());
+  }
   return ret;
 }
 
@@ -128,17 +140,53 @@ absl::Status SchemaGraphEditor::AddNode(
   ZETASQL_RET_CHECK(deleted_nodes_.empty())
       << "Graph already has deleted nodes. It must be canonicalized before "
       << "making further changes.";
+  added_node_set_.insert(node.get());
   added_nodes_.emplace_back(std::move(node));
   return absl::OkStatus();
 }
 
 bool SchemaGraphEditor::IsOriginalNode(const SchemaNode* node) const {
-  for (const auto* schema_node : original_graph_->GetSchemaNodes()) {
-    if (schema_node == node) {
-      return true;
+  return original_nodes_.contains(node);
+}
+
+absl::flat_hash_set<const SchemaNode*>
+SchemaGraphEditor::GetNodesAffectedByChanges() const {
+  std::vector<const SchemaNode*> pending(edited_clones_.begin(),
+                                         edited_clones_.end());
+  pending.insert(pending.end(), added_node_set_.begin(),
+                 added_node_set_.end());
+  for (const auto* node : deleted_nodes_) {
+    pending.push_back(FindClone(node));
+  }
+  // Include the nodes deleted in cascade.
+  for (const auto& [original, clone] : clone_map_) {
+    if (clone->is_deleted()) {
+      pending.push_back(clone);
+    }
+  }
+
+  // Nodes which hold no references to other nodes can still refer to them by
+  // name (e.g. property graphs refer to their element tables by name), so
+  // they are validated on every change.
+  for (const auto& [original, clone] : clone_map_) {
+    if (!referencing_nodes_.contains(clone)) {
+      pending.push_back(clone);
+    }
+  }
+
+  absl::flat_hash_set<const SchemaNode*> affected;
+  while (!pending.empty()) {
+    const SchemaNode* node = pending.back();
+    pending.pop_back();
+    if (node == nullptr || !affected.insert(node).second) {
+      continue;
+    }
+    auto it = neighbors_.find(node);
+    if (it != neighbors_.end()) {
+      pending.insert(pending.end(), it->second.begin(), it->second.end());
     }
   }
-  return false;
+  return affected;
 }
 
 absl::StatusOr<std::unique_ptr<SchemaGraph>>
@@ -170,10 +218,16 @@ SchemaGraphEditor::CanonicalizeGraph() {
   context_->MakeNewTempSchemaSnapshot(cloned_graph.get());
 
   // Validate the update on cloned nodes which still includes edited and
-  // deleted nodes.
+  // deleted nodes. Nodes which are not connected to any change are identical
+  // to their originals and are skipped.
+  const absl::flat_hash_set<const SchemaNode*> affected_nodes =
+      GetNodesAffectedByChanges();
   for (const auto* orig_node : original_graph_->GetSchemaNodes()) {
     auto clone = FindClone(orig_node);
     ZETASQL_RET_CHECK_NE(clone, nullptr);
+    if (!affected_nodes.contains(clone)) {
+      continue;
+    }
     ZETASQL_RETURN_IF_ERROR(clone->ValidateUpdate(orig_node, context_));
   }
 
@@ -185,6 +239,9 @@ SchemaGraphEditor::CanonicalizeGraph() {
   // Do a final pass on the canonicalized set of nodes to perform per-node
   // validation.
   for (const auto* node : cloned_graph->GetSchemaNodes()) {
+    if (!affected_nodes.contains(node)) {
+      continue;
+    }
     ZETASQL_RETURN_IF_ERROR(node->Validate(context_));
   }
   context_->ClearNewTempSchemaSnapshot();
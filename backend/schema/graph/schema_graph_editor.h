@@ -58,13 +58,18 @@ namespace backend {
 // During CanonicalizeGraph(), this class may call Validate() and
 // ValidateUpdate() on the SchemaNodes(s) in the new and old graph respectively.
 // Validate() and ValidateUpdate() are called in the same order in which the
-// nodes were added to the containing SchemaGraph.
+// nodes were added to the containing SchemaGraph. Only nodes connected to an
+// added, edited or deleted node are validated: every other node and all of its
+// neighbors are unchanged clones of nodes that were validated when the
+// original graph was built.
 class SchemaGraphEditor {
  public:
   SchemaGraphEditor(const SchemaGraph* original_graph,
                     SchemaValidationContext* context)
       : original_graph_(original_graph),
         context_(context),
+        original_nodes_(original_graph->GetSchemaNodes().begin(),
+                        original_graph->GetSchemaNodes().end()),
         cloned_pool_(std::make_unique<SchemaObjectsPool>()) {
     context_->set_added_nodes(&added_nodes_);
   }
@@ -223,12 +228,7 @@ class SchemaGraphEditor {
     if (IsOriginalNode(node)) {
       return kOriginal;
     }
-    auto it = std::find_if(
-        added_nodes_.begin(), added_nodes_.end(),
-        [&node](const std::unique_ptr<const SchemaNode>& node_ptr) {
-          return node_ptr.get() == node;
-        });
-    if (it != added_nodes_.end()) {
+    if (added_node_set_.contains(node)) {
       return kAdded;
     }
     auto it_deleted = std::find_if(
@@ -265,6 +265,11 @@ class SchemaGraphEditor {
   absl::Status FixupInternal(const SchemaNode* original,
                              SchemaNode* mutable_clone);
 
+  // Returns the nodes of the new graph that are connected to an added, edited
+  // or deleted node, and the nodes which do not reference other nodes. These
+  // are the only nodes that need validation.
+  absl::flat_hash_set<const SchemaNode*> GetNodesAffectedByChanges() const;
+
   // Canonicalizes the graph to process any pending edits/additions.
   absl::Status CanonicalizeEdits();
 
@@ -289,6 +294,20 @@ class SchemaGraphEditor {
   // Number of deleted nodes.
   int trimmed_ = 0;
 
+  // The nodes in the original graph.
+  absl::flat_hash_set<const SchemaNode*> original_nodes_;
+
+  // The nodes whose references are currently being fixed up, innermost last.
+  std::vector<const SchemaNode*> fixup_stack_;
+
+  // Nodes in the new graph referenced by, or referencing, each node. Recorded
+  // while cloning and used to find the nodes affected by changes.
+  absl::flat_hash_map<const SchemaNode*, std::vector<const SchemaNode*>>
+      neighbors_;
+
+  // Nodes in the new graph which reference at least one other node.
+  absl::flat_hash_set<const SchemaNode*> referencing_nodes_;
+
   // Mapping of original nodes to clones.
   absl::flat_hash_map<const SchemaNode*, const SchemaNode*> clone_map_;
 
@@ -311,6 +330,10 @@ class SchemaGraphEditor {
   // The nodes added to the graph.
   std::vector<std::unique_ptr<const SchemaNode>> added_nodes_;
 
+  // The nodes added to the graph, which remain valid after ownership of
+  // `added_nodes_` is transferred to the new graph.
+  absl::flat_hash_set<const SchemaNode*> added_node_set_;
+
   // Clones that were modified/edited.
   absl::flat_hash_set<const SchemaNode*> edited_clones_;
 };
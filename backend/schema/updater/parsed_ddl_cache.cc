@@ -0,0 +1,107 @@
+//
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "backend/schema/updater/parsed_ddl_cache.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "backend/schema/ddl/operations.pb.h"
+#include "common/feature_flags.h"
+#include "farmhash.h"
+#include "zetasql/base/status_macros.h"
+
+namespace google {
+namespace spanner {
+namespace emulator {
+namespace backend {
+
+namespace {
+
+// Maximum number of statements in the process-wide cache.
+constexpr int kMaxCachedStatements = 100000;
+
+// Returns the cache key for a statement. Feature flags are part of the key as
+// they enable or disable parts of the DDL grammar.
+std::string CacheKey(absl::string_view statement,
+                     database_api::DatabaseDialect dialect) {
+  using Flags = EmulatorFeatureFlags::Flags;
+  static_assert(std::is_trivially_copyable_v<Flags>);
+  const Flags flags = EmulatorFeatureFlags::instance().flags();
+  const uint64_t flags_fingerprint = farmhash::Fingerprint64(
+      reinterpret_cast<const char*>(&flags), sizeof(flags));
+  return absl::StrCat(dialect, ":", flags_fingerprint, ":", statement);
+}
+
+}  // namespace
+
+ParsedDDLCache& ParsedDDLCache::instance() {
+  static ParsedDDLCache* instance = new ParsedDDLCache(kMaxCachedStatements);
+  return *instance;
+}
+
+absl::StatusOr<std::unique_ptr<ddl::DDLStatement>> ParsedDDLCache::GetOrParse(
+    absl::string_view statement, database_api::DatabaseDialect dialect,
+    const ParseFn& parse_fn) {
+  std::string key = CacheKey(statement, dialect);
+  {
+    absl::MutexLock lock(&mu_);
+    auto it = statements_.find(key);
+    if (it != statements_.end()) {
+      ++hits_;
+      return std::make_unique<ddl::DDLStatement>(*it->second);
+    }
+    ++misses_;
+  }
+
+  // Parse outside of the lock so that concurrent misses don't serialize.
+  ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<ddl::DDLStatement> ddl_statement,
+                   parse_fn());
+  auto cached = std::make_shared<const ddl::DDLStatement>(*ddl_statement);
+  absl::MutexLock lock(&mu_);
+  if (statements_.size() >= max_entries_) {
+    statements_.clear();
+  }
+  statements_.emplace(std::move(key), std::move(cached));
+  return ddl_statement;
+}
+
+void ParsedDDLCache::Clear() {
+  absl::MutexLock lock(&mu_);
+  statements_.clear();
+}
+
+int64_t ParsedDDLCache::hits() const {
+  absl::MutexLock lock(&mu_);
+  return hits_;
+}
+
+int64_t ParsedDDLCache::misses() const {
+  absl::MutexLock lock(&mu_);
+  return misses_;
+}
+
+}  // namespace backend
+}  // namespace emulator
+}  // namespace spanner
+}  // namespace google
@@ -0,0 +1,95 @@
+//
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_SCHEMA_UPDATER_PARSED_DDL_CACHE_H_
+#define THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_SCHEMA_UPDATER_PARSED_DDL_CACHE_H_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "google/spanner/admin/database/v1/common.pb.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "backend/schema/ddl/operations.pb.h"
+
+namespace google {
+namespace spanner {
+namespace emulator {
+namespace backend {
+
+namespace database_api = ::google::spanner::admin::database::v1;
+
+// ParsedDDLCache is a process-wide cache of parsed DDL statements.
+//
+// Parsing a statement (with the JavaCC DDL parser for GoogleSQL, or with the
+// PostgreSQL parser and the PostgreSQL to Spanner DDL translator) only depends
+// on the dialect, the statement text and the emulator feature flags, so
+// databases created and updated with identical DDL, as is common for test
+// fleets, can share the parsed statements.
+//
+// Schema objects themselves are not shared between databases since they are
+// bound to the database's type factory, table/column ids and sequence state.
+//
+// This class is thread safe.
+class ParsedDDLCache {
+ public:
+  using ParseFn =
+      std::function<absl::StatusOr<std::unique_ptr<ddl::DDLStatement>>()>;
+
+  explicit ParsedDDLCache(int max_entries) : max_entries_(max_entries) {}
+
+  // Returns the process-wide cache.
+  static ParsedDDLCache& instance();
+
+  // Returns a copy of the cached parse of `statement` for `dialect` and the
+  // current feature flags. On a miss, calls `parse_fn` to parse the statement
+  // and caches the result if parsing succeeded.
+  absl::StatusOr<std::unique_ptr<ddl::DDLStatement>> GetOrParse(
+      absl::string_view statement, database_api::DatabaseDialect dialect,
+      const ParseFn& parse_fn) ABSL_LOCKS_EXCLUDED(mu_);
+
+  // Removes all cached statements.
+  void Clear() ABSL_LOCKS_EXCLUDED(mu_);
+
+  // Number of lookups served from and missed by the cache.
+  int64_t hits() const ABSL_LOCKS_EXCLUDED(mu_);
+  int64_t misses() const ABSL_LOCKS_EXCLUDED(mu_);
+
+ private:
+  // Maximum number of cached statements. The cache is cleared when full.
+  const int max_entries_;
+
+  // Cached statements keyed by dialect, feature flags and statement text.
+  absl::flat_hash_map<std::string, std::shared_ptr<const ddl::DDLStatement>>
+      statements_ ABSL_GUARDED_BY(mu_);
+
+  int64_t hits_ ABSL_GUARDED_BY(mu_) = 0;
+  int64_t misses_ ABSL_GUARDED_BY(mu_) = 0;
+
+  mutable absl::Mutex mu_;
+};
+
+}  // namespace backend
+}  // namespace emulator
+}  // namespace spanner
+}  // namespace google
+
+#endif  // THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_SCHEMA_UPDATER_PARSED_DDL_CACHE_H_
@@ -0,0 +1,114 @@
+//
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "backend/schema/updater/parsed_ddl_cache.h"
+
+#include <memory>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "zetasql/base/testing/status_matchers.h"
+#include "tests/common/proto_matchers.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "backend/schema/ddl/operations.pb.h"
+#include "tests/common/scoped_feature_flags_setter.h"
+
+namespace google {
+namespace spanner {
+namespace emulator {
+namespace backend {
+
+namespace {
+
+using zetasql_base::testing::StatusIs;
+
+constexpr char kStatement[] = "CREATE TABLE T (K INT64) PRIMARY KEY (K)";
+
+class ParsedDDLCacheTest : public testing::Test {
+ protected:
+  // Returns a parse function which counts its invocations.
+  ParsedDDLCache::ParseFn CountingParseFn() {
+    return [this]() -> absl::StatusOr<std::unique_ptr<ddl::DDLStatement>> {
+      ++num_parses_;
+      auto statement = std::make_unique<ddl::DDLStatement>();
+      statement->mutable_create_table()->set_table_name("T");
+      return statement;
+    };
+  }
+
+  ParsedDDLCache cache_{/*max_entries=*/2};
+  int num_parses_ = 0;
+};
+
+TEST_F(ParsedDDLCacheTest, IdenticalStatementIsParsedOnce) {
+  for (int i = 0; i < 3; ++i) {
+    ZETASQL_ASSERT_OK_AND_ASSIGN(
+        auto statement,
+        cache_.GetOrParse(kStatement,
+                          database_api::DatabaseDialect::GOOGLE_STANDARD_SQL,
+                          CountingParseFn()));
+    EXPECT_EQ(statement->create_table().table_name(), "T");
+  }
+  EXPECT_EQ(num_parses_, 1);
+  EXPECT_EQ(cache_.hits(), 2);
+  EXPECT_EQ(cache_.misses(), 1);
+}
+
+TEST_F(ParsedDDLCacheTest, DialectAndFeatureFlagsArePartOfTheKey) {
+  ZETASQL_ASSERT_OK(cache_
+                .GetOrParse(kStatement,
+                            database_api::DatabaseDialect::GOOGLE_STANDARD_SQL,
+                            CountingParseFn())
+                .status());
+  ZETASQL_ASSERT_OK(cache_
+                .GetOrParse(kStatement,
+                            database_api::DatabaseDialect::POSTGRESQL,
+                            CountingParseFn())
+                .status());
+  EXPECT_EQ(num_parses_, 2);
+
+  emulator::test::ScopedEmulatorFeatureFlagsSetter setter(
+      {.enable_identity_columns = false});
+  ZETASQL_ASSERT_OK(cache_
+                .GetOrParse(kStatement,
+                            database_api::DatabaseDialect::GOOGLE_STANDARD_SQL,
+                            CountingParseFn())
+                .status());
+  EXPECT_EQ(num_parses_, 3);
+}
+
+TEST_F(ParsedDDLCacheTest, ParseErrorsAreNotCached) {
+  auto failing_parse_fn =
+      [this]() -> absl::StatusOr<std::unique_ptr<ddl::DDLStatement>> {
+    ++num_parses_;
+    return absl::InvalidArgumentError("syntax error");
+  };
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_THAT(
+        cache_.GetOrParse("CREATE", database_api::DatabaseDialect::POSTGRESQL,
+                          failing_parse_fn),
+        StatusIs(absl::StatusCode::kInvalidArgument));
+  }
+  EXPECT_EQ(num_parses_, 2);
+}
+
+}  // namespace
+
+}  // namespace backend
+}  // namespace emulator
+}  // namespace spanner
+}  // namespace google
@@ -64,6 +64,8 @@
 #include "absl/types/span.h"
 #include "backend/common/case.h"
 #include "backend/common/ids.h"
+#include "backend/common/ann_index.h"
+#include "backend/common/inverted_index.h"
 #include "backend/common/utils.h"
 #include "backend/database/pg_oid_assigner/pg_oid_assigner.h"
 #include "backend/datamodel/types.h"
@@ -113,6 +115,7 @@
 #include "backend/schema/parser/ddl_parser.h"
 #include "backend/schema/updater/ddl_type_conversion.h"
 #include "backend/schema/updater/global_schema_names.h"
+#include "backend/schema/updater/parsed_ddl_cache.h"
 #include "backend/schema/updater/schema_validation_context.h"
 #include "backend/schema/updater/sql_expression_validators.h"
 #include "backend/schema/verifiers/check_constraint_verifiers.h"
@@ -234,10 +237,25 @@ class SchemaUpdaterImpl {
   absl::StatusOr<std::vector<SchemaValidationContext>> ApplyDDLStatements(
       const SchemaChangeOperation& schema_change_operation);
 
+  // Makes the write-only indexes `index_names` of `latest_schema_` readable
+  // and returns the resulting schema.
+  absl::StatusOr<std::unique_ptr<const Schema>> MakeIndexesReadable(
+      absl::Span<const std::string> index_names);
+
+  // Drops the write-only indexes `index_names` from `latest_schema_` and
+  // returns the resulting schema.
+  absl::StatusOr<std::unique_ptr<const Schema>> DropWriteOnlyIndexes(
+      absl::Span<const std::string> index_names);
+
   std::vector<std::unique_ptr<const Schema>> GetIntermediateSchemas() {
     return std::move(intermediate_schemas_);
   }
 
+  // Returns the index of the statement of each intermediate schema.
+  std::vector<int> GetIntermediateSchemaStatementIndexes() {
+    return std::move(statement_indexes_);
+  }
+
  private:
   SchemaUpdaterImpl(zetasql::TypeFactory* type_factory,
                     TableIDGenerator* table_id_generator,
@@ -257,6 +275,12 @@ class SchemaUpdaterImpl {
   // Initializes potentially failing components after construction.
   absl::Status Init();
 
+  // Applies the schema graph edits made by `edit_cb` on to `latest_schema_`,
+  // for schema changes that are not made by a DDL statement. No schema change
+  // actions may result from the edits.
+  absl::StatusOr<std::unique_ptr<const Schema>> ApplySchemaEdit(
+      const std::function<absl::Status()>& edit_cb);
+
   // Applies the given `statement` on to `latest_schema_`. Please note that
   // it can return a nullptr if the statement is a no-op and no changes are
   // made.
@@ -483,7 +507,8 @@ class SchemaUpdaterImpl {
       const std::string& pk_column_name, Table::Builder* builder);
 
   absl::StatusOr<const Index*> CreateIndex(
-      const ddl::CreateIndex& ddl_index, const Table* indexed_table = nullptr);
+      const ddl::CreateIndex& ddl_index, const Table* indexed_table = nullptr,
+      bool write_only = false);
   absl::StatusOr<const Index*> CreateVectorIndex(
       const ddl::CreateVectorIndex& ddl_index,
       const Table* indexed_table = nullptr);
@@ -506,7 +531,7 @@ class SchemaUpdaterImpl {
       const ::google::protobuf::RepeatedPtrField<ddl::KeyPartClause>* order_by,
       const ::google::protobuf::RepeatedPtrField<std::string>* null_filtered_columns,
       const ::google::protobuf::RepeatedPtrField<ddl::SetOption>* set_options,
-      const Table* indexed_table);
+      const Table* indexed_table, bool write_only);
 
   absl::flat_hash_set<const SchemaNode*>
   GatherTransitiveDependenciesForSchemaNode(
@@ -719,6 +744,10 @@ class SchemaUpdaterImpl {
   // applying each statement.
   std::vector<std::unique_ptr<const Schema>> intermediate_schemas_;
 
+  // The index of the statement of each intermediate schema, which differs from
+  // the index of the intermediate schema after no-op statements.
+  std::vector<int> statement_indexes_;
+
   // Validation context for the statement being currently processed.
   // This is also being used in SchemaGraphEditor. Please make sure this is only
   // passed by reference.
@@ -736,6 +765,10 @@ class SchemaUpdaterImpl {
 
   // Holds the database id for this schema updater.
   std::string database_id_;
+
+  // Whether indexes created by CREATE INDEX statements are write-only and left
+  // for the caller to backfill.
+  bool backfill_indexes_in_background_ = false;
 };
 
 absl::Status SchemaUpdaterImpl::Init() {
@@ -833,7 +866,11 @@ SchemaUpdaterImpl::ApplyDDLStatement(
               ddl::IF_NOT_EXISTS) {
         break;
       }
-      ZETASQL_RETURN_IF_ERROR(CreateIndex(ddl_statement->create_index()).status());
+      ZETASQL_RETURN_IF_ERROR(CreateIndex(ddl_statement->create_index(),
+                                  /*indexed_table=*/nullptr,
+                                  /*write_only=*/
+                                  backfill_indexes_in_background_)
+                          .status());
       break;
     }
     case ddl::DDLStatement::kCreateFunction: {
@@ -1102,8 +1139,11 @@ absl::StatusOr<std::vector<SchemaValidationContext>>
 SchemaUpdaterImpl::ApplyDDLStatements(
     const SchemaChangeOperation& schema_change_operation) {
   std::vector<SchemaValidationContext> pending_work;
+  backfill_indexes_in_background_ =
+      schema_change_operation.backfill_indexes_in_background;
 
-  for (const auto& statement : schema_change_operation.statements) {
+  for (int i = 0; i < schema_change_operation.statements.size(); ++i) {
+    const std::string& statement = schema_change_operation.statements[i];
     ZETASQL_VLOG(2) << "Applying statement " << statement;
 
     // Set up the SchemaValidationContext before passing it to `editor_`. This
@@ -1152,6 +1192,7 @@ SchemaUpdaterImpl::ApplyDDLStatements(
     statement_context_->SetValidatedNewSchemaSnapshot(new_schema.get());
     latest_schema_ = new_schema.get();
     intermediate_schemas_.emplace_back(std::move(new_schema));
+    statement_indexes_.push_back(i);
     pg_oid_assigner_->MarkNextPostgresqlOidForIntermediateSchema();
 
     // If everything was OK, make this the new schema snapshot for processing
@@ -1163,6 +1204,68 @@ SchemaUpdaterImpl::ApplyDDLStatements(
   return pending_work;
 }
 
+absl::StatusOr<std::unique_ptr<const Schema>>
+SchemaUpdaterImpl::ApplySchemaEdit(
+    const std::function<absl::Status()>& edit_cb) {
+  // Set up the statement context and editor as for a DDL statement, see
+  // ApplyDDLStatements.
+  std::unique_ptr<const Schema> new_tmp_schema = nullptr;
+  SchemaValidationContext statement_context{
+      storage_, &global_names_, type_factory_, schema_change_timestamp_,
+      latest_schema_->dialect()};
+  statement_context_ = &statement_context;
+  statement_context_->SetOldSchemaSnapshot(latest_schema_);
+  statement_context_->SetTempNewSchemaSnapshotConstructor(
+      [this,
+       &new_tmp_schema](const SchemaGraph* unowned_graph) -> const Schema* {
+        new_tmp_schema = std::make_unique<const Schema>(
+            unowned_graph, latest_schema_->proto_bundle(),
+            latest_schema_->dialect(), database_id_);
+        return new_tmp_schema.get();
+      });
+  editor_ = std::make_unique<SchemaGraphEditor>(
+      latest_schema_->GetSchemaGraph(), statement_context_);
+
+  ZETASQL_RETURN_IF_ERROR(edit_cb());
+  ZETASQL_ASSIGN_OR_RETURN(auto new_schema_graph, editor_->CanonicalizeGraph());
+  ZETASQL_RET_CHECK_EQ(statement_context.num_actions(), 0);
+  return std::make_unique<const OwningSchema>(
+      std::move(new_schema_graph), latest_schema_->proto_bundle(),
+      latest_schema_->dialect(), database_id_);
+}
+
+absl::StatusOr<std::unique_ptr<const Schema>>
+SchemaUpdaterImpl::MakeIndexesReadable(
+    absl::Span<const std::string> index_names) {
+  return ApplySchemaEdit([&]() -> absl::Status {
+    for (const std::string& index_name : index_names) {
+      const Index* index = latest_schema_->FindIndexCaseSensitive(index_name);
+      ZETASQL_RET_CHECK(index != nullptr && index->is_write_only()) << index_name;
+      ZETASQL_RETURN_IF_ERROR(AlterNode<Index>(
+          index, [](Index::Editor* editor) -> absl::Status {
+            editor->set_write_only(false);
+            return absl::OkStatus();
+          }));
+    }
+    return absl::OkStatus();
+  });
+}
+
+absl::StatusOr<std::unique_ptr<const Schema>>
+SchemaUpdaterImpl::DropWriteOnlyIndexes(
+    absl::Span<const std::string> index_names) {
+  return ApplySchemaEdit([&]() -> absl::Status {
+    for (const std::string& index_name : index_names) {
+      const Index* index = latest_schema_->FindIndexCaseSensitive(index_name);
+      ZETASQL_RET_CHECK(index != nullptr && index->is_write_only()) << index_name;
+      ddl::DropIndex drop_index;
+      drop_index.set_index_name(index_name);
+      ZETASQL_RETURN_IF_ERROR(DropIndex(drop_index));
+    }
+    return absl::OkStatus();
+  });
+}
+
 template <typename Modifier>
 absl::Status SchemaUpdaterImpl::ProcessLocalityGroupOption(
     const ddl::SetOption& option, Modifier* modifier) {
@@ -3428,7 +3531,8 @@ SchemaUpdaterImpl::CreateIndexDataTable(
 }
 
 absl::StatusOr<const Index*> SchemaUpdaterImpl::CreateIndex(
-    const ddl::CreateIndex& ddl_index, const Table* indexed_table) {
+    const ddl::CreateIndex& ddl_index, const Table* indexed_table,
+    bool write_only) {
   const std::string* interleave_in_table =
       ddl_index.has_interleave_in_table() ? &ddl_index.interleave_in_table()
                                           : nullptr;
@@ -3457,7 +3561,7 @@ absl::StatusOr<const Index*> SchemaUpdaterImpl::CreateIndex(
       /*partition_by=*/nullptr,
       /*order_by=*/nullptr,
       /*null_filtered_columns=*/&ddl_index.null_filtered_column(),
-      /*set_options=*/set_options, indexed_table);
+      /*set_options=*/set_options, indexed_table, write_only);
 }
 
 const google::protobuf::FieldDescriptor* GetFieldDescriptor(absl::string_view sdl_type,
@@ -3593,6 +3697,44 @@ absl::Status SetVectorIndexOptions(
   return absl::OkStatus();
 }
 
+// Returns the AnnIndex holding the vectors of a vector index with
+// `vector_index_options`, or nullptr if the options have no distance type.
+std::shared_ptr<AnnIndex> CreateAnnIndex(
+    const ddl::VectorIndexOptionsProto& vector_index_options) {
+  ddl::VectorIndexOptionsProto::DistanceType distance_type;
+  if (!vector_index_options.has_distance_type() ||
+      !ddl::VectorIndexOptionsProto::DistanceType_Parse(
+          vector_index_options.distance_type(), &distance_type)) {
+    return nullptr;
+  }
+  AnnIndex::Distance distance;
+  switch (distance_type) {
+    case ddl::VectorIndexOptionsProto::COSINE:
+      distance = AnnIndex::Distance::kCosine;
+      break;
+    case ddl::VectorIndexOptionsProto::EUCLIDEAN:
+      distance = AnnIndex::Distance::kEuclidean;
+      break;
+    case ddl::VectorIndexOptionsProto::DOT_PRODUCT:
+      distance = AnnIndex::Distance::kDotProduct;
+      break;
+    default:
+      return nullptr;
+  }
+  std::optional<int64_t> num_leaves;
+  if (vector_index_options.has_num_leaves()) {
+    num_leaves = vector_index_options.num_leaves();
+  }
+  // Indexes of depth 2 have no branches, the grouping of their leaves into
+  // branches being an implementation detail of AnnIndex.
+  std::optional<int64_t> num_branches;
+  if (vector_index_options.tree_depth() == 3 &&
+      vector_index_options.has_num_branches()) {
+    num_branches = vector_index_options.num_branches();
+  }
+  return std::make_shared<AnnIndex>(distance, num_leaves, num_branches);
+}
+
 absl::StatusOr<const Index*> SchemaUpdaterImpl::CreateVectorIndex(
     const ddl::CreateVectorIndex& ddl_index, const Table* indexed_table) {
   if (ddl_index.partition_by_size() > 0) {
@@ -3616,7 +3758,8 @@ absl::StatusOr<const Index*> SchemaUpdaterImpl::CreateVectorIndex(
       /*partition_by=*/nullptr,
       /*order_by=*/nullptr,
       /*null_filtered_columns=*/&ddl_index.null_filtered_column(),
-      /*set_options=*/&ddl_index.set_options(), indexed_table);
+      /*set_options=*/&ddl_index.set_options(), indexed_table,
+      /*write_only=*/false);
 }
 
 absl::StatusOr<const Index*> SchemaUpdaterImpl::CreateSearchIndex(
@@ -3643,7 +3786,7 @@ absl::StatusOr<const Index*> SchemaUpdaterImpl::CreateSearchIndex(
       ddl_index.stored_column_definition(),
       /*is_search_index=*/true, false, &ddl_index.partition_by(),
       &ddl_index.order_by(), &ddl_index.null_filtered_column(),
-      /*set_options=*/nullptr, indexed_table);
+      /*set_options=*/nullptr, indexed_table, /*write_only=*/false);
 }
 
 absl::StatusOr<const ChangeStream*> SchemaUpdaterImpl::CreateChangeStream(
@@ -3842,7 +3985,7 @@ absl::StatusOr<const Index*> SchemaUpdaterImpl::CreateIndexHelper(
     const ::google::protobuf::RepeatedPtrField<ddl::KeyPartClause>* order_by,
     const ::google::protobuf::RepeatedPtrField<std::string>* null_filtered_columns,
     const ::google::protobuf::RepeatedPtrField<ddl::SetOption>* set_options,
-    const Table* indexed_table) {
+    const Table* indexed_table, bool write_only) {
   if (indexed_table == nullptr) {
     indexed_table = latest_schema_->FindTableCaseSensitive(index_base_name);
     if (indexed_table == nullptr) {
@@ -3866,6 +4009,7 @@ absl::StatusOr<const Index*> SchemaUpdaterImpl::CreateIndexHelper(
   builder.set_name(index_name);
   builder.set_unique(is_unique);
   builder.set_null_filtered(is_null_filtered);
+  builder.set_write_only(write_only);
   ColumnsUsedByIndex columns_used_by_index;
   ZETASQL_ASSIGN_OR_RETURN(
       std::unique_ptr<const Table> data_table,
@@ -3888,6 +4032,7 @@ absl::StatusOr<const Index*> SchemaUpdaterImpl::CreateIndexHelper(
   }
   if (is_search_index) {
     builder.set_index_type(is_search_index);
+    builder.set_inverted_index(std::make_shared<InvertedIndex>());
 
     for (const Column* col : columns_used_by_index.partition_by_columns) {
       builder.add_partition_by_column(col);
@@ -3900,6 +4045,8 @@ absl::StatusOr<const Index*> SchemaUpdaterImpl::CreateIndexHelper(
   if (is_vector_index) {
     builder.set_vector_index_type(is_vector_index);
     ZETASQL_RETURN_IF_ERROR(SetVectorIndexOptions(index_name, *set_options, &builder));
+    builder.set_ann_index(
+        CreateAnnIndex(builder.get()->vector_index_options()));
   }
 
   ZETASQL_RETURN_IF_ERROR(AlterNode<Table>(
@@ -3911,12 +4058,26 @@ absl::StatusOr<const Index*> SchemaUpdaterImpl::CreateIndexHelper(
   // Register a backfill action for the index.
   const Index* index = builder.get();
 
-  if (!is_search_index && !is_vector_index) {
+  if (write_only) {
+    statement_context_->AddWriteOnlyIndex(index_name);
+  } else if (!is_search_index && !is_vector_index) {
     statement_context_->AddAction(
         [index](const SchemaValidationContext* context) {
           return BackfillIndex(index, context);
         });
   }
+  if (is_search_index) {
+    statement_context_->AddAction(
+        [index](const SchemaValidationContext* context) {
+          return BackfillSearchIndex(index, context);
+        });
+  }
+  if (index->ann_index() != nullptr) {
+    statement_context_->AddAction(
+        [index](const SchemaValidationContext* context) {
+          return BackfillVectorIndex(index, context);
+        });
+  }
 
   if (SDLObjectName::IsFullyQualifiedName(index_name)) {
     ZETASQL_RETURN_IF_ERROR(AlterInNamedSchema(
@@ -6180,6 +6341,11 @@ absl::Status SchemaUpdater::RunPendingActions(int* num_succesful) {
   for (const auto& pending_statement : pending_work_) {
     ZETASQL_RETURN_IF_ERROR(pending_statement.RunSchemaChangeActions());
     ++(*num_succesful);
+    // The following statements are applied once the write-only indexes of
+    // this statement have been backfilled by the caller.
+    if (!pending_statement.write_only_indexes().empty()) {
+      break;
+    }
   }
   return absl::OkStatus();
 }
@@ -6198,6 +6364,8 @@ absl::StatusOr<SchemaChangeResult> SchemaUpdater::UpdateSchemaFromDDL(
   ZETASQL_ASSIGN_OR_RETURN(pending_work_,
                    updater.ApplyDDLStatements(schema_change_operation));
   intermediate_schemas_ = updater.GetIntermediateSchemas();
+  std::vector<int> statement_indexes =
+      updater.GetIntermediateSchemaStatementIndexes();
 
   // Use the schema snapshot for the last succesful statement.
   int num_successful = 0;
@@ -6210,13 +6378,47 @@ absl::StatusOr<SchemaChangeResult> SchemaUpdater::UpdateSchemaFromDDL(
         num_successful - 1));
   }
   ZETASQL_RET_CHECK_LE(num_successful, intermediate_schemas_.size());
+  std::vector<std::string> write_only_indexes;
+  int next_statement_index = 0;
+  if (backfill_status.ok() && num_successful > 0) {
+    write_only_indexes = pending_work_[num_successful - 1].write_only_indexes();
+    next_statement_index = statement_indexes[num_successful - 1] + 1;
+  }
   return SchemaChangeResult{
       .num_successful_statements = num_successful,
       .updated_schema = std::move(new_schema),
       .backfill_status = backfill_status,
+      .write_only_indexes = std::move(write_only_indexes),
+      .next_statement_index = next_statement_index,
   };
 }
 
+absl::StatusOr<std::unique_ptr<const Schema>>
+SchemaUpdater::MakeIndexesReadable(const Schema* existing_schema,
+                                   absl::Span<const std::string> index_names,
+                                   const SchemaChangeContext& context) {
+  ZETASQL_ASSIGN_OR_RETURN(SchemaUpdaterImpl updater,
+                   SchemaUpdaterImpl::Build(
+                       context.type_factory, context.table_id_generator,
+                       context.column_id_generator, context.storage,
+                       context.schema_change_timestamp, context.pg_oid_assigner,
+                       existing_schema, context.database_id));
+  return updater.MakeIndexesReadable(index_names);
+}
+
+absl::StatusOr<std::unique_ptr<const Schema>>
+SchemaUpdater::DropWriteOnlyIndexes(const Schema* existing_schema,
+                                    absl::Span<const std::string> index_names,
+                                    const SchemaChangeContext& context) {
+  ZETASQL_ASSIGN_OR_RETURN(SchemaUpdaterImpl updater,
+                   SchemaUpdaterImpl::Build(
+                       context.type_factory, context.table_id_generator,
+                       context.column_id_generator, context.storage,
+                       context.schema_change_timestamp, context.pg_oid_assigner,
+                       existing_schema, context.database_id));
+  return updater.DropWriteOnlyIndexes(index_names);
+}
+
 absl::StatusOr<std::unique_ptr<const Schema>>
 SchemaUpdater::CreateSchemaFromDDL(
     const SchemaChangeOperation& schema_change_operation,
@@ -6230,7 +6432,9 @@ SchemaUpdater::CreateSchemaFromDDL(
   return std::move(result.updated_schema);
 }
 
-absl::StatusOr<std::unique_ptr<ddl::DDLStatement>> ParseDDLByDialect(
+namespace {
+
+absl::StatusOr<std::unique_ptr<ddl::DDLStatement>> ParseDDLByDialectUncached(
     absl::string_view statement, database_api::DatabaseDialect dialect) {
   if (dialect == database_api::DatabaseDialect::POSTGRESQL) {
     ZETASQL_ASSIGN_OR_RETURN(
@@ -6288,6 +6492,15 @@ absl::StatusOr<std::unique_ptr<ddl::DDLStatement>> ParseDDLByDialect(
   }
 }
 
+}  // namespace
+
+absl::StatusOr<std::unique_ptr<ddl::DDLStatement>> ParseDDLByDialect(
+    absl::string_view statement, database_api::DatabaseDialect dialect) {
+  return ParsedDDLCache::instance().GetOrParse(statement, dialect, [&]() {
+    return ParseDDLByDialectUncached(statement, dialect);
+  });
+}
+
 }  // namespace backend
 }  // namespace emulator
 }  // namespace spanner
@@ -47,6 +47,12 @@ struct SchemaChangeOperation {
   absl::string_view proto_descriptor_bytes;
   ::google::spanner::admin::database::v1::DatabaseDialect database_dialect =
       ::google::spanner::admin::database::v1::GOOGLE_STANDARD_SQL;
+
+  // If true, indexes created by CREATE INDEX statements are added in a
+  // write-only state and are not backfilled by the schema updater. Statements
+  // following the first such statement are not applied, see
+  // SchemaChangeResult::write_only_indexes.
+  bool backfill_indexes_in_background = false;
 };
 
 // Database context within which a schema change is processed.
@@ -87,10 +93,20 @@ struct SchemaChangeResult {
   // The error encounterd while processing the first backfill/verifier action
   // that failed. absl::OkStatus() if all schema actions successfully applied.
   absl::Status backfill_status;
+
+  // The write-only indexes created by the last successfully applied statement,
+  // if `backfill_indexes_in_background` was set. The caller backfills them and
+  // then makes them readable with SchemaUpdater::MakeIndexesReadable before
+  // applying the remaining statements.
+  std::vector<std::string> write_only_indexes;
+
+  // The index of the first statement of `schema_change_operation.statements`
+  // that remains to be applied once `write_only_indexes` are readable.
+  int next_statement_index = 0;
 };
 
 // Parses the given statement based on the dialect and returns the DDL
-// statement.
+// statement. Parsed statements are shared process-wide through ParsedDDLCache.
 absl::StatusOr<std::unique_ptr<ddl::DDLStatement>> ParseDDLByDialect(
     absl::string_view statement, database_api::DatabaseDialect dialect);
 
@@ -131,6 +147,18 @@ class SchemaUpdater {
       const SchemaChangeContext& context,
       const Schema* existing_schema = nullptr);
 
+  // Returns `existing_schema` with its write-only indexes `index_names` made
+  // readable, once they have been backfilled.
+  absl::StatusOr<std::unique_ptr<const Schema>> MakeIndexesReadable(
+      const Schema* existing_schema, absl::Span<const std::string> index_names,
+      const SchemaChangeContext& context);
+
+  // Returns `existing_schema` without its write-only indexes `index_names`,
+  // for which the backfill failed.
+  absl::StatusOr<std::unique_ptr<const Schema>> DropWriteOnlyIndexes(
+      const Schema* existing_schema, absl::Span<const std::string> index_names,
+      const SchemaChangeContext& context);
+
  private:
   absl::Status RunPendingActions(int* num_succesful);
 
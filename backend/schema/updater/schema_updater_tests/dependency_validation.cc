@@ -0,0 +1,131 @@
+//
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#include <memory>
+#include <string>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "zetasql/base/testing/status_matchers.h"
+#include "absl/status/status.h"
+#include "backend/schema/catalog/schema.h"
+#include "backend/schema/updater/schema_updater_tests/base.h"
+#include "common/errors.h"
+
+namespace google {
+namespace spanner {
+namespace emulator {
+namespace backend {
+namespace test {
+
+// Only the nodes connected to a change are validated by a schema update. The
+// following tests change a dependency without touching its dependents, and
+// check that the dependents are still validated.
+
+using database_api::DatabaseDialect::POSTGRESQL;
+using ::testing::HasSubstr;
+using DependencyValidationTest = SchemaUpdaterTest;
+
+INSTANTIATE_TEST_SUITE_P(
+    SchemaUpdaterPerDialectTests, DependencyValidationTest,
+    testing::Values(database_api::DatabaseDialect::GOOGLE_STANDARD_SQL,
+                    database_api::DatabaseDialect::POSTGRESQL),
+    [](const testing::TestParamInfo<DependencyValidationTest::ParamType>&
+           info) { return database_api::DatabaseDialect_Name(info.param); });
+
+TEST_P(DependencyValidationTest, ValidatesViewOfChangedTable) {
+  if (GetParam() == POSTGRESQL) GTEST_SKIP();
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto schema, CreateSchema({R"(
+      CREATE TABLE T (
+        A INT64,
+        B INT64,
+      ) PRIMARY KEY(A))",
+                                                  R"(
+      CREATE VIEW V SQL SECURITY INVOKER AS SELECT T.B FROM T)"}));
+  EXPECT_THAT(UpdateSchema(schema.get(), {"ALTER TABLE T DROP COLUMN B"}),
+              ::zetasql_base::testing::StatusIs(
+                  absl::StatusCode::kFailedPrecondition,
+                  HasSubstr("dependent views: V")));
+}
+
+TEST_P(DependencyValidationTest, ValidatesForeignKeyOfChangedTable) {
+  if (GetParam() == POSTGRESQL) GTEST_SKIP();
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto schema, CreateSchema({R"(
+      CREATE TABLE T (
+        A INT64,
+        B INT64,
+      ) PRIMARY KEY(A))",
+                                                  R"(
+      CREATE TABLE U (
+        X INT64,
+        Y INT64,
+        CONSTRAINT FK_U FOREIGN KEY (Y) REFERENCES T (B),
+      ) PRIMARY KEY(X))"}));
+  EXPECT_THAT(
+      UpdateSchema(schema.get(), {"ALTER TABLE T ALTER COLUMN B STRING(MAX)"}),
+      ::zetasql_base::testing::StatusIs(absl::StatusCode::kFailedPrecondition,
+                                        HasSubstr("FK_U")));
+}
+
+TEST_P(DependencyValidationTest, ValidatesIndexOfChangedTable) {
+  if (GetParam() == POSTGRESQL) GTEST_SKIP();
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto schema, CreateSchema({R"(
+      CREATE TABLE T (
+        A INT64,
+        B INT64,
+      ) PRIMARY KEY(A))",
+                                                  R"(
+      CREATE INDEX TByB ON T(B))"}));
+  EXPECT_THAT(
+      UpdateSchema(schema.get(), {"ALTER TABLE T DROP COLUMN B"}),
+      StatusIs(error::InvalidDropColumnWithDependency("B", "T", "TByB")));
+}
+
+TEST_P(DependencyValidationTest, ValidatesPropertyGraphOnUnrelatedChange) {
+  if (GetParam() == POSTGRESQL) GTEST_SKIP();
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto schema, CreateSchema({R"(
+      CREATE TABLE T (
+        A INT64 NOT NULL,
+      ) PRIMARY KEY(A))",
+                                                  R"(
+      CREATE PROPERTY GRAPH G
+        NODE TABLES (
+          T KEY(A)
+        ))"}));
+  ZETASQL_EXPECT_OK(
+      UpdateSchema(schema.get(), {"CREATE TABLE W (C INT64) PRIMARY KEY(C)"}));
+}
+
+TEST_P(DependencyValidationTest, ValidatesUdfOfDroppedTable) {
+  if (GetParam() == POSTGRESQL) GTEST_SKIP();
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto schema, CreateSchema({R"(
+      CREATE TABLE T (
+        A INT64,
+        B INT64,
+      ) PRIMARY KEY(A))",
+                                                  R"(
+      CREATE FUNCTION F() RETURNS INT64 SQL SECURITY INVOKER
+      AS ((SELECT MAX(T.B) FROM T)))"}));
+  EXPECT_THAT(UpdateSchema(schema.get(), {"DROP TABLE T"}),
+              StatusIs(error::InvalidDropDependentFunction("TABLE", "T", "F")));
+}
+
+}  // namespace test
+}  // namespace backend
+}  // namespace emulator
+}  // namespace spanner
+}  // namespace google
@@ -18,6 +18,7 @@
 #define THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_SCHEMA_CATALOG_SCHEMA_VALIDATION_CONTEXT_H_
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "zetasql/public/types/type_factory.h"
@@ -87,6 +88,18 @@ class SchemaValidationContext {
     actions_.emplace_back(std::move(action_fn));
   }
 
+  // Records a write-only index created by the schema change. Its backfill is
+  // not run as a SchemaChangeAction, but left to the caller of the schema
+  // updater.
+  void AddWriteOnlyIndex(const std::string& index_name) {
+    write_only_indexes_.push_back(index_name);
+  }
+
+  // Returns the names of the write-only indexes created by the schema change.
+  const std::vector<std::string>& write_only_indexes() const {
+    return write_only_indexes_;
+  }
+
   // Interface used by a SchemaChangeAction to access the
   // database
   // --------------------------------------------------
@@ -239,6 +252,9 @@ class SchemaValidationContext {
   // The list of pending schema change actions (verifications/backfills) to run.
   std::vector<SchemaChangeAction> actions_;
 
+  // The names of the write-only indexes created by the schema change.
+  std::vector<std::string> write_only_indexes_;
+
   // The old schema.
   const Schema* old_schema_snapshot_ = nullptr;
 
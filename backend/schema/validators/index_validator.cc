@@ -245,6 +245,8 @@ absl::Status IndexValidator::ValidateUpdate(const Index* index,
   ZETASQL_RET_CHECK_EQ(index->name_, old_index->name_);
   ZETASQL_RET_CHECK_EQ(index->is_null_filtered_, old_index->is_null_filtered_);
   ZETASQL_RET_CHECK_EQ(index->is_unique_, old_index->is_unique_);
+  // A backfilled index never becomes write-only again.
+  ZETASQL_RET_CHECK(!index->is_write_only_ || old_index->is_write_only_);
   ZETASQL_RET_CHECK_EQ(index->key_columns_.size(), old_index->key_columns_.size());
 
   if (context->is_postgresql_dialect()) {
@@ -17,13 +17,19 @@
 #include "backend/schema/verifiers/foreign_key_verifiers.h"
 
 #include <algorithm>
-#include <iterator>
 #include <memory>
+#include <optional>
+#include <utility>
 #include <vector>
 
 #include "zetasql/public/value.h"
 #include "absl/status/status.h"
-#include "backend/common/ids.h"
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "backend/actions/foreign_key.h"
+#include "backend/common/parallel.h"
+#include "backend/datamodel/key.h"
+#include "backend/datamodel/key_range.h"
 #include "backend/schema/catalog/foreign_key.h"
 #include "backend/schema/catalog/index.h"
 #include "common/errors.h"
@@ -35,14 +41,59 @@ namespace backend {
 
 namespace {
 
-std::vector<ColumnID> DataColumnIds(const Table* data_table, int column_count) {
-  std::vector<ColumnID> column_ids;
-  std::transform(
-      data_table->primary_key().begin(), data_table->primary_key().end(),
-      std::back_inserter(column_ids),
-      [](const KeyColumn* key_column) { return key_column->column()->id(); });
-  return std::vector<ColumnID>(column_ids.begin(),
-                               column_ids.begin() + column_count);
+// Number of distinct referencing keys verified by a single task. Foreign keys
+// with more referencing keys than this are verified in parallel, with each
+// task scanning the range of the referenced data table spanned by its keys.
+constexpr int kVerificationShardSize = 10000;
+
+// Returns true if the first `column_count` key columns of both data tables are
+// sorted the same way.
+bool HaveSameKeyOrder(const Table* data_table, const Table* other_data_table,
+                      int column_count) {
+  for (int i = 0; i < column_count; ++i) {
+    const KeyColumn* key_column = data_table->primary_key()[i];
+    const KeyColumn* other_key_column = other_data_table->primary_key()[i];
+    if (key_column->is_descending() != other_key_column->is_descending() ||
+        key_column->is_nulls_last() != other_key_column->is_nulls_last()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns the first of the sorted and deduplicated `keys` for which no row of
+// `data_table` has a matching key prefix, or nullopt if all keys are found.
+// The keys are merged against a single ordered scan of the range of the data
+// table they span.
+absl::StatusOr<std::optional<Key>> FindMissingKey(
+    const SchemaValidationContext* context, const Table* data_table,
+    absl::Span<const Key> keys) {
+  if (keys.empty()) {
+    return std::nullopt;
+  }
+  int column_count = keys.front().NumColumns();
+  std::unique_ptr<StorageIterator> itr;
+  ZETASQL_RETURN_IF_ERROR(context->storage()->Read(
+      context->pending_commit_timestamp(), data_table->id(),
+      KeyRange::ClosedOpen(keys.front(), keys.back().ToPrefixLimit()), {},
+      &itr));
+  int i = 0;
+  while (i < keys.size() && itr->Next()) {
+    Key row_key = ForeignKeyPrefix(itr->Key(), column_count, data_table);
+    // Keys sorting before the current row have no matching row.
+    int comparison = keys[i].Compare(row_key);
+    if (comparison < 0) {
+      return keys[i];
+    }
+    if (comparison == 0) {
+      ++i;
+    }
+  }
+  ZETASQL_RETURN_IF_ERROR(itr->Status());
+  if (i < keys.size()) {
+    return keys[i];
+  }
+  return std::nullopt;
 }
 
 }  // namespace
@@ -52,32 +103,52 @@ absl::Status VerifyForeignKeyData(const ForeignKey* foreign_key,
   if (!foreign_key->enforced()) {
     return absl::OkStatus();
   }
-  const Storage* storage = context->storage();
-  absl::Time timestamp = context->pending_commit_timestamp();
+  const Table* referencing_data_table = foreign_key->referencing_data_table();
+  const Table* referenced_data_table = foreign_key->referenced_data_table();
   int column_count = foreign_key->referencing_columns().size();
-  TableID referenced_data_table_id = foreign_key->referenced_data_table()->id();
+
+  // Collect the distinct constraint keys of the referencing rows, ordered like
+  // the referenced data table.
   std::unique_ptr<StorageIterator> referencing_iterator;
-  ZETASQL_RETURN_IF_ERROR(storage->Read(
-      timestamp, foreign_key->referencing_data_table()->id(), KeyRange::All(),
-      DataColumnIds(foreign_key->referencing_data_table(), column_count),
-      &referencing_iterator));
+  ZETASQL_RETURN_IF_ERROR(context->storage()->Read(
+      context->pending_commit_timestamp(), referencing_data_table->id(),
+      KeyRange::All(), {}, &referencing_iterator));
+  std::vector<Key> keys;
   while (referencing_iterator->Next()) {
-    Key constraint_key(std::vector<zetasql::Value>(
-        referencing_iterator->Key().column_values().begin(),
-        referencing_iterator->Key().column_values().begin() + column_count));
-    std::unique_ptr<StorageIterator> referenced_iterator;
-    ZETASQL_RETURN_IF_ERROR(storage->Read(timestamp, referenced_data_table_id,
-                                  KeyRange::Point(constraint_key), {},
-                                  &referenced_iterator));
-    if (!referenced_iterator->Next() && referenced_iterator->Status().ok()) {
+    Key constraint_key = ForeignKeyPrefix(referencing_iterator->Key(),
+                                          column_count, referenced_data_table);
+    if (keys.empty() || !(keys.back() == constraint_key)) {
+      keys.push_back(std::move(constraint_key));
+    }
+  }
+  ZETASQL_RETURN_IF_ERROR(referencing_iterator->Status());
+  if (!HaveSameKeyOrder(referencing_data_table, referenced_data_table,
+                        column_count)) {
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+  }
+
+  // Merge the keys against the referenced data table, one shard of keys at a
+  // time. The first missing key in key order is reported.
+  int num_shards =
+      (keys.size() + kVerificationShardSize - 1) / kVerificationShardSize;
+  auto verify_shard = [&](int shard) -> absl::Status {
+    absl::Span<const Key> shard_keys = absl::MakeConstSpan(keys).subspan(
+        shard * kVerificationShardSize, kVerificationShardSize);
+    ZETASQL_ASSIGN_OR_RETURN(std::optional<Key> missing_key,
+                     FindMissingKey(context, referenced_data_table, shard_keys));
+    if (missing_key.has_value()) {
       return error::ForeignKeyReferencedKeyNotFound(
           foreign_key->Name(), foreign_key->referencing_table()->Name(),
           foreign_key->referenced_table()->Name(),
-          constraint_key.DebugString());
+          Key(missing_key->column_values()).DebugString());
     }
-    ZETASQL_RETURN_IF_ERROR(referenced_iterator->Status());
+    return absl::OkStatus();
+  };
+  if (num_shards <= 1) {
+    return verify_shard(0);
   }
-  return referencing_iterator->Status();
+  return ParallelFor(num_shards, DefaultParallelism(), verify_shard);
 }
 
 }  // namespace backend
@@ -106,6 +106,23 @@ class ForeignKeyVerifiersTest : public ::testing::Test {
     ZETASQL_ASSERT_OK(txn->Commit());
   }
 
+  void InsertRows(const std::string& table,
+                  const std::vector<std::string>& columns,
+                  const std::vector<std::vector<int>>& rows) {
+    std::vector<ValueList> value_lists;
+    value_lists.reserve(rows.size());
+    for (const std::vector<int>& row : rows) {
+      value_lists.push_back(AsList(row));
+    }
+    Mutation m;
+    m.AddWriteOp(MutationOpType::kInsert, table, columns, value_lists);
+    ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ReadWriteTransaction> txn,
+                         database_->CreateReadWriteTransaction(
+                             ReadWriteOptions(), RetryState()));
+    ZETASQL_ASSERT_OK(txn->Write(m));
+    ZETASQL_ASSERT_OK(txn->Commit());
+  }
+
   ValueList AsList(const std::vector<int>& values) {
     ValueList value_list;
     std::transform(
@@ -132,6 +149,67 @@ TEST_F(ForeignKeyVerifiersTest, InvalidExistingData) {
   EXPECT_THAT(AddForeignKey(), StatusIs(absl::StatusCode::kFailedPrecondition));
 }
 
+// Enough referencing rows for the verification to be split into several
+// shards that are verified in parallel.
+constexpr int kManyRows = 25000;
+
+TEST_F(ForeignKeyVerifiersTest, ValidExistingDataAcrossShards) {
+  std::vector<std::vector<int>> referenced_rows;
+  std::vector<std::vector<int>> referencing_rows;
+  for (int i = 1; i <= kManyRows; ++i) {
+    referenced_rows.push_back({i, i, i + 1});
+    referencing_rows.push_back({i, i + 1, i});
+  }
+  InsertRows("T", {"A", "B", "C"}, referenced_rows);
+  InsertRows("U", {"X", "Y", "Z"}, referencing_rows);
+  ZETASQL_EXPECT_OK(AddForeignKey());
+}
+
+TEST_F(ForeignKeyVerifiersTest, InvalidExistingDataAcrossShards) {
+  std::vector<std::vector<int>> referenced_rows;
+  std::vector<std::vector<int>> referencing_rows;
+  for (int i = 1; i <= kManyRows; ++i) {
+    referenced_rows.push_back({i, i, i + 1});
+    referencing_rows.push_back({i, i + 1, i});
+  }
+  // Referencing rows for which no referenced row exists, in two different
+  // shards. The smallest missing key is reported.
+  referencing_rows.push_back({kManyRows + 1, 1, 22222});
+  referencing_rows.push_back({kManyRows + 2, 1, 11111});
+  InsertRows("T", {"A", "B", "C"}, referenced_rows);
+  InsertRows("U", {"X", "Y", "Z"}, referencing_rows);
+  EXPECT_THAT(AddForeignKey(),
+              StatusIs(absl::StatusCode::kFailedPrecondition,
+                       testing::HasSubstr("Int64(11111)")));
+}
+
+TEST_F(ForeignKeyVerifiersTest, DescendingReferencedKey) {
+  ZETASQL_ASSERT_OK(CreateDatabase({R"(
+        CREATE TABLE T (
+          A INT64,
+        ) PRIMARY KEY(A DESC))",
+                            R"(
+        CREATE TABLE U (
+          X INT64,
+          Y INT64,
+          Z INT64,
+        ) PRIMARY KEY(X))"}));
+  InsertRows("T", {"A"}, {{1}, {2}, {3}});
+  InsertRows("U", {"X", "Y", "Z"},
+             {{1, 3, 3}, {2, 1, 1}, {3, 2, 4}, {4, 3, 2}});
+  ZETASQL_EXPECT_OK(UpdateSchema({R"(
+        ALTER TABLE U
+          ADD CONSTRAINT C
+            FOREIGN KEY(Y)
+            REFERENCES T(A))"}));
+  EXPECT_THAT(UpdateSchema({R"(
+        ALTER TABLE U
+          ADD CONSTRAINT D
+            FOREIGN KEY(Z)
+            REFERENCES T(A))"}),
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+}
+
 }  // namespace
 }  // namespace backend
 }  // namespace emulator
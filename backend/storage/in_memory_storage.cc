@@ -16,6 +16,7 @@
 
 #include "backend/storage/in_memory_storage.h"
 
+#include <iterator>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -23,6 +24,7 @@
 #include "zetasql/public/value.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
 #include "backend/storage/in_memory_iterator.h"
 #include "common/errors.h"
 #include "absl/status/status.h"
@@ -172,6 +174,37 @@ absl::Status InMemoryStorage::Read(
   return absl::OkStatus();
 }
 
+absl::Status InMemoryStorage::GetSplitKeys(
+    absl::Time timestamp, const TableID& table_id, int max_rows_per_split,
+    std::vector<Key>* split_keys) const {
+  absl::MutexLock lock(&mu_);
+
+  if (max_rows_per_split <= 0) {
+    return error::Internal(
+        absl::StrCat("InMemoryStorage::GetSplitKeys should be called with a "
+                     "positive number of rows per split, found: ",
+                     max_rows_per_split));
+  }
+
+  split_keys->clear();
+  auto table_itr = tables_.find(table_id);
+  if (table_itr == tables_.end()) {
+    return absl::OkStatus();
+  }
+  int num_rows = 0;
+  for (const auto& [key, row] : table_itr->second) {
+    if (!Exists(row, timestamp)) {
+      continue;
+    }
+    if (num_rows == max_rows_per_split) {
+      split_keys->push_back(key);
+      num_rows = 0;
+    }
+    ++num_rows;
+  }
+  return absl::OkStatus();
+}
+
 absl::Status InMemoryStorage::Write(
     absl::Time timestamp, const TableID& table_id, const Key& key,
     const std::vector<ColumnID>& column_ids,
@@ -180,9 +213,36 @@ absl::Status InMemoryStorage::Write(
 
   // Add the table if it does not exist.
   Table& table = tables_[table_id];
+  WriteRow(timestamp, column_ids, values, table[key]);
+  return absl::OkStatus();
+}
+
+absl::Status InMemoryStorage::BatchWrite(
+    absl::Time timestamp, const TableID& table_id,
+    const std::vector<ColumnID>& column_ids,
+    absl::Span<const std::pair<Key, std::vector<zetasql::Value>>> rows) {
+  absl::MutexLock lock(&mu_);
+
+  // Add the table if it does not exist.
+  Table& table = tables_[table_id];
+
+  // Use the position after the previously written row as an insertion hint,
+  // which makes inserting rows given in ascending key order amortized constant
+  // time. The hint only affects performance, not correctness.
+  auto hint = table.end();
+  for (const auto& [key, values] : rows) {
+    auto row_itr = table.try_emplace(hint, key);
+    WriteRow(timestamp, column_ids, values, row_itr->second);
+    hint = std::next(row_itr);
+  }
+  return absl::OkStatus();
+}
 
+void InMemoryStorage::WriteRow(absl::Time timestamp,
+                               const std::vector<ColumnID>& column_ids,
+                               const std::vector<zetasql::Value>& values,
+                               Row& row) {
   // Add the row with _exists system column if it does not exist.
-  Row& row = table[key];
   if (!Exists(row, timestamp)) {
     row[kExistsColumn][timestamp] = zetasql::values::Bool(true);
   }
@@ -191,8 +251,6 @@ absl::Status InMemoryStorage::Write(
   for (int i = 0; i < column_ids.size(); ++i) {
     row[column_ids[i]][timestamp] = values[i];
   }
-
-  return absl::OkStatus();
 }
 
 absl::Status InMemoryStorage::Delete(absl::Time timestamp,
@@ -243,6 +301,44 @@ absl::Status InMemoryStorage::Delete(absl::Time timestamp,
   return absl::OkStatus();
 }
 
+absl::Status InMemoryStorage::Purge(const TableID& table_id,
+                                    const KeyRange& key_range,
+                                    PurgeStats* stats) {
+  absl::MutexLock lock(&mu_);
+
+  if (!key_range.IsClosedOpen()) {
+    return error::Internal(
+        absl::StrCat("InMemoryStorage::Purge should be called "
+                     "with ClosedOpen key range, found: ",
+                     key_range.DebugString()));
+  }
+  if (key_range.start_key() >= key_range.limit_key()) {
+    return absl::OkStatus();
+  }
+
+  auto table_itr = tables_.find(table_id);
+  if (table_itr == tables_.end()) {
+    return absl::OkStatus();
+  }
+  Table& table = table_itr->second;
+
+  auto row_start_itr = table.lower_bound(key_range.start_key());
+  auto row_end_itr = table.lower_bound(key_range.limit_key());
+  for (auto itr = row_start_itr; itr != row_end_itr; ++itr) {
+    ++stats->num_rows;
+    stats->num_bytes += itr->first.LogicalSizeInBytes();
+    for (const auto& [column_id, cell] : itr->second) {
+      for (const auto& [timestamp, value] : cell) {
+        if (value.is_valid()) {
+          stats->num_bytes += value.physical_byte_size();
+        }
+      }
+    }
+  }
+  table.erase(row_start_itr, row_end_itr);
+  return absl::OkStatus();
+}
+
 }  // namespace backend
 }  // namespace emulator
 }  // namespace spanner
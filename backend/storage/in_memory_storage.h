@@ -17,8 +17,12 @@
 #ifndef THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_STORAGE_IN_MEMORY_STORAGE_H_
 #define THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_STORAGE_IN_MEMORY_STORAGE_H_
 
+#include <utility>
+#include <vector>
+
 #include "zetasql/public/value.h"
 #include "absl/time/time.h"
+#include "absl/types/span.h"
 #include "backend/common/ids.h"
 #include "backend/datamodel/key.h"
 #include "backend/datamodel/key_range.h"
@@ -35,7 +39,7 @@ namespace backend {
 //
 // Keys are stored in sorted order. Value versions for a given column are also
 // sorted in order of the timestamp written. Keys are never deleted, but are
-// marked deleted for multi-version lookup.
+// marked deleted for multi-version lookup, unless they are purged.
 //
 // Lookup and Read return invalid zetasql::Value(s) for non-existent columns.
 //
@@ -53,15 +57,29 @@ class InMemoryStorage : public Storage {
                     std::unique_ptr<StorageIterator>* itr) const override
       ABSL_LOCKS_EXCLUDED(mu_);
 
+  absl::Status GetSplitKeys(absl::Time timestamp, const TableID& table_id,
+                            int max_rows_per_split,
+                            std::vector<Key>* split_keys) const override
+      ABSL_LOCKS_EXCLUDED(mu_);
+
   absl::Status Write(absl::Time timestamp, const TableID& table_id,
                      const Key& key, const std::vector<ColumnID>& column_ids,
                      const std::vector<zetasql::Value>& values) override
       ABSL_LOCKS_EXCLUDED(mu_);
 
+  absl::Status BatchWrite(
+      absl::Time timestamp, const TableID& table_id,
+      const std::vector<ColumnID>& column_ids,
+      absl::Span<const std::pair<Key, std::vector<zetasql::Value>>> rows)
+      override ABSL_LOCKS_EXCLUDED(mu_);
+
   absl::Status Delete(absl::Time timestamp, const TableID& table_id,
                       const KeyRange& key_range) override
       ABSL_LOCKS_EXCLUDED(mu_);
 
+  absl::Status Purge(const TableID& table_id, const KeyRange& key_range,
+                     PurgeStats* stats) override ABSL_LOCKS_EXCLUDED(mu_);
+
  private:
   using Cell = std::map<absl::Time, zetasql::Value>;
   using Row = absl::flat_hash_map<ColumnID, Cell>;
@@ -78,6 +96,12 @@ class InMemoryStorage : public Storage {
                                            absl::Time timestamp) const
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
+  // Writes the given column values to row at the specified timestamp, marking
+  // the row as existing if it does not exist yet.
+  void WriteRow(absl::Time timestamp, const std::vector<ColumnID>& column_ids,
+                const std::vector<zetasql::Value>& values, Row& row)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
   mutable absl::Mutex mu_;
   Tables tables_ ABSL_GUARDED_BY(mu_);
 };
@@ -17,6 +17,8 @@
 #include "backend/storage/in_memory_storage.h"
 
 #include <memory>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "gmock/gmock.h"
@@ -114,6 +116,58 @@ TEST_F(InMemoryStorageTest, ReadRangeFromSingleTable) {
   EXPECT_FALSE(itr_->Next());
 }
 
+TEST_F(InMemoryStorageTest, BatchWriteMatchesIndividualWrites) {
+  absl::Time t0 = absl::Now();
+
+  // Pre-existing rows are interleaved with the batch and overwritten by it.
+  ZETASQL_EXPECT_OK(storage_.Write(t0, kTableId0, Key({Int64(1)}), {kColumnID},
+                           {String("old-1")}));
+  ZETASQL_EXPECT_OK(storage_.Write(t0, kTableId0, Key({Int64(2)}), {kColumnID},
+                           {String("old-2")}));
+
+  // Batch rows are not required to be in key order.
+  std::vector<std::pair<Key, std::vector<zetasql::Value>>> rows = {
+      {Key({Int64(0)}), {String("value-0")}},
+      {Key({Int64(2)}), {String("value-2")}},
+      {Key({Int64(4)}), {String("value-4")}},
+      {Key({Int64(3)}), {String("value-3")}},
+  };
+  ZETASQL_EXPECT_OK(storage_.BatchWrite(t0, kTableId0, {kColumnID}, rows));
+
+  ZETASQL_EXPECT_OK(storage_.Read(t0, kTableId0, kKeyRange0To5, {kColumnID}, &itr_));
+  for (const std::string& expected :
+       {"value-0", "old-1", "value-2", "value-3", "value-4"}) {
+    EXPECT_TRUE(itr_->Next());
+    EXPECT_EQ(itr_->ColumnValue(0), String(expected));
+  }
+  EXPECT_FALSE(itr_->Next());
+}
+
+TEST_F(InMemoryStorageTest, GetSplitKeys) {
+  absl::Time t0 = absl::Now();
+  for (int i = 0; i < 7; ++i) {
+    ZETASQL_EXPECT_OK(storage_.Write(t0, kTableId0, Key({Int64(i)}), {kColumnID},
+                             {String("value")}));
+  }
+  // Deleted rows are not counted.
+  ZETASQL_EXPECT_OK(storage_.Delete(t0 + absl::Seconds(1), kTableId0,
+                            KeyRange::Point(Key({Int64(1)}))));
+
+  std::vector<Key> split_keys;
+  ZETASQL_EXPECT_OK(storage_.GetSplitKeys(t0, kTableId0, /*max_rows_per_split=*/3,
+                                  &split_keys));
+  EXPECT_THAT(split_keys,
+              testing::ElementsAre(Key({Int64(3)}), Key({Int64(6)})));
+
+  ZETASQL_EXPECT_OK(storage_.GetSplitKeys(t0 + absl::Seconds(1), kTableId0,
+                                  /*max_rows_per_split=*/3, &split_keys));
+  EXPECT_THAT(split_keys, testing::ElementsAre(Key({Int64(4)})));
+
+  ZETASQL_EXPECT_OK(storage_.GetSplitKeys(t0, kTableId1, /*max_rows_per_split=*/3,
+                                  &split_keys));
+  EXPECT_THAT(split_keys, testing::IsEmpty());
+}
+
 TEST_F(InMemoryStorageTest, LookupByTimestamp) {
   absl::Time write_ts = absl::Now();
 
@@ -702,6 +756,51 @@ TEST_F(InMemoryStorageTest,
       zetasql_base::testing::StatusIs(absl::StatusCode::kInternal));
 }
 
+TEST_F(InMemoryStorageTest, PurgeRemovesAllVersions) {
+  absl::Time t0 = absl::Now();
+  absl::Time t1 = t0 + absl::Seconds(1);
+  absl::Time t2 = t0 + absl::Seconds(2);
+
+  for (int i = 0; i < 5; ++i) {
+    ZETASQL_EXPECT_OK(storage_.Write(t0, kTableId0, Key({Int64(i)}), {kColumnID},
+                             {String(absl::StrCat("value-", i))}));
+  }
+  ZETASQL_EXPECT_OK(storage_.Write(t1, kTableId0, Key({Int64(1)}), {kColumnID},
+                           {String("value-1-1")}));
+  ZETASQL_EXPECT_OK(storage_.Delete(
+      t2, kTableId0, KeyRange::ClosedOpen(Key({Int64(2)}), Key({Int64(3)}))));
+
+  PurgeStats stats;
+  ZETASQL_EXPECT_OK(storage_.Purge(
+      kTableId0, KeyRange::ClosedOpen(Key({Int64(1)}), Key({Int64(3)})),
+      &stats));
+  EXPECT_EQ(stats.num_rows, 2);
+  EXPECT_GT(stats.num_bytes, 0);
+
+  // Purged rows are gone at every timestamp, other rows are untouched.
+  std::vector<zetasql::Value> values;
+  EXPECT_THAT(
+      storage_.Lookup(t0, kTableId0, Key({Int64(1)}), {kColumnID}, &values),
+      zetasql_base::testing::StatusIs(absl::StatusCode::kNotFound));
+  EXPECT_THAT(
+      storage_.Lookup(t1, kTableId0, Key({Int64(2)}), {kColumnID}, &values),
+      zetasql_base::testing::StatusIs(absl::StatusCode::kNotFound));
+  ZETASQL_EXPECT_OK(storage_.Read(t0, kTableId0, kKeyRange0To5, {kColumnID}, &itr_));
+  for (int i : {0, 3, 4}) {
+    EXPECT_TRUE(itr_->Next());
+    EXPECT_EQ(itr_->Key(), Key({Int64(i)}));
+  }
+  EXPECT_FALSE(itr_->Next());
+
+  // Purging an empty range does not reclaim anything.
+  PurgeStats empty_stats;
+  ZETASQL_EXPECT_OK(storage_.Purge(
+      kTableId0, KeyRange::ClosedOpen(Key({Int64(1)}), Key({Int64(3)})),
+      &empty_stats));
+  EXPECT_EQ(empty_stats.num_rows, 0);
+  EXPECT_EQ(empty_stats.num_bytes, 0);
+}
+
 }  // namespace
 
 }  // namespace backend
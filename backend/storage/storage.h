@@ -17,9 +17,14 @@
 #ifndef THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_STORAGE_STORAGE_H_
 #define THIRD_PARTY_CLOUD_SPANNER_EMULATOR_BACKEND_STORAGE_STORAGE_H_
 
+#include <cstdint>
+#include <utility>
+#include <vector>
+
 #include "zetasql/public/value.h"
 #include "absl/status/status.h"
 #include "absl/time/time.h"
+#include "absl/types/span.h"
 #include "backend/common/ids.h"
 #include "backend/datamodel/key.h"
 #include "backend/datamodel/key_range.h"
@@ -31,10 +36,20 @@ namespace spanner {
 namespace emulator {
 namespace backend {
 
+// Space reclaimed by Storage::Purge.
+struct PurgeStats {
+  // Number of rows removed.
+  int64_t num_rows = 0;
+
+  // Approximate size in bytes of the keys and all value versions removed.
+  int64_t num_bytes = 0;
+};
+
 // Storage defines the interface for a multi-version data store.
 //
 // There will be a Storage instance for each database created. The current
-// interface is grow-only, i.e. once data is added, it will not be deleted.
+// interface is grow-only, i.e. once data is added, it will not be deleted,
+// except for data that is explicitly purged.
 // Storage is thread-safe.
 class Storage {
  public:
@@ -59,6 +74,17 @@ class Storage {
                             const std::vector<ColumnID>& column_ids,
                             std::unique_ptr<StorageIterator>* itr) const = 0;
 
+  // Splits the rows of the given table at the specified timestamp into
+  // consecutive key ranges of at most max_rows_per_split rows each, and returns
+  // the start keys of all but the first range in split_keys, in sorted order.
+  // Range i is [split_keys[i - 1], split_keys[i]), where the first range starts
+  // and the last range ends at the bounds of KeyRange::All(). Each range can be
+  // read separately with Read, e.g. by different threads.
+  virtual absl::Status GetSplitKeys(absl::Time timestamp,
+                                    const TableID& table_id,
+                                    int max_rows_per_split,
+                                    std::vector<Key>* split_keys) const = 0;
+
   // Writes column values for given key at the specified timestamp. Column value
   // will be overwritten for non-unique <timestamp, table_id, key, column_id>
   // combination.
@@ -67,12 +93,31 @@ class Storage {
                              const std::vector<ColumnID>& column_ids,
                              const std::vector<zetasql::Value>& values) = 0;
 
+  // Writes the given rows at the specified timestamp, with the values of each
+  // row in the order of column_ids. This is equivalent to calling Write for
+  // each row, but lets implementations amortize the per-write overhead across
+  // the batch. Rows given in ascending key order are written most efficiently.
+  virtual absl::Status BatchWrite(
+      absl::Time timestamp, const TableID& table_id,
+      const std::vector<ColumnID>& column_ids,
+      absl::Span<const std::pair<Key, std::vector<zetasql::Value>>>
+          rows) = 0;
+
   // Marks the given key range as deleted at the specified timestamp. Column
   // values at older timestamps are still accessible via Read and Lookup.
   // KeyRange interval should be in KeyRange::ClosedOpen format. Non ClosedOpen
   // ranges will result in INVALID_ARGUMENT.
   virtual absl::Status Delete(absl::Time timestamp, const TableID& table_id,
                               const KeyRange& key_range) = 0;
+
+  // Removes all versions of the rows in the given key range, so that they are
+  // not visible at any timestamp anymore, and adds the reclaimed space to
+  // `stats`. Callers must ensure that the rows are no longer read at any
+  // timestamp at which they existed. KeyRange interval should be in
+  // KeyRange::ClosedOpen format. Non ClosedOpen ranges will result in
+  // INVALID_ARGUMENT.
+  virtual absl::Status Purge(const TableID& table_id, const KeyRange& key_range,
+                             PurgeStats* stats) = 0;
 };
 
 }  // namespace backend
@@ -166,14 +166,12 @@ absl::Status ValidateCommitTimestampKeySetForDeleteOp(const Table* table,
 }
 
 absl::StatusOr<ValueList> MaybeSetCommitTimestampSentinel(
-    absl::Span<const Column* const> columns, const ValueList& row) {
-  if (row.empty()) return row;
-  ValueList ret_val;
+    absl::Span<const Column* const> columns, ValueList row) {
   for (int i = 0; i < row.size(); i++) {
-    ZETASQL_ASSIGN_OR_RETURN(ret_val.emplace_back(),
-                     MaybeSetCommitTimestampSentinel(columns[i], row[i]));
+    ZETASQL_ASSIGN_OR_RETURN(row[i], MaybeSetCommitTimestampSentinel(
+                                 columns[i], std::move(row[i])));
   }
-  return ret_val;
+  return row;
 }
 
 absl::StatusOr<KeyRange> MaybeSetCommitTimestampSentinel(
@@ -17,11 +17,13 @@
 #include "backend/transaction/read_write_transaction.h"
 
 #include <functional>
+#include <iterator>
 #include <memory>
 #include <optional>
 #include <queue>
 #include <string>
 #include <utility>
+#include <variant>
 #include <vector>
 
 #include "zetasql/public/value.h"
@@ -43,14 +45,19 @@
 #include "backend/actions/context.h"
 #include "backend/actions/manager.h"
 #include "backend/actions/ops.h"
+#include "backend/common/ann_index.h"
 #include "backend/common/ids.h"
+#include "backend/common/inverted_index.h"
 #include "backend/common/rows.h"
+#include "backend/database/change_stream/change_stream_commit_notifier.h"
 #include "backend/datamodel/key.h"
 #include "backend/datamodel/key_range.h"
 #include "backend/datamodel/value.h"
 #include "backend/locking/manager.h"
+#include "backend/schema/catalog/change_stream.h"
 #include "backend/schema/catalog/column.h"
 #include "backend/schema/catalog/foreign_key.h"
+#include "backend/schema/catalog/index.h"
 #include "backend/schema/catalog/schema.h"
 #include "backend/schema/catalog/table.h"
 #include "backend/schema/catalog/versioned_catalog.h"
@@ -105,16 +112,16 @@ absl::StatusOr<std::vector<WriteOp>> FlattenDeleteOp(
 //   corresponding WriteOp of the same type.
 absl::StatusOr<std::vector<WriteOp>> FlattenNonDeleteOpRow(
     MutationOpType type, const Table* table,
-    const std::vector<const Column*>& columns, const Key& key,
-    const ValueList& row, const TransactionStore* transaction_store) {
+    const std::vector<const Column*>& columns, const Key& key, ValueList row,
+    const TransactionStore* transaction_store) {
   std::vector<WriteOp> write_ops;
   switch (type) {
     case MutationOpType::kInsert: {
-      write_ops.push_back(InsertOp{table, key, columns, row});
+      write_ops.push_back(InsertOp{table, key, columns, std::move(row)});
       break;
     }
     case MutationOpType::kUpdate: {
-      write_ops.push_back(UpdateOp{table, key, columns, row});
+      write_ops.push_back(UpdateOp{table, key, columns, std::move(row)});
       break;
     }
     case MutationOpType::kInsertOrUpdate: {
@@ -123,9 +130,9 @@ absl::StatusOr<std::vector<WriteOp>> FlattenNonDeleteOpRow(
                                     /*columns= */ {});
       if (maybe_row.ok()) {
         // Row exists and therefore we should only update.
-        write_ops.push_back(UpdateOp{table, key, columns, row});
+        write_ops.push_back(UpdateOp{table, key, columns, std::move(row)});
       } else if (maybe_row.status().code() == absl::StatusCode::kNotFound) {
-        write_ops.push_back(InsertOp{table, key, columns, row});
+        write_ops.push_back(InsertOp{table, key, columns, std::move(row)});
       } else {
         return maybe_row.status();
       }
@@ -133,7 +140,7 @@ absl::StatusOr<std::vector<WriteOp>> FlattenNonDeleteOpRow(
     }
     case MutationOpType::kReplace: {
       write_ops.push_back(DeleteOp{table, key});
-      write_ops.push_back(InsertOp{table, key, columns, row});
+      write_ops.push_back(InsertOp{table, key, columns, std::move(row)});
       break;
     }
     case MutationOpType::kDelete: {
@@ -187,16 +194,7 @@ bool SplitKeyRangeAndAppend(const KeyRange& key_range, const Key& key,
   return true;
 }
 
-absl::StatusOr<bool> IsMutationInvolvingForeignKeyAction(
-    const MutationOp& mutation_op, const Schema* schema) {
-  const Table* table = schema->FindTable(mutation_op.table);
-  if (IsChangeStreamPartitionTable(mutation_op.table)) {
-    ZETASQL_ASSIGN_OR_RETURN(table,
-                     FindChangeStreamPartitionTable(schema, mutation_op.table));
-  }
-  if (table == nullptr) {
-    return error::TableNotFound(mutation_op.table);
-  }
+bool IsTableInvolvingForeignKeyAction(const Table* table) {
   for (const ForeignKey* foreign_key : table->referencing_foreign_keys()) {
     if (foreign_key->on_delete_action() == ForeignKey::Action::kCascade) {
       return true;
@@ -210,7 +208,8 @@ ReadWriteTransaction::ReadWriteTransaction(
     const ReadWriteOptions& options, const RetryState& retry_state,
     TransactionID transaction_id, Clock* clock, Storage* storage,
     LockManager* lock_manager, const VersionedCatalog* const versioned_catalog,
-    ActionManager* action_manager)
+    ActionManager* action_manager,
+    ChangeStreamCommitNotifier* change_stream_notifier)
     : options_(options),
       retry_state_(MakeRetryState(retry_state, clock)),
       id_(transaction_id),
@@ -228,6 +227,7 @@ ReadWriteTransaction::ReadWriteTransaction(
           std::make_unique<TransactionReadOnlyStore>(transaction_store_.get()),
           std::make_unique<TransactionEffectsBuffer>(&write_ops_queue_),
           clock)),
+      change_stream_notifier_(change_stream_notifier),
       schema_(versioned_catalog_->GetLatestSchema()) {}
 
 absl::StatusOr<absl::Time> ReadWriteTransaction::GetCommitTimestamp() {
@@ -272,11 +272,10 @@ absl::Status ReadWriteTransaction::ApplyEffectors(const WriteOp& op) {
 }
 
 absl::Status ReadWriteTransaction::ApplyStatementVerifiers() {
-  for (const auto& write_op : transaction_store_->GetBufferedOps()) {
-    ZETASQL_RETURN_IF_ERROR(
-        action_registry_->ExecuteVerifiers(action_context_.get(), write_op));
-  }
-  return absl::OkStatus();
+  // Buffered ops are grouped by table and sorted by key, which lets verifiers
+  // such as the foreign key verifiers check all ops of a table in one pass.
+  return action_registry_->ExecuteVerifiers(
+      action_context_.get(), transaction_store_->GetBufferedOps());
 }
 
 void ReadWriteTransaction::UpdateTrackedCommitTimestamps() {
@@ -294,6 +293,7 @@ const Schema* ReadWriteTransaction::schema() const {
 void ReadWriteTransaction::Reset() {
   mu_.AssertHeld();
 
+  DiscardUncommittedVectorAndSearchIndexEntries();
   lock_handle_->UnlockAll();
   transaction_store_->Clear();
   std::queue<WriteOp> empty;
@@ -402,21 +402,117 @@ absl::Status ReadWriteTransaction::ProcessChangeStreamWriteOps() {
   return absl::OkStatus();
 }
 
-absl::StatusOr<ResolvedMutationOp>
-ReadWriteTransaction::ResolveNonDeleteMutationOp(const MutationOp& mutation_op,
-                                                 const Schema* schema) {
-  ZETASQL_RET_CHECK(mutation_op.type != MutationOpType::kDelete);
-
-  const Table* table = schema->FindTable(mutation_op.table);
+void ReadWriteTransaction::NotifyChangeStreamCommits(
+    const std::vector<WriteOp>& write_ops) {
+  if (change_stream_notifier_ == nullptr) {
+    return;
+  }
+  for (const WriteOp& op : write_ops) {
+    const Table* table = TableOf(op);
+    const ChangeStream* change_stream = table->owner_change_stream();
+    if (change_stream == nullptr) {
+      continue;
+    }
+    if (table == change_stream->change_stream_data_table()) {
+      // The partition token is the first key column of the data table.
+      const Key& key = std::visit(
+          [](const auto& row_op) -> const Key& { return row_op.key; }, op);
+      change_stream_notifier_->NotifyPartition(
+          change_stream->Name(), key.ColumnValue(0).string_value(),
+          commit_timestamp_);
+    } else {
+      change_stream_notifier_->NotifyChangeStream(change_stream->Name(),
+                                                  commit_timestamp_);
+    }
+  }
+}
 
-  if (IsChangeStreamPartitionTable(mutation_op.table)) {
-    ZETASQL_ASSIGN_OR_RETURN(table,
-                     FindChangeStreamPartitionTable(schema, mutation_op.table));
+absl::Status ReadWriteTransaction::CommitVectorAndSearchIndexes(
+    const std::vector<WriteOp>& write_ops) {
+  for (const WriteOp& op : write_ops) {
+    const Table* table = TableOf(op);
+    const Key& key = std::visit(
+        [](const auto& row_op) -> const Key& { return row_op.key; }, op);
+    const std::vector<const Column*>* columns = nullptr;
+    const std::vector<zetasql::Value>* values = nullptr;
+    if (const auto* insert_op = std::get_if<InsertOp>(&op)) {
+      columns = &insert_op->columns;
+      values = &insert_op->values;
+    } else if (const auto* update_op = std::get_if<UpdateOp>(&op)) {
+      columns = &update_op->columns;
+      values = &update_op->values;
+    }
+    // Returns the value the write sets `column` to, NULL if an insert leaves
+    // it out, or std::nullopt if an update leaves it unchanged.
+    auto written_value =
+        [&](const Column* column) -> std::optional<zetasql::Value> {
+      for (int i = 0; i < static_cast<int>(columns->size()); ++i) {
+        if ((*columns)[i] == column) {
+          return (*values)[i];
+        }
+      }
+      if (std::holds_alternative<InsertOp>(op)) {
+        return zetasql::Value::Null(column->GetType());
+      }
+      return std::nullopt;
+    };
+
+    for (const Index* index : table->indexes()) {
+      if (AnnIndex* ann_index = index->ann_index(); ann_index != nullptr) {
+        if (columns == nullptr) {
+          ann_index->CommitDelete(key, commit_timestamp_);
+          continue;
+        }
+        std::optional<zetasql::Value> vector =
+            written_value(index->key_columns()[0]->column()->source_column());
+        if (vector.has_value()) {
+          ZETASQL_RETURN_IF_ERROR(
+              ann_index->CommitVector(key, *vector, commit_timestamp_));
+        }
+      }
+      if (InvertedIndex* inverted_index = index->inverted_index();
+          inverted_index != nullptr) {
+        if (columns == nullptr) {
+          inverted_index->CommitDelete(key, commit_timestamp_);
+          continue;
+        }
+        for (const KeyColumn* key_column : index->key_columns()) {
+          const Column* column = key_column->column()->source_column();
+          if (!column->GetType()->IsTokenList()) {
+            continue;
+          }
+          std::optional<zetasql::Value> token_list = written_value(column);
+          if (token_list.has_value()) {
+            ZETASQL_RETURN_IF_ERROR(inverted_index->CommitTokenList(
+                column->id(), key, *token_list, commit_timestamp_));
+          }
+        }
+      }
+    }
   }
+  return absl::OkStatus();
+}
 
-  if (table == nullptr) {
-    return error::TableNotFound(mutation_op.table);
+void ReadWriteTransaction::DiscardUncommittedVectorAndSearchIndexEntries() {
+  for (const WriteOp& op : transaction_store_->GetBufferedOps()) {
+    const Key& key = std::visit(
+        [](const auto& row_op) -> const Key& { return row_op.key; }, op);
+    for (const Index* index : TableOf(op)->indexes()) {
+      if (index->ann_index() != nullptr) {
+        index->ann_index()->DiscardUncommittedVectors(key);
+      }
+      if (index->inverted_index() != nullptr) {
+        index->inverted_index()->DiscardUncommittedTokenLists(key);
+      }
+    }
   }
+}
+
+absl::StatusOr<ResolvedMutationOp>
+ReadWriteTransaction::ResolveNonDeleteMutationOp(
+    const MutationOp& mutation_op, const Table* table,
+    std::vector<const Column*> columns) {
+  ZETASQL_RET_CHECK(mutation_op.type != MutationOpType::kDelete);
 
   ResolvedMutationOp resolved_mutation_op;
   resolved_mutation_op.table = table;
@@ -431,8 +527,6 @@ ReadWriteTransaction::ResolveNonDeleteMutationOp(const MutationOp& mutation_op,
   ZETASQL_RETURN_IF_ERROR(action_registry_->ExecuteGeneratedKeyEffectors(
       mutation_op, &generated_values, &columns_with_generated_values));
 
-  ZETASQL_ASSIGN_OR_RETURN(std::vector<const Column*> columns,
-                   GetColumnsByName(table, mutation_op.columns));
   // If we have key columns with generated default values, append them here:
   if (!columns_with_generated_values.empty()) {
     columns.insert(columns.end(), columns_with_generated_values.begin(),
@@ -442,20 +536,26 @@ ReadWriteTransaction::ResolveNonDeleteMutationOp(const MutationOp& mutation_op,
   ZETASQL_ASSIGN_OR_RETURN(std::vector<std::optional<int>> key_indices,
                    ExtractPrimaryKeyIndices(columns, table->primary_key()));
 
+  resolved_mutation_op.rows.reserve(mutation_op.rows.size());
+  resolved_mutation_op.keys.reserve(mutation_op.rows.size());
   for (int i = 0; i < mutation_op.rows.size(); i++) {
     const ValueList& row = mutation_op.rows[i];
-    ValueList new_row = row;
+    ValueList new_row;
+    new_row.reserve(columns.size());
+    new_row.insert(new_row.end(), row.begin(), row.end());
     // If we have key columns with generated/default values, append them here:
-    new_row.insert(new_row.end(), generated_values[i].begin(),
-                   generated_values[i].end());
+    new_row.insert(new_row.end(),
+                   std::make_move_iterator(generated_values[i].begin()),
+                   std::make_move_iterator(generated_values[i].end()));
 
     ZETASQL_RET_CHECK_EQ(new_row.size(), columns.size())
         << "MutationOp has difference in size of column and value vectors, "
            "mutation op: "
         << mutation_op.DebugString();
 
-    ZETASQL_ASSIGN_OR_RETURN(resolved_mutation_op.rows.emplace_back(),
-                     MaybeSetCommitTimestampSentinel(columns, new_row));
+    ZETASQL_ASSIGN_OR_RETURN(
+        resolved_mutation_op.rows.emplace_back(),
+        MaybeSetCommitTimestampSentinel(columns, std::move(new_row)));
 
     resolved_mutation_op.keys.push_back(ComputeKey(
         resolved_mutation_op.rows.back(), table->primary_key(), key_indices));
@@ -481,9 +581,10 @@ absl::Status ReadWriteTransaction::Write(const Mutation& mutation) {
         postgres_translator::spangres::MemoryContextPGArena::Init(nullptr));
 
     for (const MutationOp& mutation_op : mutation.ops()) {
-      ZETASQL_ASSIGN_OR_RETURN(
-          bool has_delete_cascade_foreign_key,
-          IsMutationInvolvingForeignKeyAction(mutation_op, schema_));
+      ZETASQL_ASSIGN_OR_RETURN(const Table* table,
+                       FindMutationOpTable(mutation_op, schema_));
+      const bool has_delete_cascade_foreign_key =
+          IsTableInvolvingForeignKeyAction(table);
       if (mutation_op.type == MutationOpType::kDelete) {
         // Process Delete.
         ZETASQL_ASSIGN_OR_RETURN(
@@ -508,9 +609,13 @@ absl::Status ReadWriteTransaction::Write(const Mutation& mutation) {
         ZETASQL_RETURN_IF_ERROR(ProcessWriteOps(write_ops));
       } else {
         // Process non-delete Mutation ops.
-        ZETASQL_RETURN_IF_ERROR(ValidateNonDeleteMutationOp(mutation_op, schema_));
-        ZETASQL_ASSIGN_OR_RETURN(ResolvedMutationOp resolved_mutation_op,
-                         ResolveNonDeleteMutationOp(mutation_op, schema_));
+        ZETASQL_ASSIGN_OR_RETURN(std::vector<const Column*> columns,
+                         ResolveMutationOpColumns(mutation_op, table));
+        ZETASQL_RETURN_IF_ERROR(
+            ValidateNonDeleteMutationOp(mutation_op.type, table, columns));
+        ZETASQL_ASSIGN_OR_RETURN(
+            ResolvedMutationOp resolved_mutation_op,
+            ResolveNonDeleteMutationOp(mutation_op, table, std::move(columns)));
         const std::string& table_name = resolved_mutation_op.table->Name();
 
         // Process Insert, Update, Replace and InsertOrUpdate.
@@ -550,7 +655,8 @@ absl::Status ReadWriteTransaction::Write(const Mutation& mutation) {
               FlattenNonDeleteOpRow(
                   resolved_mutation_op.type, resolved_mutation_op.table,
                   resolved_mutation_op.columns, resolved_mutation_op.keys[i],
-                  resolved_mutation_op.rows[i], transaction_store_.get()));
+                  std::move(resolved_mutation_op.rows[i]),
+                  transaction_store_.get()));
 
           if (has_delete_cascade_foreign_key) {
             ZETASQL_RETURN_IF_ERROR(fk_restrictions.ValidateReferencedMods(
@@ -595,19 +701,26 @@ absl::Status ReadWriteTransaction::Commit() {
     ZETASQL_ASSIGN_OR_RETURN(commit_timestamp_, lock_handle_->ReserveCommitTimestamp());
 
     // Write the mutations to the base storage.
-    absl::Status flush_status = FlushWriteOpsToStorage(
-        transaction_store_->GetBufferedOps(), base_storage_, commit_timestamp_);
+    std::vector<WriteOp> write_ops = transaction_store_->GetBufferedOps();
+    absl::Status flush_status =
+        FlushWriteOpsToStorage(write_ops, base_storage_, commit_timestamp_);
     ZETASQL_RETURN_IF_ERROR(lock_handle_->MarkCommitted());
     if (!flush_status.ok()) {
       return flush_status;
     }
 
+    // Update the vector and search indexes before other transactions can
+    // write to the rows again.
+    ZETASQL_RETURN_IF_ERROR(CommitVectorAndSearchIndexes(write_ops));
+
     // Mark the transaction as committed.
     state_ = State::kCommitted;
 
     // Unlock all locks.
     lock_handle_->UnlockAll();
 
+    NotifyChangeStreamCommits(write_ops);
+
     return absl::OkStatus();
   });
 }
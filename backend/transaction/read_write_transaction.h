@@ -31,6 +31,7 @@
 #include "backend/actions/manager.h"
 #include "backend/common/case.h"
 #include "backend/common/ids.h"
+#include "backend/database/change_stream/change_stream_commit_notifier.h"
 #include "backend/datamodel/key.h"
 #include "backend/datamodel/key_range.h"
 #include "backend/locking/handle.h"
@@ -84,7 +85,9 @@ class ReadWriteTransaction : public RowReader, public RowWriter {
                        TransactionID transaction_id, Clock* clock,
                        Storage* storage, LockManager* lock_manager,
                        const VersionedCatalog* const versioned_catalog,
-                       ActionManager* action_manager);
+                       ActionManager* action_manager,
+                       ChangeStreamCommitNotifier* change_stream_notifier =
+                           nullptr);
 
   absl::Status Read(const ReadArg& read_arg,
                     std::unique_ptr<RowCursor>* cursor) override
@@ -145,6 +148,18 @@ class ReadWriteTransaction : public RowReader, public RowWriter {
       ABSL_LOCKS_EXCLUDED(mu_);
   absl::Status ProcessWriteOps(const std::vector<WriteOp>& write_ops);
   absl::Status ProcessChangeStreamWriteOps();
+  // Wakes up change stream queries waiting on the change stream internal
+  // tables written by `write_ops`.
+  void NotifyChangeStreamCommits(const std::vector<WriteOp>& write_ops)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  // Replaces the vectors and token lists of the rows written by `write_ops` in
+  // the vector and search indexes with the committed ones.
+  absl::Status CommitVectorAndSearchIndexes(
+      const std::vector<WriteOp>& write_ops) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  // Discards the vectors and token lists the buffered writes added to the
+  // vector and search indexes.
+  void DiscardUncommittedVectorAndSearchIndexEntries()
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
   // Resets the transaction and marks it Active.
   void Reset();
 
@@ -156,10 +171,11 @@ class ReadWriteTransaction : public RowReader, public RowWriter {
   // Updates commit timestamp tracking to reflect currently buffered ops.
   void UpdateTrackedCommitTimestamps();
 
-  // Converts input non-delete MutationOp into ResolvedMutationOp after
-  // validating that input table, columns and rows are valid schema objects.
+  // Converts input non-delete MutationOp, which writes `columns` of `table`,
+  // into ResolvedMutationOp.
   absl::StatusOr<ResolvedMutationOp> ResolveNonDeleteMutationOp(
-      const MutationOp& mutation_op, const Schema* schema);
+      const MutationOp& mutation_op, const Table* table,
+      std::vector<const Column*> columns);
 
   // Returns true if the given key exists within the table.
   bool KeyExists(const Table* table, const Key& key) const;
@@ -200,6 +216,9 @@ class ReadWriteTransaction : public RowReader, public RowWriter {
   ActionRegistry* action_registry_;
   std::unique_ptr<ActionContext> action_context_;
 
+  // Notified of commits to change stream internal tables. May be null.
+  ChangeStreamCommitNotifier* change_stream_notifier_;
+
   // The commit timestamp chosen for this transaction.
   absl::Time commit_timestamp_ ABSL_GUARDED_BY(mu_);
 
@@ -22,8 +22,8 @@
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_set.h"
 #include "absl/status/statusor.h"
-#include "absl/strings/match.h"
 #include "absl/strings/string_view.h"
 #include "backend/access/write.h"
 #include "backend/common/case.h"
@@ -96,6 +96,18 @@ absl::Status ValidateColumnsAreNotDuplicate(
   return absl::OkStatus();
 }
 
+absl::Status ValidateColumnsAreNotDuplicate(
+    const std::vector<const Column*>& columns) {
+  absl::flat_hash_set<const Column*> seen_columns;
+  seen_columns.reserve(columns.size());
+  for (const Column* column : columns) {
+    if (!seen_columns.insert(column).second) {
+      return error::MultipleValuesForColumn(column->Name());
+    }
+  }
+  return absl::OkStatus();
+}
+
 absl::Status ValidateNotNullColumnsPresent(
     const Table* table, const std::vector<const Column*>& columns) {
   // TODO: Find a way of doing this without creating a hash set for
@@ -219,9 +231,7 @@ absl::StatusOr<std::vector<std::optional<int>>> ExtractPrimaryKeyIndices(
   for (const auto& key_column : primary_key) {
     int i = 0;
     for (; i < columns.size(); ++i) {
-      // Column names are case-insensitive in Cloud Spanner.
-      if (absl::EqualsIgnoreCase(key_column->column()->Name(),
-                                 columns[i]->Name())) {
+      if (key_column->column() == columns[i]) {
         key_indices.push_back(i);
         break;
       }
@@ -294,6 +304,9 @@ absl::StatusOr<ResolvedReadArg> ResolveReadArg(const ReadArg& read_arg,
       return error::IndexTableDoesNotMatchBaseTable(
           read_table->Name(), index->indexed_table()->Name(), index->Name());
     }
+    if (index->is_write_only()) {
+      return error::IndexNotReadable(index->Name());
+    }
     read_table = index->index_data_table();
   }
 
@@ -341,10 +354,8 @@ absl::StatusOr<const Table*> FindChangeStreamPartitionTable(
   return iter->change_stream_partition_table();
 }
 
-absl::Status ValidateNonDeleteMutationOp(const MutationOp& mutation_op,
-                                         const Schema* schema) {
-  ZETASQL_RET_CHECK(mutation_op.type != MutationOpType::kDelete);
-
+absl::StatusOr<const Table*> FindMutationOpTable(const MutationOp& mutation_op,
+                                                 const Schema* schema) {
   const Table* table = schema->FindTable(mutation_op.table);
 
   if (IsChangeStreamPartitionTable(mutation_op.table)) {
@@ -355,15 +366,29 @@ absl::Status ValidateNonDeleteMutationOp(const MutationOp& mutation_op,
   if (table == nullptr) {
     return error::TableNotFound(mutation_op.table);
   }
+  return table;
+}
+
+absl::StatusOr<std::vector<const Column*>> ResolveMutationOpColumns(
+    const MutationOp& mutation_op, const Table* table) {
+  if (mutation_op.resolved_table == table &&
+      mutation_op.resolved_columns.size() == mutation_op.columns.size()) {
+    ZETASQL_RETURN_IF_ERROR(
+        ValidateColumnsAreNotDuplicate(mutation_op.resolved_columns));
+    return mutation_op.resolved_columns;
+  }
 
   ZETASQL_RETURN_IF_ERROR(ValidateColumnsAreNotDuplicate(mutation_op.columns));
+  return GetColumnsByName(table, mutation_op.columns);
+}
 
-  ZETASQL_ASSIGN_OR_RETURN(std::vector<const Column*> columns,
-                   GetColumnsByName(table, mutation_op.columns));
+absl::Status ValidateNonDeleteMutationOp(
+    MutationOpType op_type, const Table* table,
+    const std::vector<const Column*>& columns) {
+  ZETASQL_RET_CHECK(op_type != MutationOpType::kDelete);
 
-  ZETASQL_RETURN_IF_ERROR(
-      ValidateDefaultAndGeneratedKeys(table, columns, mutation_op.type));
-  if (mutation_op.type != MutationOpType::kUpdate) {
+  ZETASQL_RETURN_IF_ERROR(ValidateDefaultAndGeneratedKeys(table, columns, op_type));
+  if (op_type != MutationOpType::kUpdate) {
     // Insert, InsertOrUpdate and Replace mutation ops require that all
     // not-null columns be present in the mutation. Note: this check is
     // specifically done before InsertOrUpdate & Replace mutation ops are
@@ -371,7 +396,7 @@ absl::Status ValidateNonDeleteMutationOp(const MutationOp& mutation_op,
     ZETASQL_RETURN_IF_ERROR(ValidateNotNullColumnsPresent(table, columns));
   }
   ZETASQL_RETURN_IF_ERROR(
-      ValidateGeneratedColumnsNotPresent(table, columns, mutation_op.type));
+      ValidateGeneratedColumnsNotPresent(table, columns, op_type));
 
   return absl::OkStatus();
 }
@@ -86,9 +86,22 @@ absl::StatusOr<std::vector<std::optional<int>>> ExtractPrimaryKeyIndices(
     absl::Span<const Column* const> columns,
     absl::Span<const KeyColumn* const> primary_key);
 
-// Validates that input table, columns and rows are valid schema objects.
-absl::Status ValidateNonDeleteMutationOp(const MutationOp& mutation_op,
-                                         const Schema* schema);
+// Returns the table on which `mutation_op` operates, which may be the
+// partition table of a change stream.
+absl::StatusOr<const Table*> FindMutationOpTable(const MutationOp& mutation_op,
+                                                 const Schema* schema);
+
+// Returns the columns of `table` written by non-delete `mutation_op`, after
+// validating that no column is written twice. Reuses the columns resolved by
+// the producer of the op if they belong to `table`.
+absl::StatusOr<std::vector<const Column*>> ResolveMutationOpColumns(
+    const MutationOp& mutation_op, const Table* table);
+
+// Validates that a non-delete mutation op of the given type may write
+// `columns` of `table`.
+absl::Status ValidateNonDeleteMutationOp(
+    MutationOpType op_type, const Table* table,
+    const std::vector<const Column*>& columns);
 
 // Converts input Delete MutationOp into ResolvedMutationOp after validating
 // that input table, columns and rows are valid schema objects. Validates that
@@ -42,6 +42,7 @@ namespace {
 
 using zetasql::values::Int64;
 using zetasql::values::String;
+using zetasql_base::testing::IsOkAndHolds;
 using zetasql_base::testing::StatusIs;
 
 class ResolveTest : public testing::Test {
@@ -212,6 +213,44 @@ TEST_F(ResolveTest, CanResolveDeleteMutationOp) {
               testing::ElementsAre(KeyRange::Point(k1)));
 }
 
+TEST_F(ResolveTest, CanResolveMutationOpColumnsByName) {
+  MutationOp mutation_op(MutationOpType::kInsert, "TestTable",
+                         {"int64col", "StringCol"}, {});
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(const Table* table,
+                       FindMutationOpTable(mutation_op, schema_.get()));
+  EXPECT_EQ(table, test_table_);
+  EXPECT_THAT(ResolveMutationOpColumns(mutation_op, table),
+              IsOkAndHolds(testing::ElementsAre(int_col_, string_col_)));
+}
+
+TEST_F(ResolveTest, ReusesResolvedMutationOpColumns) {
+  MutationOp mutation_op(MutationOpType::kInsert, "TestTable",
+                         {"Int64Col", "StringCol"}, {});
+  // Resolved columns are trusted as long as they belong to the table.
+  mutation_op.resolved_table = test_table_;
+  mutation_op.resolved_columns = {string_col_, int_col_};
+  EXPECT_THAT(ResolveMutationOpColumns(mutation_op, test_table_),
+              IsOkAndHolds(testing::ElementsAre(string_col_, int_col_)));
+
+  // Columns resolved for another table are looked up again by name.
+  EXPECT_THAT(ResolveMutationOpColumns(mutation_op,
+                                       change_stream_partition_table_),
+              StatusIs(absl::StatusCode::kNotFound));
+}
+
+TEST_F(ResolveTest, CannotResolveDuplicateMutationOpColumns) {
+  MutationOp mutation_op(MutationOpType::kInsert, "TestTable",
+                         {"Int64Col", "int64col"}, {});
+  EXPECT_THAT(ResolveMutationOpColumns(mutation_op, test_table_),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+
+  mutation_op.resolved_table = test_table_;
+  mutation_op.resolved_columns = {int_col_, int_col_};
+  EXPECT_THAT(ResolveMutationOpColumns(mutation_op, test_table_),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
 }  // namespace
 }  // namespace backend
 }  // namespace emulator
@@ -225,7 +225,7 @@ absl::Status TransactionStore::Read(
   std::vector<FixedRowStorageIterator::Row> rows;
   auto table_itr = buffered_ops_.find(table);
   if (table_itr != buffered_ops_.end()) {
-    auto table = table_itr->second;
+    const auto& table = table_itr->second;
     // Key range lookup.
     auto begin_itr = table.lower_bound(key_range.start_key());
     auto end_itr = table.lower_bound(key_range.limit_key());
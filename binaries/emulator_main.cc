@@ -24,12 +24,19 @@
 #include "frontend/server/server.h"
 
 using Server = ::google::spanner::emulator::frontend::Server;
+namespace config = ::google::spanner::emulator::config;
 
 int main(int argc, char** argv) {
   // Start the emulator gRPC server.
   absl::ParseCommandLine(argc, argv);
   Server::Options options;
-  options.server_address = google::spanner::emulator::config::grpc_host_port();
+  options.server_address = config::grpc_host_port();
+  options.num_worker_threads = config::grpc_worker_threads();
+  options.num_query_threads = config::grpc_query_threads();
+  options.max_streaming_calls = config::grpc_max_streaming_calls();
+  options.max_concurrent_streams_per_connection =
+      config::grpc_max_concurrent_streams_per_connection();
+  options.resource_quota_bytes = config::grpc_resource_quota_bytes();
   std::unique_ptr<Server> server = Server::Create(options);
   if (!server) {
     ABSL_LOG(ERROR) << "Failed to start gRPC server.";
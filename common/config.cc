@@ -16,6 +16,7 @@
 
 #include "common/config.h"
 
+#include <cstdint>
 #include <string>
 
 #include "absl/flags/flag.h"
@@ -51,6 +52,30 @@ ABSL_FLAG(
     "to the current transaction. A value of zero means that the emulator will "
     "never abort the current transaction.");
 
+ABSL_FLAG(int, grpc_worker_threads, 0,
+          "Maximum number of gRPC requests other than reads, queries and DML "
+          "that the emulator processes concurrently. Further requests are "
+          "queued. If zero, the limit is derived from the number of CPUs.");
+
+ABSL_FLAG(int, grpc_query_threads, 0,
+          "Maximum number of reads, queries and DML requests that the "
+          "emulator processes concurrently. Further requests are queued. "
+          "Change stream queries waiting for new records do not count against "
+          "this limit. If zero, the limit is the number of CPUs.");
+
+ABSL_FLAG(int, grpc_max_streaming_calls, 4096,
+          "Maximum number of concurrent server streaming gRPC calls (e.g. "
+          "change stream queries). Further calls fail with RESOURCE_EXHAUSTED. "
+          "If zero, the number of streaming calls is not limited.");
+
+ABSL_FLAG(int, grpc_max_concurrent_streams_per_connection, 0,
+          "Maximum number of concurrent gRPC calls on a single client "
+          "connection. If zero, the gRPC default is used.");
+
+ABSL_FLAG(int64_t, grpc_resource_quota_bytes, 0,
+          "Maximum amount of memory that the gRPC server may use for buffers. "
+          "If zero, the memory used by gRPC is not limited.");
+
 namespace google {
 namespace spanner {
 namespace emulator {
@@ -76,6 +101,22 @@ void set_abort_current_transaction_probability(int probability) {
   absl::SetFlag(&FLAGS_abort_current_transaction_probability, probability);
 }
 
+int grpc_worker_threads() { return absl::GetFlag(FLAGS_grpc_worker_threads); }
+
+int grpc_query_threads() { return absl::GetFlag(FLAGS_grpc_query_threads); }
+
+int grpc_max_streaming_calls() {
+  return absl::GetFlag(FLAGS_grpc_max_streaming_calls);
+}
+
+int grpc_max_concurrent_streams_per_connection() {
+  return absl::GetFlag(FLAGS_grpc_max_concurrent_streams_per_connection);
+}
+
+int64_t grpc_resource_quota_bytes() {
+  return absl::GetFlag(FLAGS_grpc_resource_quota_bytes);
+}
+
 }  // namespace config
 }  // namespace emulator
 }  // namespace spanner
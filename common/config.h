@@ -17,6 +17,7 @@
 #ifndef THIRD_PARTY_CLOUD_SPANNER_EMULATOR_COMMON_CONFIG_H_
 #define THIRD_PARTY_CLOUD_SPANNER_EMULATOR_COMMON_CONFIG_H_
 
+#include <cstdint>
 #include <string>
 
 namespace google {
@@ -54,6 +55,26 @@ int abort_current_transaction_probability();
 
 void set_abort_current_transaction_probability(int probability);
 
+// Maximum number of gRPC requests processed concurrently, not counting reads,
+// queries and DML. Zero means that the limit is derived from the number of
+// CPUs.
+int grpc_worker_threads();
+
+// Maximum number of reads, queries and DML processed concurrently. Zero means
+// that the limit is the number of CPUs.
+int grpc_query_threads();
+
+// Maximum number of concurrent server streaming gRPC calls. Zero means no
+// limit.
+int grpc_max_streaming_calls();
+
+// Maximum number of concurrent gRPC calls per client connection. Zero means
+// that the gRPC default is used.
+int grpc_max_concurrent_streams_per_connection();
+
+// Maximum amount of memory used by the gRPC server. Zero means no limit.
+int64_t grpc_resource_quota_bytes();
+
 }  // namespace config
 }  // namespace emulator
 }  // namespace spanner
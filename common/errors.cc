@@ -249,6 +249,16 @@ absl::Status BadLabelValue(absl::string_view key, absl::string_view value) {
                    key));
 }
 
+// Server errors.
+absl::Status TooManyStreamingCalls(int max_streaming_calls) {
+  return absl::Status(
+      absl::StatusCode::kResourceExhausted,
+      absl::Substitute("The emulator is already serving $0 streaming calls. "
+                       "Retry once some of them have finished, or raise "
+                       "--grpc_max_streaming_calls.",
+                       max_streaming_calls));
+}
+
 // Session errors.
 absl::Status InvalidSessionURI(absl::string_view uri) {
   return absl::Status(absl::StatusCode::kInvalidArgument,
@@ -2350,6 +2360,14 @@ absl::Status IndexNotFound(absl::string_view index, absl::string_view table) {
                                    "' was found for table '", table, "'."));
 }
 
+absl::Status IndexNotReadable(absl::string_view index) {
+  return absl::Status(
+      absl::StatusCode::kFailedPrecondition,
+      absl::Substitute("The index $0 cannot be used because it is still being "
+                       "backfilled.",
+                       index));
+}
+
 absl::Status ColumnNotFoundInIndex(absl::string_view index,
                                    absl::string_view indexed_table,
                                    absl::string_view column) {
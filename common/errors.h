@@ -78,6 +78,9 @@ absl::Status TooManyLabels(int num);
 absl::Status BadLabelKey(absl::string_view key);
 absl::Status BadLabelValue(absl::string_view key, absl::string_view value);
 
+// Server errors.
+absl::Status TooManyStreamingCalls(int max_streaming_calls);
+
 // Session errors.
 absl::Status InvalidSessionURI(absl::string_view uri);
 absl::Status SessionNotFound(absl::string_view uri);
@@ -559,6 +562,7 @@ absl::Status IndexTableDoesNotMatchBaseTable(absl::string_view base_table,
                                              absl::string_view index);
 
 absl::Status IndexNotFound(absl::string_view index, absl::string_view table);
+absl::Status IndexNotReadable(absl::string_view index);
 
 absl::Status ColumnNotFoundInIndex(absl::string_view index,
                                    absl::string_view indexed_table,
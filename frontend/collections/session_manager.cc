@@ -16,14 +16,19 @@
 
 #include "frontend/collections/session_manager.h"
 
-#include <map>
+#include <algorithm>
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <thread>  // NOLINT
+#include <utility>
 #include <vector>
 
+#include "absl/flags/flag.h"
+#include "absl/log/log.h"
 #include "absl/status/statusor.h"
-#include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
 #include "common/errors.h"
@@ -32,15 +37,73 @@
 #include "frontend/entities/database.h"
 #include "frontend/entities/session.h"
 
+ABSL_FLAG(absl::Duration, session_reaper_interval, absl::Minutes(1),
+          "How often to delete sessions that have been idle for longer than "
+          "their expiration duration.");
+
 namespace google {
 namespace spanner {
 namespace emulator {
 namespace frontend {
 
+namespace {
+
+// Returns true if the session has been idle for longer than it is kept alive.
+bool IsExpired(const Session& session, absl::Time now) {
+  absl::Duration expiration_duration =
+      session.multiplexed() ? absl::Hours(28 * 24) : absl::Hours(1);
+  return now - session.approximate_last_use_time() > expiration_duration;
+}
+
+// Returns the URI of the database a session URI belongs to.
+absl::string_view DatabaseUriOf(absl::string_view session_uri) {
+  return session_uri.substr(0, session_uri.rfind("/sessions/"));
+}
+
+}  // namespace
+
+SessionManager::SessionManager(Clock* clock) : clock_(clock) {
+  reaper_thread_ = std::thread(&SessionManager::RunReaper, this);
+}
+
+SessionManager::~SessionManager() {
+  {
+    absl::MutexLock lock(&reaper_mu_);
+    stop_reaper_ = true;
+  }
+  reaper_thread_.join();
+}
+
+SessionManager::SessionShard* SessionManager::FindShard(
+    absl::string_view database_uri) const {
+  auto itr = shards_.find(database_uri);
+  return itr == shards_.end() ? nullptr : itr->second.get();
+}
+
+void SessionManager::InsertSession(SessionShard* shard,
+                                   std::shared_ptr<Session> session) {
+  if (session->multiplexed()) {
+    ++shard->num_multiplexed_sessions;
+  }
+  std::string session_uri = session->session_uri();
+  shard->sessions[std::move(session_uri)] = std::move(session);
+}
+
+void SessionManager::EraseSession(SessionShard* shard,
+                                  const std::string& session_uri) {
+  auto itr = shard->sessions.find(session_uri);
+  if (itr == shard->sessions.end()) {
+    return;
+  }
+  if (itr->second->multiplexed()) {
+    --shard->num_multiplexed_sessions;
+  }
+  shard->sessions.erase(itr);
+}
+
 absl::StatusOr<std::shared_ptr<Session>> SessionManager::CreateSession(
     const Labels& labels, const bool multiplexed,
     std::shared_ptr<Database> database) {
-  absl::MutexLock lock(&mu_);
   const std::string session_id = absl::StrCat(next_session_id_++);
   std::string session_uri =
       MakeSessionUri(database->database_uri(), session_id);
@@ -49,58 +112,156 @@ absl::StatusOr<std::shared_ptr<Session>> SessionManager::CreateSession(
                                 /* create_time = */ clock_->Now(), database);
   session->set_approximate_last_use_time(clock_->Now());
 
-  session_map_[session_uri] = session;
+  {
+    absl::ReaderMutexLock lock(&mu_);
+    SessionShard* shard = FindShard(database->database_uri());
+    if (shard != nullptr) {
+      absl::MutexLock shard_lock(&shard->mu);
+      InsertSession(shard, session);
+      return session;
+    }
+  }
+
+  // First session of the database.
+  absl::MutexLock lock(&mu_);
+  std::unique_ptr<SessionShard>& shard = shards_[database->database_uri()];
+  if (shard == nullptr) {
+    shard = std::make_unique<SessionShard>();
+  }
+  absl::MutexLock shard_lock(&shard->mu);
+  InsertSession(shard.get(), session);
   return session;
 }
 
 absl::StatusOr<std::shared_ptr<Session>> SessionManager::GetSession(
     const std::string& session_uri) {
-  absl::MutexLock lock(&mu_);
-  auto itr = session_map_.find(session_uri);
-  if (itr == session_map_.end()) {
+  absl::ReaderMutexLock lock(&mu_);
+  SessionShard* shard = FindShard(DatabaseUriOf(session_uri));
+  if (shard == nullptr) {
+    return error::SessionNotFound(session_uri);
+  }
+  absl::MutexLock shard_lock(&shard->mu);
+  auto itr = shard->sessions.find(session_uri);
+  if (itr == shard->sessions.end()) {
     return error::SessionNotFound(session_uri);
   }
   std::shared_ptr<Session> session = itr->second;
-  absl::Duration expiration_duration =
-      session->multiplexed() ? absl::Hours(28 * 24) : absl::Hours(1);
-  if (clock_->Now() - session->approximate_last_use_time() >
-      expiration_duration) {
+  const absl::Time now = clock_->Now();
+  if (IsExpired(*session, now)) {
     // Delete inactive sessions after expiration duration.
-    session_map_.erase(session_uri);
+    EraseSession(shard, session_uri);
+    ++num_expired_sessions_;
     return error::SessionNotFound(session_uri);
   }
-  session->set_approximate_last_use_time(clock_->Now());
+  session->set_approximate_last_use_time(now);
   return session;
 }
 
 absl::StatusOr<std::vector<std::shared_ptr<Session>>>
 SessionManager::ListSessions(const std::string& database_uri) const {
-  absl::MutexLock lock(&mu_);
-  std::string session_uri_prefix = absl::StrCat(database_uri, "/");
   std::vector<std::shared_ptr<Session>> sessions;
-  for (auto itr = session_map_.lower_bound(session_uri_prefix);
-       itr != session_map_.end(); ++itr) {
-    if (absl::StartsWith(itr->first, session_uri_prefix)) {
-      std::shared_ptr<Session> session = itr->second;
-      absl::Duration expiration_duration =
-          session->multiplexed() ? absl::Hours(28 * 24) : absl::Hours(1);
-      if (clock_->Now() - session->approximate_last_use_time() <=
-          expiration_duration) {
+  {
+    absl::ReaderMutexLock lock(&mu_);
+    SessionShard* shard = FindShard(database_uri);
+    if (shard == nullptr) {
+      return sessions;
+    }
+    const absl::Time now = clock_->Now();
+    absl::MutexLock shard_lock(&shard->mu);
+    for (const auto& [session_uri, session] : shard->sessions) {
+      if (!IsExpired(*session, now)) {
         sessions.push_back(session);
       }
-    } else {
-      return sessions;
     }
   }
+  std::sort(sessions.begin(), sessions.end(),
+            [](const std::shared_ptr<Session>& a,
+               const std::shared_ptr<Session>& b) {
+              return a->session_uri() < b->session_uri();
+            });
   return sessions;
 }
 
 absl::Status SessionManager::DeleteSession(const std::string& session_uri) {
-  absl::MutexLock lock(&mu_);
-  session_map_.erase(session_uri);
+  absl::ReaderMutexLock lock(&mu_);
+  SessionShard* shard = FindShard(DatabaseUriOf(session_uri));
+  if (shard != nullptr) {
+    absl::MutexLock shard_lock(&shard->mu);
+    EraseSession(shard, session_uri);
+  }
   return absl::OkStatus();
 }
 
+int64_t SessionManager::ReapExpiredSessions() {
+  int64_t num_reaped = 0;
+  bool has_empty_shards = false;
+  {
+    absl::ReaderMutexLock lock(&mu_);
+    const absl::Time now = clock_->Now();
+    for (const auto& [database_uri, shard] : shards_) {
+      absl::MutexLock shard_lock(&shard->mu);
+      std::vector<std::string> expired;
+      for (const auto& [session_uri, session] : shard->sessions) {
+        if (IsExpired(*session, now)) {
+          expired.push_back(session_uri);
+        }
+      }
+      for (const std::string& session_uri : expired) {
+        EraseSession(shard.get(), session_uri);
+      }
+      num_reaped += expired.size();
+      has_empty_shards |= shard->sessions.empty();
+    }
+  }
+  num_expired_sessions_ += num_reaped;
+
+  if (has_empty_shards) {
+    // Shards of databases without sessions are dropped so that deleted
+    // databases do not leave entries behind.
+    absl::MutexLock lock(&mu_);
+    absl::erase_if(shards_, [](const auto& entry) {
+      absl::MutexLock shard_lock(&entry.second->mu);
+      return entry.second->sessions.empty();
+    });
+  }
+  return num_reaped;
+}
+
+SessionCounts SessionManager::GetSessionCounts() const {
+  SessionCounts counts;
+  {
+    absl::ReaderMutexLock lock(&mu_);
+    for (const auto& [database_uri, shard] : shards_) {
+      absl::MutexLock shard_lock(&shard->mu);
+      counts.num_sessions += shard->sessions.size();
+      counts.num_multiplexed_sessions += shard->num_multiplexed_sessions;
+    }
+  }
+  counts.num_expired_sessions = num_expired_sessions_;
+  return counts;
+}
+
+void SessionManager::RunReaper() {
+  while (true) {
+    {
+      absl::MutexLock lock(&reaper_mu_);
+      reaper_mu_.AwaitWithTimeout(absl::Condition(&stop_reaper_),
+                                  absl::GetFlag(FLAGS_session_reaper_interval));
+      if (stop_reaper_) {
+        return;
+      }
+    }
+    const int64_t num_reaped = ReapExpiredSessions();
+    if (num_reaped > 0) {
+      const SessionCounts counts = GetSessionCounts();
+      ABSL_LOG(INFO) << "Deleted " << num_reaped << " expired sessions, "
+                     << counts.num_sessions << " sessions ("
+                     << counts.num_multiplexed_sessions
+                     << " multiplexed) remain.";
+    }
+  }
+}
+
 }  // namespace frontend
 }  // namespace emulator
 }  // namespace spanner
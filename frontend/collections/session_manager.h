@@ -17,22 +17,58 @@
 #ifndef STORAGE_CLOUD_SPANNER_EMULATOR_FRONTEND_SESSION_MANAGER_H_
 #define STORAGE_CLOUD_SPANNER_EMULATOR_FRONTEND_SESSION_MANAGER_H_
 
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/flags/declare.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
 #include "common/clock.h"
 #include "frontend/entities/database.h"
 #include "frontend/entities/session.h"
 
+// How often the background reaper deletes sessions that have been idle for
+// longer than their expiration duration.
+ABSL_DECLARE_FLAG(absl::Duration, session_reaper_interval);
+
 namespace google {
 namespace spanner {
 namespace emulator {
 namespace frontend {
 
+// Number of sessions tracked by the session manager.
+struct SessionCounts {
+  // Number of live sessions, including multiplexed sessions.
+  int64_t num_sessions = 0;
+
+  // Number of live multiplexed sessions.
+  int64_t num_multiplexed_sessions = 0;
+
+  // Number of sessions deleted so far because they were idle for too long.
+  int64_t num_expired_sessions = 0;
+};
+
 // Session manager manages the set of active sessions in the emulator.
+//
+// Sessions are sharded by database so that lookups, which happen on every RPC,
+// only contend with other requests on the same database. Like in production,
+// sessions that have not been used for an hour (28 days for multiplexed
+// sessions) expire and are deleted by a background reaper.
 class SessionManager {
  public:
-  explicit SessionManager(Clock* clock) : clock_(clock) {}
+  explicit SessionManager(Clock* clock);
+
+  // Stops the background reaper.
+  ~SessionManager();
 
   // Creates a session attached to the given database.
   absl::StatusOr<std::shared_ptr<Session>> CreateSession(
@@ -47,23 +83,69 @@ class SessionManager {
   absl::Status DeleteSession(const std::string& session_uri)
       ABSL_LOCKS_EXCLUDED(mu_);
 
-  // Lists sessions attached to the given database URI.
+  // Lists sessions attached to the given database URI, sorted by session URI.
   absl::StatusOr<std::vector<std::shared_ptr<Session>>> ListSessions(
       const std::string& database_uri) const ABSL_LOCKS_EXCLUDED(mu_);
 
+  // Deletes all expired sessions and returns how many were deleted. This is
+  // called periodically by the background reaper.
+  int64_t ReapExpiredSessions() ABSL_LOCKS_EXCLUDED(mu_);
+
+  // Returns the number of live and expired sessions.
+  SessionCounts GetSessionCounts() const ABSL_LOCKS_EXCLUDED(mu_);
+
  private:
+  // Sessions of a single database.
+  struct SessionShard {
+    mutable absl::Mutex mu;
+
+    // Map from session URI to session objects.
+    absl::flat_hash_map<std::string, std::shared_ptr<Session>> sessions
+        ABSL_GUARDED_BY(mu);
+
+    int64_t num_multiplexed_sessions ABSL_GUARDED_BY(mu) = 0;
+  };
+
+  // Returns the shard of the database, or nullptr if it has no sessions.
+  SessionShard* FindShard(absl::string_view database_uri) const
+      ABSL_SHARED_LOCKS_REQUIRED(mu_);
+
+  // Adds the session to the shard.
+  static void InsertSession(SessionShard* shard,
+                            std::shared_ptr<Session> session)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(shard->mu);
+
+  // Removes the session from the shard.
+  static void EraseSession(SessionShard* shard,
+                           const std::string& session_uri)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(shard->mu);
+
+  // Body of the background reaper thread.
+  void RunReaper() ABSL_LOCKS_EXCLUDED(reaper_mu_);
+
   // System-wide clock.
   Clock* clock_;
 
-  // Mutex to guard state below.
-  mutable absl::Mutex mu_;
-
   // Counter for session ids.
-  int next_session_id_ ABSL_GUARDED_BY(mu_) = 0;
+  std::atomic<int64_t> next_session_id_ = 0;
 
-  // Map from session URI to session objects.
-  std::map<std::string, std::shared_ptr<Session>> session_map_
+  // Number of sessions deleted because they expired.
+  std::atomic<int64_t> num_expired_sessions_ = 0;
+
+  // Guards the set of shards. Requests on sessions hold it in shared mode for
+  // their duration, so that empty shards are only removed when no request is
+  // using them.
+  mutable absl::Mutex mu_;
+
+  // Map from database URI to the sessions of that database.
+  absl::flat_hash_map<std::string, std::unique_ptr<SessionShard>> shards_
       ABSL_GUARDED_BY(mu_);
+
+  absl::Mutex reaper_mu_;
+
+  bool stop_reaper_ ABSL_GUARDED_BY(reaper_mu_) = false;
+
+  std::thread reaper_thread_;
 };
 
 }  // namespace frontend
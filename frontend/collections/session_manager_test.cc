@@ -17,17 +17,24 @@
 #include "frontend/collections/session_manager.h"
 
 #include <memory>
+#include <string>
+#include <vector>
 
+#include "google/spanner/v1/transaction.pb.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "zetasql/base/testing/status_matchers.h"
 #include "tests/common/proto_matchers.h"
+#include "absl/flags/flag.h"
 #include "absl/strings/match.h"
+#include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "common/clock.h"
+#include "common/limits.h"
 #include "frontend/collections/database_manager.h"
 #include "frontend/entities/database.h"
 #include "frontend/entities/session.h"
+#include "frontend/entities/transaction.h"
 #include "zetasql/base/status_macros.h"
 
 namespace google {
@@ -128,6 +135,98 @@ TEST_F(SessionManagerTest, GetMultiplexedSessionFailsAfterVersionGcDuration) {
               zetasql_base::testing::StatusIs(absl::StatusCode::kNotFound));
 }
 
+TEST_F(SessionManagerTest, ReapExpiredSessions) {
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::shared_ptr<Session> expired,
+      session_manager_.CreateSession(test_labels_, multiplexed_, database_));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::shared_ptr<Session> active,
+      session_manager_.CreateSession(test_labels_, multiplexed_, database_));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::shared_ptr<Session> multiplexed,
+      session_manager_.CreateSession(test_labels_, true, database_));
+  expired->set_approximate_last_use_time(absl::Now() - absl::Hours(1.5));
+  multiplexed->set_approximate_last_use_time(absl::Now() - absl::Hours(1.5));
+
+  EXPECT_EQ(session_manager_.ReapExpiredSessions(), 1);
+  SessionCounts counts = session_manager_.GetSessionCounts();
+  EXPECT_EQ(counts.num_sessions, 2);
+  EXPECT_EQ(counts.num_multiplexed_sessions, 1);
+  EXPECT_EQ(counts.num_expired_sessions, 1);
+  EXPECT_THAT(session_manager_.GetSession(expired->session_uri()),
+              zetasql_base::testing::StatusIs(absl::StatusCode::kNotFound));
+  ZETASQL_EXPECT_OK(session_manager_.GetSession(active->session_uri()));
+
+  // Once a database has no sessions left, its sessions can be created again.
+  ZETASQL_EXPECT_OK(session_manager_.DeleteSession(active->session_uri()));
+  ZETASQL_EXPECT_OK(session_manager_.DeleteSession(multiplexed->session_uri()));
+  EXPECT_EQ(session_manager_.ReapExpiredSessions(), 0);
+  EXPECT_EQ(session_manager_.GetSessionCounts().num_sessions, 0);
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::shared_ptr<Session> created,
+      session_manager_.CreateSession(test_labels_, multiplexed_, database_));
+  ZETASQL_EXPECT_OK(session_manager_.GetSession(created->session_uri()));
+}
+
+TEST_F(SessionManagerTest, MultiplexedSessionKeepsConcurrentTransactions) {
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::shared_ptr<Session> session,
+      session_manager_.CreateSession(test_labels_, true, database_));
+  google::spanner::v1::TransactionOptions options;
+  options.mutable_read_only()->set_strong(true);
+
+  // Unlike regular sessions, beginning a transaction does not invalidate the
+  // transactions created before it, and there is no cap on their number.
+  std::vector<std::shared_ptr<Transaction>> txns;
+  for (int i = 0; i < 2 * limits::kMaxTransactionsPerSession; ++i) {
+    ZETASQL_ASSERT_OK_AND_ASSIGN(
+        std::shared_ptr<Transaction> txn,
+        session->CreateMultiUseTransaction(
+            options, Session::TransactionActivation::kInitializeAndActivate));
+    txns.push_back(txn);
+  }
+  for (const std::shared_ptr<Transaction>& txn : txns) {
+    ZETASQL_ASSERT_OK_AND_ASSIGN(
+        std::shared_ptr<Transaction> found,
+        session->FindAndUseTransaction(std::to_string(txn->id())));
+    EXPECT_EQ(found, txn);
+  }
+}
+
+TEST_F(SessionManagerTest, MultiplexedSessionDropsIdleTransactions) {
+  absl::Duration retention =
+      absl::GetFlag(FLAGS_multiplexed_session_transaction_retention);
+  absl::SetFlag(&FLAGS_multiplexed_session_transaction_retention,
+                absl::Milliseconds(10));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::shared_ptr<Session> session,
+      session_manager_.CreateSession(test_labels_, true, database_));
+  google::spanner::v1::TransactionOptions options;
+  options.mutable_read_only()->set_strong(true);
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::shared_ptr<Transaction> idle,
+      session->CreateMultiUseTransaction(
+          options, Session::TransactionActivation::kInitializeAndActivate));
+  absl::SleepFor(absl::Milliseconds(20));
+
+  // Transactions are dropped as the session creates new ones, once they have
+  // been idle for longer than the retention period.
+  std::shared_ptr<Transaction> recent;
+  for (int i = 0; i < 64 * limits::kMaxTransactionsPerSession; ++i) {
+    ZETASQL_ASSERT_OK_AND_ASSIGN(
+        recent,
+        session->CreateMultiUseTransaction(
+            options, Session::TransactionActivation::kInitializeAndActivate));
+  }
+  EXPECT_TRUE(idle->IsClosed());
+  EXPECT_THAT(session->FindAndUseTransaction(std::to_string(idle->id())),
+              zetasql_base::testing::StatusIs(absl::StatusCode::kNotFound));
+  ZETASQL_EXPECT_OK(session->FindAndUseTransaction(std::to_string(recent->id())));
+
+  absl::SetFlag(&FLAGS_multiplexed_session_transaction_retention, retention);
+}
+
 TEST_F(SessionManagerTest, DeleteSession) {
   ZETASQL_ASSERT_OK_AND_ASSIGN(
       std::shared_ptr<Session> actual,
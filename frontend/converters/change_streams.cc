@@ -18,6 +18,7 @@
 
 #include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "google/protobuf/struct.pb.h"
@@ -394,7 +395,8 @@ ConvertHeartbeatTimestampToStruct(absl::Time timestamp, bool expect_metadata) {
               ChangeStreamOutputTypes::ReturningType::CHILD_PARTITIONS)));
   ZETASQL_ASSIGN_OR_RETURN(*row_pb->add_values(), ValueToProto(change_record));
   ZETASQL_ASSIGN_OR_RETURN(auto responses,
-                   ChunkResultSet(result_pb, limits::kMaxStreamingChunkSize));
+                   ChunkResultSet(std::move(result_pb),
+                                  limits::kMaxStreamingChunkSize));
   if (expect_metadata) {
     ZETASQL_RETURN_IF_ERROR(PopulateMetadata(&responses));
   } else {
@@ -426,7 +428,8 @@ ConvertPartitionTableRowCursorToStruct(
     record_sequence++;
   }
   ZETASQL_ASSIGN_OR_RETURN(auto responses,
-                   ChunkResultSet(result_pb, limits::kMaxStreamingChunkSize));
+                   ChunkResultSet(std::move(result_pb),
+                                  limits::kMaxStreamingChunkSize));
   if (expect_metadata) {
     ZETASQL_RETURN_IF_ERROR(PopulateMetadata(&responses));
   } else {
@@ -454,8 +457,12 @@ ConvertDataTableRowCursorToStruct(backend::RowCursor* row_cursor,
                 ChangeStreamOutputTypes::ReturningType::CHILD_PARTITIONS)));
     ZETASQL_ASSIGN_OR_RETURN(*row_pb->add_values(), ValueToProto(change_record));
   }
+  if (result_pb.rows().empty()) {
+    return std::vector<spanner_api::PartialResultSet>();
+  }
   ZETASQL_ASSIGN_OR_RETURN(auto responses,
-                   ChunkResultSet(result_pb, limits::kMaxStreamingChunkSize));
+                   ChunkResultSet(std::move(result_pb),
+                                  limits::kMaxStreamingChunkSize));
   if (expect_metadata) {
     ZETASQL_RETURN_IF_ERROR(PopulateMetadata(&responses));
   } else {
@@ -49,7 +49,8 @@ ConvertHeartbeatTimestampToStruct(absl::Time timestamp,
                                   bool expect_metadata = false);
 
 // Takes a row cursor from data table and convert all rows into a vector of
-// partial result set as ARRAY<STRUCT>.
+// partial result set as ARRAY<STRUCT>. Returns no partial result sets if the
+// cursor is empty.
 absl::StatusOr<std::vector<spanner_api::PartialResultSet>>
 ConvertDataTableRowCursorToStruct(backend::RowCursor* row_cursor,
                                   bool expect_metadata = false);
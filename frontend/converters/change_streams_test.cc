@@ -785,6 +785,28 @@ TEST_F(ChangeStreamResultConverterTest,
   ASSERT_EQ(change_recods.data_change_records.size(), 1);
 }
 
+TEST_F(ChangeStreamResultConverterTest,
+       ConvertEmptyDataTableRowCursorToStruct) {
+  TestRowCursor cursor(
+      {"partition_token", "commit_timestamp", "server_transaction_id",
+       "record_sequence", "is_last_record_in_transaction_in_partition",
+       "table_name", "column_types_name", "column_types_type",
+       "column_type_is_primary_key", "column_types_ordinal_position",
+       "mods_keys", "mods_new_values", "mods_old_values", "mod_type",
+       "value_capture_type", "number_of_records_in_transaction",
+       "number_of_partitions_in_transaction", "transaction_tag",
+       "is_system_transaction"},
+      {StringType(), TimestampType(), StringType(), StringType(), BoolType(),
+       StringType(), StringType(), StringType(), BoolType(), Int64Type(),
+       StringType(), StringType(), StringType(), StringType(), StringType(),
+       Int64Type(), Int64Type(), StringType(), BoolType()},
+      {});
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::vector<PartialResultSet> results,
+                       ConvertDataTableRowCursorToStruct(
+                           &cursor, /*expect_metadata=*/true));
+  EXPECT_TRUE(results.empty());
+}
+
 }  // namespace
 
 }  // namespace frontend
@@ -17,8 +17,10 @@
 #include "frontend/converters/chunking.h"
 
 #include <algorithm>
+#include <utility>
 #include <vector>
 
+#include "absl/functional/function_ref.h"
 #include "absl/memory/memory.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/substitute.h"
@@ -90,8 +92,9 @@ class ResultSetBuilder {
   }
 
   // Adds the incoming value to the set of PartialResultSets chunking as
-  // necessary.
-  absl::Status AddValue(const protobuf::Value& value) {
+  // necessary. Parts of the value which are not chunked are moved into the
+  // results.
+  absl::Status AddValue(protobuf::Value&& value) {
     // If the current size exceeds the limit, create a new chunk.
     if (HasExceededChunkLimit()) {
       StartNewResultSet();
@@ -102,16 +105,17 @@ class ResultSetBuilder {
     // partial values will be added to the end of this result set and beginning
     // of the next one. The partial results will be merged back together by the
     // receiving client.
-    auto value_size = value.ByteSizeLong();
+    const int64_t value_size = value.ByteSizeLong();
     switch (value.kind_case()) {
       case protobuf::Value::kListValue: {
         // Check if list can fit into current chunk.
         if (current_chunk_size_ + value_size <= max_chunk_size_) {
-          AddUnchunkedValue(value);
+          AddUnchunkedValue(std::move(value), value_size);
         } else {
           StartList();
-          for (const auto& list_value : value.list_value().values()) {
-            ZETASQL_RETURN_IF_ERROR(AddValue(list_value));
+          for (auto& list_value :
+               *value.mutable_list_value()->mutable_values()) {
+            ZETASQL_RETURN_IF_ERROR(AddValue(std::move(list_value)));
           }
           FinishList();
         }
@@ -121,7 +125,7 @@ class ResultSetBuilder {
       case protobuf::Value::kStringValue: {
         // Check if string can fit into current chunk.
         if (current_chunk_size_ + value_size <= max_chunk_size_) {
-          AddUnchunkedValue(value);
+          AddUnchunkedValue(std::move(value), value_size);
         } else {
           AddString(value.string_value());
         }
@@ -131,7 +135,7 @@ class ResultSetBuilder {
       case protobuf::Value::kBoolValue:
       case protobuf::Value::kNumberValue:
       case protobuf::Value::kNullValue:
-        AddUnchunkedValue(value);
+        AddUnchunkedValue(std::move(value), value_size);
         break;
 
       default:
@@ -156,10 +160,10 @@ class ResultSetBuilder {
   // Adds a value as the next value without chunking. The value will be added to
   // a list if there are any nested lists otherwise it will be added as the next
   // value in results. Used for the fast path when it is known this will not
-  // need to be chunked.
-  void AddUnchunkedValue(const protobuf::Value& value) {
-    *stack_.back()->Add() = value;
-    current_chunk_size_ += value.ByteSizeLong();
+  // need to be chunked. `value_size` is the serialized size of the value.
+  void AddUnchunkedValue(protobuf::Value&& value, int64_t value_size) {
+    *stack_.back()->Add() = std::move(value);
+    current_chunk_size_ += value_size;
   }
 
   // If a nested list ends at the boundary of the chunk, we need to make sure
@@ -290,15 +294,41 @@ class ResultSetBuilder {
 absl::StatusOr<std::vector<google::spanner::v1::PartialResultSet>>
 ChunkResultSet(const google::spanner::v1::ResultSet& set,
                int64_t max_chunk_size) {
+  return ChunkResultSet(google::spanner::v1::ResultSet(set), max_chunk_size);
+}
+
+absl::StatusOr<std::vector<google::spanner::v1::PartialResultSet>>
+ChunkResultSet(google::spanner::v1::ResultSet&& set, int64_t max_chunk_size) {
+  std::vector<google::spanner::v1::PartialResultSet> results;
+  results.emplace_back();
+  *results.front().mutable_metadata() = std::move(*set.mutable_metadata());
+
+  ResultSetBuilder builder(max_chunk_size, &results);
+  for (auto& row : *set.mutable_rows()) {
+    for (auto& value : *row.mutable_values()) {
+      ZETASQL_RETURN_IF_ERROR(builder.AddValue(std::move(value)));
+    }
+  }
+  return results;
+}
+
+absl::StatusOr<std::vector<google::spanner::v1::PartialResultSet>> ChunkValues(
+    google::spanner::v1::ResultSetMetadata metadata,
+    absl::FunctionRef<absl::StatusOr<bool>(protobuf::Value*)> next_value,
+    int64_t max_chunk_size) {
   std::vector<google::spanner::v1::PartialResultSet> results;
   results.emplace_back();
-  *results.front().mutable_metadata() = set.metadata();
+  *results.front().mutable_metadata() = std::move(metadata);
 
   ResultSetBuilder builder(max_chunk_size, &results);
-  for (const auto& row : set.rows()) {
-    for (const auto& value : row.values()) {
-      ZETASQL_RETURN_IF_ERROR(builder.AddValue(value));
+  protobuf::Value value;
+  while (true) {
+    value.Clear();
+    ZETASQL_ASSIGN_OR_RETURN(bool has_value, next_value(&value));
+    if (!has_value) {
+      break;
     }
+    ZETASQL_RETURN_IF_ERROR(builder.AddValue(std::move(value)));
   }
   return results;
 }
@@ -21,6 +21,7 @@
 
 #include "google/protobuf/struct.pb.h"
 #include "google/spanner/v1/result_set.pb.h"
+#include "absl/functional/function_ref.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 #include "absl/status/status.h"
@@ -36,6 +37,21 @@ namespace frontend {
 absl::StatusOr<std::vector<google::spanner::v1::PartialResultSet>>
 ChunkResultSet(const google::spanner::v1::ResultSet& set, int64_t max_chunk_size);
 
+// Same as above, but moves the values out of `set` instead of copying them.
+absl::StatusOr<std::vector<google::spanner::v1::PartialResultSet>>
+ChunkResultSet(google::spanner::v1::ResultSet&& set, int64_t max_chunk_size);
+
+// Chunks the values produced by `next_value` into PartialResultSets, the first
+// of which carries `metadata`. `next_value` encodes the next value of the
+// result, row after row, into an empty proto and returns false once there are
+// no more values. Lets callers encode results straight into chunks without
+// building a full ResultSet first.
+absl::StatusOr<std::vector<google::spanner::v1::PartialResultSet>> ChunkValues(
+    google::spanner::v1::ResultSetMetadata metadata,
+    absl::FunctionRef<absl::StatusOr<bool>(google::protobuf::Value*)>
+        next_value,
+    int64_t max_chunk_size);
+
 }  // namespace frontend
 }  // namespace emulator
 }  // namespace spanner
@@ -18,6 +18,7 @@
 
 #include <random>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "google/protobuf/struct.pb.h"
@@ -711,6 +712,49 @@ TEST(ChunkingTest, RandomChunking) {
   }
 }
 
+TEST(ChunkingTest, MovingAndStreamingValuesMatchCopying) {
+  int64_t time = absl::ToUnixNanos(absl::Now());
+  std::seed_seq seed({time});
+  absl::BitGen gen(seed);
+  ABSL_LOG(INFO) << "Testing chunking without copies with seed: " << time;
+
+  const int kNumColumns = 50;
+  const int64_t kChunkSize = 100;
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      ResultSet result,
+      backend::test::GenerateRandomResultSet(&gen, kNumColumns));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::vector<PartialResultSet> expected,
+                       ChunkResultSet(result, kChunkSize));
+
+  ResultSet moved = result;
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::vector<PartialResultSet> moved_results,
+                       ChunkResultSet(std::move(moved), kChunkSize));
+
+  int row = 0;
+  int column = 0;
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::vector<PartialResultSet> streamed_results,
+      ChunkValues(
+          result.metadata(),
+          [&](google::protobuf::Value* value) -> absl::StatusOr<bool> {
+            if (row == result.rows_size()) return false;
+            *value = result.rows(row).values(column);
+            if (++column == result.rows(row).values_size()) {
+              column = 0;
+              ++row;
+            }
+            return true;
+          },
+          kChunkSize));
+
+  ASSERT_EQ(moved_results.size(), expected.size());
+  ASSERT_EQ(streamed_results.size(), expected.size());
+  for (int i = 0; i < expected.size(); ++i) {
+    EXPECT_THAT(moved_results[i], test::EqualsProto(expected[i]));
+    EXPECT_THAT(streamed_results[i], test::EqualsProto(expected[i]));
+  }
+}
+
 }  // namespace
 
 }  // namespace frontend
@@ -79,20 +79,23 @@ absl::Status WriteFromProto(const backend::Schema& schema,
 
   // Populate the list of values for the rows that will be written to.
   std::vector<backend::ValueList> value_list;
+  value_list.reserve(write_pb.values_size());
   for (const google::protobuf::ListValue& values : write_pb.values()) {
-    backend::ValueList row_values;
+    backend::ValueList& row_values = value_list.emplace_back();
     if (values.values_size() != columns.size()) {
       return error::MutationColumnAndValueSizeMismatch(columns.size(),
                                                        values.values_size());
     }
+    row_values.reserve(columns.size());
     for (int i = 0; i < columns.size(); ++i) {
       ZETASQL_ASSIGN_OR_RETURN(row_values.emplace_back(),
                        ValueFromProto(values.values(i), columns[i]->GetType()));
     }
-    value_list.push_back(std::move(row_values));
   }
-  mutation->AddWriteOp(op_type, table->Name(), std::move(column_names),
-                       std::move(value_list));
+  // Hand the resolved table and columns to the transaction, so that it does
+  // not need to look them up by name again.
+  mutation->AddWriteOp(op_type, table, table->Name(), std::move(columns),
+                       std::move(column_names), std::move(value_list));
   return absl::OkStatus();
 }
 
@@ -127,6 +127,11 @@ TEST_F(AccessProtosTest, CanCreateMutationFromProto) {
   EXPECT_EQ(mutation.ops()[0].rows.size(), 1);
   EXPECT_EQ(mutation.ops()[0].columns[0], "int64_col");
   EXPECT_EQ(mutation.ops()[0].rows[0][0], zetasql::values::Int64(123));
+  // The table and columns resolved against the schema are kept.
+  const backend::Table* table = schema_->tables()[0];
+  EXPECT_EQ(mutation.ops()[0].resolved_table, table);
+  EXPECT_THAT(mutation.ops()[0].resolved_columns,
+              testing::ElementsAre(table->FindColumn("int64_col")));
 
   EXPECT_EQ(mutation.ops()[1].columns.size(), 1);
   EXPECT_EQ(mutation.ops()[1].rows.size(), 1);
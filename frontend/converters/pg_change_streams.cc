@@ -223,7 +223,8 @@ ConvertHeartbeatTimestampToJson(absl::Time timestamp,
                    ValueToProto(zetasql::Value::Json(
                        std::move(heartbeat_record_json_value))));
   ZETASQL_ASSIGN_OR_RETURN(auto responses,
-                   ChunkResultSet(result_pb, limits::kMaxStreamingChunkSize));
+                   ChunkResultSet(std::move(result_pb),
+                                  limits::kMaxStreamingChunkSize));
   if (expect_metadata) {
     ZETASQL_RETURN_IF_ERROR(PopulateMetadata(&responses, tvf_name));
   } else {
@@ -254,7 +255,8 @@ ConvertPartitionTableRowCursorToJson(
     record_sequence++;
   }
   ZETASQL_ASSIGN_OR_RETURN(auto responses,
-                   ChunkResultSet(result_pb, limits::kMaxStreamingChunkSize));
+                   ChunkResultSet(std::move(result_pb),
+                                  limits::kMaxStreamingChunkSize));
   if (expect_metadata) {
     ZETASQL_RETURN_IF_ERROR(PopulateMetadata(&responses, tvf_name));
   } else {
@@ -273,15 +275,16 @@ ConvertDataTableRowCursorToJson(backend::RowCursor* row_cursor,
     auto* row_pb = result_pb.add_rows();
     JSON change_record;
     change_record[kDataChangeRecord] = CreateDataChangeRecord(row_cursor);
-    ZETASQL_ASSIGN_OR_RETURN(
-        auto data_change_record_json_value,
-        zetasql::JSONValue::ParseJSONString(change_record.dump()));
-    ZETASQL_ASSIGN_OR_RETURN(*row_pb->add_values(),
-                     ValueToProto(zetasql::Value::Json(
-                         std::move(data_change_record_json_value))));
+    // The record is already valid JSON, so serialize it into the JSON value
+    // proto directly instead of round-tripping through zetasql::JSONValue.
+    row_pb->add_values()->set_string_value(change_record.dump());
+  }
+  if (result_pb.rows().empty()) {
+    return std::vector<spanner_api::PartialResultSet>();
   }
   ZETASQL_ASSIGN_OR_RETURN(auto responses,
-                   ChunkResultSet(result_pb, limits::kMaxStreamingChunkSize));
+                   ChunkResultSet(std::move(result_pb),
+                                  limits::kMaxStreamingChunkSize));
   if (expect_metadata) {
     ZETASQL_RETURN_IF_ERROR(PopulateMetadata(&responses, tvf_name));
   } else {
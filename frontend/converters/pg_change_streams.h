@@ -92,7 +92,7 @@ ConvertPartitionTableRowCursorToJson(
     bool expect_metadata = false);
 
 // Takes a row cursor from data table and convert all rows into partial result
-// set as JSON.
+// set as JSON. Returns no partial result sets if the cursor is empty.
 absl::StatusOr<std::vector<spanner_api::PartialResultSet>>
 ConvertDataTableRowCursorToJson(backend::RowCursor* row_cursor,
                                 const std::string& tvf_name,
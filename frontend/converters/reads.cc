@@ -17,6 +17,7 @@
 #include "frontend/converters/reads.h"
 
 #include <limits>
+#include <utility>
 #include <vector>
 
 #include "google/protobuf/struct.pb.h"
@@ -230,9 +231,10 @@ absl::Status RowCursorToResultSetProto(backend::RowCursor* cursor, int limit,
   int row_count = 0;
   while (cursor->Next()) {
     auto* row_pb = result_pb->add_rows();
+    row_pb->mutable_values()->Reserve(cursor->NumColumns());
     for (int i = 0; i < cursor->NumColumns(); ++i) {
-      ZETASQL_ASSIGN_OR_RETURN(*row_pb->add_values(),
-                       ValueToProto(cursor->ColumnValue(i)));
+      ZETASQL_RETURN_IF_ERROR(
+          ValueToProto(cursor->ColumnValue(i), row_pb->add_values()));
     }
     ++row_count;
     if (limit > 0 && limit == row_count) {
@@ -245,9 +247,29 @@ absl::Status RowCursorToResultSetProto(backend::RowCursor* cursor, int limit,
 
 absl::StatusOr<std::vector<spanner_api::PartialResultSet>>
 RowCursorToPartialResultSetProtos(backend::RowCursor* cursor, int limit) {
-  spanner_api::ResultSet result_set;
-  ZETASQL_RETURN_IF_ERROR(RowCursorToResultSetProto(cursor, limit, &result_set));
-  return ChunkResultSet(result_set, limits::kMaxStreamingChunkSize);
+  spanner_api::ResultSetMetadata metadata;
+  ZETASQL_RETURN_IF_ERROR(ResultSetMetadataToProto(cursor, &metadata));
+
+  // Encode the values of the cursor straight into the chunks, without
+  // materializing the whole result as a ResultSet first.
+  int row_count = 0;
+  int column = cursor->NumColumns();
+  return ChunkValues(
+      std::move(metadata),
+      [&](google::protobuf::Value* value_pb) -> absl::StatusOr<bool> {
+        while (column == cursor->NumColumns()) {
+          if ((limit > 0 && row_count == limit) || !cursor->Next()) {
+            return false;
+          }
+          ++row_count;
+          column = 0;
+        }
+        ZETASQL_RETURN_IF_ERROR(
+            ValueToProto(cursor->ColumnValue(column), value_pb));
+        ++column;
+        return true;
+      },
+      limits::kMaxStreamingChunkSize);
 }
 
 }  // namespace frontend
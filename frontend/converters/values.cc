@@ -77,7 +77,7 @@ static absl::StatusOr<zetasql::Value> CreatePgJsonbValueWithMemoryContext(
     absl::string_view jsonb_string) {
   ZETASQL_ASSIGN_OR_RETURN(
       std::unique_ptr<postgres_translator::interfaces::PGArena> pg_arena,
-      postgres_translator::interfaces::CreatePGArena(nullptr));
+      postgres_translator::interfaces::CreateThreadLocalPGArena(nullptr));
   return postgres_translator::spangres::datatypes::CreatePgJsonbValue(
       jsonb_string);
 }
@@ -88,7 +88,7 @@ static absl::StatusOr<zetasql::Value> CreatePgNumericValueWithMemoryContext(
     absl::string_view numeric_string) {
   ZETASQL_ASSIGN_OR_RETURN(
       std::unique_ptr<postgres_translator::interfaces::PGArena> pg_arena,
-      postgres_translator::interfaces::CreatePGArena(nullptr));
+      postgres_translator::interfaces::CreateThreadLocalPGArena(nullptr));
   return postgres_translator::spangres::datatypes::CreatePgNumericValue(
       numeric_string);
 }
@@ -284,7 +284,7 @@ absl::StatusOr<zetasql::Value> ValueFromProto(
       if (!absl::Base64Unescape(value_pb.string_value(), &bytes)) {
         return error::CouldNotParseStringAsBytes(value_pb.string_value());
       }
-      return zetasql::values::Bytes(bytes);
+      return zetasql::Value::Bytes(std::move(bytes));
     }
 
     case zetasql::TypeKind::TYPE_NUMERIC: {
@@ -355,12 +355,23 @@ absl::StatusOr<zetasql::Value> ValueFromProto(
             ValueFromProto(element_pb, type->AsArray()->element_type()),
             _ << "\nWhen parsing array element #" << i << ": {"
               << element_pb.DebugString() << "} in " << value_pb.DebugString());
+        // The commit timestamp sentinel is parsed as a string and is only
+        // allowed as the value of a timestamp column.
+        if (!values[i].type()->Equals(type->AsArray()->element_type())) {
+          return error::ValueProtoTypeMismatch(
+              element_pb.DebugString(),
+              type->AsArray()->element_type()->DebugString());
+        }
       }
-      return zetasql::values::Array(type->AsArray(), values);
+      // The types of the elements were checked above, so they are moved into
+      // the array without checking them again.
+      return zetasql::Value::UnsafeArray(type->AsArray(), std::move(values));
     }
 
     case zetasql::TypeKind::TYPE_STRUCT: {
-      if (value_pb.kind_case() != google::protobuf::Value::kListValue) {
+      if (value_pb.kind_case() != google::protobuf::Value::kListValue ||
+          value_pb.list_value().values_size() !=
+              type->AsStruct()->num_fields()) {
         return error::ValueProtoTypeMismatch(value_pb.DebugString(),
                                              type->DebugString());
       }
@@ -373,8 +384,13 @@ absl::StatusOr<zetasql::Value> ValueFromProto(
             ValueFromProto(field_pb, type->AsStruct()->field(i).type),
             _ << "\nWhen parsing struct element #" << i << ": {"
               << field_pb.DebugString() << "} in " << value_pb.DebugString());
+        if (!values[i].type()->Equals(type->AsStruct()->field(i).type)) {
+          return error::ValueProtoTypeMismatch(
+              field_pb.DebugString(),
+              type->AsStruct()->field(i).type->DebugString());
+        }
       }
-      return zetasql::values::Struct(type->AsStruct(), values);
+      return zetasql::Value::UnsafeStruct(type->AsStruct(), std::move(values));
     }
 
     case zetasql::TypeKind::TYPE_PROTO: {
@@ -386,7 +402,8 @@ absl::StatusOr<zetasql::Value> ValueFromProto(
       if (!absl::Base64Unescape(value_pb.string_value(), &bytes)) {
         return error::CouldNotParseStringAsBytes(value_pb.string_value());
       }
-      return zetasql::values::Proto(type->AsProto(), absl::Cord(bytes));
+      return zetasql::values::Proto(type->AsProto(),
+                                      absl::Cord(std::move(bytes)));
     }
     case zetasql::TypeKind::TYPE_ENUM: {
       if (value_pb.kind_case() != google::protobuf::Value::kStringValue) {
@@ -409,40 +426,40 @@ absl::StatusOr<zetasql::Value> ValueFromProto(
   }
 }
 
-absl::StatusOr<google::protobuf::Value> ValueToProto(
-    const zetasql::Value& value) {
+absl::Status ValueToProto(const zetasql::Value& value,
+                          google::protobuf::Value* value_pb) {
   if (!value.is_valid()) {
     return error::Internal(
         "Uninitialized ZetaSQL value passed to ValueToProto");
   }
 
-  google::protobuf::Value value_pb;
+  value_pb->Clear();
   if (value.is_null()) {
-    value_pb.set_null_value(google::protobuf::NullValue());
-    return value_pb;
+    value_pb->set_null_value(google::protobuf::NullValue());
+    return absl::OkStatus();
   }
 
   switch (value.type_kind()) {
     case zetasql::TypeKind::TYPE_BOOL: {
-      value_pb.set_bool_value(value.bool_value());
+      value_pb->set_bool_value(value.bool_value());
       break;
     }
 
     case zetasql::TypeKind::TYPE_INT64: {
-      value_pb.set_string_value(absl::StrCat(value.int64_value()));
+      value_pb->set_string_value(absl::StrCat(value.int64_value()));
       break;
     }
 
     case zetasql::TypeKind::TYPE_FLOAT: {
       float val = value.float_value();
       if (std::isfinite(val)) {
-        value_pb.set_number_value(static_cast<double>(val));
+        value_pb->set_number_value(static_cast<double>(val));
       } else if (val == std::numeric_limits<float>::infinity()) {
-        value_pb.set_string_value("Infinity");
+        value_pb->set_string_value("Infinity");
       } else if (val == -std::numeric_limits<float>::infinity()) {
-        value_pb.set_string_value("-Infinity");
+        value_pb->set_string_value("-Infinity");
       } else if (std::isnan(val)) {
-        value_pb.set_string_value("NaN");
+        value_pb->set_string_value("NaN");
       } else {
         return error::Internal(absl::StrCat("Unsupported float value ",
                                             value.float_value(),
@@ -454,13 +471,13 @@ absl::StatusOr<google::protobuf::Value> ValueToProto(
     case zetasql::TypeKind::TYPE_DOUBLE: {
       double val = value.double_value();
       if (std::isfinite(val)) {
-        value_pb.set_number_value(val);
+        value_pb->set_number_value(val);
       } else if (val == std::numeric_limits<double>::infinity()) {
-        value_pb.set_string_value("Infinity");
+        value_pb->set_string_value("Infinity");
       } else if (val == -std::numeric_limits<double>::infinity()) {
-        value_pb.set_string_value("-Infinity");
+        value_pb->set_string_value("-Infinity");
       } else if (std::isnan(val)) {
-        value_pb.set_string_value("NaN");
+        value_pb->set_string_value("NaN");
       } else {
         return error::Internal(absl::StrCat("Unsupported double value ",
                                             value.double_value(),
@@ -474,17 +491,17 @@ absl::StatusOr<google::protobuf::Value> ValueToProto(
           static_cast<const SpannerExtendedType*>(value.type())->code();
       switch (type_code) {
         case TypeAnnotationCode::PG_JSONB: {
-          value_pb.set_string_value(
+          value_pb->set_string_value(
               std::string(*GetPgJsonbNormalizedValue(value)));
           break;
         }
         case TypeAnnotationCode::PG_NUMERIC: {
-          value_pb.set_string_value(
+          value_pb->set_string_value(
               std::string(*GetPgNumericNormalizedValue(value)));
           break;
         }
         case TypeAnnotationCode::PG_OID: {
-          value_pb.set_string_value(absl::StrCat(*GetPgOidValue(value)));
+          value_pb->set_string_value(absl::StrCat(*GetPgOidValue(value)));
           break;
         }
         default:
@@ -496,7 +513,7 @@ absl::StatusOr<google::protobuf::Value> ValueToProto(
     }
 
     case zetasql::TypeKind::TYPE_TIMESTAMP: {
-      value_pb.set_string_value(
+      value_pb->set_string_value(
           absl::StrCat(absl::FormatTime(kRFC3339TimeFormatNoOffset,
                                         value.ToTime(), absl::UTCTimeZone()),
                        "Z"));
@@ -512,76 +529,76 @@ absl::StatusOr<google::protobuf::Value> ValueToProto(
             "Unsupported date value ", value.DebugString(),
             " passed to ValueToProto. Year must be between 1 and 9999."));
       }
-      absl::StrAppendFormat(value_pb.mutable_string_value(), "%04d-%02d-%02d",
+      absl::StrAppendFormat(value_pb->mutable_string_value(), "%04d-%02d-%02d",
                             date.year(), date.month(), date.day());
       break;
     }
 
     case zetasql::TypeKind::TYPE_STRING: {
-      value_pb.set_string_value(value.string_value());
+      value_pb->set_string_value(value.string_value());
       break;
     }
 
     case zetasql::TypeKind::TYPE_NUMERIC: {
-      value_pb.set_string_value(value.numeric_value().ToString());
+      value_pb->set_string_value(value.numeric_value().ToString());
       break;
     }
 
     case zetasql::TypeKind::TYPE_JSON: {
-      value_pb.set_string_value(value.json_string());
+      value_pb->set_string_value(value.json_string());
       break;
     }
 
     case zetasql::TypeKind::TYPE_BYTES: {
-      absl::Base64Escape(value.bytes_value(), value_pb.mutable_string_value());
+      absl::Base64Escape(value.bytes_value(), value_pb->mutable_string_value());
       break;
     }
 
     case zetasql::TypeKind::TYPE_ENUM: {
-      value_pb.set_string_value(std::to_string(value.enum_value()));
+      value_pb->set_string_value(std::to_string(value.enum_value()));
       break;
     }
 
     case zetasql::TypeKind::TYPE_PROTO: {
-      std::string strvalue;
-      absl::CopyCordToString(value.ToCord(), &strvalue);
-      absl::Base64Escape(strvalue, value_pb.mutable_string_value());
+      absl::Cord cord = value.ToCord();
+      absl::Base64Escape(cord.Flatten(), value_pb->mutable_string_value());
       break;
     }
 
     case zetasql::TYPE_TOKENLIST: {
       absl::Base64Escape(value.tokenlist_value().GetBytes(),
-                         value_pb.mutable_string_value());
+                         value_pb->mutable_string_value());
       break;
     }
 
     case zetasql::TypeKind::TYPE_INTERVAL: {
       zetasql::IntervalValue interval_value = value.interval_value();
-      value_pb.set_string_value(interval_value.ToISO8601());
+      value_pb->set_string_value(interval_value.ToISO8601());
       break;
     }
 
     case zetasql::TypeKind::TYPE_ARRAY: {
       google::protobuf::ListValue* list_value_pb =
-          value_pb.mutable_list_value();
+          value_pb->mutable_list_value();
+      list_value_pb->mutable_values()->Reserve(value.num_elements());
       for (int i = 0; i < value.num_elements(); ++i) {
-        ZETASQL_ASSIGN_OR_RETURN(*list_value_pb->add_values(),
-                         ValueToProto(value.element(i)),
-                         _ << "\nWhen encoding array element #" << i << ": "
-                           << value.element(i).DebugString() << " in "
-                           << value.DebugString());
+        ZETASQL_RETURN_IF_ERROR(
+            ValueToProto(value.element(i), list_value_pb->add_values()))
+            << "\nWhen encoding array element #" << i << ": "
+            << value.element(i).DebugString() << " in " << value.DebugString();
       }
       break;
     }
 
     case zetasql::TypeKind::TYPE_STRUCT: {
       google::protobuf::ListValue* list_value_pb =
-          value_pb.mutable_list_value();
+          value_pb->mutable_list_value();
+      list_value_pb->mutable_values()->Reserve(value.num_fields());
       for (int i = 0; i < value.num_fields(); ++i) {
-        ZETASQL_ASSIGN_OR_RETURN(
-            *list_value_pb->add_values(), ValueToProto(value.field(i)),
-            _ << "\nWhen encoding struct element #" << i << ": "
-              << value.field(i).DebugString() << " in " << value.DebugString());
+        ZETASQL_RETURN_IF_ERROR(
+            ValueToProto(value.field(i), list_value_pb->add_values()))
+            << "\nWhen encoding struct element #" << i << ": "
+            << value.field(i).DebugString() << " in " << value.DebugString();
       }
       break;
     }
@@ -593,6 +610,13 @@ absl::StatusOr<google::protobuf::Value> ValueToProto(
     }
   }
 
+  return absl::OkStatus();
+}
+
+absl::StatusOr<google::protobuf::Value> ValueToProto(
+    const zetasql::Value& value) {
+  google::protobuf::Value value_pb;
+  ZETASQL_RETURN_IF_ERROR(ValueToProto(value, &value_pb));
   return value_pb;
 }
 
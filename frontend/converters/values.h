@@ -47,6 +47,12 @@ absl::StatusOr<zetasql::Value> ValueFromProto(
 absl::StatusOr<google::protobuf::Value> ValueToProto(
     const zetasql::Value& value);
 
+// Same as above, but encodes the value into `value_pb`, replacing its contents.
+// Lets callers encode straight into a row of a larger message instead of
+// building and moving a temporary proto for each value.
+absl::Status ValueToProto(const zetasql::Value& value,
+                          google::protobuf::Value* value_pb);
+
 }  // namespace frontend
 }  // namespace emulator
 }  // namespace spanner
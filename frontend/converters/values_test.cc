@@ -71,6 +71,7 @@ using zetasql::types::NumericArrayType;
 using zetasql::types::NumericType;
 using zetasql::types::FloatType;
 using zetasql::types::StringType;
+using zetasql::types::TimestampArrayType;
 using zetasql::types::TimestampType;
 
 using zetasql::values::Bool;
@@ -381,6 +382,21 @@ TEST_F(ValueProtos, ParsesSpannerCommitTimestamp) {
   EXPECT_EQ(String("spanner.commit_timestamp()"), value);
 }
 
+TEST_F(ValueProtos, DoesNotParseSpannerCommitTimestampInArraysAndStructs) {
+  const google::protobuf::Value list_pb = PARSE_TEXT_PROTO(
+      "list_value: { values: { string_value: 'spanner.commit_timestamp()' } }");
+  EXPECT_THAT(ValueFromProto(list_pb, TimestampArrayType()),
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+
+  zetasql::TypeFactory factory;
+  const StructType* timestamp_struct;
+  ZETASQL_ASSERT_OK(factory.MakeStructType(
+      {StructType::StructField("ts", factory.get_timestamp())},
+      &timestamp_struct));
+  EXPECT_THAT(ValueFromProto(list_pb, timestamp_struct),
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+}
+
 TEST_F(ValueProtos, DoesNotParseInvalidTimestamps) {
   // Missing 'Z' offset.
   EXPECT_THAT(
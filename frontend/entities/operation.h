@@ -43,6 +43,9 @@ class Operation {
   // Constructs an empty operation.
   explicit Operation(const std::string& operation_uri);
 
+  // Returns the URI of this operation.
+  const std::string& operation_uri() const { return operation_uri_; }
+
   // Sets the metadata for an operation.
   void SetMetadata(const google::protobuf::Message& metadata) ABSL_LOCKS_EXCLUDED(mu_);
 
@@ -20,12 +20,16 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "google/spanner/v1/spanner.pb.h"
 #include "google/spanner/v1/transaction.pb.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/flags/flag.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "backend/common/ids.h"
 #include "backend/transaction/options.h"
@@ -40,6 +44,11 @@
 #include "absl/status/status.h"
 #include "zetasql/base/status_macros.h"
 
+ABSL_FLAG(absl::Duration, multiplexed_session_transaction_retention,
+          absl::Hours(1),
+          "How long a multi-use transaction of a multiplexed session is kept "
+          "after it was last used.");
+
 namespace google {
 namespace spanner {
 namespace emulator {
@@ -103,7 +112,7 @@ absl::Status Session::ToProto(spanner_api::Session* session,
   ZETASQL_ASSIGN_OR_RETURN(*session->mutable_create_time(),
                    TimestampToProto(create_time_));
   ZETASQL_ASSIGN_OR_RETURN(*session->mutable_approximate_last_use_time(),
-                   TimestampToProto(approximate_last_use_time_));
+                   TimestampToProto(approximate_last_use_time()));
   session->set_multiplexed(multiplexed_);
   return absl::OkStatus();
 }
@@ -132,6 +141,17 @@ absl::StatusOr<std::shared_ptr<Transaction>> Session::CreateMultiUseTransaction(
     const TransactionActivation& activation) {
   ZETASQL_RETURN_IF_ERROR(ValidateMultiUseTransactionOptions(options));
 
+  if (multiplexed_) {
+    // Transactions on a multiplexed session are independent of each other, so
+    // there is no active transaction to activate or to derive the retry state
+    // from.
+    ZETASQL_ASSIGN_OR_RETURN(std::shared_ptr<Transaction> txn,
+                     CreateTransaction(options, Transaction::Usage::kMultiUse,
+                                       backend::RetryState()));
+    AddMultiplexedTransaction(txn);
+    return txn;
+  }
+
   absl::MutexLock lock(&mu_);
   // Move-convert unique pointer returned by CreateTransaction to shared pointer
   // since session will also hold a reference to multi-use transaction object
@@ -169,6 +189,11 @@ Session::CreateSingleUseTransaction(
     const spanner_api::TransactionOptions& options) {
   ZETASQL_RETURN_IF_ERROR(ValidateSingleUseTransactionOptions(options));
 
+  if (multiplexed_) {
+    return CreateTransaction(options, Transaction::Usage::kSingleUse,
+                             backend::RetryState());
+  }
+
   absl::MutexLock lock(&mu_);
   return CreateTransaction(options, Transaction::Usage::kSingleUse,
                            MakeRetryState(options, /*is_single_use_txn=*/true));
@@ -237,10 +262,14 @@ absl::StatusOr<std::unique_ptr<Transaction>> Session::CreateReadWrite(
 absl::StatusOr<std::shared_ptr<Transaction>> Session::FindAndUseTransaction(
     const std::string& bytes) {
   const backend::TransactionID& id = TransactionIDFromProto(bytes);
-  absl::MutexLock lock(&mu_);
   if (id == backend::kInvalidTransactionID) {
     return error::InvalidTransactionID(backend::kInvalidTransactionID);
   }
+  if (multiplexed_) {
+    return FindMultiplexedTransaction(id);
+  }
+
+  absl::MutexLock lock(&mu_);
   if (id < min_valid_id_) {
     return error::InvalidTransactionID(min_valid_id_);
   }
@@ -264,6 +293,58 @@ absl::StatusOr<std::shared_ptr<Transaction>> Session::FindAndUseTransaction(
   return active_transaction_;
 }
 
+void Session::AddMultiplexedTransaction(std::shared_ptr<Transaction> txn) {
+  MultiplexedTransactionShard& shard =
+      multiplexed_transactions_[txn->id() % kNumMultiplexedTransactionShards];
+  const absl::Time now = absl::Now();
+  const absl::Duration retention =
+      absl::GetFlag(FLAGS_multiplexed_session_transaction_retention);
+  std::vector<std::shared_ptr<Transaction>> expired;
+  {
+    absl::MutexLock lock(&shard.mu);
+    if (shard.transactions.size() >= shard.prune_threshold) {
+      for (auto it = shard.transactions.begin();
+           it != shard.transactions.end();) {
+        if (now - it->second.last_use_time > retention) {
+          expired.push_back(std::move(it->second.txn));
+          shard.transactions.erase(it++);
+        } else {
+          ++it;
+        }
+      }
+      shard.prune_threshold =
+          std::max<size_t>(limits::kMaxTransactionsPerSession,
+                           2 * shard.transactions.size());
+    }
+    const backend::TransactionID id = txn->id();
+    shard.transactions.emplace(
+        id,
+        MultiplexedTransaction{.txn = std::move(txn), .last_use_time = now});
+  }
+
+  // Closing a transaction may roll it back, so it is done outside the shard
+  // lock to not hold up requests on the other transactions of the shard.
+  for (const std::shared_ptr<Transaction>& txn : expired) {
+    txn->Close();
+  }
+}
+
+absl::StatusOr<std::shared_ptr<Transaction>> Session::FindMultiplexedTransaction(
+    backend::TransactionID id) {
+  MultiplexedTransactionShard& shard =
+      multiplexed_transactions_[id % kNumMultiplexedTransactionShards];
+  absl::MutexLock lock(&shard.mu);
+  auto it = shard.transactions.find(id);
+  if (it == shard.transactions.end()) {
+    return error::TransactionNotFound(id);
+  }
+  if (it->second.txn->IsClosed()) {
+    return error::TransactionClosed(id);
+  }
+  it->second.last_use_time = absl::Now();
+  return it->second.txn;
+}
+
 absl::StatusOr<std::shared_ptr<Transaction>> Session::FindOrInitTransaction(
     const spanner_api::TransactionSelector& selector) {
   std::shared_ptr<Transaction> txn;
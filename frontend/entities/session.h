@@ -17,6 +17,10 @@
 #ifndef STORAGE_CLOUD_SPANNER_EMULATOR_FRONTEND_SESSION_H_
 #define STORAGE_CLOUD_SPANNER_EMULATOR_FRONTEND_SESSION_H_
 
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <string>
@@ -24,16 +28,24 @@
 #include "google/spanner/v1/spanner.pb.h"
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/flags/declare.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
 #include "backend/common/ids.h"
+#include "backend/transaction/options.h"
+#include "common/limits.h"
 #include "frontend/common/labels.h"
 #include "frontend/entities/database.h"
 #include "frontend/entities/transaction.h"
 #include "absl/status/status.h"
 
+// How long a multi-use transaction of a multiplexed session is kept after it
+// was last used. This matches the idle expiration of regular sessions, which
+// keep their transactions for as long as they live.
+ABSL_DECLARE_FLAG(absl::Duration, multiplexed_session_transaction_retention);
+
 namespace google {
 namespace spanner {
 namespace emulator {
@@ -53,6 +65,13 @@ namespace frontend {
 // active, and any transactions created prior to the active transaction are
 // marked as invalid. Invalid transactions will be rolled back if necessary.
 //
+// Multiplexed sessions instead carry any number of concurrent transactions.
+// Their transactions are kept in a map sharded by transaction id, so requests
+// on different transactions of the same session do not serialize on the
+// session mutex. Transactions that have been idle for longer than
+// --multiplexed_session_transaction_retention are closed and dropped from the
+// map as it grows.
+//
 // More information about sessions can be found at:
 //     https://cloud.google.com/spanner/docs/sessions
 class Session {
@@ -86,17 +105,21 @@ class Session {
 
   const bool multiplexed() const { return multiplexed_; }
 
+  // Returns the database to which this session is attached.
+  std::shared_ptr<Database> database() const { return database_; }
+
   // Return the time this session was last used.
-  absl::Time approximate_last_use_time() const ABSL_LOCKS_EXCLUDED(mu_) {
-    absl::MutexLock lock(&mu_);
-    return approximate_last_use_time_;
+  absl::Time approximate_last_use_time() const {
+    return absl::FromUnixMicros(
+        approximate_last_use_time_micros_.load(std::memory_order_relaxed));
   }
 
-  // Sets the time this session was last used.
-  void set_approximate_last_use_time(absl::Time approximate_last_use_time)
-      ABSL_LOCKS_EXCLUDED(mu_) {
-    absl::MutexLock lock(&mu_);
-    approximate_last_use_time_ = approximate_last_use_time;
+  // Sets the time this session was last used. This happens on every request,
+  // so it does not take the session mutex.
+  void set_approximate_last_use_time(absl::Time approximate_last_use_time) {
+    approximate_last_use_time_micros_.store(
+        absl::ToUnixMicros(approximate_last_use_time),
+        std::memory_order_relaxed);
   }
 
   // Converts this session to its proto representation.
@@ -137,6 +160,13 @@ class Session {
       const spanner_api::TransactionOptions& options,
       const Transaction::Usage& usage, const backend::RetryState& retry_state);
 
+  // Tracks a multi-use transaction of a multiplexed session.
+  void AddMultiplexedTransaction(std::shared_ptr<Transaction> txn);
+
+  // Finds a multi-use transaction of a multiplexed session.
+  absl::StatusOr<std::shared_ptr<Transaction>> FindMultiplexedTransaction(
+      backend::TransactionID id);
+
   // Builds the retry state from active transaction.
   backend::RetryState MakeRetryState(
       const spanner_api::TransactionOptions& options, bool is_single_use_txn)
@@ -160,8 +190,8 @@ class Session {
   // Mutex to guard the state below.
   mutable absl::Mutex mu_;
 
-  // The last time this session was used.
-  absl::Time approximate_last_use_time_ ABSL_GUARDED_BY(mu_);
+  // The last time this session was used, in microseconds since the epoch.
+  std::atomic<int64_t> approximate_last_use_time_micros_ = 0;
 
   // Map of transactions that have been pre-created in this session.
   std::map<backend::TransactionID, std::shared_ptr<Transaction>>
@@ -172,6 +202,35 @@ class Session {
 
   // The first transaction id which is valid for use within this session.
   backend::TransactionID min_valid_id_ = backend::kInvalidTransactionID + 1;
+
+  // A multi-use transaction of a multiplexed session.
+  struct MultiplexedTransaction {
+    std::shared_ptr<Transaction> txn;
+
+    // The last time the transaction was looked up.
+    absl::Time last_use_time;
+  };
+
+  // A shard of the transactions of a multiplexed session.
+  struct MultiplexedTransactionShard {
+    absl::Mutex mu;
+
+    absl::flat_hash_map<backend::TransactionID, MultiplexedTransaction>
+        transactions ABSL_GUARDED_BY(mu);
+
+    // Size at which idle transactions are dropped next. Doubles with the
+    // number of transactions that are kept, so that pruning is amortized over
+    // the transactions created in between.
+    size_t prune_threshold ABSL_GUARDED_BY(mu) =
+        limits::kMaxTransactionsPerSession;
+  };
+
+  static constexpr int kNumMultiplexedTransactionShards = 16;
+
+  // Transactions of a multiplexed session, sharded by transaction id. Not
+  // used by regular sessions.
+  std::array<MultiplexedTransactionShard, kNumMultiplexedTransactionShards>
+      multiplexed_transactions_;
 };
 
 }  // namespace frontend
@@ -20,27 +20,40 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "google/spanner/v1/spanner.pb.h"
 #include "google/spanner/v1/transaction.pb.h"
+#include "zetasql/public/value.h"
 #include "absl/flags/flag.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/strings/substitute.h"
 #include "absl/time/time.h"
 #include "backend/access/read.h"
+#include "backend/database/change_stream/change_stream_commit_notifier.h"
+#include "backend/database/database.h"
+#include "backend/datamodel/key.h"
+#include "backend/datamodel/key_range.h"
+#include "backend/datamodel/key_set.h"
 #include "backend/query/change_stream/change_stream_query_validator.h"
 #include "backend/query/query_engine.h"
+#include "backend/schema/catalog/change_stream.h"
+#include "backend/schema/catalog/column.h"
 #include "backend/schema/catalog/schema.h"
+#include "backend/schema/catalog/table.h"
 #include "common/clock.h"
 #include "common/errors.h"
 #include "frontend/converters/change_streams.h"
 #include "frontend/converters/pg_change_streams.h"
 #include "frontend/converters/time.h"
+#include "frontend/entities/database.h"
 #include "frontend/entities/session.h"
 #include "frontend/entities/transaction.h"
 #include "frontend/server/handler.h"
+#include "frontend/server/request_context.h"
+#include "frontend/server/thread_pool.h"
 #include "zetasql/base/ret_check.h"
 #include "zetasql/base/status_macros.h"
 
@@ -48,11 +61,6 @@ ABSL_FLAG(bool, cloud_spanner_emulator_test_with_fake_partition_table, false,
           "TEST ONLY. Set to true to enable querying against mocked change "
           "stream internal partition table during test.");
 
-ABSL_FLAG(
-    absl::Duration, change_streams_partition_query_chop_interval,
-    absl::Milliseconds(100),
-    "Change streams chopped interval for partition query in milliseconds.");
-
 namespace google {
 namespace spanner {
 namespace emulator {
@@ -133,12 +141,20 @@ absl::Status ValidateTokenInRetentionWindow(
 }  // namespace
 
 absl::Status ChangeStreamsHandler::ProcessDataChangeRecordsAndStreamBack(
-    backend::QueryResult& result, const bool expect_heartbeat,
+    backend::RowCursor* data_records, const bool expect_heartbeat,
     const absl::Time scan_end, bool& expect_metadata,
     absl::Time* last_record_time,
     ServerStream<spanner_api::PartialResultSet>* stream) {
-  std::vector<spanner_api::PartialResultSet> responses;
-  if (IsQueryResultEmpty(result) && expect_heartbeat) {
+  ZETASQL_ASSIGN_OR_RETURN(
+      std::vector<spanner_api::PartialResultSet> responses,
+      metadata().is_pg
+          ? ConvertDataTableRowCursorToJson(data_records, metadata().tvf_name,
+                                            expect_metadata)
+          : ConvertDataTableRowCursorToStruct(data_records, expect_metadata));
+  if (!responses.empty()) {
+    *last_record_time = scan_end;
+    expect_metadata = false;
+  } else if (expect_heartbeat) {
     ZETASQL_ASSIGN_OR_RETURN(
         responses,
         metadata().is_pg
@@ -147,15 +163,6 @@ absl::Status ChangeStreamsHandler::ProcessDataChangeRecordsAndStreamBack(
             : ConvertHeartbeatTimestampToStruct(scan_end, expect_metadata));
     expect_metadata = false;
     *last_record_time = scan_end;
-  } else if (!IsQueryResultEmpty(result)) {
-    ZETASQL_ASSIGN_OR_RETURN(responses, metadata().is_pg
-                                    ? ConvertDataTableRowCursorToJson(
-                                          result.rows.get(),
-                                          metadata().tvf_name, expect_metadata)
-                                    : ConvertDataTableRowCursorToStruct(
-                                          result.rows.get(), expect_metadata));
-    *last_record_time = scan_end;
-    expect_metadata = false;
   }
   for (auto& response : responses) {
     stream->Send(response);
@@ -253,27 +260,32 @@ absl::StatusOr<absl::Time> ChangeStreamsHandler::TryGetPartitionTokenEndTime(
   return end;
 }
 
-backend::Query ChangeStreamsHandler::ConstructDataTablePartitionQuery(
-    absl::Time start, absl::Time end) const {
+backend::ReadArg ChangeStreamsHandler::ConstructDataTablePartitionRead(
+    const backend::Table* data_table, absl::Time start, absl::Time end) const {
   // If user passed end_timestamp is not null and current scan is the last scan
   // in query lifetime, we do an inclusive scan to include the data change
   // record with commit_timestamp exactly at the user passed end_timestamp. If
-  // current scan is a middle chopped scan, we do an exclusive scan because all
-  // data records of a partition token has a commit_timestamp in
+  // current scan is a middle scan, we do an exclusive scan because all data
+  // records of a partition token has a commit_timestamp in
   // [partition_start_time,partition_end_time).
   const bool is_inclusive_read = metadata().end_timestamp.has_value() &&
                                  metadata().end_timestamp.value() == end;
-  backend::Query data_table_partition_query = backend::Query{absl::Substitute(
-      "SELECT * "
-      "FROM $0 "
-      "WHERE( partition_token='$1' AND commit_timestamp >= '$2' AND "
-      "commit_timestamp $3 '$4' ) ORDER BY partition_token, commit_timestamp, "
-      "server_transaction_id,record_sequence",
-      metadata().data_table, metadata().partition_token.value(), start,
-      is_inclusive_read ? "<=" : "<", end)};
-  data_table_partition_query.change_stream_internal_lookup =
-      metadata().change_stream_name;
-  return data_table_partition_query;
+  // The data table is keyed by (partition_token, commit_timestamp, ...), so
+  // the records of the partition in [start, end] are a single key range that
+  // is read in commit timestamp order without going through the query engine.
+  const zetasql::Value partition_token =
+      zetasql::values::String(metadata().partition_token.value());
+  backend::Key start_key({partition_token, zetasql::values::Timestamp(start)});
+  backend::Key end_key({partition_token, zetasql::values::Timestamp(end)});
+  backend::ReadArg read_arg;
+  read_arg.change_stream_for_data_table = metadata().change_stream_name;
+  read_arg.key_set = backend::KeySet(
+      is_inclusive_read ? backend::KeyRange::ClosedClosed(start_key, end_key)
+                        : backend::KeyRange::ClosedOpen(start_key, end_key));
+  for (const backend::Column* column : data_table->columns()) {
+    read_arg.columns.push_back(column->Name());
+  }
+  return read_arg;
 }
 
 backend::Query ChangeStreamsHandler::ConstructPartitionTablePartitionQuery()
@@ -288,113 +300,116 @@ backend::Query ChangeStreamsHandler::ConstructPartitionTablePartitionQuery()
   return data_table_partition_query;
 }
 
-absl::Status ChangeStreamsHandler::ExecutePartitionQuery(
+absl::Status ChangeStreamsHandler::ScanPartition(
+    PartitionQueryState& state,
     ServerStream<spanner_api::PartialResultSet>* stream,
     std::shared_ptr<Session> session) {
-  const absl::Time tvf_end = metadata().end_timestamp.has_value()
-                                 ? metadata().end_timestamp.value()
-                                 : absl::InfiniteFuture();
-  const absl::Time now = Clock().Now();
-  const absl::Duration heartbeat_interval =
-      absl::Milliseconds(metadata().heartbeat_milliseconds);
-  absl::Time last_record_time = now;
-  absl::Time partition_token_end_time = absl::InfiniteFuture();
-  absl::Time current_start = metadata().start_timestamp;
-  absl::Time current_end = std::min(
-      std::max(now,
-               current_start +
-                   absl::GetFlag(
-                       FLAGS_change_streams_partition_query_chop_interval)),
-      tvf_end);
-  // Metadata is only expected for the first response to users in a single
-  // query's lifetime.
-  bool expect_metadata = true;
-  while (current_start <= tvf_end && current_start < partition_token_end_time) {
-    // For historical queries where tvf end is in the past, set the read
-    // transaction snapshot time to now to prevent >1h stale read, which is now
-    // allowed.
-    absl::Time current_txn_snapshot_time = std::max(current_end, now);
-    // Get the newest retention period so most up to date retention will apply
-    // to curent running query.
+  // For historical queries, read at now to prevent >1h stale reads, which
+  // are not allowed. If the user provided tvf start time is in the future,
+  // the reads below are blocked until that time.
+  const absl::Time current_txn_snapshot_time =
+      std::max(state.current_start, Clock().Now());
+  // Get the newest retention period so most up to date retention will apply
+  // to curent running query.
+  ZETASQL_ASSIGN_OR_RETURN(
+      absl::Duration current_retention,
+      TryGetChangeStreamRetentionPeriod(metadata().change_stream_name, session,
+                                        current_txn_snapshot_time));
+  // If the partition token hasn't been churned yet, we re-scan the partition
+  // table to see if the end time has been churned and update the partition
+  // end time.
+  if (state.partition_token_end_time == absl::InfiniteFuture()) {
     ZETASQL_ASSIGN_OR_RETURN(
-        absl::Duration current_retention,
-        TryGetChangeStreamRetentionPeriod(metadata().change_stream_name,
-                                          session, current_txn_snapshot_time));
-    spanner_api::TransactionOptions txn_options;
-    // If the partition token hasn't been churned yet, we re-scan the partition
-    // table to see if the end time has been churned and update the partition
-    // end time.
-    if (partition_token_end_time == absl::InfiniteFuture()) {
-      ZETASQL_ASSIGN_OR_RETURN(
-          partition_token_end_time,
-          TryGetPartitionTokenEndTime(session, current_txn_snapshot_time));
-    }
-    ZETASQL_RETURN_IF_ERROR(ValidateTokenInRetentionWindow(
-        metadata().start_timestamp, current_start, partition_token_end_time,
-        current_retention));
-    // Only scan data records up to minimum of current chopped end time
-    // and end time of current partition token.
-    const absl::Time scan_end = std::min(partition_token_end_time, current_end);
-    const bool expect_heartbeat =
-        current_end - last_record_time >= heartbeat_interval;
-    // This transaction will be blocked until now passes current_end.
-    ZETASQL_ASSIGN_OR_RETURN(*txn_options.mutable_read_only()->mutable_read_timestamp(),
-                     TimestampToProto(current_txn_snapshot_time));
-    ZETASQL_ASSIGN_OR_RETURN(auto txn,
-                     session->CreateSingleUseTransaction(txn_options));
-    absl::Status status =
-        txn->GuardedCall(Transaction::OpType::kSql, [&]() -> absl::Status {
-          backend::Query read_data_query =
-              ConstructDataTablePartitionQuery(current_start, scan_end);
-          ZETASQL_ASSIGN_OR_RETURN(auto data_records_results,
-                           txn->ExecuteSql(read_data_query));
-          ZETASQL_RETURN_IF_ERROR(ProcessDataChangeRecordsAndStreamBack(
-              data_records_results, expect_heartbeat, scan_end, expect_metadata,
-              &last_record_time, stream));
-          if (partition_token_end_time <= current_end) {
-            // Get child partition records after all data records are returned
-            // in current query.
-            backend::Query tail_query_partition_table =
-                ConstructPartitionTablePartitionQuery();
-            ZETASQL_ASSIGN_OR_RETURN(auto tail_partition_records_results,
-                             txn->ExecuteSql(tail_query_partition_table));
-            ZETASQL_RET_CHECK(!IsQueryResultEmpty(tail_partition_records_results));
-            ZETASQL_ASSIGN_OR_RETURN(
-                auto responses,
-                metadata().is_pg
-                    ? ConvertPartitionTableRowCursorToJson(
-                          tail_partition_records_results.rows.get(),
-                          /*initial_start_time=*/std::nullopt,
-                          metadata().tvf_name, expect_metadata)
-                    : ConvertPartitionTableRowCursorToStruct(
-                          tail_partition_records_results.rows.get(),
-                          /*initial_start_time=*/std::nullopt,
-                          expect_metadata));
-            expect_metadata = false;
-            for (auto& response : responses) {
-              stream->Send(response);
-            }
-            return absl::OkStatus();
+        state.partition_token_end_time,
+        TryGetPartitionTokenEndTime(session, current_txn_snapshot_time));
+  }
+  ZETASQL_RETURN_IF_ERROR(ValidateTokenInRetentionWindow(
+      metadata().start_timestamp, state.current_start,
+      state.partition_token_end_time, current_retention));
+  // Scan all data records committed since the previous scan, up to the end
+  // time of the query and of the current partition token.
+  const absl::Time scan_end = std::min(
+      {current_txn_snapshot_time, state.partition_token_end_time, tvf_end()});
+  const bool expect_heartbeat =
+      scan_end - state.last_record_time >= heartbeat_interval();
+  spanner_api::TransactionOptions txn_options;
+  ZETASQL_ASSIGN_OR_RETURN(*txn_options.mutable_read_only()->mutable_read_timestamp(),
+                   TimestampToProto(current_txn_snapshot_time));
+  ZETASQL_ASSIGN_OR_RETURN(auto txn, session->CreateSingleUseTransaction(txn_options));
+  ZETASQL_RETURN_IF_ERROR(
+      txn->GuardedCall(Transaction::OpType::kSql, [&]() -> absl::Status {
+        const backend::ChangeStream* change_stream =
+            txn->schema()->FindChangeStream(metadata().change_stream_name);
+        if (change_stream == nullptr) {
+          return error::ChangeStreamNotFound(metadata().change_stream_name);
+        }
+        std::unique_ptr<backend::RowCursor> data_records;
+        ZETASQL_RETURN_IF_ERROR(txn->Read(
+            ConstructDataTablePartitionRead(
+                change_stream->change_stream_data_table(), state.current_start,
+                scan_end),
+            &data_records));
+        ZETASQL_RETURN_IF_ERROR(ProcessDataChangeRecordsAndStreamBack(
+            data_records.get(), expect_heartbeat, scan_end,
+            state.expect_metadata, &state.last_record_time, stream));
+        if (state.partition_token_end_time <= scan_end) {
+          // Get child partition records after all data records are returned
+          // in current query.
+          backend::Query tail_query_partition_table =
+              ConstructPartitionTablePartitionQuery();
+          ZETASQL_ASSIGN_OR_RETURN(auto tail_partition_records_results,
+                           txn->ExecuteSql(tail_query_partition_table));
+          ZETASQL_RET_CHECK(!IsQueryResultEmpty(tail_partition_records_results));
+          ZETASQL_ASSIGN_OR_RETURN(
+              auto responses,
+              metadata().is_pg
+                  ? ConvertPartitionTableRowCursorToJson(
+                        tail_partition_records_results.rows.get(),
+                        /*initial_start_time=*/std::nullopt,
+                        metadata().tvf_name, state.expect_metadata)
+                  : ConvertPartitionTableRowCursorToStruct(
+                        tail_partition_records_results.rows.get(),
+                        /*initial_start_time=*/std::nullopt,
+                        state.expect_metadata));
+          state.expect_metadata = false;
+          for (auto& response : responses) {
+            stream->Send(response);
           }
           return absl::OkStatus();
-        });
-    ZETASQL_RETURN_IF_ERROR(status);
-    // Increment by 1 microsecond gap to avoid repetitive records.
-    current_start = scan_end + absl::Microseconds(1);
-    current_end = std::min(
-        {current_start +
-             absl::GetFlag(FLAGS_change_streams_partition_query_chop_interval),
-         tvf_end, partition_token_end_time});
-  }
+        }
+        return absl::OkStatus();
+      }));
+  // Increment by 1 microsecond gap to avoid repetitive records.
+  state.current_start = scan_end + absl::Microseconds(1);
+  return absl::OkStatus();
+}
+
+bool ChangeStreamsHandler::IsPartitionQueryDone(
+    const PartitionQueryState& state,
+    const ServerStream<spanner_api::PartialResultSet>& stream) const {
+  return state.current_start > tvf_end() ||
+         state.current_start >= state.partition_token_end_time ||
+         stream.IsClosed();
+}
+
+absl::Time ChangeStreamsHandler::NextScanDeadline(
+    const PartitionQueryState& state) const {
+  return std::min({state.last_record_time + heartbeat_interval(), tvf_end(),
+                   state.partition_token_end_time});
+}
 
+absl::Status ChangeStreamsHandler::FinishPartitionQuery(
+    const PartitionQueryState& state,
+    ServerStream<spanner_api::PartialResultSet>* stream) {
   // If expect_metadata is still true, stub a heartbeat record.
-  if (expect_metadata == true) {
+  if (state.expect_metadata) {
     ZETASQL_ASSIGN_OR_RETURN(
         auto extra_heartbeat,
         metadata().is_pg
-            ? ConvertHeartbeatTimestampToJson(tvf_end, metadata().tvf_name,
-                                              expect_metadata)
-            : ConvertHeartbeatTimestampToStruct(tvf_end, expect_metadata));
+            ? ConvertHeartbeatTimestampToJson(tvf_end(), metadata().tvf_name,
+                                              state.expect_metadata)
+            : ConvertHeartbeatTimestampToStruct(tvf_end(),
+                                                state.expect_metadata));
     for (auto& response : extra_heartbeat) {
       stream->Send(response);
     }
@@ -402,8 +417,98 @@ absl::Status ChangeStreamsHandler::ExecutePartitionQuery(
   return absl::OkStatus();
 }
 
+namespace {
+
+// A partition query which returned its thread to the pool while it waits for
+// commits to its partition.
+struct DetachedPartitionQuery {
+  ChangeStreamsHandler handler;
+  ChangeStreamsHandler::PartitionQueryState state;
+  ServerStream<spanner_api::PartialResultSet> stream;
+  std::shared_ptr<Session> session;
+  ThreadPool* thread_pool;
+  RequestContext::DoneCallback done;
+};
+
+void RunNextScan(std::shared_ptr<DetachedPartitionQuery> query);
+
+// Schedules the next scan once a commit may have added records to the
+// partition, the partition may have been churned or a heartbeat is due.
+void WaitForNextScan(std::shared_ptr<DetachedPartitionQuery> query) {
+  backend::ChangeStreamCommitNotifier* notifier =
+      query->session->database()->backend()->change_stream_commit_notifier();
+  const auto& metadata = query->handler.metadata();
+  const absl::Time deadline = query->handler.NextScanDeadline(query->state);
+  notifier->NotifyOnCommit(
+      metadata.change_stream_name, metadata.partition_token.value(),
+      query->state.current_start, deadline, [query](bool committed) {
+        query->thread_pool->Schedule([query]() { RunNextScan(query); });
+      });
+}
+
+void RunNextScan(std::shared_ptr<DetachedPartitionQuery> query) {
+  absl::Status status = query->handler.ScanPartition(
+      query->state, &query->stream, query->session);
+  if (!status.ok()) {
+    query->done(status);
+    return;
+  }
+  if (query->handler.IsPartitionQueryDone(query->state, query->stream)) {
+    query->done(
+        query->handler.FinishPartitionQuery(query->state, &query->stream));
+    return;
+  }
+  // Let a slow client catch up on the records sent so far before waiting for
+  // the next commits.
+  if (query->stream.NotifyWhenWritable(
+          [query]() { WaitForNextScan(query); })) {
+    return;
+  }
+  WaitForNextScan(std::move(query));
+}
+
+}  // namespace
+
+absl::Status ChangeStreamsHandler::ExecutePartitionQuery(
+    RequestContext* ctx, ServerStream<spanner_api::PartialResultSet>* stream,
+    std::shared_ptr<Session> session) {
+  PartitionQueryState state;
+  state.current_start = metadata().start_timestamp;
+  state.last_record_time = Clock().Now();
+  // The first scan returns all historical records up to now. Later scans only
+  // run once a commit may have added records to this partition, the partition
+  // may have been churned or a heartbeat is due.
+  if (!IsPartitionQueryDone(state, *stream)) {
+    ZETASQL_RETURN_IF_ERROR(ScanPartition(state, stream, session));
+  }
+  if (ctx->thread_pool() == nullptr) {
+    backend::ChangeStreamCommitNotifier* notifier =
+        session->database()->backend()->change_stream_commit_notifier();
+    while (!IsPartitionQueryDone(state, *stream)) {
+      notifier->WaitForCommit(metadata().change_stream_name,
+                              metadata().partition_token.value(),
+                              state.current_start, NextScanDeadline(state));
+      ZETASQL_RETURN_IF_ERROR(ScanPartition(state, stream, session));
+    }
+    return FinishPartitionQuery(state, stream);
+  }
+  if (IsPartitionQueryDone(state, *stream)) {
+    return FinishPartitionQuery(state, stream);
+  }
+  // Waiting for commits or for the client does not use the CPU, so return the
+  // thread to the pool and run each later scan as a new task.
+  auto query = std::make_shared<DetachedPartitionQuery>(
+      DetachedPartitionQuery{*this, state, *stream, std::move(session),
+                             ctx->thread_pool(), ctx->Detach()});
+  if (!query->stream.NotifyWhenWritable(
+          [query]() { WaitForNextScan(query); })) {
+    WaitForNextScan(std::move(query));
+  }
+  return absl::OkStatus();
+}
+
 absl::Status ChangeStreamsHandler::ExecuteChangeStreamQuery(
-    const spanner_api::ExecuteSqlRequest* request,
+    RequestContext* ctx, const spanner_api::ExecuteSqlRequest* request,
     ServerStream<spanner_api::PartialResultSet>* stream,
     std::shared_ptr<Session> session) {
   ZETASQL_RETURN_IF_ERROR(
@@ -414,7 +519,7 @@ absl::Status ChangeStreamsHandler::ExecuteChangeStreamQuery(
   if (!metadata().partition_token.has_value()) {
     return ExecuteInitialQuery(session, stream);
   } else {
-    return ExecutePartitionQuery(stream, session);
+    return ExecutePartitionQuery(ctx, stream, session);
   }
 }
 }  // namespace frontend
@@ -26,10 +26,13 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/time/time.h"
+#include "backend/access/read.h"
 #include "backend/query/change_stream/change_stream_query_validator.h"
 #include "backend/query/query_engine.h"
+#include "backend/schema/catalog/table.h"
 #include "frontend/entities/session.h"
 #include "frontend/server/handler.h"
+#include "frontend/server/request_context.h"
 
 ABSL_DECLARE_FLAG(bool, cloud_spanner_emulator_test_with_fake_partition_table);
 
@@ -46,7 +49,7 @@ class ChangeStreamsHandler {
   static constexpr char kTestPartitionTable[] = "partition_table";
   static constexpr char kTestDataTable[] = "data_table";
   explicit ChangeStreamsHandler(
-      backend::ChangeStreamQueryValidator::ChangeStreamMetadata& metadata)
+      const backend::ChangeStreamQueryValidator::ChangeStreamMetadata& metadata)
       : metadata_(metadata) {
     // Name of the partition&data table to be read from. For certain test cases
     // this need to be set to test only mock tables.
@@ -57,8 +60,20 @@ class ChangeStreamsHandler {
             : metadata.partition_table;
   }
 
+  // Progress of a partition query between two scans of its records.
+  struct PartitionQueryState {
+    absl::Time current_start;
+    absl::Time last_record_time;
+    absl::Time partition_token_end_time = absl::InfiniteFuture();
+    // Metadata is only expected for the first response to users in a single
+    // query's lifetime.
+    bool expect_metadata = true;
+  };
+
+  // Partition queries served by the gRPC server detach from `ctx` while they
+  // wait for new records, so that they do not hold a thread of the pool.
   absl::Status ExecuteChangeStreamQuery(
-      const spanner_api::ExecuteSqlRequest* request,
+      RequestContext* ctx, const spanner_api::ExecuteSqlRequest* request,
       ServerStream<spanner_api::PartialResultSet>* stream,
       std::shared_ptr<Session> session);
 
@@ -72,17 +87,42 @@ class ChangeStreamsHandler {
 
   // Execute change stream partition query when partition token is non null.
   absl::Status ExecutePartitionQuery(
+      RequestContext* ctx, ServerStream<spanner_api::PartialResultSet>* stream,
+      std::shared_ptr<Session> session);
+
+  // Streams back the records committed since the previous scan of the
+  // partition, and the child partitions once the partition has ended.
+  absl::Status ScanPartition(
+      PartitionQueryState& state,
       ServerStream<spanner_api::PartialResultSet>* stream,
       std::shared_ptr<Session> session);
 
+  // Returns true once the partition query has returned all its records.
+  bool IsPartitionQueryDone(
+      const PartitionQueryState& state,
+      const ServerStream<spanner_api::PartialResultSet>& stream) const;
+
+  // Returns the time by which the next scan is due even if there were no new
+  // commits, e.g. to send a heartbeat.
+  absl::Time NextScanDeadline(const PartitionQueryState& state) const;
+
+  // Stubs a heartbeat record if the query did not return any record.
+  absl::Status FinishPartitionQuery(
+      const PartitionQueryState& state,
+      ServerStream<spanner_api::PartialResultSet>* stream);
+
   backend::Query ConstructPartitionTablePartitionQuery() const;
 
-  backend::Query ConstructDataTablePartitionQuery(absl::Time start,
-                                                  absl::Time end) const;
+  // Constructs a read of the data change records of the partition with
+  // commit timestamps in [start, end) from `data_table`, or in [start, end] if
+  // `end` is the end timestamp of the query.
+  backend::ReadArg ConstructDataTablePartitionRead(
+      const backend::Table* data_table, absl::Time start,
+      absl::Time end) const;
 
   absl::Status ProcessDataChangeRecordsAndStreamBack(
-      backend::QueryResult& result, bool expect_heartbeat, absl::Time scan_end,
-      bool& expect_metadata, absl::Time* last_record_time,
+      backend::RowCursor* data_records, bool expect_heartbeat,
+      absl::Time scan_end, bool& expect_metadata, absl::Time* last_record_time,
       ServerStream<spanner_api::PartialResultSet>* stream);
 
   const backend::ChangeStreamQueryValidator::ChangeStreamMetadata& metadata()
@@ -91,7 +131,18 @@ class ChangeStreamsHandler {
   }
 
  private:
-  const backend::ChangeStreamQueryValidator::ChangeStreamMetadata& metadata_;
+  absl::Time tvf_end() const {
+    return metadata_.end_timestamp.has_value()
+               ? metadata_.end_timestamp.value()
+               : absl::InfiniteFuture();
+  }
+
+  absl::Duration heartbeat_interval() const {
+    return absl::Milliseconds(metadata_.heartbeat_milliseconds);
+  }
+
+  // Copied since detached partition queries outlive the request handler.
+  backend::ChangeStreamQueryValidator::ChangeStreamMetadata metadata_;
   std::string partition_table_;
 };
 }  // namespace frontend
@@ -32,11 +32,13 @@
 #include "backend/schema/parser/ddl_parser.h"
 #include "backend/schema/printer/print_ddl.h"
 #include "backend/schema/updater/schema_updater.h"
+#include "common/clock.h"
 #include "common/errors.h"
 #include "common/feature_flags.h"
 #include "frontend/common/uris.h"
 #include "frontend/converters/time.h"
 #include "frontend/entities/database.h"
+#include "frontend/entities/operation.h"
 #include "frontend/server/handler.h"
 #include "zetasql/base/status_macros.h"
 
@@ -51,6 +53,39 @@ namespace database_api = ::google::spanner::admin::database::v1;
 namespace operations_api = ::google::longrunning;
 namespace protobuf_api = ::google::protobuf;
 
+// Records the progress of a schema change in its operation metadata.
+void RecordSchemaChangeProgress(const backend::SchemaChangeProgress& progress,
+                                absl::Time now,
+                                database_api::UpdateDatabaseDdlMetadata* md) {
+  absl::StatusOr<protobuf_api::Timestamp> now_timestamp = TimestampToProto(now);
+  if (!now_timestamp.ok()) {
+    return;
+  }
+  for (int i = md->commit_timestamps_size();
+       i < progress.commit_timestamps.size(); ++i) {
+    absl::StatusOr<protobuf_api::Timestamp> commit_timestamp =
+        TimestampToProto(progress.commit_timestamps[i]);
+    if (!commit_timestamp.ok()) {
+      return;
+    }
+    *md->add_commit_timestamps() = *commit_timestamp;
+    database_api::OperationProgress* statement_progress =
+        md->mutable_progress(i);
+    statement_progress->set_progress_percent(100);
+    *statement_progress->mutable_end_time() = *now_timestamp;
+    if (i + 1 < md->progress_size()) {
+      *md->mutable_progress(i + 1)->mutable_start_time() = *now_timestamp;
+    }
+  }
+
+  // Only the statement being applied reports partial progress.
+  int next_statement = md->commit_timestamps_size();
+  if (!progress.done && next_statement < md->progress_size()) {
+    md->mutable_progress(next_statement)
+        ->set_progress_percent(progress.backfill_progress_percent);
+  }
+}
+
 }  // namespace
 
 // Lists all databases in an instance.
@@ -204,32 +239,22 @@ absl::Status UpdateDatabaseDdl(
     statements.push_back(statement);
   }
 
-  backend::Database* backend_database = database->backend();
-  int num_succesful_statements;
-  absl::Time commit_timestamp;
-  absl::Status backfill_status;
-  ZETASQL_RETURN_IF_ERROR(backend_database->UpdateSchema(
-      backend::SchemaChangeOperation{
-          .statements = statements,
-          .proto_descriptor_bytes = request->proto_descriptors(),
-          .database_dialect = backend_database->dialect()},
-      &num_succesful_statements, &commit_timestamp, &backfill_status));
+  if (statements.empty()) {
+    return error::UpdateDatabaseMissingStatements();
+  }
 
-  // Populate ResultSet metadata.
-  // For simplicity in emulator, we have implemented the schema updates in such
-  // a way that all the statements in update ddl execute at the same commit
-  // timestamp.
+  // Populate ResultSet metadata. Statements that create an index are applied
+  // once the index has been backfilled, and the statements between two such
+  // statements are applied at the same commit timestamp.
   database_api::UpdateDatabaseDdlMetadata update_md;
   update_md.set_database(request->database());
   for (const std::string& statement : statements) {
     update_md.add_statements(statement);
+    update_md.add_progress();
   }
-
-  // Only the timestamps of the successful statements are reported.
-  for (int i = 0; i < num_succesful_statements; ++i) {
-    ZETASQL_ASSIGN_OR_RETURN(*update_md.add_commit_timestamps(),
-                     TimestampToProto(commit_timestamp));
-  }
+  Clock* clock = ctx->env()->clock();
+  ZETASQL_ASSIGN_OR_RETURN(*update_md.mutable_progress(0)->mutable_start_time(),
+                   TimestampToProto(clock->Now()));
 
   // Create operation to be returned as part of the response.
   // A user-supplied operation_id would have already been validated above.
@@ -237,10 +262,33 @@ absl::Status UpdateDatabaseDdl(
                    ctx->env()->operation_manager()->CreateOperation(
                        request->database(), request->operation_id()));
   operation->SetMetadata(update_md);
-  if (backfill_status.ok()) {
-    operation->SetResponse(protobuf_api::Empty());
-  } else {
-    operation->SetError(backfill_status);
+
+  // Invalid statements are returned as errors by UpdateSchemaAsync. Index
+  // backfills then run in the background, and the operation reports their
+  // progress until it is done.
+  backend::Database* backend_database = database->backend();
+  absl::Status status = backend_database->UpdateSchemaAsync(
+      backend::SchemaChangeOperation{
+          .statements = statements,
+          .proto_descriptor_bytes = request->proto_descriptors(),
+          .database_dialect = backend_database->dialect()},
+      [operation, update_md,
+       clock](const backend::SchemaChangeProgress& progress) mutable {
+        RecordSchemaChangeProgress(progress, clock->Now(), &update_md);
+        operation->SetMetadata(update_md);
+        if (!progress.done) {
+          return;
+        }
+        if (progress.backfill_status.ok()) {
+          operation->SetResponse(protobuf_api::Empty());
+        } else {
+          operation->SetError(progress.backfill_status);
+        }
+      });
+  if (!status.ok()) {
+    ZETASQL_RETURN_IF_ERROR(ctx->env()->operation_manager()->DeleteOperation(
+        operation->operation_uri()));
+    return status;
   }
   operation->ToProto(response);
 
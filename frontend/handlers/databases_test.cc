@@ -435,6 +435,29 @@ TEST_F(DatabaseApiTest, UpdateDatabaseDdlPartialSuccess) {
   }
 }
 
+TEST_F(DatabaseApiTest, UpdateDatabaseDdlReportsProgress) {
+  ZETASQL_EXPECT_OK(CreateTestDatabase());
+
+  database_api::UpdateDatabaseDdlMetadata metadata;
+  std::vector<std::string> statements = {R"(
+     CREATE TABLE another_table (
+       int64_col INT64 NOT NULL,
+     ) PRIMARY KEY (int64_col)
+  )",
+                                         R"(
+     CREATE INDEX test_index ON test_table(string_col)
+  )"};
+  ZETASQL_EXPECT_OK(UpdateDatabaseDdl(test_database_uri_, statements, &metadata));
+
+  EXPECT_EQ(metadata.commit_timestamps_size(), 2);
+  ASSERT_EQ(metadata.progress_size(), 2);
+  for (const auto& progress : metadata.progress()) {
+    EXPECT_EQ(progress.progress_percent(), 100);
+    EXPECT_TRUE(progress.has_start_time());
+    EXPECT_TRUE(progress.has_end_time());
+  }
+}
+
 TEST_F(DatabaseApiTest, GetDatabaseNonExistentDatabase) {
   database_api::Database database;
   EXPECT_THAT(GetDatabase(test_database_uri_, &database),
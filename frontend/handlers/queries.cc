@@ -533,8 +533,8 @@ absl::Status ExecuteStreamingSql(
       });
   if (change_stream_metadata.is_change_stream_query) {
     ChangeStreamsHandler change_streams_handler{change_stream_metadata};
-    return change_streams_handler.ExecuteChangeStreamQuery(request, stream,
-                                                           session);
+    return change_streams_handler.ExecuteChangeStreamQuery(ctx, request,
+                                                           stream, session);
   }
   return status;
 }
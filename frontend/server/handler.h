@@ -17,6 +17,9 @@
 #ifndef THIRD_PARTY_CLOUD_SPANNER_EMULATOR_FRONTEND_SERVER_HANDLER_H_
 #define THIRD_PARTY_CLOUD_SPANNER_EMULATOR_FRONTEND_SERVER_HANDLER_H_
 
+#include <functional>
+#include <utility>
+
 #include "zetasql/base/logging.h"
 #include "absl/status/status.h"
 #include "common/config.h"
@@ -30,6 +33,20 @@ namespace spanner {
 namespace emulator {
 namespace frontend {
 
+// WriteQueue is implemented by response writers which queue the responses
+// instead of blocking until the client received them, so that producers can
+// wait for a slow client without holding a thread.
+class WriteQueue {
+ public:
+  virtual ~WriteQueue() = default;
+
+  // Returns true if the client lags behind, in which case `resume` is called
+  // once it caught up or the call failed, possibly from a gRPC reaction, so it
+  // should only schedule the producer. Returns false otherwise, and `resume` is
+  // not called.
+  virtual bool NotifyWhenWritable(std::function<void()> resume) = 0;
+};
+
 // ServerStream intercepts writes to a grpc::ServerWriter.
 //
 // Instead of passing a grpc::ServerWriter to server streaming handlers, we pass
@@ -39,17 +56,38 @@ template <typename T>
 class ServerStream {
  public:
   explicit ServerStream(grpc::ServerWriterInterface<T>* writer)
-      : writer_(writer) {}
+      : writer_(writer), write_queue_(dynamic_cast<WriteQueue*>(writer)) {}
 
   void Send(const T& msg) {
     if (config::should_log_requests()) {
       ABSL_LOG(INFO) << "Sending streaming response:\n" << msg.DebugString();
     }
-    writer_->Write(msg);
+    if (!writer_->Write(msg)) {
+      closed_ = true;
+    }
+  }
+
+  // Returns true if a response could not be sent, e.g. because the client
+  // cancelled the call. Handlers of long-running streams should stop early.
+  bool IsClosed() const { return closed_; }
+
+  // Returns true if the responses sent so far are queued because the client
+  // lags behind, in which case `resume` is called once the producer should
+  // send more. Handlers which produce responses over time, rather than all at
+  // once, should then return their thread to the pool. Always returns false if
+  // the writer does not queue responses.
+  bool NotifyWhenWritable(std::function<void()> resume) {
+    return write_queue_ != nullptr &&
+           write_queue_->NotifyWhenWritable(std::move(resume));
   }
 
  private:
   grpc::ServerWriterInterface<T>* writer_;
+
+  // Set if `writer_` queues responses.
+  WriteQueue* write_queue_;
+
+  bool closed_ = false;
 };
 
 // Base class for gRPC handlers.
@@ -127,7 +165,9 @@ class ServerStreamingGRPCHandler final : public GRPCHandlerBase {
     if (config::should_log_requests()) {
       ABSL_LOG(INFO) << "Response[" << service_name() << "." << method_name()
                 << "]\n"
-                << (status.ok() ? "OK" : "Error: " + status.ToString());
+                << (ctx->detached() ? "Detached"
+                    : status.ok()   ? "OK"
+                                    : "Error: " + status.ToString());
     }
 
     return status;
@@ -16,6 +16,9 @@
 
 #include "frontend/server/handler.h"
 
+#include <functional>
+#include <utility>
+
 #include "google/spanner/v1/result_set.pb.h"
 #include "google/spanner/v1/spanner.pb.h"
 #include "gmock/gmock.h"
@@ -104,6 +107,47 @@ TEST(HandlerRegisterer, RegistersServerStreamingGRPCHandler) {
   EXPECT_EQ("World", writer.messages().at(1).resume_token());
 }
 
+// Test ServerWriter which queues the sent messages until they are taken.
+template <class MessageT>
+class TestQueueingServerWriter : public TestServerWriter<MessageT>,
+                                 public WriteQueue {
+ public:
+  bool NotifyWhenWritable(std::function<void()> resume) override {
+    if (this->messages().size() < 2) {
+      return false;
+    }
+    resume_ = std::move(resume);
+    return true;
+  }
+
+  void Resume() { std::move(resume_)(); }
+
+ private:
+  std::function<void()> resume_;
+};
+
+TEST(ServerStream, NotifiesWhenQueueingWriterIsWritable) {
+  TestQueueingServerWriter<google::spanner::v1::PartialResultSet> writer;
+  ServerStream<google::spanner::v1::PartialResultSet> stream(&writer);
+  bool resumed = false;
+  stream.Send(google::spanner::v1::PartialResultSet());
+  EXPECT_FALSE(stream.NotifyWhenWritable([&resumed]() { resumed = true; }));
+
+  stream.Send(google::spanner::v1::PartialResultSet());
+  ASSERT_TRUE(stream.NotifyWhenWritable([&resumed]() { resumed = true; }));
+  EXPECT_FALSE(resumed);
+  writer.Resume();
+  EXPECT_TRUE(resumed);
+}
+
+TEST(ServerStream, NeverWaitsForBlockingWriter) {
+  TestServerWriter<google::spanner::v1::PartialResultSet> writer;
+  ServerStream<google::spanner::v1::PartialResultSet> stream(&writer);
+  stream.Send(google::spanner::v1::PartialResultSet());
+  stream.Send(google::spanner::v1::PartialResultSet());
+  EXPECT_FALSE(stream.NotifyWhenWritable([]() {}));
+}
+
 TEST(HandlerRegisterer, ReturnsNullptrForUnrecognizedHandlers) {
   ASSERT_EQ(nullptr, GetHandler("UnknownServer", "UnknownMethod"));
 }
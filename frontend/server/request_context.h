@@ -17,8 +17,13 @@
 #ifndef THIRD_PARTY_CLOUD_SPANNER_EMULATOR_FRONTEND_SERVER_REQUEST_CONTEXT_H_
 #define THIRD_PARTY_CLOUD_SPANNER_EMULATOR_FRONTEND_SERVER_REQUEST_CONTEXT_H_
 
+#include <functional>
+#include <utility>
+
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "frontend/server/environment.h"
+#include "frontend/server/thread_pool.h"
 #include "grpcpp/server_context.h"
 
 namespace google {
@@ -29,19 +34,51 @@ namespace frontend {
 // RequestContext encapsulates the state passed to a gRPC method handler.
 class RequestContext {
  public:
-  RequestContext(ServerEnv* env, grpc::ServerContext* grpc)
+  RequestContext(ServerEnv* env, grpc::ServerContextBase* grpc)
       : env_(env), grpc_(grpc) {}
 
+  // Called with the final status of a call which finishes asynchronously.
+  using DoneCallback = std::function<void(absl::Status)>;
+
   // Accessors.
   ServerEnv* env() { return env_; }
-  grpc::ServerContext* grpc() { return grpc_; }
+  grpc::ServerContextBase* grpc() { return grpc_; }
+
+  // Lets the handler finish the call after it has returned, see Detach().
+  // Called by the server before it runs a server streaming handler.
+  void EnableDetach(ThreadPool* thread_pool, DoneCallback done) {
+    thread_pool_ = thread_pool;
+    done_ = std::move(done);
+  }
+
+  // Returns the pool running the handler if the handler may detach, or
+  // nullptr otherwise.
+  ThreadPool* thread_pool() { return thread_pool_; }
+
+  // Takes over the completion of the call, e.g. to wait for an event without
+  // holding a thread of the pool. The status returned by the handler is then
+  // ignored, and the returned callback must be called exactly once instead.
+  // The request and the response stream stay valid until then. Requires
+  // thread_pool() to be non-null.
+  DoneCallback Detach() {
+    detached_ = true;
+    return std::move(done_);
+  }
+
+  bool detached() const { return detached_; }
 
  private:
   // Server environment shared by all requests.
   ServerEnv* env_;
 
   // gRPC context specific to a single request.
-  grpc::ServerContext* grpc_;
+  grpc::ServerContextBase* grpc_;
+
+  // Set if the handler may detach.
+  ThreadPool* thread_pool_ = nullptr;
+  DoneCallback done_;
+
+  bool detached_ = false;
 };
 
 // Checks if an instance exists. Returns the Instance entity or an error:
@@ -23,11 +23,13 @@
 #include "google/spanner/admin/instance/v1/spanner_instance_admin.pb.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "absl/status/status.h"
 #include "zetasql/base/testing/status_matchers.h"
 #include "tests/common/proto_matchers.h"
 #include "absl/strings/str_cat.h"
 #include "frontend/common/uris.h"
 #include "frontend/entities/session.h"
+#include "frontend/server/thread_pool.h"
 #include "tests/common/proto_matchers.h"
 
 namespace google {
@@ -120,6 +122,24 @@ TEST_F(SessionExistenceTest, WrongInstanceId) {
                   testing::MatchesRegex(".*Instance not found.*")));
 }
 
+TEST(RequestContextTest, DetachHandsOverDoneCallback) {
+  RequestContext ctx(/*env=*/nullptr, /*grpc=*/nullptr);
+  EXPECT_EQ(ctx.thread_pool(), nullptr);
+
+  ThreadPool thread_pool(/*num_threads=*/1);
+  absl::Status done_status = absl::UnknownError("not done");
+  ctx.EnableDetach(&thread_pool, [&done_status](absl::Status status) {
+    done_status = status;
+  });
+  EXPECT_EQ(ctx.thread_pool(), &thread_pool);
+  EXPECT_FALSE(ctx.detached());
+
+  RequestContext::DoneCallback done = ctx.Detach();
+  EXPECT_TRUE(ctx.detached());
+  done(absl::OkStatus());
+  ZETASQL_EXPECT_OK(done_status);
+}
+
 }  // namespace
 }  // namespace frontend
 }  // namespace emulator
@@ -16,8 +16,13 @@
 
 #include "frontend/server/server.h"
 
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <functional>
 #include <memory>
 #include <string>
+#include <thread>  // NOLINT
 #include <utility>
 
 #include "zetasql/base/logging.h"
@@ -33,15 +38,23 @@
 #include "google/spanner/v1/spanner.grpc.pb.h"
 #include "google/spanner/v1/spanner.pb.h"
 #include "google/spanner/v1/transaction.pb.h"
+#include "absl/base/thread_annotations.h"
 #include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
 #include "common/constants.h"
 #include "common/errors.h"
 #include "common/limits.h"
 #include "frontend/common/status.h"
 #include "frontend/server/handler.h"
 #include "frontend/server/request_context.h"
+#include "frontend/server/thread_pool.h"
+#include "grpcpp/resource_quota.h"
 #include "grpcpp/server_builder.h"
+#include "grpcpp/server_context.h"
+#include "grpcpp/support/server_callback.h"
 #include "grpcpp/support/status.h"
+#include "grpcpp/support/sync_stream.h"
 
 namespace google {
 namespace spanner {
@@ -58,7 +71,8 @@ namespace spanner_api = ::google::spanner::v1;
 
 namespace {
 
-void MaybeAddTrailingMetadata(const absl::Status& status, RequestContext* ctx) {
+void MaybeAddTrailingMetadata(const absl::Status& status,
+                              grpc::ServerContextBase* grpc_ctx) {
   if (!status.ok()) {
     // Check for ResourceInfo within the returned status and append it as extra
     // trailing metadata. The Java client library expects the ResourceInfo to be
@@ -66,12 +80,146 @@ void MaybeAddTrailingMetadata(const absl::Status& status, RequestContext* ctx) {
     auto payload = status.GetPayload(kResourceInfoType);
     if (payload.has_value()) {
       std::string serialized_info(payload.value());
-      ctx->grpc()->AddTrailingMetadata(kResourceInfoBinaryHeader,
-                                       serialized_info);
+      grpc_ctx->AddTrailingMetadata(kResourceInfoBinaryHeader,
+                                    serialized_info);
     }
   }
 }
 
+// StreamingReactor sends the responses of a server streaming call.
+//
+// Handlers are written against the grpc::ServerWriterInterface, so the reactor
+// implements it on top of the asynchronous writes of the callback API: Write()
+// queues the response and returns right away. Producers which would otherwise
+// run ahead of a slow client wait through NotifyWhenWritable() without holding
+// a thread, and are rescheduled once the client caught up. The reactor deletes
+// itself once the call is done.
+template <typename ResponseT>
+class StreamingReactor : public grpc::ServerWriteReactor<ResponseT>,
+                         public grpc::ServerWriterInterface<ResponseT>,
+                         public WriteQueue {
+ public:
+  // `num_calls` is decremented once the call is done.
+  explicit StreamingReactor(std::atomic<int>* num_calls)
+      : num_calls_(num_calls) {}
+
+  // Initial metadata is sent along with the first response.
+  void SendInitialMetadata() override {}
+
+  bool Write(const ResponseT& msg, grpc::WriteOptions options) override {
+    const std::pair<ResponseT, grpc::WriteOptions>* write = nullptr;
+    {
+      absl::MutexLock lock(&mu_);
+      if (failed_) {
+        return false;
+      }
+      pending_writes_.emplace_back(msg, options);
+      if (pending_writes_.size() == 1) {
+        write = &pending_writes_.front();
+      }
+    }
+    // Reactions may run inline, so writes are started without holding mu_.
+    if (write != nullptr) {
+      this->StartWrite(&write->first, write->second);
+    }
+    return true;
+  }
+
+  bool NotifyWhenWritable(std::function<void()> resume) override {
+    absl::MutexLock lock(&mu_);
+    if (failed_ || pending_writes_.size() < kMaxPendingWrites) {
+      return false;
+    }
+    resume_ = std::move(resume);
+    return true;
+  }
+
+  // Finishes the call once all pending responses have been sent.
+  void FinishHandler(grpc::Status status) {
+    {
+      absl::MutexLock lock(&mu_);
+      if (!pending_writes_.empty()) {
+        finish_status_ = std::move(status);
+        finish_pending_ = true;
+        return;
+      }
+    }
+    this->Finish(status);
+  }
+
+  void OnWriteDone(bool ok) override {
+    const std::pair<ResponseT, grpc::WriteOptions>* write = nullptr;
+    bool finish = false;
+    grpc::Status status;
+    std::function<void()> resume;
+    {
+      absl::MutexLock lock(&mu_);
+      pending_writes_.pop_front();
+      if (!ok || failed_) {
+        // The remaining responses cannot be delivered anymore.
+        failed_ = true;
+        pending_writes_.clear();
+      }
+      // Resume a waiting producer once half of the queue has drained, so that
+      // it is not rescheduled for every response.
+      if (resume_ != nullptr &&
+          (failed_ || pending_writes_.size() <= kMaxPendingWrites / 2)) {
+        resume = std::move(resume_);
+        resume_ = nullptr;
+      }
+      if (!pending_writes_.empty()) {
+        write = &pending_writes_.front();
+      } else if (finish_pending_) {
+        finish = true;
+        status = finish_status_;
+      }
+    }
+    if (resume != nullptr) {
+      resume();
+    }
+    if (write != nullptr) {
+      this->StartWrite(&write->first, write->second);
+    } else if (finish) {
+      this->Finish(status);
+    }
+  }
+
+  void OnCancel() override {
+    absl::MutexLock lock(&mu_);
+    failed_ = true;
+  }
+
+  void OnDone() override {
+    num_calls_->fetch_sub(1);
+    delete this;
+  }
+
+ private:
+  // Number of responses queued for a call from which a producer should wait
+  // for the client, see NotifyWhenWritable().
+  static constexpr int kMaxPendingWrites = 16;
+
+  std::atomic<int>* const num_calls_;
+
+  absl::Mutex mu_;
+
+  // Responses not yet sent to the client. Only the front one is being written.
+  std::deque<std::pair<ResponseT, grpc::WriteOptions>> pending_writes_
+      ABSL_GUARDED_BY(mu_);
+
+  // True if the call was cancelled or a write failed.
+  bool failed_ ABSL_GUARDED_BY(mu_) = false;
+
+  // True if the handler returned while responses were still pending.
+  bool finish_pending_ ABSL_GUARDED_BY(mu_) = false;
+
+  // Status returned by the handler, if finish_pending_.
+  grpc::Status finish_status_ ABSL_GUARDED_BY(mu_);
+
+  // Reschedules the producer waiting for the client to catch up, if any.
+  std::function<void()> resume_ ABSL_GUARDED_BY(mu_);
+};
+
 }  // namespace
 
 // Invokes the given unary gRPC method on the given service by looking up the
@@ -79,7 +227,7 @@ void MaybeAddTrailingMetadata(const absl::Status& status, RequestContext* ctx) {
 template <typename RequestT, typename ResponseT>
 absl::Status Invoke(const std::string& service_name,
                     const std::string& method_name,
-                    grpc::ServerContext* grpc_ctx, ServerEnv* env,
+                    grpc::ServerContextBase* grpc_ctx, ServerEnv* env,
                     const RequestT* request, ResponseT* response) {
   GRPCHandlerBase* handler = GetHandler(service_name, method_name);
   if (!handler) {
@@ -90,44 +238,93 @@ absl::Status Invoke(const std::string& service_name,
   absl::Status status =
       dynamic_cast<UnaryGRPCHandler<RequestT, ResponseT>*>(handler)->Run(
           &ctx, request, response);
-  MaybeAddTrailingMetadata(status, &ctx);
+  MaybeAddTrailingMetadata(status, grpc_ctx);
   return status;
 }
 
 // Invokes the given server streaming gRPC method on the given service by
-// looking up the handler registry. Returns INTERNAL error if the handler could
-// not be found.
+// looking up the handler registry, and calls `done` with the final status once
+// the call has finished, which may be after this returns if the handler
+// detached. Fails with INTERNAL error if the handler could not be found.
 template <typename RequestT, typename ResponseT>
-absl::Status Invoke(const std::string& service_name,
-                    const std::string& method_name,
-                    grpc::ServerContext* grpc_ctx, ServerEnv* env,
-                    const RequestT* request,
-                    grpc::ServerWriter<ResponseT>* writer) {
+void Invoke(const std::string& service_name, const std::string& method_name,
+            grpc::ServerContextBase* grpc_ctx, ServerEnv* env,
+            ThreadPool* thread_pool, const RequestT* request,
+            grpc::ServerWriterInterface<ResponseT>* writer,
+            RequestContext::DoneCallback done) {
   GRPCHandlerBase* handler = GetHandler(service_name, method_name);
   if (!handler) {
-    return error::Internal(absl::StrCat("Could not find handler for ",
-                                        service_name, ".", method_name));
+    done(error::Internal(absl::StrCat("Could not find handler for ",
+                                      service_name, ".", method_name)));
+    return;
   }
+  RequestContext::DoneCallback finish = [grpc_ctx, done = std::move(done)](
+                                            absl::Status status) {
+    MaybeAddTrailingMetadata(status, grpc_ctx);
+    done(std::move(status));
+  };
   RequestContext ctx(env, grpc_ctx);
+  ctx.EnableDetach(thread_pool, finish);
   absl::Status status =
       dynamic_cast<ServerStreamingGRPCHandler<RequestT, ResponseT>*>(handler)
           ->Run(&ctx, request, writer);
-  MaybeAddTrailingMetadata(status, &ctx);
-  return status;
+  if (!ctx.detached()) {
+    finish(std::move(status));
+  }
 }
 
+// Defines a unary gRPC method which runs its handler on the given pool.
+#define DEFINE_GRPC_METHOD_ON_POOL(Pool, ServiceName, MethodName, RequestType, \
+                                   ResponseType)                               \
+  grpc::ServerUnaryReactor* MethodName(grpc::CallbackServerContext* grpc_ctx,  \
+                                       const RequestType* request,             \
+                                       ResponseType* response) override {      \
+    grpc::ServerUnaryReactor* reactor = grpc_ctx->DefaultReactor();            \
+    Pool->Schedule([env = env_, grpc_ctx, request, response, reactor]() {      \
+      reactor->Finish(ToGRPCStatus(                                            \
+          Invoke(#ServiceName, #MethodName, grpc_ctx, env, request,            \
+                 response)));                                                  \
+    });                                                                        \
+    return reactor;                                                            \
+  }
+
+// Defines a unary gRPC method which runs its handler on the thread pool.
 #define DEFINE_GRPC_METHOD(ServiceName, MethodName, RequestType, ResponseType) \
-  grpc::Status MethodName(grpc::ServerContext* grpc_ctx,                       \
-                          const RequestType* request, ResponseType* response)  \
+  DEFINE_GRPC_METHOD_ON_POOL(thread_pool_, ServiceName, MethodName,            \
+                             RequestType, ResponseType)
+
+// Defines a unary gRPC method which reads or writes data and runs its handler
+// on the query thread pool.
+#define DEFINE_QUERY_GRPC_METHOD(ServiceName, MethodName, RequestType,         \
+                                 ResponseType)                                 \
+  DEFINE_GRPC_METHOD_ON_POOL(query_thread_pool_, ServiceName, MethodName,      \
+                             RequestType, ResponseType)
+
+// Defines a server streaming gRPC method which runs its handler on the query
+// thread pool.
+#define DEFINE_STREAMING_GRPC_METHOD(ServiceName, MethodName, RequestType,     \
+                                     ResponseType)                             \
+  grpc::ServerWriteReactor<ResponseType>* MethodName(                          \
+      grpc::CallbackServerContext* grpc_ctx, const RequestType* request)       \
       override {                                                               \
-    return ToGRPCStatus(                                                       \
-        Invoke(#ServiceName, #MethodName, grpc_ctx, env_, request, response)); \
+    return StartStreamingCall<ResponseType>(                                   \
+        [env = env_, pool = query_thread_pool_, grpc_ctx, request](            \
+            grpc::ServerWriterInterface<ResponseType>* writer,                 \
+            RequestContext::DoneCallback done) {                               \
+          Invoke(#ServiceName, #MethodName, grpc_ctx, env, pool, request,      \
+                 writer, std::move(done));                                     \
+        });                                                                    \
   }
 
 // Implementation of the Spanner gRPC service.
-class SpannerService : public spanner_api::Spanner::Service {
+class SpannerService : public spanner_api::Spanner::CallbackService {
  public:
-  explicit SpannerService(ServerEnv* env) : env_(env) {}
+  SpannerService(ServerEnv* env, ThreadPool* thread_pool,
+                 ThreadPool* query_thread_pool, int max_streaming_calls)
+      : env_(env),
+        thread_pool_(thread_pool),
+        query_thread_pool_(query_thread_pool),
+        max_streaming_calls_(max_streaming_calls) {}
 
   // Sessions.
   DEFINE_GRPC_METHOD(Spanner, CreateSession, spanner_api::CreateSessionRequest,
@@ -143,31 +340,34 @@ class SpannerService : public spanner_api::Spanner::Service {
                      spanner_api::BatchCreateSessionsResponse)
 
   // Reads.
-  DEFINE_GRPC_METHOD(Spanner, Read, spanner_api::ReadRequest,
-                     spanner_api::ResultSet);
-  DEFINE_GRPC_METHOD(Spanner, StreamingRead, spanner_api::ReadRequest,
-                     grpc::ServerWriter<v1::PartialResultSet>);
+  DEFINE_QUERY_GRPC_METHOD(Spanner, Read, spanner_api::ReadRequest,
+                           spanner_api::ResultSet);
+  DEFINE_STREAMING_GRPC_METHOD(Spanner, StreamingRead, spanner_api::ReadRequest,
+                               spanner_api::PartialResultSet);
 
   // Queries.
-  DEFINE_GRPC_METHOD(Spanner, ExecuteSql, spanner_api::ExecuteSqlRequest,
-                     spanner_api::ResultSet);
-  DEFINE_GRPC_METHOD(Spanner, ExecuteStreamingSql,
-                     spanner_api::ExecuteSqlRequest,
-                     grpc::ServerWriter<v1::PartialResultSet>);
-  DEFINE_GRPC_METHOD(Spanner, ExecuteBatchDml,
-                     spanner_api::ExecuteBatchDmlRequest,
-                     spanner_api::ExecuteBatchDmlResponse);
+  DEFINE_QUERY_GRPC_METHOD(Spanner, ExecuteSql,
+                           spanner_api::ExecuteSqlRequest,
+                           spanner_api::ResultSet);
+  DEFINE_STREAMING_GRPC_METHOD(Spanner, ExecuteStreamingSql,
+                               spanner_api::ExecuteSqlRequest,
+                               spanner_api::PartialResultSet);
+  DEFINE_QUERY_GRPC_METHOD(Spanner, ExecuteBatchDml,
+                           spanner_api::ExecuteBatchDmlRequest,
+                           spanner_api::ExecuteBatchDmlResponse);
 
   // Batch
-  DEFINE_GRPC_METHOD(Spanner, BatchWrite, spanner_api::BatchWriteRequest,
-                     grpc::ServerWriter<v1::BatchWriteResponse>);
+  DEFINE_STREAMING_GRPC_METHOD(Spanner, BatchWrite,
+                               spanner_api::BatchWriteRequest,
+                               spanner_api::BatchWriteResponse);
 
   // Partitions.
-  DEFINE_GRPC_METHOD(Spanner, PartitionRead, spanner_api::PartitionReadRequest,
-                     spanner_api::PartitionResponse);
-  DEFINE_GRPC_METHOD(Spanner, PartitionQuery,
-                     spanner_api::PartitionQueryRequest,
-                     spanner_api::PartitionResponse);
+  DEFINE_QUERY_GRPC_METHOD(Spanner, PartitionRead,
+                           spanner_api::PartitionReadRequest,
+                           spanner_api::PartitionResponse);
+  DEFINE_QUERY_GRPC_METHOD(Spanner, PartitionQuery,
+                           spanner_api::PartitionQueryRequest,
+                           spanner_api::PartitionResponse);
 
   // Transactions.
   DEFINE_GRPC_METHOD(Spanner, BeginTransaction,
@@ -179,13 +379,47 @@ class SpannerService : public spanner_api::Spanner::Service {
                      protobuf_api::Empty);
 
  private:
+  // Admits a server streaming call and runs `invoke` on the query thread pool.
+  // The call is finished once `invoke` calls its done callback.
+  template <typename ResponseT>
+  grpc::ServerWriteReactor<ResponseT>* StartStreamingCall(
+      std::function<void(grpc::ServerWriterInterface<ResponseT>*,
+                         RequestContext::DoneCallback)>
+          invoke) {
+    auto* reactor = new StreamingReactor<ResponseT>(&num_streaming_calls_);
+    if (num_streaming_calls_.fetch_add(1) >= max_streaming_calls_ &&
+        max_streaming_calls_ > 0) {
+      reactor->Finish(
+          ToGRPCStatus(error::TooManyStreamingCalls(max_streaming_calls_)));
+      return reactor;
+    }
+    query_thread_pool_->Schedule([reactor, invoke = std::move(invoke)]() {
+      invoke(reactor, [reactor](absl::Status status) {
+        reactor->FinishHandler(ToGRPCStatus(status));
+      });
+    });
+    return reactor;
+  }
+
   ServerEnv* const env_;
+  ThreadPool* const thread_pool_;
+
+  // Pool running the handlers which read or write data.
+  ThreadPool* const query_thread_pool_;
+
+  // Maximum number of concurrent server streaming calls, zero if unlimited.
+  const int max_streaming_calls_;
+
+  // Number of server streaming calls that are not done yet.
+  std::atomic<int> num_streaming_calls_ = 0;
 };
 
 // Implementation of the DatabaseAdmin gRPC service.
-class DatabaseAdminService : public database_api::DatabaseAdmin::Service {
+class DatabaseAdminService
+    : public database_api::DatabaseAdmin::CallbackService {
  public:
-  explicit DatabaseAdminService(ServerEnv* env) : env_(env) {}
+  DatabaseAdminService(ServerEnv* env, ThreadPool* thread_pool)
+      : env_(env), thread_pool_(thread_pool) {}
 
   // Databases.
   DEFINE_GRPC_METHOD(DatabaseAdmin, ListDatabases,
@@ -218,12 +452,15 @@ class DatabaseAdminService : public database_api::DatabaseAdmin::Service {
 
  private:
   ServerEnv* const env_;
+  ThreadPool* const thread_pool_;
 };
 
 // Implementation of the InstanceAdmin gRPC service.
-class InstanceAdminService : public instance_api::InstanceAdmin::Service {
+class InstanceAdminService
+    : public instance_api::InstanceAdmin::CallbackService {
  public:
-  explicit InstanceAdminService(ServerEnv* env) : env_(env) {}
+  InstanceAdminService(ServerEnv* env, ThreadPool* thread_pool)
+      : env_(env), thread_pool_(thread_pool) {}
 
   // Instance configs.
   DEFINE_GRPC_METHOD(InstanceAdmin, ListInstanceConfigs,
@@ -259,12 +496,14 @@ class InstanceAdminService : public instance_api::InstanceAdmin::Service {
 
  private:
   ServerEnv* const env_;
+  ThreadPool* const thread_pool_;
 };
 
 // Implementation of the Operations gRPC service.
-class OperationsService : public operations_api::Operations::Service {
+class OperationsService : public operations_api::Operations::CallbackService {
  public:
-  explicit OperationsService(ServerEnv* env) : env_(env) {}
+  OperationsService(ServerEnv* env, ThreadPool* thread_pool)
+      : env_(env), thread_pool_(thread_pool) {}
 
   DEFINE_GRPC_METHOD(Operations, ListOperations,
                      operations_api::ListOperationsRequest,
@@ -284,19 +523,34 @@ class OperationsService : public operations_api::Operations::Service {
 
  private:
   ServerEnv* const env_;
+  ThreadPool* const thread_pool_;
 };
 
-Server::Server(std::unique_ptr<ServerEnv> env)
+Server::Server(std::unique_ptr<ServerEnv> env, const Options& options)
     : env_(std::move(env)),
-      database_admin_service_(new DatabaseAdminService(env_.get())),
-      instance_admin_service_(new InstanceAdminService(env_.get())),
-      operations_service_(new OperationsService(env_.get())),
-      spanner_service_(new SpannerService(env_.get())) {}
+      thread_pool_(std::make_unique<ThreadPool>(
+          options.num_worker_threads > 0
+              ? options.num_worker_threads
+              : std::max<int>(8, 2 * std::thread::hardware_concurrency()))),
+      query_thread_pool_(std::make_unique<ThreadPool>(
+          options.num_query_threads > 0
+              ? options.num_query_threads
+              : std::max<int>(1, std::thread::hardware_concurrency()))),
+      database_admin_service_(
+          new DatabaseAdminService(env_.get(), thread_pool_.get())),
+      instance_admin_service_(
+          new InstanceAdminService(env_.get(), thread_pool_.get())),
+      operations_service_(
+          new OperationsService(env_.get(), thread_pool_.get())),
+      spanner_service_(new SpannerService(env_.get(), thread_pool_.get(),
+                                          query_thread_pool_.get(),
+                                          options.max_streaming_calls)) {}
 
 // Server lifecycle methods.
 std::unique_ptr<Server> Server::Create(const Server::Options& options) {
   auto env = std::make_unique<ServerEnv>();
-  std::unique_ptr<Server> server = absl::WrapUnique(new Server(std::move(env)));
+  std::unique_ptr<Server> server =
+      absl::WrapUnique(new Server(std::move(env), options));
   ::grpc::ServerBuilder builder;
 
   // Configure server address.
@@ -311,6 +565,17 @@ std::unique_ptr<Server> Server::Create(const Server::Options& options) {
   builder.AddChannelArgument(GRPC_ARG_MAX_RECEIVE_MESSAGE_LENGTH,
                              limits::kMaxGRPCIncomingMessageSize);
 
+  // Configure server resource limits.
+  if (options.max_concurrent_streams_per_connection > 0) {
+    builder.AddChannelArgument(GRPC_ARG_MAX_CONCURRENT_STREAMS,
+                               options.max_concurrent_streams_per_connection);
+  }
+  if (options.resource_quota_bytes > 0) {
+    ::grpc::ResourceQuota quota("cloud_spanner_emulator");
+    quota.Resize(options.resource_quota_bytes);
+    builder.SetResourceQuota(quota);
+  }
+
   // Configure services exported on this server.
   builder.RegisterService(server->spanner_service_.get())
       .RegisterService(server->database_admin_service_.get())
@@ -17,10 +17,12 @@
 #ifndef STORAGE_SPANNER_CLOUD_EMULATOR_FRONTEND_SERVER_H_
 #define STORAGE_SPANNER_CLOUD_EMULATOR_FRONTEND_SERVER_H_
 
+#include <cstdint>
 #include <memory>
 #include <string>
 
 #include "frontend/server/environment.h"
+#include "frontend/server/thread_pool.h"
 #include "grpcpp/impl/service_type.h"
 #include "grpcpp/server.h"
 #include "grpcpp/support/status.h"
@@ -50,10 +52,36 @@ namespace frontend {
 // all state needed by a handler into a RequestContext and dispatches the
 // request to its associated free-standing handler function.
 //
+// Services use the gRPC callback API, so gRPC threads never block on requests.
+// Handlers run on bounded ThreadPools instead: reads, queries and DML run on a
+// pool sized by the number of CPUs, and other requests run on a separate pool,
+// so that a burst of queries cannot starve session or admin requests.
+// Responses of server streaming calls are sent asynchronously, and handlers
+// waiting for change stream records do not hold a thread of the pools.
+//
 class Server {
  public:
   struct Options {
     std::string server_address;
+
+    // Maximum number of requests processed concurrently, not counting reads,
+    // queries and DML. If zero, the limit is derived from the number of CPUs.
+    int num_worker_threads = 0;
+
+    // Maximum number of reads, queries and DML processed concurrently. If
+    // zero, it is the number of CPUs.
+    int num_query_threads = 0;
+
+    // Maximum number of concurrent server streaming calls. If zero, the
+    // number of streaming calls is not limited.
+    int max_streaming_calls = 0;
+
+    // Maximum number of concurrent calls per client connection. If zero, the
+    // gRPC default is used.
+    int max_concurrent_streams_per_connection = 0;
+
+    // Maximum amount of memory used by gRPC. If zero, it is not limited.
+    int64_t resource_quota_bytes = 0;
   };
 
   // Returns an initialized Server, or nullptr if the initialization failed.
@@ -73,7 +101,7 @@ class Server {
 
  private:
   // Constructor is only used by the factory function
-  explicit Server(std::unique_ptr<ServerEnv> env);
+  Server(std::unique_ptr<ServerEnv> env, const Options& options);
 
   // Address of the gRPC server.
   std::string host_;
@@ -82,6 +110,11 @@ class Server {
   // Environment shared by all handlers.
   std::unique_ptr<ServerEnv> env_;
 
+  // Pools running the handlers. They outlive the gRPC server, which waits for
+  // in-flight calls on shutdown.
+  std::unique_ptr<ThreadPool> thread_pool_;
+  std::unique_ptr<ThreadPool> query_thread_pool_;
+
   // Services implemented by this gRPC server.
   std::unique_ptr<grpc::Service> database_admin_service_;
   std::unique_ptr<grpc::Service> instance_admin_service_;
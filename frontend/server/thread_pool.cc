@@ -0,0 +1,130 @@
+//
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "frontend/server/thread_pool.h"
+
+#include <functional>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+
+namespace google {
+namespace spanner {
+namespace emulator {
+namespace frontend {
+
+ThreadPool::ThreadPool(int num_threads, absl::Duration idle_thread_timeout)
+    : num_threads_(num_threads), idle_thread_timeout_(idle_thread_timeout) {}
+
+ThreadPool::~ThreadPool() {
+  std::vector<std::thread> threads;
+  {
+    absl::MutexLock lock(&mu_);
+    stop_ = true;
+    for (auto& [id, thread] : threads_) {
+      threads.push_back(std::move(thread));
+    }
+    threads_.clear();
+    for (std::thread& thread : exited_threads_) {
+      threads.push_back(std::move(thread));
+    }
+    exited_threads_.clear();
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+}
+
+void ThreadPool::Schedule(std::function<void()> task) {
+  absl::MutexLock lock(&mu_);
+  tasks_.push_back(std::move(task));
+  MaybeStartThreadLocked();
+}
+
+int ThreadPool::NumThreads() {
+  absl::MutexLock lock(&mu_);
+  return threads_.size();
+}
+
+void ThreadPool::MaybeStartThreadLocked() {
+  JoinExitedThreadsLocked();
+  // Idle threads pick up the task once they are allowed to run it.
+  if (CanRunTaskLocked() && num_idle_ == 0 && !stop_) {
+    ++num_idle_;
+    std::thread thread(&ThreadPool::Run, this);
+    std::thread::id id = thread.get_id();
+    threads_.emplace(id, std::move(thread));
+  }
+}
+
+void ThreadPool::JoinExitedThreadsLocked() {
+  // Exited threads released mu_ when they moved themselves here, so joining
+  // them only waits for them to return.
+  for (std::thread& thread : exited_threads_) {
+    thread.join();
+  }
+  exited_threads_.clear();
+}
+
+void ThreadPool::Run() {
+  absl::MutexLock lock(&mu_);
+  auto can_run_or_stopped = [this]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    return CanRunTaskLocked() || (stop_ && tasks_.empty());
+  };
+  while (true) {
+    bool signaled = mu_.AwaitWithTimeout(absl::Condition(&can_run_or_stopped),
+                                         idle_thread_timeout_);
+    if (tasks_.empty()) {
+      --num_idle_;
+      if (!signaled && !stop_) {
+        // Idle for too long. The thread was registered by the thread which
+        // started it before this one could acquire mu_, and it is joined by a
+        // later call once it has returned.
+        auto it = threads_.find(std::this_thread::get_id());
+        exited_threads_.push_back(std::move(it->second));
+        threads_.erase(it);
+      }
+      // Otherwise stopped, in which case the destructor joins the thread.
+      return;
+    }
+    if (!CanRunTaskLocked()) {
+      // Timed out while there were tasks which other threads are running.
+      continue;
+    }
+    --num_idle_;
+    ++num_active_;
+    std::function<void()> task = std::move(tasks_.front());
+    tasks_.pop_front();
+    // Another idle thread may be needed for the remaining tasks.
+    MaybeStartThreadLocked();
+
+    mu_.Unlock();
+    task();
+    mu_.Lock();
+
+    --num_active_;
+    ++num_idle_;
+  }
+}
+
+}  // namespace frontend
+}  // namespace emulator
+}  // namespace spanner
+}  // namespace google
@@ -0,0 +1,105 @@
+//
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef THIRD_PARTY_CLOUD_SPANNER_EMULATOR_FRONTEND_SERVER_THREAD_POOL_H_
+#define THIRD_PARTY_CLOUD_SPANNER_EMULATOR_FRONTEND_SERVER_THREAD_POOL_H_
+
+#include <deque>
+#include <functional>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+
+namespace google {
+namespace spanner {
+namespace emulator {
+namespace frontend {
+
+// ThreadPool runs the handlers of gRPC requests.
+//
+// At most `num_threads` tasks run at any time, and further tasks are queued.
+// Threads are started on demand and exit once they have been idle for
+// `idle_thread_timeout`, so a burst of requests does not leave threads behind.
+//
+// Tasks should not block for long. A handler which waits for an event, such as
+// a change stream query waiting for new commits, returns its thread to the
+// pool and schedules a new task once the event happened.
+//
+// This class is thread-safe.
+class ThreadPool {
+ public:
+  explicit ThreadPool(int num_threads,
+                      absl::Duration idle_thread_timeout = absl::Minutes(1));
+
+  // Runs the queued tasks and stops the threads.
+  ~ThreadPool();
+
+  // Runs `task` on a thread of the pool.
+  void Schedule(std::function<void()> task) ABSL_LOCKS_EXCLUDED(mu_);
+
+  // Returns the number of threads which are running.
+  int NumThreads() ABSL_LOCKS_EXCLUDED(mu_);
+
+ private:
+  // Body of each thread of the pool.
+  void Run() ABSL_LOCKS_EXCLUDED(mu_);
+
+  // Starts a thread if there are queued tasks that no idle thread can pick up.
+  void MaybeStartThreadLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Joins the threads which have exited.
+  void JoinExitedThreadsLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  bool CanRunTaskLocked() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    return !tasks_.empty() && num_active_ < num_threads_;
+  }
+
+  // Maximum number of active tasks.
+  const int num_threads_;
+
+  // How long a thread waits for a task before it exits.
+  const absl::Duration idle_thread_timeout_;
+
+  absl::Mutex mu_;
+
+  std::deque<std::function<void()>> tasks_ ABSL_GUARDED_BY(mu_);
+
+  // Number of tasks that are running.
+  int num_active_ ABSL_GUARDED_BY(mu_) = 0;
+
+  // Number of threads waiting for a task.
+  int num_idle_ ABSL_GUARDED_BY(mu_) = 0;
+
+  bool stop_ ABSL_GUARDED_BY(mu_) = false;
+
+  // Threads which are running, by id.
+  absl::flat_hash_map<std::thread::id, std::thread> threads_
+      ABSL_GUARDED_BY(mu_);
+
+  // Threads which have exited and are yet to be joined.
+  std::vector<std::thread> exited_threads_ ABSL_GUARDED_BY(mu_);
+};
+
+}  // namespace frontend
+}  // namespace emulator
+}  // namespace spanner
+}  // namespace google
+
+#endif  // THIRD_PARTY_CLOUD_SPANNER_EMULATOR_FRONTEND_SERVER_THREAD_POOL_H_
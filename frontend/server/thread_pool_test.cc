@@ -0,0 +1,92 @@
+//
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "frontend/server/thread_pool.h"
+
+#include <atomic>
+
+#include "gtest/gtest.h"
+#include "absl/synchronization/notification.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+
+namespace google {
+namespace spanner {
+namespace emulator {
+namespace frontend {
+namespace {
+
+TEST(ThreadPoolTest, RunsScheduledTasks) {
+  std::atomic<int> num_runs = 0;
+  {
+    ThreadPool pool(/*num_threads=*/4);
+    for (int i = 0; i < 100; ++i) {
+      pool.Schedule([&num_runs]() { ++num_runs; });
+    }
+  }
+  EXPECT_EQ(num_runs, 100);
+}
+
+TEST(ThreadPoolTest, LimitsActiveTasks) {
+  ThreadPool pool(/*num_threads=*/1);
+  absl::Notification release;
+  absl::Notification second_ran;
+  pool.Schedule([&release]() { release.WaitForNotification(); });
+  pool.Schedule([&second_ran]() { second_ran.Notify(); });
+
+  // The second task waits for the first one.
+  EXPECT_FALSE(second_ran.WaitForNotificationWithTimeout(
+      absl::Milliseconds(100)));
+  EXPECT_EQ(pool.NumThreads(), 1);
+  release.Notify();
+  EXPECT_TRUE(second_ran.WaitForNotificationWithTimeout(absl::Seconds(10)));
+}
+
+TEST(ThreadPoolTest, RetiresIdleThreads) {
+  ThreadPool pool(/*num_threads=*/4,
+                  /*idle_thread_timeout=*/absl::Milliseconds(10));
+  absl::Notification release;
+  std::atomic<int> num_started = 0;
+  for (int i = 0; i < 4; ++i) {
+    pool.Schedule([&release, &num_started]() {
+      ++num_started;
+      release.WaitForNotification();
+    });
+  }
+  while (num_started < 4) {
+    absl::SleepFor(absl::Milliseconds(1));
+  }
+  EXPECT_EQ(pool.NumThreads(), 4);
+  release.Notify();
+
+  // Threads exit once they have been idle for the timeout.
+  absl::Time deadline = absl::Now() + absl::Seconds(10);
+  while (pool.NumThreads() > 0 && absl::Now() < deadline) {
+    absl::SleepFor(absl::Milliseconds(1));
+  }
+  EXPECT_EQ(pool.NumThreads(), 0);
+
+  // New threads are started for tasks scheduled afterwards.
+  absl::Notification ran;
+  pool.Schedule([&ran]() { ran.Notify(); });
+  EXPECT_TRUE(ran.WaitForNotificationWithTimeout(absl::Seconds(10)));
+}
+
+}  // namespace
+}  // namespace frontend
+}  // namespace emulator
+}  // namespace spanner
+}  // namespace google
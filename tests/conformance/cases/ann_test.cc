@@ -14,6 +14,7 @@
 // limitations under the License.
 //
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -676,6 +677,84 @@ TEST_F(ANNTest, DropVectorIndex) {
       DROP VECTOR INDEX VI_drop
     )sql"}));
 }
+
+TEST_F(ANNTest, ANNQueryUsesVectorIndexOfPartitionedVectors) {
+  ZETASQL_ASSERT_OK(SetSchema({R"sql(
+    CREATE TABLE Points (
+      Id INT64 NOT NULL,
+      Embedding ARRAY<FLOAT64>(vector_length=>2),
+    ) PRIMARY KEY(Id)
+  )sql"}));
+  // Enough vectors to fill the leaves of the index, clustered around the
+  // corners of a square.
+  const double corners[4][2] = {
+      {100, 100}, {100, -100}, {-100, 100}, {-100, -100}};
+  std::vector<ValueRow> rows;
+  for (int64_t id = 0; id < 128; ++id) {
+    const double* corner = corners[id / 32];
+    rows.push_back({id, std::vector<double>{corner[0] + id % 32 % 8,
+                                            corner[1] + id % 32 / 8}});
+  }
+  ZETASQL_ASSERT_OK(MultiInsert("Points", {"Id", "Embedding"}, rows));
+  ZETASQL_ASSERT_OK(SetSchema({R"sql(
+    CREATE VECTOR INDEX PointsByEmbedding ON Points(Embedding)
+    WHERE Embedding IS NOT NULL
+    OPTIONS(distance_type = 'EUCLIDEAN', num_leaves = 4)
+  )sql"}));
+
+  const std::string query = R"sql(
+    SELECT p.Id FROM Points@{FORCE_INDEX=PointsByEmbedding} p
+    WHERE p.Embedding IS NOT NULL
+    ORDER BY APPROX_EUCLIDEAN_DISTANCE(
+      p.Embedding, ARRAY<FLOAT64>[100.2, 100.1],
+      options => JSON '{"num_leaves_to_search": 1}')
+    LIMIT 3)sql";
+  EXPECT_THAT(Query(query), IsOkAndHoldsRows({{0}, {1}, {8}}));
+
+  // Vectors written after the index is built are found as well.
+  ZETASQL_ASSERT_OK(Insert("Points", {"Id", "Embedding"},
+                   {1000, std::vector<double>{100.2, 100.1}}));
+  ZETASQL_ASSERT_OK(Delete("Points", Key(0)));
+  EXPECT_THAT(Query(query), IsOkAndHoldsRows({{1000}, {1}, {8}}));
+}
+
+TEST_F(ANNTest, ANNQueryReturnsNearestNeighborsAfterDeletes) {
+  ZETASQL_ASSERT_OK(SetSchema({R"sql(
+    CREATE TABLE Points (
+      Id INT64 NOT NULL,
+      Embedding ARRAY<FLOAT64>(vector_length=>2),
+    ) PRIMARY KEY(Id)
+  )sql"}));
+  const double corners[4][2] = {
+      {100, 100}, {100, -100}, {-100, 100}, {-100, -100}};
+  std::vector<ValueRow> rows;
+  for (int64_t id = 0; id < 128; ++id) {
+    const double* corner = corners[id / 32];
+    rows.push_back({id, std::vector<double>{corner[0] + id % 32 % 8,
+                                            corner[1] + id % 32 / 8}});
+  }
+  ZETASQL_ASSERT_OK(MultiInsert("Points", {"Id", "Embedding"}, rows));
+  ZETASQL_ASSERT_OK(SetSchema({R"sql(
+    CREATE VECTOR INDEX PointsByEmbedding ON Points(Embedding)
+    WHERE Embedding IS NOT NULL
+    OPTIONS(distance_type = 'EUCLIDEAN', num_leaves = 4)
+  )sql"}));
+
+  // Deletes the rows of the two leaves nearest to the query vector, so that
+  // the nearest neighbors left are in the third one.
+  ZETASQL_ASSERT_OK(Delete("Points", ClosedClosed(Key(0), Key(31))));
+  ZETASQL_ASSERT_OK(Delete("Points", ClosedClosed(Key(64), Key(95))));
+
+  EXPECT_THAT(Query(R"sql(
+    SELECT p.Id FROM Points@{FORCE_INDEX=PointsByEmbedding} p
+    WHERE p.Embedding IS NOT NULL
+    ORDER BY APPROX_EUCLIDEAN_DISTANCE(
+      p.Embedding, ARRAY<FLOAT64>[100, 100],
+      options => JSON '{"num_leaves_to_search": 1}')
+    LIMIT 3)sql"),
+              IsOkAndHoldsRows({{56}, {57}, {58}}));
+}
+
 }  // namespace
 
 }  // namespace test
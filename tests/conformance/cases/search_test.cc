@@ -1123,6 +1123,76 @@ TEST_P(SearchTest, SearchFailAfterDropSearchIndex) {
                        HasSubstr("index called summary_idx")));
 }
 
+TEST_P(SearchTest, SearchSeesWritesAfterIndexCreation) {
+  ZETASQL_ASSERT_OK(Update("albums", {"albumid", "summary"}, {1, "local top 50 song"}));
+  ZETASQL_ASSERT_OK(Delete("albums", Key(2)));
+  ZETASQL_ASSERT_OK(Insert("albums",
+                   {"albumid", "userid", "releasetimestamp", "uid", "summary"},
+                   {18, 1, 22, 0, "global hit"}));
+
+  std::string query = R"sql(
+          SELECT albumid
+          FROM albums@{force_index=albumindex}
+          WHERE SEARCH(summary_tokens, "global")
+            AND userid = 1
+          ORDER BY albumid ASC)sql";
+  EXPECT_THAT(Query(GetSqlQueryString(query)), IsOkAndHoldsRows({{18}}));
+
+  std::string local_query = R"sql(
+          SELECT albumid
+          FROM albums@{force_index=albumindex}
+          WHERE SEARCH(summary_tokens, "local | hit")
+          ORDER BY albumid ASC)sql";
+  EXPECT_THAT(Query(GetSqlQueryString(local_query)),
+              IsOkAndHoldsRows({{1}, {18}}));
+}
+
+TEST_P(SearchTest, SearchSeesRowsWrittenBeforeIndexCreation) {
+  ZETASQL_ASSERT_OK(UpdateSchema({R"sql(
+      CREATE TABLE songs (
+        songid INT64 NOT NULL,
+        lyrics STRING(MAX),
+        lyrics_tokens TOKENLIST AS (TOKENIZE_FULLTEXT(lyrics)) HIDDEN,
+      ) PRIMARY KEY(songid))sql"}));
+  ZETASQL_ASSERT_OK(MultiInsert("songs", {"songid", "lyrics"},
+                        {{1, "rock around the clock"},
+                         {2, "blue suede shoes"},
+                         {3, "jailhouse rock"}}));
+  ZETASQL_ASSERT_OK(UpdateSchema({R"sql(
+      CREATE SEARCH INDEX lyrics_idx ON songs(lyrics_tokens))sql"}));
+  ZETASQL_ASSERT_OK(Insert("songs", {"songid", "lyrics"}, {4, "rock lobster"}));
+
+  std::string query = R"sql(
+          SELECT songid
+          FROM songs@{force_index=lyrics_idx}
+          WHERE SEARCH(lyrics_tokens, "rock")
+          ORDER BY songid ASC)sql";
+  EXPECT_THAT(Query(GetSqlQueryString(query)),
+              IsOkAndHoldsRows({{1}, {3}, {4}}));
+}
+
+TEST_P(SearchTest, SearchNgramsSeesWritesAfterIndexCreation) {
+  ZETASQL_ASSERT_OK(Update("albums", {"albumid", "name"}, {16, "classic jazz"}));
+  ZETASQL_ASSERT_OK(Insert("albums",
+                   {"albumid", "userid", "releasetimestamp", "uid", "name"},
+                   {18, 1, 22, 0, "progressive rock"}));
+
+  std::string query = R"sql(
+          SELECT albumid
+          FROM albums@{force_index=albumindex}
+          WHERE SEARCH_NGRAMS(Name_Ngrams_Tokens, 'rock')
+            AND userid = 1
+          ORDER BY albumid ASC)sql";
+  EXPECT_THAT(Query(GetSqlQueryString(query)), IsOkAndHoldsRows({{17}, {18}}));
+
+  std::string fuzzy_query = R"sql(
+          SELECT albumid
+          FROM albums@{force_index=albumindex}
+          WHERE SEARCH_NGRAMS(Name_Ngrams_Tokens, 'progresive', min_ngrams=>5)
+          ORDER BY albumid ASC)sql";
+  EXPECT_THAT(Query(GetSqlQueryString(fuzzy_query)), IsOkAndHoldsRows({{18}}));
+}
+
 TEST_P(SearchTest, ProjectTokenlistFailColRef) {
   std::string query = R"sql(
       SELECT albumid, length_tokens
@@ -64,10 +64,12 @@ zetasql::FunctionEvaluator PGFunctionEvaluator(
   return [function, on_compute_begin,
           on_compute_end](absl::Span<const zetasql::Value> args)
              -> absl::StatusOr<zetasql::Value> {
-    // Binds PG memory context arena to thread local
+    // Binds the PG memory context cached on this thread, which is reset once
+    // the arena goes out of scope at the end of this call.
     ZETASQL_VLOG(1) << "Creating PG arena and Evaluating PG function";
     absl::StatusOr<std::unique_ptr<postgres_translator::interfaces::PGArena>>
-        status_or = postgres_translator::interfaces::CreatePGArena(nullptr);
+        status_or =
+            postgres_translator::interfaces::CreateThreadLocalPGArena(nullptr);
     if (!status_or.ok()) {
       ABSL_LOG(WARNING) << "Tried to create PG arena but failed: "
                    << status_or.status();
@@ -68,6 +68,7 @@
 #include "absl/status/statusor.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/escaping.h"
+#include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
 #include "absl/types/span.h"
 #include "zetasql/base/mathutil.h"
@@ -79,6 +80,7 @@
 #include "third_party/spanner_pg/catalog/emulator_function_evaluators.h"
 #include "third_party/spanner_pg/catalog/jsonb_array_elements_table_valued_function.h"
 #include "third_party/spanner_pg/datatypes/common/jsonb/jsonb_value.h"
+#include "third_party/spanner_pg/datatypes/common/pg_numeric_arithmetic.h"
 #include "third_party/spanner_pg/datatypes/common/pg_numeric_parse.h"
 #include "third_party/spanner_pg/datatypes/extended/pg_jsonb_conversion_functions.h"
 #include "third_party/spanner_pg/datatypes/extended/pg_jsonb_type.h"
@@ -107,12 +109,18 @@ using spangres::datatypes::CreatePgNumericValue;
 using spangres::datatypes::CreatePgNumericValueWithMemoryContext;
 using spangres::datatypes::CreatePgNumericValueWithPrecisionAndScale;
 using spangres::datatypes::GetPgJsonbNormalizedValue;
+using spangres::datatypes::GetPgJsonbParsedValue;
 using spangres::datatypes::GetPgNumericNormalizedValue;
 using spangres::datatypes::GetPgOidValue;
 using spangres::datatypes::common::jsonb::IsValidJsonbString;
 using spangres::datatypes::common::jsonb::SerializeJsonbString;
 using spangres::datatypes::common::jsonb::PgJsonbValue;
 using spangres::datatypes::common::jsonb::TreeNode;
+using spangres::datatypes::common::AbsPgNumeric;
+using spangres::datatypes::common::AddPgNumerics;
+using spangres::datatypes::common::MultiplyPgNumerics;
+using spangres::datatypes::common::NegatePgNumeric;
+using spangres::datatypes::common::SubtractPgNumerics;
 
 using ::zetasql::FunctionArgumentType;
 using ::zetasql::FunctionArgumentTypeOptions;
@@ -166,7 +174,6 @@ using ::postgres_translator::function_evaluators::CastNumericToInt8;
 using ::postgres_translator::function_evaluators::Ceil;
 using ::postgres_translator::function_evaluators::CleanupPostgresDateTimeCache;
 using ::postgres_translator::function_evaluators::CleanupPostgresNumberCache;
-using ::postgres_translator::function_evaluators::CleanupRegexCache;
 using ::postgres_translator::function_evaluators::DateMii;
 using ::postgres_translator::function_evaluators::DatePli;
 using ::postgres_translator::function_evaluators::Divide;
@@ -209,6 +216,29 @@ using ::postgres_translator::function_evaluators::PgMakeInterval;
 
 using ::postgres_translator::InitializePGTimezoneToDefault;
 
+using NativeFunction =
+    std::function<absl::StatusOr<std::optional<zetasql::Value>>(
+        absl::Span<const zetasql::Value>)>;
+
+// Returns an evaluator that computes `native_function` without a PG memory
+// context. `native_function` returns std::nullopt for the arguments it leaves
+// to PostgreSQL, which are evaluated by `pg_function` in a PG memory context.
+zetasql::FunctionEvaluator NativeFunctionEvaluator(
+    NativeFunction native_function,
+    const zetasql::FunctionEvaluator& pg_function) {
+  return [native_function = std::move(native_function),
+          pg_evaluator = PGFunctionEvaluator(pg_function)](
+             absl::Span<const zetasql::Value> args)
+             -> absl::StatusOr<zetasql::Value> {
+    ZETASQL_ASSIGN_OR_RETURN(std::optional<zetasql::Value> result,
+                     native_function(args));
+    if (result.has_value()) {
+      return *std::move(result);
+    }
+    return pg_evaluator(args);
+  };
+}
+
 // PG array functions
 
 // Used by both array_upper and array_length because they return the same
@@ -305,7 +335,7 @@ std::unique_ptr<zetasql::Function> TextregexneFunction(
     absl::string_view catalog_name) {
   zetasql::FunctionOptions function_options;
   function_options.set_evaluator(PGFunctionEvaluator(
-      EvalTextregexne, InitializePGTimezoneToDefault, CleanupRegexCache));
+      EvalTextregexne, InitializePGTimezoneToDefault));
   return std::make_unique<zetasql::Function>(
       kPGTextregexneFunctionName, catalog_name, zetasql::Function::SCALAR,
       std::vector<zetasql::FunctionSignature>{zetasql::FunctionSignature{
@@ -514,6 +544,42 @@ std::unique_ptr<zetasql::Function> ToNumberFunction(
 
 // PG.NUMERIC Mathematical functions
 
+// Native implementations of the most common PG.NUMERIC operators. They return
+// std::nullopt for NULL arguments and for the values that they leave to the
+// PostgreSQL implementations below.
+absl::StatusOr<std::optional<zetasql::Value>> EvalNativeNumericUnary(
+    absl::Span<const zetasql::Value> args,
+    std::optional<std::string> (*function)(absl::string_view)) {
+  ZETASQL_RET_CHECK(args.size() == 1);
+  if (args[0].is_null()) {
+    return std::nullopt;
+  }
+  ZETASQL_ASSIGN_OR_RETURN(absl::Cord value, GetPgNumericNormalizedValue(args[0]));
+  std::optional<std::string> result = function(std::string(value));
+  if (!result.has_value()) {
+    return std::nullopt;
+  }
+  return CreatePgNumericValue(*result);
+}
+
+absl::StatusOr<std::optional<zetasql::Value>> EvalNativeNumericBinary(
+    absl::Span<const zetasql::Value> args,
+    std::optional<std::string> (*function)(absl::string_view,
+                                           absl::string_view)) {
+  ZETASQL_RET_CHECK(args.size() == 2);
+  if (args[0].is_null() || args[1].is_null()) {
+    return std::nullopt;
+  }
+  ZETASQL_ASSIGN_OR_RETURN(absl::Cord lhs, GetPgNumericNormalizedValue(args[0]));
+  ZETASQL_ASSIGN_OR_RETURN(absl::Cord rhs, GetPgNumericNormalizedValue(args[1]));
+  std::optional<std::string> result =
+      function(std::string(lhs), std::string(rhs));
+  if (!result.has_value()) {
+    return std::nullopt;
+  }
+  return CreatePgNumericValue(*result);
+}
+
 absl::StatusOr<zetasql::Value> EvalZetaSQLAbs(
     absl::Span<const zetasql::Value> args) {
   static const zetasql::Type* gsql_pg_numeric =
@@ -537,7 +603,11 @@ std::unique_ptr<zetasql::Function> NumericAbsFunction(
       spangres::datatypes::GetPgNumericType();
 
   zetasql::FunctionOptions function_options;
-  function_options.set_evaluator(PGFunctionEvaluator(EvalZetaSQLAbs));
+  function_options.set_evaluator(NativeFunctionEvaluator(
+      [](absl::Span<const zetasql::Value> args) {
+        return EvalNativeNumericUnary(args, AbsPgNumeric);
+      },
+      EvalZetaSQLAbs));
   return std::make_unique<zetasql::Function>(
     kZetaSQLAbsFunctionName, catalog_name, zetasql::Function::SCALAR,
       std::vector<zetasql::FunctionSignature>{zetasql::FunctionSignature{
@@ -565,7 +635,11 @@ std::unique_ptr<zetasql::Function> NumericAddFunction(
   const zetasql::Type* gsql_pg_numeric =
       postgres_translator::spangres::datatypes::GetPgNumericType();
   zetasql::FunctionOptions function_options;
-  function_options.set_evaluator(PGFunctionEvaluator(EvalZetaSQLAdd));
+  function_options.set_evaluator(NativeFunctionEvaluator(
+      [](absl::Span<const zetasql::Value> args) {
+        return EvalNativeNumericBinary(args, AddPgNumerics);
+      },
+      EvalZetaSQLAdd));
 
   return std::make_unique<zetasql::Function>(
       kZetaSQLAddFunctionName, catalog_name, zetasql::Function::SCALAR,
@@ -760,7 +834,11 @@ std::unique_ptr<zetasql::Function> NumericMultiplyFunction(
   const zetasql::Type* gsql_pg_numeric =
       postgres_translator::spangres::datatypes::GetPgNumericType();
   zetasql::FunctionOptions function_options;
-  function_options.set_evaluator(PGFunctionEvaluator(EvalZetaSQLMultiply));
+  function_options.set_evaluator(NativeFunctionEvaluator(
+      [](absl::Span<const zetasql::Value> args) {
+        return EvalNativeNumericBinary(args, MultiplyPgNumerics);
+      },
+      EvalZetaSQLMultiply));
 
   return std::make_unique<zetasql::Function>(
       kZetaSQLMultiplyFunctionName, catalog_name, zetasql::Function::SCALAR,
@@ -792,7 +870,11 @@ std::unique_ptr<zetasql::Function> NumericSubtractFunction(
   const zetasql::Type* gsql_pg_numeric =
       postgres_translator::spangres::datatypes::GetPgNumericType();
   zetasql::FunctionOptions function_options;
-  function_options.set_evaluator(PGFunctionEvaluator(EvalZetaSQLSubtract));
+  function_options.set_evaluator(NativeFunctionEvaluator(
+      [](absl::Span<const zetasql::Value> args) {
+        return EvalNativeNumericBinary(args, SubtractPgNumerics);
+      },
+      EvalZetaSQLSubtract));
 
   return std::make_unique<zetasql::Function>(
       kZetaSQLSubtractFunctionName, catalog_name, zetasql::Function::SCALAR,
@@ -861,7 +943,11 @@ std::unique_ptr<zetasql::Function> NumericUminusFunction(
       spangres::datatypes::GetPgNumericType();
 
   zetasql::FunctionOptions function_options;
-  function_options.set_evaluator(PGFunctionEvaluator(EvalZetaSQLUminus));
+  function_options.set_evaluator(NativeFunctionEvaluator(
+      [](absl::Span<const zetasql::Value> args) {
+        return EvalNativeNumericUnary(args, NegatePgNumeric);
+      },
+      EvalZetaSQLUminus));
   return std::make_unique<zetasql::Function>(
       kZetaSQLUminusFunctionName, catalog_name, zetasql::Function::SCALAR,
       std::vector<zetasql::FunctionSignature>{zetasql::FunctionSignature{
@@ -1046,7 +1132,7 @@ std::unique_ptr<zetasql::Function> RegexpMatchFunction(
     absl::string_view catalog_name) {
   zetasql::FunctionOptions function_options;
   function_options.set_evaluator(PGFunctionEvaluator(
-      EvalRegexpMatch, InitializePGTimezoneToDefault, CleanupRegexCache));
+      EvalRegexpMatch, InitializePGTimezoneToDefault));
   return std::make_unique<zetasql::Function>(
       kPGRegexpMatchFunctionName, catalog_name, zetasql::Function::SCALAR,
       std::vector<zetasql::FunctionSignature>{
@@ -1093,9 +1179,8 @@ absl::StatusOr<zetasql::Value> EvalRegexpSplitToArray(
 std::unique_ptr<zetasql::Function> RegexpSplitToArrayFunction(
     absl::string_view catalog_name) {
   zetasql::FunctionOptions function_options;
-  function_options.set_evaluator(
-      PGFunctionEvaluator(EvalRegexpSplitToArray, InitializePGTimezoneToDefault,
-                          CleanupRegexCache));
+  function_options.set_evaluator(PGFunctionEvaluator(
+      EvalRegexpSplitToArray, InitializePGTimezoneToDefault));
   return std::make_unique<zetasql::Function>(
       kPGRegexpSplitToArrayFunctionName, catalog_name,
       zetasql::Function::SCALAR,
@@ -1131,7 +1216,7 @@ std::unique_ptr<zetasql::Function> SubstringFunction(
     absl::string_view catalog_name) {
   zetasql::FunctionOptions function_options;
   function_options.set_evaluator(PGFunctionEvaluator(
-      EvalSubstring, InitializePGTimezoneToDefault, CleanupRegexCache));
+      EvalSubstring, InitializePGTimezoneToDefault));
   return std::make_unique<zetasql::Function>(
       kPGSubstringFunctionName, catalog_name, zetasql::Function::SCALAR,
       std::vector<zetasql::FunctionSignature>{
@@ -1965,6 +2050,54 @@ std::unique_ptr<zetasql::Function> CastFromJsonbFunction(
       function_options);
 }
 
+// Looks up the element of a PG.JSONB value addressed by a subscript and
+// stores it in `*element`, or std::nullopt if it doesn't exist. Returns false
+// if the subscript has to be evaluated by PostgreSQL instead: scalar roots
+// behave like single element arrays there and are left to it.
+bool NativeJsonbSubscript(const zetasql::Value& jsonb,
+                          const zetasql::Value& subscript,
+                          std::optional<PgJsonbValue>* element) {
+  absl::StatusOr<const PgJsonbValue*> root = GetPgJsonbParsedValue(jsonb);
+  if (!root.ok()) {
+    return false;
+  }
+  if (subscript.type_kind() == zetasql::TYPE_INT64) {
+    if (!(*root)->IsArray() && !(*root)->IsObject()) {
+      return false;
+    }
+    *element = (*root)->GetArrayElementIfExists(
+        static_cast<int32_t>(subscript.int64_value()));
+  } else {
+    *element = (*root)->GetMemberIfExists(subscript.string_value());
+  }
+  return true;
+}
+
+absl::StatusOr<std::optional<zetasql::Value>> EvalNativeJsonbSubscriptText(
+    absl::Span<const zetasql::Value> args) {
+  ZETASQL_RET_CHECK(args.size() == 2);
+  if (args[0].is_null() || args[1].is_null() ||
+      (args[1].type_kind() != zetasql::TYPE_INT64 &&
+       args[1].type_kind() != zetasql::TYPE_STRING)) {
+    return std::nullopt;
+  }
+  std::optional<PgJsonbValue> element;
+  if (!NativeJsonbSubscript(args[0], args[1], &element)) {
+    return std::nullopt;
+  }
+  if (!element.has_value() || element->IsNull()) {
+    return zetasql::Value::NullString();
+  }
+  if (element->IsString()) {
+    // Escaped strings are unescaped by PostgreSQL.
+    if (absl::StrContains(element->GetSerializedString(), '\\')) {
+      return std::nullopt;
+    }
+    return zetasql::Value::String(element->GetString());
+  }
+  return zetasql::Value::String(std::string(element->Serialize()));
+}
+
 absl::StatusOr<zetasql::Value> EvalJsonbSubscriptText(
     absl::Span<const zetasql::Value> args) {
   ZETASQL_RET_CHECK(args.size() == 2);
@@ -1991,7 +2124,8 @@ std::unique_ptr<zetasql::Function> JsonbSubscriptTextFunction(
   const zetasql::Type* gsql_pg_jsonb =
       postgres_translator::spangres::datatypes::GetPgJsonbType();
   zetasql::FunctionOptions function_options;
-  function_options.set_evaluator(PGFunctionEvaluator(EvalJsonbSubscriptText));
+  function_options.set_evaluator(
+      NativeFunctionEvaluator(EvalNativeJsonbSubscriptText, EvalJsonbSubscriptText));
   return std::make_unique<zetasql::Function>(
       kPGJsonbSubscriptTextFunctionName, catalog_name,
       zetasql::Function::SCALAR,
@@ -2006,6 +2140,31 @@ std::unique_ptr<zetasql::Function> JsonbSubscriptTextFunction(
       function_options);
 }
 
+absl::StatusOr<std::optional<zetasql::Value>> EvalNativeSubscript(
+    absl::Span<const zetasql::Value> args) {
+  ZETASQL_RET_CHECK(args.size() == 2);
+  if (args[0].is_null() || args[1].is_null() ||
+      (args[1].type_kind() != zetasql::TYPE_INT64 &&
+       args[1].type_kind() != zetasql::TYPE_STRING)) {
+    return std::nullopt;
+  }
+  // Out of range array indexes are reported by PostgreSQL.
+  if (args[1].type_kind() == zetasql::TYPE_INT64 &&
+      (args[1].int64_value() < std::numeric_limits<int32_t>::min() ||
+       args[1].int64_value() > std::numeric_limits<int32_t>::max())) {
+    return std::nullopt;
+  }
+  std::optional<PgJsonbValue> element;
+  if (!NativeJsonbSubscript(args[0], args[1], &element)) {
+    return std::nullopt;
+  }
+  if (!element.has_value()) {
+    return zetasql::Value::Null(
+        postgres_translator::spangres::datatypes::GetPgJsonbType());
+  }
+  return CreatePgJsonbValueFromNormalized(element->Serialize());
+}
+
 absl::StatusOr<zetasql::Value> EvalSubscript(
   absl::Span<const zetasql::Value> args) {
   ZETASQL_RET_CHECK(args.size() == 2);
@@ -2032,7 +2191,8 @@ std::unique_ptr<zetasql::Function> ZetaSQLSubscriptFunction(
   const zetasql::Type* gsql_pg_jsonb =
       postgres_translator::spangres::datatypes::GetPgJsonbType();
   zetasql::FunctionOptions function_options;
-  function_options.set_evaluator(PGFunctionEvaluator(EvalSubscript));
+  function_options.set_evaluator(
+      NativeFunctionEvaluator(EvalNativeSubscript, EvalSubscript));
   return std::make_unique<zetasql::Function>(
       kZetaSQLSubscriptFunctionName, catalog_name,
       zetasql::Function::SCALAR,
@@ -3236,7 +3396,7 @@ class MinMaxNumericEvaluator : public zetasql::AggregateFunctionEvaluator {
     // called by LessThan().
     ZETASQL_ASSIGN_OR_RETURN(
         std::unique_ptr<postgres_translator::interfaces::PGArena> arena,
-        postgres_translator::interfaces::CreatePGArena(nullptr));
+        postgres_translator::interfaces::CreateThreadLocalPGArena(nullptr));
 
     if (is_min_ && !result_.LessThan(value)) {
       // Evaluating as MIN().
@@ -3383,7 +3543,7 @@ class SumEvaluator : public zetasql::AggregateFunctionEvaluator {
       // CreatePgNumericValue() and EvalZetaSQLAdd().
       ZETASQL_ASSIGN_OR_RETURN(
           std::unique_ptr<postgres_translator::interfaces::PGArena> arena,
-          postgres_translator::interfaces::CreatePGArena(nullptr));
+          postgres_translator::interfaces::CreateThreadLocalPGArena(nullptr));
       ZETASQL_ASSIGN_OR_RETURN(auto value_as_numeric,
                        CreatePgNumericValue(absl::StrCat(value.int64_value())));
       ZETASQL_ASSIGN_OR_RETURN(
@@ -3421,7 +3581,7 @@ class SumEvaluator : public zetasql::AggregateFunctionEvaluator {
       // EvalZetaSQLAdd().
       ZETASQL_ASSIGN_OR_RETURN(
           std::unique_ptr<postgres_translator::interfaces::PGArena> arena,
-          postgres_translator::interfaces::CreatePGArena(nullptr));
+          postgres_translator::interfaces::CreateThreadLocalPGArena(nullptr));
       ZETASQL_ASSIGN_OR_RETURN(result_,
                        EvalZetaSQLAdd(absl::MakeConstSpan({result_, value})));
     }  // No else because we've already validated the type above.
@@ -3511,7 +3671,7 @@ class AvgEvaluator : public SumEvaluator {
     // CreatePgNumericValue() and EvalZetaSQLDivide().
     ZETASQL_ASSIGN_OR_RETURN(
         std::unique_ptr<postgres_translator::interfaces::PGArena> arena,
-        postgres_translator::interfaces::CreatePGArena(nullptr));
+        postgres_translator::interfaces::CreateThreadLocalPGArena(nullptr));
     ZETASQL_ASSIGN_OR_RETURN(auto count_as_numeric,
                      CreatePgNumericValue(absl::StrCat(count_)));
     return EvalZetaSQLDivide(
@@ -40,7 +40,7 @@ namespace postgres_translator {
 
 namespace {
 
-using ::postgres_translator::interfaces::CreatePGArena;
+using ::postgres_translator::interfaces::CreateThreadLocalPGArena;
 using ::postgres_translator::interfaces::PGArena;
 using ::postgres_translator::spangres::datatypes::
     CreatePgJsonbValueFromNormalized;
@@ -84,7 +84,7 @@ class JsonbArrayElementsEvaluator : public zetasql::EvaluatorTableIterator {
     // Set up the PG memory context arena in case we call into native PG code.
     ZETASQL_ASSIGN_OR_RETURN(
         std::unique_ptr<postgres_translator::interfaces::PGArena> pg_arena,
-        CreatePGArena(nullptr));
+        CreateThreadLocalPGArena(nullptr));
 
     // Parse the input.
     ZETASQL_ASSIGN_OR_RETURN(absl::Cord jsonb, GetPgJsonbNormalizedValue(input_));
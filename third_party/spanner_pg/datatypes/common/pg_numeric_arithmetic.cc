@@ -0,0 +1,413 @@
+//
+// PostgreSQL is released under the PostgreSQL License, a liberal Open Source
+// license, similar to the BSD or MIT licenses.
+//
+// PostgreSQL Database Management System
+// (formerly known as Postgres, then as Postgres95)
+//
+// Portions Copyright © 1996-2020, The PostgreSQL Global Development Group
+//
+// Portions Copyright © 1994, The Regents of the University of California
+//
+// Portions Copyright 2023 Google LLC
+//
+// Permission to use, copy, modify, and distribute this software and its
+// documentation for any purpose, without fee, and without a written agreement
+// is hereby granted, provided that the above copyright notice and this
+// paragraph and the following two paragraphs appear in all copies.
+//
+// IN NO EVENT SHALL THE UNIVERSITY OF CALIFORNIA BE LIABLE TO ANY PARTY FOR
+// DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+// LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+// EVEN IF THE UNIVERSITY OF CALIFORNIA HAS BEEN ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+//
+// THE UNIVERSITY OF CALIFORNIA SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+// INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+// FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON AN
+// "AS IS" BASIS, AND THE UNIVERSITY OF CALIFORNIA HAS NO OBLIGATIONS TO PROVIDE
+// MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+//------------------------------------------------------------------------------
+
+#include "third_party/spanner_pg/datatypes/common/pg_numeric_arithmetic.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "third_party/spanner_pg/datatypes/common/numeric_core.h"
+
+namespace postgres_translator::spangres::datatypes::common {
+
+namespace {
+
+// Digits are stored in base 10^9 limbs, the largest power of ten whose
+// products fit in 64 bits along with a carry.
+constexpr uint32_t kLimbBase = 1000000000;
+constexpr int kLimbDigits = 9;
+constexpr uint32_t kPowersOfTen[kLimbDigits] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000};
+
+// A normalized PG.NUMERIC value split into its components.
+struct NumericParts {
+  bool negative = false;
+  absl::string_view whole;
+  absl::string_view fraction;
+};
+
+bool AllDigits(absl::string_view digits) {
+  return std::all_of(digits.begin(), digits.end(), absl::ascii_isdigit);
+}
+
+bool IsNaN(absl::string_view value) { return value == kPGNumericNaN; }
+
+// Splits a normalized, finite `value`. Returns std::nullopt if `value` is not
+// normalized.
+std::optional<NumericParts> Split(absl::string_view value) {
+  NumericParts parts;
+  if (!value.empty() && value.front() == '-') {
+    parts.negative = true;
+    value.remove_prefix(1);
+  }
+  const size_t point = value.find('.');
+  parts.whole = value.substr(0, point);
+  if (point != absl::string_view::npos) {
+    parts.fraction = value.substr(point + 1);
+    if (parts.fraction.empty()) {
+      return std::nullopt;
+    }
+  }
+  if (parts.whole.empty() || parts.whole.size() > kMaxPGNumericWholeDigits ||
+      parts.fraction.size() > kMaxPGNumericFractionalDigits ||
+      (parts.whole.size() > 1 && parts.whole.front() == '0') ||
+      !AllDigits(parts.whole) || !AllDigits(parts.fraction)) {
+    return std::nullopt;
+  }
+  // PostgreSQL never prints a sign for zero.
+  if (parts.negative && parts.whole == "0" &&
+      parts.fraction.find_first_not_of('0') == absl::string_view::npos) {
+    return std::nullopt;
+  }
+  return parts;
+}
+
+// A finite decimal equal to (-1)^negative * coefficient * 10^-scale. The
+// coefficient is stored in little-endian limbs without leading zero limbs, so
+// that zero has no limbs.
+struct Decimal {
+  bool negative = false;
+  std::vector<uint32_t> coefficient;
+  int scale = 0;
+};
+
+void TrimLeadingZeroLimbs(std::vector<uint32_t>& limbs) {
+  while (!limbs.empty() && limbs.back() == 0) {
+    limbs.pop_back();
+  }
+}
+
+Decimal ToDecimal(const NumericParts& parts) {
+  const std::string digits = absl::StrCat(parts.whole, parts.fraction);
+  Decimal decimal;
+  decimal.negative = parts.negative;
+  decimal.scale = static_cast<int>(parts.fraction.size());
+  decimal.coefficient.reserve(digits.size() / kLimbDigits + 1);
+  for (size_t end = digits.size(); end > 0;) {
+    const size_t begin = end > kLimbDigits ? end - kLimbDigits : 0;
+    uint32_t limb = 0;
+    for (size_t i = begin; i < end; ++i) {
+      limb = limb * 10 + (digits[i] - '0');
+    }
+    decimal.coefficient.push_back(limb);
+    end = begin;
+  }
+  TrimLeadingZeroLimbs(decimal.coefficient);
+  return decimal;
+}
+
+// Multiplies `limbs` by 10^`exponent`.
+void ShiftLeft(std::vector<uint32_t>& limbs, int exponent) {
+  if (limbs.empty() || exponent == 0) {
+    return;
+  }
+  limbs.insert(limbs.begin(), exponent / kLimbDigits, 0);
+  const uint32_t factor = kPowersOfTen[exponent % kLimbDigits];
+  if (factor == 1) {
+    return;
+  }
+  uint64_t carry = 0;
+  for (uint32_t& limb : limbs) {
+    const uint64_t product = static_cast<uint64_t>(limb) * factor + carry;
+    limb = static_cast<uint32_t>(product % kLimbBase);
+    carry = product / kLimbBase;
+  }
+  if (carry != 0) {
+    limbs.push_back(static_cast<uint32_t>(carry));
+  }
+}
+
+// Brings `lhs` and `rhs` to the same scale.
+void Align(Decimal& lhs, Decimal& rhs) {
+  if (lhs.scale < rhs.scale) {
+    ShiftLeft(lhs.coefficient, rhs.scale - lhs.scale);
+    lhs.scale = rhs.scale;
+  } else if (rhs.scale < lhs.scale) {
+    ShiftLeft(rhs.coefficient, lhs.scale - rhs.scale);
+    rhs.scale = lhs.scale;
+  }
+}
+
+int CompareMagnitudes(const std::vector<uint32_t>& lhs,
+                      const std::vector<uint32_t>& rhs) {
+  if (lhs.size() != rhs.size()) {
+    return lhs.size() < rhs.size() ? -1 : 1;
+  }
+  for (size_t i = lhs.size(); i > 0; --i) {
+    if (lhs[i - 1] != rhs[i - 1]) {
+      return lhs[i - 1] < rhs[i - 1] ? -1 : 1;
+    }
+  }
+  return 0;
+}
+
+std::vector<uint32_t> AddMagnitudes(const std::vector<uint32_t>& lhs,
+                                    const std::vector<uint32_t>& rhs) {
+  const std::vector<uint32_t>& longer = lhs.size() >= rhs.size() ? lhs : rhs;
+  const std::vector<uint32_t>& shorter = lhs.size() >= rhs.size() ? rhs : lhs;
+  std::vector<uint32_t> sum;
+  sum.reserve(longer.size() + 1);
+  uint32_t carry = 0;
+  for (size_t i = 0; i < longer.size(); ++i) {
+    uint32_t limb = longer[i] + carry + (i < shorter.size() ? shorter[i] : 0);
+    carry = limb >= kLimbBase ? 1 : 0;
+    sum.push_back(limb - carry * kLimbBase);
+  }
+  if (carry != 0) {
+    sum.push_back(carry);
+  }
+  return sum;
+}
+
+// Returns `larger` - `smaller`. Requires `larger` >= `smaller`.
+std::vector<uint32_t> SubtractMagnitudes(const std::vector<uint32_t>& larger,
+                                         const std::vector<uint32_t>& smaller) {
+  std::vector<uint32_t> difference;
+  difference.reserve(larger.size());
+  uint32_t borrow = 0;
+  for (size_t i = 0; i < larger.size(); ++i) {
+    const uint32_t subtrahend =
+        borrow + (i < smaller.size() ? smaller[i] : 0);
+    if (larger[i] >= subtrahend) {
+      difference.push_back(larger[i] - subtrahend);
+      borrow = 0;
+    } else {
+      difference.push_back(larger[i] + kLimbBase - subtrahend);
+      borrow = 1;
+    }
+  }
+  TrimLeadingZeroLimbs(difference);
+  return difference;
+}
+
+std::vector<uint32_t> MultiplyMagnitudes(const std::vector<uint32_t>& lhs,
+                                         const std::vector<uint32_t>& rhs) {
+  if (lhs.empty() || rhs.empty()) {
+    return {};
+  }
+  std::vector<uint32_t> product(lhs.size() + rhs.size(), 0);
+  for (size_t i = 0; i < lhs.size(); ++i) {
+    uint64_t carry = 0;
+    for (size_t j = 0; j < rhs.size(); ++j) {
+      const uint64_t limb = product[i + j] +
+                            static_cast<uint64_t>(lhs[i]) * rhs[j] + carry;
+      product[i + j] = static_cast<uint32_t>(limb % kLimbBase);
+      carry = limb / kLimbBase;
+    }
+    product[i + rhs.size()] = static_cast<uint32_t>(carry);
+  }
+  TrimLeadingZeroLimbs(product);
+  return product;
+}
+
+// Prints `decimal` in normalized representation. Returns std::nullopt if the
+// value is out of the range of PG.NUMERIC.
+std::optional<std::string> Print(const Decimal& decimal) {
+  std::string digits;
+  if (decimal.coefficient.empty()) {
+    digits = "0";
+  } else {
+    digits = absl::StrCat(decimal.coefficient.back());
+    for (size_t i = decimal.coefficient.size() - 1; i > 0; --i) {
+      const std::string limb = absl::StrCat(decimal.coefficient[i - 1]);
+      digits.append(kLimbDigits - limb.size(), '0');
+      digits.append(limb);
+    }
+  }
+  const size_t scale = decimal.scale;
+  if (digits.size() <= scale) {
+    digits.insert(0, scale + 1 - digits.size(), '0');
+  }
+  if (digits.size() - scale > kMaxPGNumericWholeDigits) {
+    return std::nullopt;
+  }
+  if (scale > 0) {
+    digits.insert(digits.size() - scale, 1, '.');
+  }
+  if (decimal.negative && !decimal.coefficient.empty()) {
+    digits.insert(0, 1, '-');
+  }
+  return digits;
+}
+
+std::optional<std::string> Add(absl::string_view lhs, absl::string_view rhs,
+                               bool negate_rhs) {
+  if (IsNaN(lhs) || IsNaN(rhs)) {
+    return IsNormalizedPgNumeric(lhs) && IsNormalizedPgNumeric(rhs)
+               ? std::make_optional<std::string>(kPGNumericNaN)
+               : std::nullopt;
+  }
+  std::optional<NumericParts> lhs_parts = Split(lhs);
+  std::optional<NumericParts> rhs_parts = Split(rhs);
+  if (!lhs_parts.has_value() || !rhs_parts.has_value()) {
+    return std::nullopt;
+  }
+  Decimal x = ToDecimal(*lhs_parts);
+  Decimal y = ToDecimal(*rhs_parts);
+  y.negative ^= negate_rhs;
+  Align(x, y);
+
+  // Like PostgreSQL, the result keeps the larger scale of the inputs.
+  Decimal sum;
+  sum.scale = x.scale;
+  if (x.negative == y.negative) {
+    sum.negative = x.negative;
+    sum.coefficient = AddMagnitudes(x.coefficient, y.coefficient);
+  } else if (CompareMagnitudes(x.coefficient, y.coefficient) >= 0) {
+    sum.negative = x.negative;
+    sum.coefficient = SubtractMagnitudes(x.coefficient, y.coefficient);
+  } else {
+    sum.negative = y.negative;
+    sum.coefficient = SubtractMagnitudes(y.coefficient, x.coefficient);
+  }
+  return Print(sum);
+}
+
+}  // namespace
+
+bool IsNormalizedPgNumeric(absl::string_view value) {
+  return IsNaN(value) || Split(value).has_value();
+}
+
+std::optional<int> ComparePgNumerics(absl::string_view lhs,
+                                     absl::string_view rhs) {
+  if (IsNaN(lhs) || IsNaN(rhs)) {
+    if (!IsNormalizedPgNumeric(lhs) || !IsNormalizedPgNumeric(rhs)) {
+      return std::nullopt;
+    }
+    return static_cast<int>(IsNaN(lhs)) - static_cast<int>(IsNaN(rhs));
+  }
+  std::optional<NumericParts> x = Split(lhs);
+  std::optional<NumericParts> y = Split(rhs);
+  if (!x.has_value() || !y.has_value()) {
+    return std::nullopt;
+  }
+  if (x->negative != y->negative) {
+    return x->negative ? -1 : 1;
+  }
+
+  // Whole parts have no leading zeros, so the longer one is larger.
+  int magnitude = 0;
+  if (x->whole.size() != y->whole.size()) {
+    magnitude = x->whole.size() < y->whole.size() ? -1 : 1;
+  } else if (int cmp = x->whole.compare(y->whole); cmp != 0) {
+    magnitude = cmp < 0 ? -1 : 1;
+  } else {
+    // Compare the fractions as if the shorter one was padded with zeros.
+    const size_t common = std::min(x->fraction.size(), y->fraction.size());
+    if (int cmp = x->fraction.substr(0, common).compare(
+            y->fraction.substr(0, common));
+        cmp != 0) {
+      magnitude = cmp < 0 ? -1 : 1;
+    } else if (x->fraction.substr(common).find_first_not_of('0') !=
+               absl::string_view::npos) {
+      magnitude = 1;
+    } else if (y->fraction.substr(common).find_first_not_of('0') !=
+               absl::string_view::npos) {
+      magnitude = -1;
+    }
+  }
+  return x->negative ? -magnitude : magnitude;
+}
+
+std::optional<std::string> AddPgNumerics(absl::string_view lhs,
+                                         absl::string_view rhs) {
+  return Add(lhs, rhs, /*negate_rhs=*/false);
+}
+
+std::optional<std::string> SubtractPgNumerics(absl::string_view lhs,
+                                              absl::string_view rhs) {
+  return Add(lhs, rhs, /*negate_rhs=*/true);
+}
+
+std::optional<std::string> MultiplyPgNumerics(absl::string_view lhs,
+                                              absl::string_view rhs) {
+  if (IsNaN(lhs) || IsNaN(rhs)) {
+    return IsNormalizedPgNumeric(lhs) && IsNormalizedPgNumeric(rhs)
+               ? std::make_optional<std::string>(kPGNumericNaN)
+               : std::nullopt;
+  }
+  std::optional<NumericParts> lhs_parts = Split(lhs);
+  std::optional<NumericParts> rhs_parts = Split(rhs);
+  if (!lhs_parts.has_value() || !rhs_parts.has_value()) {
+    return std::nullopt;
+  }
+  // PostgreSQL keeps every fractional digit of the product, and rounds it
+  // only when that exceeds the maximum scale.
+  if (lhs_parts->fraction.size() + rhs_parts->fraction.size() >
+      kMaxPGNumericFractionalDigits) {
+    return std::nullopt;
+  }
+  const Decimal x = ToDecimal(*lhs_parts);
+  const Decimal y = ToDecimal(*rhs_parts);
+  Decimal product;
+  product.negative = x.negative != y.negative;
+  product.scale = x.scale + y.scale;
+  product.coefficient = MultiplyMagnitudes(x.coefficient, y.coefficient);
+  return Print(product);
+}
+
+std::optional<std::string> NegatePgNumeric(absl::string_view value) {
+  if (IsNaN(value)) {
+    return std::string(value);
+  }
+  std::optional<NumericParts> parts = Split(value);
+  if (!parts.has_value()) {
+    return std::nullopt;
+  }
+  if (parts->negative) {
+    return std::string(value.substr(1));
+  }
+  if (parts->whole == "0" &&
+      parts->fraction.find_first_not_of('0') == absl::string_view::npos) {
+    return std::string(value);
+  }
+  return absl::StrCat("-", value);
+}
+
+std::optional<std::string> AbsPgNumeric(absl::string_view value) {
+  if (!IsNormalizedPgNumeric(value)) {
+    return std::nullopt;
+  }
+  if (!value.empty() && value.front() == '-') {
+    value.remove_prefix(1);
+  }
+  return std::string(value);
+}
+
+}  // namespace postgres_translator::spangres::datatypes::common
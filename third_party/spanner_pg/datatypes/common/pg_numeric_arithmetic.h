@@ -0,0 +1,84 @@
+//
+// PostgreSQL is released under the PostgreSQL License, a liberal Open Source
+// license, similar to the BSD or MIT licenses.
+//
+// PostgreSQL Database Management System
+// (formerly known as Postgres, then as Postgres95)
+//
+// Portions Copyright © 1996-2020, The PostgreSQL Global Development Group
+//
+// Portions Copyright © 1994, The Regents of the University of California
+//
+// Portions Copyright 2023 Google LLC
+//
+// Permission to use, copy, modify, and distribute this software and its
+// documentation for any purpose, without fee, and without a written agreement
+// is hereby granted, provided that the above copyright notice and this
+// paragraph and the following two paragraphs appear in all copies.
+//
+// IN NO EVENT SHALL THE UNIVERSITY OF CALIFORNIA BE LIABLE TO ANY PARTY FOR
+// DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+// LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+// EVEN IF THE UNIVERSITY OF CALIFORNIA HAS BEEN ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+//
+// THE UNIVERSITY OF CALIFORNIA SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+// INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+// FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON AN
+// "AS IS" BASIS, AND THE UNIVERSITY OF CALIFORNIA HAS NO OBLIGATIONS TO PROVIDE
+// MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+//------------------------------------------------------------------------------
+
+#ifndef DATATYPES_COMMON_PG_NUMERIC_ARITHMETIC_H_
+#define DATATYPES_COMMON_PG_NUMERIC_ARITHMETIC_H_
+
+#include <optional>
+#include <string>
+
+#include "absl/strings/string_view.h"
+
+// Native implementations of the most common PG.NUMERIC operations. They work
+// directly on the normalized representation produced by PostgreSQL's
+// `numeric_out` and give the same results as the PostgreSQL functions, without
+// converting the values to datums in a PG memory context.
+//
+// Every function returns std::nullopt for the inputs it does not handle: values
+// that are not in normalized representation and results that PostgreSQL would
+// reject or round. Callers fall back to the PostgreSQL implementation in that
+// case, so that errors are reported exactly as PostgreSQL reports them.
+namespace postgres_translator::spangres::datatypes::common {
+
+// Returns true if `value` is in the normalized representation that PostgreSQL's
+// `numeric_out` produces for a value without typmod: "NaN", or an optional
+// minus sign on a non-zero value, the whole digits without leading zeros and
+// optionally a decimal point followed by at least one fractional digit.
+bool IsNormalizedPgNumeric(absl::string_view value);
+
+// Compares the normalized `lhs` and `rhs` like PostgreSQL's `numeric_cmp`.
+// Returns a negative value, zero or a positive value if `lhs` is less than,
+// equal to or greater than `rhs`. NaN equals NaN and is greater than all other
+// values.
+std::optional<int> ComparePgNumerics(absl::string_view lhs,
+                                     absl::string_view rhs);
+
+// Returns `lhs` + `rhs`, like PostgreSQL's `numeric_add`.
+std::optional<std::string> AddPgNumerics(absl::string_view lhs,
+                                         absl::string_view rhs);
+
+// Returns `lhs` - `rhs`, like PostgreSQL's `numeric_sub`.
+std::optional<std::string> SubtractPgNumerics(absl::string_view lhs,
+                                              absl::string_view rhs);
+
+// Returns `lhs` * `rhs`, like PostgreSQL's `numeric_mul`.
+std::optional<std::string> MultiplyPgNumerics(absl::string_view lhs,
+                                              absl::string_view rhs);
+
+// Returns -`value`, like PostgreSQL's `numeric_uminus`.
+std::optional<std::string> NegatePgNumeric(absl::string_view value);
+
+// Returns the absolute value of `value`, like PostgreSQL's `numeric_abs`.
+std::optional<std::string> AbsPgNumeric(absl::string_view value);
+
+}  // namespace postgres_translator::spangres::datatypes::common
+
+#endif  // DATATYPES_COMMON_PG_NUMERIC_ARITHMETIC_H_
@@ -0,0 +1,135 @@
+//
+// PostgreSQL is released under the PostgreSQL License, a liberal Open Source
+// license, similar to the BSD or MIT licenses.
+//
+// PostgreSQL Database Management System
+// (formerly known as Postgres, then as Postgres95)
+//
+// Portions Copyright © 1996-2020, The PostgreSQL Global Development Group
+//
+// Portions Copyright © 1994, The Regents of the University of California
+//
+// Portions Copyright 2023 Google LLC
+//
+// Permission to use, copy, modify, and distribute this software and its
+// documentation for any purpose, without fee, and without a written agreement
+// is hereby granted, provided that the above copyright notice and this
+// paragraph and the following two paragraphs appear in all copies.
+//
+// IN NO EVENT SHALL THE UNIVERSITY OF CALIFORNIA BE LIABLE TO ANY PARTY FOR
+// DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+// LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+// EVEN IF THE UNIVERSITY OF CALIFORNIA HAS BEEN ADVISED OF THE POSSIBILITY OF
+// SUCH DAMAGE.
+//
+// THE UNIVERSITY OF CALIFORNIA SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+// INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+// FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON AN
+// "AS IS" BASIS, AND THE UNIVERSITY OF CALIFORNIA HAS NO OBLIGATIONS TO PROVIDE
+// MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+//------------------------------------------------------------------------------
+
+#include "third_party/spanner_pg/datatypes/common/pg_numeric_arithmetic.h"
+
+#include <optional>
+#include <string>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "third_party/spanner_pg/datatypes/common/numeric_core.h"
+
+namespace postgres_translator::spangres::datatypes::common {
+namespace {
+
+using ::testing::Eq;
+using ::testing::Optional;
+
+TEST(PgNumericArithmeticTest, IsNormalizedPgNumeric) {
+  EXPECT_TRUE(IsNormalizedPgNumeric("0"));
+  EXPECT_TRUE(IsNormalizedPgNumeric("0.000"));
+  EXPECT_TRUE(IsNormalizedPgNumeric("-12.50"));
+  EXPECT_TRUE(IsNormalizedPgNumeric("NaN"));
+
+  EXPECT_FALSE(IsNormalizedPgNumeric(""));
+  EXPECT_FALSE(IsNormalizedPgNumeric("-0"));
+  EXPECT_FALSE(IsNormalizedPgNumeric("-0.00"));
+  EXPECT_FALSE(IsNormalizedPgNumeric("+1"));
+  EXPECT_FALSE(IsNormalizedPgNumeric("01"));
+  EXPECT_FALSE(IsNormalizedPgNumeric("1."));
+  EXPECT_FALSE(IsNormalizedPgNumeric(".5"));
+  EXPECT_FALSE(IsNormalizedPgNumeric("1e5"));
+  EXPECT_FALSE(IsNormalizedPgNumeric(" 1"));
+  EXPECT_FALSE(IsNormalizedPgNumeric("Infinity"));
+  EXPECT_FALSE(IsNormalizedPgNumeric("nan"));
+}
+
+TEST(PgNumericArithmeticTest, ComparePgNumerics) {
+  EXPECT_THAT(ComparePgNumerics("1.10", "1.1"), Optional(Eq(0)));
+  EXPECT_THAT(ComparePgNumerics("0.5", "1"), Optional(Eq(-1)));
+  EXPECT_THAT(ComparePgNumerics("10", "9.99"), Optional(Eq(1)));
+  EXPECT_THAT(ComparePgNumerics("1.001", "1.0009"), Optional(Eq(1)));
+  EXPECT_THAT(ComparePgNumerics("1.1", "1.1001"), Optional(Eq(-1)));
+  EXPECT_THAT(ComparePgNumerics("-2", "-10"), Optional(Eq(1)));
+  EXPECT_THAT(ComparePgNumerics("-1", "0"), Optional(Eq(-1)));
+  EXPECT_THAT(ComparePgNumerics("NaN", "NaN"), Optional(Eq(0)));
+  EXPECT_THAT(ComparePgNumerics("NaN", "1000"), Optional(Eq(1)));
+  EXPECT_THAT(ComparePgNumerics("-1000", "NaN"), Optional(Eq(-1)));
+
+  EXPECT_EQ(ComparePgNumerics("1e3", "1"), std::nullopt);
+  EXPECT_EQ(ComparePgNumerics("NaN", "01"), std::nullopt);
+}
+
+TEST(PgNumericArithmeticTest, AddAndSubtractKeepTheLargerScale) {
+  EXPECT_THAT(AddPgNumerics("1.5", "2.25"), Optional(Eq("3.75")));
+  EXPECT_THAT(AddPgNumerics("1.50", "-1.5"), Optional(Eq("0.00")));
+  EXPECT_THAT(AddPgNumerics("999999999", "1"), Optional(Eq("1000000000")));
+  EXPECT_THAT(AddPgNumerics("-0.001", "0.0001"), Optional(Eq("-0.0009")));
+  EXPECT_THAT(SubtractPgNumerics("1", "1.000"), Optional(Eq("0.000")));
+  EXPECT_THAT(SubtractPgNumerics("-5", "-7.5"), Optional(Eq("2.5")));
+  EXPECT_THAT(SubtractPgNumerics("1000000000.1", "0.2"),
+              Optional(Eq("999999999.9")));
+  EXPECT_THAT(AddPgNumerics("NaN", "1"), Optional(Eq("NaN")));
+  EXPECT_THAT(SubtractPgNumerics("1", "NaN"), Optional(Eq("NaN")));
+}
+
+TEST(PgNumericArithmeticTest, MultiplyKeepsAllFractionalDigits) {
+  EXPECT_THAT(MultiplyPgNumerics("1.5", "2.25"), Optional(Eq("3.375")));
+  EXPECT_THAT(MultiplyPgNumerics("0.00", "-1.5"), Optional(Eq("0.000")));
+  EXPECT_THAT(MultiplyPgNumerics("-0.1", "0.1"), Optional(Eq("-0.01")));
+  EXPECT_THAT(MultiplyPgNumerics("123456789012345678901234567890",
+                                 "-987654321098765432109876543210"),
+              Optional(Eq("-121932631137021795226185032733622923332237463801"
+                          "111263526900")));
+  EXPECT_THAT(MultiplyPgNumerics("NaN", "0"), Optional(Eq("NaN")));
+}
+
+TEST(PgNumericArithmeticTest, NegateAndAbs) {
+  EXPECT_THAT(NegatePgNumeric("1.50"), Optional(Eq("-1.50")));
+  EXPECT_THAT(NegatePgNumeric("-1.50"), Optional(Eq("1.50")));
+  EXPECT_THAT(NegatePgNumeric("0.0"), Optional(Eq("0.0")));
+  EXPECT_THAT(NegatePgNumeric("NaN"), Optional(Eq("NaN")));
+  EXPECT_THAT(AbsPgNumeric("-3.14"), Optional(Eq("3.14")));
+  EXPECT_THAT(AbsPgNumeric("3.14"), Optional(Eq("3.14")));
+  EXPECT_THAT(AbsPgNumeric("NaN"), Optional(Eq("NaN")));
+}
+
+TEST(PgNumericArithmeticTest, LeavesOtherInputsToPostgreSQL) {
+  EXPECT_EQ(AddPgNumerics("1e3", "1"), std::nullopt);
+  EXPECT_EQ(AddPgNumerics("1", "Infinity"), std::nullopt);
+  EXPECT_EQ(MultiplyPgNumerics("NaN", "1."), std::nullopt);
+  EXPECT_EQ(NegatePgNumeric("-0"), std::nullopt);
+  EXPECT_EQ(AbsPgNumeric(" 1"), std::nullopt);
+
+  // Results out of range of PG.NUMERIC.
+  const std::string max_whole(kMaxPGNumericWholeDigits, '9');
+  EXPECT_EQ(AddPgNumerics(max_whole, "1"), std::nullopt);
+  EXPECT_EQ(MultiplyPgNumerics(max_whole, "10"), std::nullopt);
+
+  // Products that PostgreSQL would round.
+  const std::string min_fraction =
+      "0." + std::string(kMaxPGNumericFractionalDigits - 1, '0') + "1";
+  EXPECT_EQ(MultiplyPgNumerics(min_fraction, "0.1"), std::nullopt);
+}
+
+}  // namespace
+}  // namespace postgres_translator::spangres::datatypes::common
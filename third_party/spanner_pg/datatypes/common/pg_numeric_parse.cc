@@ -41,6 +41,7 @@
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "absl/strings/substitute.h"
+#include "third_party/spanner_pg/datatypes/common/pg_numeric_arithmetic.h"
 #include "third_party/spanner_pg/postgres_includes/all.h"
 #include "third_party/spanner_pg/shims/error_shim.h"
 #include "zetasql/base/ret_check.h"
@@ -123,6 +124,11 @@ absl::StatusOr<int32_t> GetTypeModifier(int64_t precision, int64_t scale = 0) {
 
 absl::StatusOr<std::string> NormalizePgNumeric(
     absl::string_view readable_value) {
+  // Values that are already normalized, such as the results of the native
+  // arithmetic and the numbers of normalized PG.JSONB, don't need PostgreSQL.
+  if (IsNormalizedPgNumeric(readable_value)) {
+    return std::string(readable_value);
+  }
   return NormalizePgNumeric(readable_value, /*typmod=*/-1);
 }
 
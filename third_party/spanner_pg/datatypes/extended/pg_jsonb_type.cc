@@ -32,6 +32,8 @@
 #include "third_party/spanner_pg/datatypes/extended/pg_jsonb_type.h"
 
 #include <cstdint>
+#include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -46,6 +48,7 @@
 #include "zetasql/public/types/value_equality_check_options.h"
 #include "zetasql/public/value.h"
 #include "zetasql/public/value_content.h"
+#include "absl/base/call_once.h"
 #include "absl/flags/flag.h"
 #include "absl/hash/hash.h"
 #include "absl/log/check.h"
@@ -77,6 +80,8 @@ using TypeProto = ::zetasql::TypeProto;
 using ValueContent = ::zetasql::ValueContent;
 using ValueProto = ::zetasql::ValueProto;
 using postgres_translator::spangres::datatypes::common::jsonb::ParseJsonb;
+using postgres_translator::spangres::datatypes::common::jsonb::PgJsonbValue;
+using postgres_translator::spangres::datatypes::common::jsonb::TreeNode;
 using TypeAnnotationCode = ::google::spanner::v1::TypeAnnotationCode;
 
 using absl::StrAppend;
@@ -99,8 +104,35 @@ class PgJsonbRef final : public CompactReferenceCounted<PgJsonbRef> {
     return sizeof(PgJsonbRef) + normalized_.size() * sizeof(char);
   }
 
+  // Returns the parsed value, parsing it on first use.
+  absl::StatusOr<const PgJsonbValue*> parsed() const {
+    absl::call_once(parse_once_, [this]() {
+      parsed_ = std::make_unique<Parsed>();
+      absl::StatusOr<PgJsonbValue> root = PgJsonbValue::Parse(
+          std::string(normalized_), &parsed_->tree_nodes);
+      if (root.ok()) {
+        parsed_->root.emplace(*std::move(root));
+      } else {
+        parsed_->status = std::move(root).status();
+      }
+    });
+    if (!parsed_->root.has_value()) {
+      return parsed_->status;
+    }
+    return &*parsed_->root;
+  }
+
  private:
+  struct Parsed {
+    std::vector<std::unique_ptr<TreeNode>> tree_nodes;
+    std::optional<PgJsonbValue> root;
+    absl::Status status;
+  };
+
   const absl::Cord normalized_;
+
+  mutable absl::once_flag parse_once_;
+  mutable std::unique_ptr<Parsed> parsed_;
 };
 
 class PgJsonbType : public SpannerExtendedType {
@@ -265,7 +297,7 @@ absl::StatusOr<zetasql::Value> CreatePgJsonbValueWithMemoryContext(
     absl::string_view jsonb_string) {
   ZETASQL_ASSIGN_OR_RETURN(
       std::unique_ptr<postgres_translator::interfaces::PGArena> pg_arena,
-      postgres_translator::interfaces::CreatePGArena(nullptr));
+      postgres_translator::interfaces::CreateThreadLocalPGArena(nullptr));
   return spangres::datatypes::CreatePgJsonbValue(jsonb_string);
 }
 
@@ -283,5 +315,12 @@ absl::StatusOr<absl::Cord> GetPgJsonbNormalizedValue(
   return value.extended_value().GetAs<PgJsonbRef*>()->value();
 }
 
+absl::StatusOr<const PgJsonbValue*> GetPgJsonbParsedValue(
+    const zetasql::Value& value) {
+  ZETASQL_RET_CHECK(!value.is_null());
+  ZETASQL_RET_CHECK(value.type() == GetPgJsonbType());
+  return value.extended_value().GetAs<PgJsonbRef*>()->parsed();
+}
+
 }  // namespace datatypes
 }  // namespace postgres_translator::spangres
@@ -38,6 +38,7 @@
 #include "absl/status/statusor.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/string_view.h"
+#include "third_party/spanner_pg/datatypes/common/jsonb/jsonb_value.h"
 #include "third_party/spanner_pg/datatypes/extended/spanner_extended_type.h"
 
 namespace postgres_translator::spangres {
@@ -71,6 +72,14 @@ zetasql::Value CreatePgJsonbValueFromNormalized(
 absl::StatusOr<absl::Cord> GetPgJsonbNormalizedValue(
     const zetasql::Value& value);
 
+// Returns the parsed representation of the PG.JSONB `value`, so that lookups
+// into the document don't have to parse it or convert it to a PG datum.
+// Returns error if `value` doesn't contain non-NULL value of PG.JSONB. The
+// document is parsed once and shared by all the copies of `value`, which own
+// it. It must not be modified.
+absl::StatusOr<const common::jsonb::PgJsonbValue*> GetPgJsonbParsedValue(
+    const zetasql::Value& value);
+
 }  // namespace datatypes
 }  // namespace postgres_translator::spangres
 #endif  // DATATYPES_EXTENDED_PG_JSONB_TYPE_H_
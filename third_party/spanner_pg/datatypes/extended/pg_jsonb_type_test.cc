@@ -54,8 +54,10 @@ using google::spanner::v1::TypeAnnotationCode;
 using ::postgres_translator::spangres::datatypes::CreatePgJsonbValue;
 using ::postgres_translator::spangres::datatypes::GetPgJsonbArrayType;
 using ::postgres_translator::spangres::datatypes::GetPgJsonbNormalizedValue;
+using ::postgres_translator::spangres::datatypes::GetPgJsonbParsedValue;
 using ::postgres_translator::spangres::datatypes::GetPgJsonbType;
 using ::postgres_translator::spangres::datatypes::SpannerExtendedType;
+using ::zetasql_base::testing::IsOkAndHolds;
 
 using PgJsonbTypeTest = postgres_translator::test::ValidMemoryContext;
 
@@ -91,6 +93,22 @@ TEST_F(PgJsonbTypeTest, GetExtendedValue) {
   validate_extended_value("null");
 }
 
+TEST_F(PgJsonbTypeTest, GetParsedValue) {
+  ZETASQL_ASSERT_OK_AND_ASSIGN(zetasql::Value pg_jsonb,
+                       CreatePgJsonbValue("{\"a\": [1, \"b\"]}"));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      const postgres_translator::spangres::datatypes::common::jsonb::
+          PgJsonbValue* parsed,
+      GetPgJsonbParsedValue(pg_jsonb));
+  ASSERT_TRUE(parsed->IsObject());
+  EXPECT_EQ(parsed->GetMemberIfExists("a")->Serialize(), "[1, \"b\"]");
+
+  // Copies of a value share its parsed representation.
+  zetasql::Value copy = pg_jsonb;
+  EXPECT_THAT(GetPgJsonbParsedValue(copy),
+              IsOkAndHolds(parsed));
+}
+
 TEST(PgJsonbArrayTypeTest, ValidateTypeProperties) {
   const zetasql::ArrayType* type = GetPgJsonbArrayType();
   ASSERT_NE(type, nullptr);
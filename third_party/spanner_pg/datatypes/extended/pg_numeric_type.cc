@@ -32,6 +32,7 @@
 #include "third_party/spanner_pg/datatypes/extended/pg_numeric_type.h"
 
 #include <cstdint>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -55,6 +56,7 @@
 #include "absl/strings/cord.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "third_party/spanner_pg/datatypes/common/pg_numeric_arithmetic.h"
 #include "third_party/spanner_pg/datatypes/common/pg_numeric_parse.h"
 #include "third_party/spanner_pg/datatypes/extended/spanner_extended_type.h"
 #include "third_party/spanner_pg/interface/pg_arena.h"
@@ -236,8 +238,6 @@ class PgNumericType : public SpannerExtendedType {
   absl::StatusOr<int32_t> CollatedCompare(
       const absl::Cord& lhs_normalized,
       const absl::Cord& rhs_normalized) const {
-    // This implementation calls PG `numeric_cmp` to compare the input numerics.
-
     // Convert absl::Cord to std::string
     std::string lhs_normalized_str;
     lhs_normalized_str.reserve(lhs_normalized.size());
@@ -246,9 +246,17 @@ class PgNumericType : public SpannerExtendedType {
     rhs_normalized_str.reserve(rhs_normalized.size());
     absl::CopyCordToString(rhs_normalized, &rhs_normalized_str);
 
+    // Normalized values are compared natively. PG `numeric_cmp` is only
+    // called for the values that the native comparison does not handle.
+    if (std::optional<int> native_result =
+            common::ComparePgNumerics(lhs_normalized_str, rhs_normalized_str);
+        native_result.has_value()) {
+      return *native_result;
+    }
+
      // Setup the memory context arena which is required for PG function calls.
     auto set_up_arena =
-         postgres_translator::interfaces::CreatePGArena(nullptr);
+         postgres_translator::interfaces::CreateThreadLocalPGArena(nullptr);
     // If the arena setup fails and it isn't because the arena has already been
     // setup, return the error.
     if (!set_up_arena.ok() &&
@@ -379,7 +387,7 @@ absl::StatusOr<zetasql::Value> CreatePgNumericValueWithMemoryContext(
     absl::string_view numeric_string) {
   ZETASQL_ASSIGN_OR_RETURN(
       std::unique_ptr<postgres_translator::interfaces::PGArena> pg_arena,
-      postgres_translator::interfaces::CreatePGArena(nullptr));
+      postgres_translator::interfaces::CreateThreadLocalPGArena(nullptr));
   return CreatePgNumericValue(numeric_string);
 }
 
@@ -47,4 +47,10 @@ absl::StatusOr<std::unique_ptr<PGArena>> CreatePGArena(
       std::move(memory_reservation_manager));
 }
 
+absl::StatusOr<std::unique_ptr<PGArena>> CreateThreadLocalPGArena(
+    std::unique_ptr<MemoryReservationManager> memory_reservation_manager) {
+  return spangres::ThreadLocalMemoryContextPGArena::Init(
+      std::move(memory_reservation_manager));
+}
+
 }  // namespace postgres_translator::interfaces
@@ -31,6 +31,7 @@
 
 #include "third_party/spanner_pg/interface/regexp_evaluators.h"
 
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
@@ -50,6 +51,10 @@ inline constexpr Datum kNullDatum = 0;
 
 void CleanupRegexCache() { CleanupCompiledRegexCache(); }
 
+int64_t RegexCacheHits() { return CompiledRegexCacheHits(); }
+
+int64_t RegexCacheMisses() { return CompiledRegexCacheMisses(); }
+
 static absl::StatusOr<std::unique_ptr<std::vector<std::string>>>
 RegexpSplitToArray(absl::string_view string, absl::string_view pattern,
                    std::optional<absl::string_view> flags) {
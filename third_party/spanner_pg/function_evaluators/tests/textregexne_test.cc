@@ -29,6 +29,8 @@
 // MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 //------------------------------------------------------------------------------
 
+#include <cstdint>
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "zetasql/base/testing/status_matchers.h"
@@ -66,6 +68,21 @@ TEST_F(TextregexneTest, ReturnsFalseWhenExpressionMatchesRegex) {
   EXPECT_THAT(Textregexne("", ""), IsOkAndHolds(IsFalse()));
 }
 
+TEST(TextregexneCacheTest, ReusesCompiledRegexAcrossArenas) {
+  const int64_t hits = RegexCacheHits();
+  const int64_t misses = RegexCacheMisses();
+  {
+    ZETASQL_ASSERT_OK_AND_ASSIGN(auto pg_arena, SetUpPgMemoryArena());
+    EXPECT_THAT(Textregexne("abcde", "^abc.*"), IsOkAndHolds(IsFalse()));
+  }
+  // The regex compiled under the previous arena is still cached.
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto pg_arena, SetUpPgMemoryArena());
+  EXPECT_THAT(Textregexne("xyz", "^abc.*"), IsOkAndHolds(IsTrue()));
+  EXPECT_EQ(RegexCacheMisses() - misses, 1);
+  EXPECT_EQ(RegexCacheHits() - hits, 1);
+  CleanupRegexCache();
+}
+
 // ReDOS -
 // https://owasp.org/www-community/attacks/Regular_expression_Denial_of_Service_-_ReDoS
 TEST_F(TextregexneTest, HandlesReDOSGracefully) {
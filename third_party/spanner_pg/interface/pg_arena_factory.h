@@ -43,6 +43,15 @@ namespace postgres_translator::interfaces {
 absl::StatusOr<std::unique_ptr<PGArena>> CreatePGArena(
     std::unique_ptr<MemoryReservationManager> memory_reservation_manager);
 
+// Like CreatePGArena(), but reuses a memory context cached on the calling
+// thread instead of setting up and tearing down a new one per arena. Meant for
+// arenas that live for a single function call or row: everything allocated
+// against the arena is still freed when it is destroyed, and the thread is left
+// in the same state as by an arena from CreatePGArena(), except that timezone
+// definitions loaded by PG stay cached for the next arena on the thread.
+absl::StatusOr<std::unique_ptr<PGArena>> CreateThreadLocalPGArena(
+    std::unique_ptr<MemoryReservationManager> memory_reservation_manager);
+
 }  // namespace postgres_translator::interfaces
 
 #endif  // INTERFACE_PG_ARENA_FACTORY_H_
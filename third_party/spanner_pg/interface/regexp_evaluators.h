@@ -32,6 +32,7 @@
 #ifndef INTERFACE_REGEXP_EVALUATORS_H_
 #define INTERFACE_REGEXP_EVALUATORS_H_
 
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
@@ -43,8 +44,18 @@
 namespace postgres_translator::function_evaluators {
 
 // Frees the memory for the regex cache.
+//
+// Compiled regexes are cached per thread, keyed by pattern, flags and
+// collation, and stay valid across function calls and PG arenas until they
+// are evicted by newer patterns, so this only needs to be called to release
+// the memory held by the cache.
 void CleanupRegexCache();
 
+// Number of regex compilations served from and missed by the regex caches of
+// all threads.
+int64_t RegexCacheHits();
+int64_t RegexCacheMisses();
+
 // Returns string matches after splitting the input `string` by the given regex
 // `pattern`. If the `pattern` does not match anything within the input
 // `string`, the input `string` is returned as a single element in the output
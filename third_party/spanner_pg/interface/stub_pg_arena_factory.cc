@@ -38,4 +38,9 @@ absl::StatusOr<std::unique_ptr<PGArena>> CreatePGArena(
   return std::make_unique<PGArena>(std::move(memory_reservation_manager));
 }
 
+absl::StatusOr<std::unique_ptr<PGArena>> CreateThreadLocalPGArena(
+    std::unique_ptr<MemoryReservationManager> memory_reservation_manager) {
+  return std::make_unique<PGArena>(std::move(memory_reservation_manager));
+}
+
 }  // namespace postgres_translator::interfaces
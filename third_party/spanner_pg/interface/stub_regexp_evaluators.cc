@@ -36,6 +36,10 @@ namespace postgres_translator::function_evaluators {
 
 void CleanupRegexCache() {}
 
+int64_t RegexCacheHits() { return 0; }
+
+int64_t RegexCacheMisses() { return 0; }
+
 absl::StatusOr<std::unique_ptr<std::vector<std::string>>> RegexpSplitToArray(
     absl::string_view string, absl::string_view pattern) {
   return absl::UnimplementedError("invoked stub RegexpSplitToArray");
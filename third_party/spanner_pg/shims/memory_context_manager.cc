@@ -31,6 +31,8 @@
 
 #include "third_party/spanner_pg/shims/memory_context_manager.h"
 
+#include <utility>
+
 #include "zetasql/base/logging.h"
 #include "absl/status/status.h"
 #include "absl/synchronization/mutex.h"
@@ -216,4 +218,128 @@ bool ActiveMemoryContext::IsActive() const {
   return active_memory_context_.has_value();
 }
 
+namespace {
+
+// The contexts cached on a thread by ScopedThreadLocalMemoryContext.
+struct ThreadLocalMemoryContexts {
+  ~ThreadLocalMemoryContexts() {
+    // Compiled regexes outlive attached contexts too, in a context of their
+    // own, so release them along with the thread's cached contexts.
+    CleanupCompiledRegexCache();
+    if (root == nullptr) {
+      return;
+    }
+    absl::Status status = CheckedPgMemoryContextDelete(root);
+    if (status.ok() && CurrentMemoryContext == nullptr) {
+      status = CheckedPgAsetDeleteFreelists();
+    }
+    if (!status.ok()) {
+      ABSL_LOG(ERROR) << "Thread-local MemoryContext cleanup failed: "
+                      << status.message();
+    }
+  }
+
+  // Never installed itself; owns the timezone hashtable and `per_use`.
+  MemoryContext root = nullptr;
+  // Installed while attached and reset on every detach.
+  MemoryContext per_use = nullptr;
+  HTAB* timezone_cache = nullptr;
+};
+
+thread_local ThreadLocalMemoryContexts thread_local_memory_contexts;
+
+absl::Status CreateThreadLocalMemoryContexts(
+    ThreadLocalMemoryContexts& contexts) {
+  ZETASQL_ASSIGN_OR_RETURN(MemoryContext root,
+                   CheckedPgAllocSetContextCreateInternal(
+                       nullptr, "ThreadLocalMemoryContext",
+                       MemoryContextManager::kMinContextSize,
+                       MemoryContextManager::kInitBlockSize,
+                       MemoryContextManager::kMaxBlockSize),
+                   _.With(FailedMemoryContextCreation));
+  contexts.root = root;
+  ZETASQL_ASSIGN_OR_RETURN(contexts.per_use,
+                   CheckedPgAllocSetContextCreateInternal(
+                       root, "ThreadLocalMemoryContext per use",
+                       MemoryContextManager::kMinContextSize,
+                       MemoryContextManager::kInitBlockSize,
+                       MemoryContextManager::kMaxBlockSize),
+                   _.With(FailedMemoryContextCreation));
+
+  // pg_tzset() creates its hashtable in CurrentMemoryContext, so load a zone
+  // with `root` installed to keep the hashtable out of `per_use`.
+  CurrentMemoryContext = root;
+  TopMemoryContext = root;
+  absl::StatusOr<pg_tz*> gmt = CheckedPgTZSet("GMT");
+  contexts.timezone_cache = GetTimezoneHashtablePointer();
+  ClearTimezoneHashtablePointer();
+  CurrentMemoryContext = nullptr;
+  TopMemoryContext = nullptr;
+  ZETASQL_RETURN_IF_ERROR(gmt.status());
+  ZETASQL_RET_CHECK_NE(contexts.timezone_cache, nullptr);
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+absl::StatusOr<ScopedThreadLocalMemoryContext>
+ScopedThreadLocalMemoryContext::Attach() {
+  ZETASQL_RET_CHECK_EQ(CurrentMemoryContext, nullptr)
+      << "Memory context already present in slot.";
+  ZETASQL_RET_CHECK_EQ(TopMemoryContext, nullptr)
+      << "Memory context already present in top slot.";
+
+  ThreadLocalMemoryContexts& contexts = thread_local_memory_contexts;
+  if (contexts.timezone_cache == nullptr) {
+    if (contexts.root != nullptr) {
+      // A previous attempt failed halfway; start over.
+      MemoryContext root = contexts.root;
+      contexts.root = nullptr;
+      contexts.per_use = nullptr;
+      ZETASQL_RETURN_IF_ERROR(CheckedPgMemoryContextDelete(root));
+    }
+    ZETASQL_RETURN_IF_ERROR(CreateThreadLocalMemoryContexts(contexts));
+  }
+
+  CurrentMemoryContext = contexts.per_use;
+  TopMemoryContext = contexts.per_use;
+  SetTimezoneHashtablePointer(contexts.timezone_cache);
+  return ScopedThreadLocalMemoryContext(&CurrentMemoryContext);
+}
+
+ScopedThreadLocalMemoryContext::ScopedThreadLocalMemoryContext(
+    ScopedThreadLocalMemoryContext&& other) noexcept
+    : attached_slot_(std::exchange(other.attached_slot_, nullptr)) {}
+
+ScopedThreadLocalMemoryContext::~ScopedThreadLocalMemoryContext() {
+  absl::Status status = Detach();
+  if (!status.ok()) {
+    ABSL_LOG(ERROR) << "Thread-local MemoryContext detach failed: "
+                    << status.message();
+  }
+}
+
+absl::Status ScopedThreadLocalMemoryContext::Detach() {
+  if (attached_slot_ == nullptr) {
+    return absl::OkStatus();
+  }
+  if (attached_slot_ != &CurrentMemoryContext) {
+    return absl::InternalError(
+        "attempting to detach ScopedThreadLocalMemoryContext on a different "
+        "fiber from where it was attached");
+  }
+  attached_slot_ = nullptr;
+
+  // Leave no pointers into the contexts behind for the next user of the
+  // thread, then free what this use allocated.
+  absl::Status status = DeleteCacheMemoryContext();
+  session_timezone = nullptr;
+  log_timezone = nullptr;
+  ClearTimezoneHashtablePointer();
+  CurrentMemoryContext = nullptr;
+  TopMemoryContext = nullptr;
+  MemoryContextReset(thread_local_memory_contexts.per_use);
+  return status;
+}
+
 }  // namespace postgres_translator
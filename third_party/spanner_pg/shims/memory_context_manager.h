@@ -165,6 +165,54 @@ class MemoryContextManager {
   friend class ActiveMemoryContext;
 };
 
+// Attaches a PG MemoryContext that is cached on the calling thread, for
+// short-lived uses such as evaluating a single function call, where creating
+// and deleting a whole context each time would dominate the cost of the work.
+//
+// While an instance is alive, the cached context occupies the thread local
+// variables within PG, just like an ActiveMemoryContext does. Destroying (or
+// detaching) the instance frees everything that was allocated against the
+// context and nulls those variables again, so whatever runs next on the thread
+// sees the same state as after ActiveMemoryContext::Clear(). Only timezone
+// definitions loaded through pg_tzset() survive, in a parent context that is
+// never installed itself, so that selecting a timezone again is a hash lookup.
+// The cached contexts are deleted when the thread exits.
+class ScopedThreadLocalMemoryContext {
+ public:
+  // Attaches the calling thread's cached context, creating it on first use.
+  // Like MemoryContextManager::Init(), fails if a context is already present.
+  static absl::StatusOr<ScopedThreadLocalMemoryContext> Attach();
+
+  // Calls Detach(), logging and swallowing any non-ok status returned.
+  ~ScopedThreadLocalMemoryContext();
+
+  // Not copyable
+  ScopedThreadLocalMemoryContext(const ScopedThreadLocalMemoryContext&) =
+      delete;
+  ScopedThreadLocalMemoryContext& operator=(
+      const ScopedThreadLocalMemoryContext&) = delete;
+
+  // Move-constructible, so that it can be returned in a StatusOr. The input
+  // no longer represents the attached context.
+  ScopedThreadLocalMemoryContext(
+      ScopedThreadLocalMemoryContext&& other) noexcept;
+  ScopedThreadLocalMemoryContext& operator=(ScopedThreadLocalMemoryContext&&) =
+      delete;
+
+  // Frees everything allocated against the context and detaches it from the
+  // thread. Must be called on the thread that attached it; has no effect once
+  // it has already been called.
+  absl::Status Detach();
+
+ private:
+  explicit ScopedThreadLocalMemoryContext(MemoryContext* attached_slot)
+      : attached_slot_(attached_slot) {}
+
+  // The address of the thread-local CurrentMemoryContext on the thread that
+  // attached the context, or nullptr once detached. See ActiveMemoryContext.
+  MemoryContext* attached_slot_;
+};
+
 }  // namespace postgres_translator
 
 #endif  // SHIMS_MEMORY_CONTEXT_MANAGER_H_
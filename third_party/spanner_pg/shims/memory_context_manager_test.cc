@@ -98,5 +98,61 @@ TEST(MemoryContextTest, ContextWithChild) {
   MemoryContextReset(child);
   MemoryContextDelete(child);
 }
+
+TEST(ScopedThreadLocalMemoryContextTest, ReusesAndResetsContext) {
+  auto res_manager = std::make_unique<StubMemoryReservationManager>();
+  auto res_holder = MemoryReservationHolder::Create(res_manager.get());
+  ASSERT_EQ(CurrentMemoryContext, nullptr);
+
+  MemoryContext first_context;
+  {
+    ZETASQL_ASSERT_OK_AND_ASSIGN(ScopedThreadLocalMemoryContext context,
+                         ScopedThreadLocalMemoryContext::Attach());
+    first_context = CurrentMemoryContext;
+    ASSERT_NE(first_context, nullptr);
+    EXPECT_EQ(TopMemoryContext, first_context);
+    EXPECT_NE(palloc(123), nullptr);
+  }
+  // Detaching leaves the thread as if the context had been cleared.
+  EXPECT_EQ(CurrentMemoryContext, nullptr);
+  EXPECT_EQ(TopMemoryContext, nullptr);
+  EXPECT_EQ(GetTimezoneHashtablePointer(), nullptr);
+
+  // Attaching again reuses the same context, with nothing left allocated.
+  ZETASQL_ASSERT_OK_AND_ASSIGN(ScopedThreadLocalMemoryContext context,
+                       ScopedThreadLocalMemoryContext::Attach());
+  EXPECT_EQ(CurrentMemoryContext, first_context);
+  EXPECT_TRUE(MemoryContextIsEmpty(CurrentMemoryContext));
+  ZETASQL_ASSERT_OK(context.Detach());
+  EXPECT_EQ(CurrentMemoryContext, nullptr);
+}
+
+TEST(ScopedThreadLocalMemoryContextTest, KeepsLoadedTimezones) {
+  auto res_manager = std::make_unique<StubMemoryReservationManager>();
+  auto res_holder = MemoryReservationHolder::Create(res_manager.get());
+
+  pg_tz* first_timezone;
+  {
+    ZETASQL_ASSERT_OK_AND_ASSIGN(ScopedThreadLocalMemoryContext context,
+                         ScopedThreadLocalMemoryContext::Attach());
+    first_timezone = pg_tzset("GMT");
+    ASSERT_NE(first_timezone, nullptr);
+  }
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(ScopedThreadLocalMemoryContext context,
+                       ScopedThreadLocalMemoryContext::Attach());
+  EXPECT_EQ(pg_tzset("GMT"), first_timezone);
+}
+
+TEST(ScopedThreadLocalMemoryContextTest, FailsWithActiveContext) {
+  auto res_manager = std::make_unique<StubMemoryReservationManager>();
+  auto res_holder = MemoryReservationHolder::Create(res_manager.get());
+  ZETASQL_ASSERT_OK_AND_ASSIGN(ActiveMemoryContext active_context,
+                       MemoryContextManager::Init("TestMemoryContext"));
+
+  EXPECT_THAT(ScopedThreadLocalMemoryContext::Attach(),
+              StatusIs(absl::StatusCode::kInternal));
+}
+
 }  // namespace
 }  // namespace postgres_translator
@@ -79,6 +79,44 @@ class MemoryContextPGArena : public interfaces::PGArena {
   ActiveMemoryContext memory_context_;
 };
 
+// Implementation of PGArena that attaches the memory context cached on the
+// calling thread via an internal ScopedThreadLocalMemoryContext object, instead
+// of initializing a new one. See interfaces::CreateThreadLocalPGArena().
+class ThreadLocalMemoryContextPGArena : public interfaces::PGArena {
+ public:
+  ThreadLocalMemoryContextPGArena(
+      std::unique_ptr<interfaces::MemoryReservationManager>
+          memory_reservation_manager,
+      MemoryReservationHolder memory_reservation_holder,
+      ScopedThreadLocalMemoryContext memory_context)
+      : PGArena(std::move(memory_reservation_manager)),
+        memory_reservation_holder_(std::move(memory_reservation_holder)),
+        memory_context_(std::move(memory_context)) {}
+
+  ~ThreadLocalMemoryContextPGArena() override = default;
+
+  static absl::StatusOr<std::unique_ptr<ThreadLocalMemoryContextPGArena>> Init(
+      std::unique_ptr<interfaces::MemoryReservationManager>
+          memory_reservation_manager) {
+    if (memory_reservation_manager == nullptr) {
+      memory_reservation_manager =
+          std::make_unique<StubMemoryReservationManager>();
+    }
+    ZETASQL_ASSIGN_OR_RETURN(
+        MemoryReservationHolder holder,
+        MemoryReservationHolder::Create(memory_reservation_manager.get()));
+    ZETASQL_ASSIGN_OR_RETURN(ScopedThreadLocalMemoryContext context,
+                     ScopedThreadLocalMemoryContext::Attach());
+    return std::make_unique<ThreadLocalMemoryContextPGArena>(
+        std::move(memory_reservation_manager), std::move(holder),
+        std::move(context));
+  }
+
+ private:
+  MemoryReservationHolder memory_reservation_holder_;
+  ScopedThreadLocalMemoryContext memory_context_;
+};
+
 }  // namespace spangres
 }  // namespace postgres_translator
 
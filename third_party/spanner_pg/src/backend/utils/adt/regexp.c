@@ -29,9 +29,14 @@
  */
 #include "postgres.h"
 
+// SPANGRES BEGIN
+#include <pthread.h>
+// SPANGRES END
+
 #include "catalog/pg_type.h"
 #include "funcapi.h"
 #include "miscadmin.h"
+#include "port/atomics.h"
 #include "regex/regex.h"
 #include "utils/array.h"
 #include "utils/builtins.h"
@@ -108,11 +113,57 @@ typedef struct cached_re_str
 	int			cre_flags;		/* compile flags: extended,icase etc */
 	Oid			cre_collation;	/* collation to use */
 	regex_t		cre_re;			/* the compiled regular expression */
+	// SPANGRES BEGIN
+	MemoryContext cre_context;	/* memory context for this regex */
+	// SPANGRES END
 } cached_re_str;
 
 static __thread int	num_res = 0;		/* # of cached re's */
 static __thread cached_re_str re_array[MAX_CACHED_RES];	/* cached re's */
 
+// SPANGRES BEGIN
+// Each cached regex lives in its own memory context under this thread-local
+// parent, which is never installed as CurrentMemoryContext and does not belong
+// to any PGArena. That keeps the cache valid across function calls, arenas and
+// queries on the thread, instead of it having to be cleaned up together with
+// the context that happened to be current when a pattern was compiled.
+static __thread MemoryContext RegexpCacheMemoryContext = NULL;
+
+// Lookups in the compiled regex cache of a thread. Only the owning thread
+// updates them, with plain loads and stores rather than atomic increments, so
+// that lookups on different threads do not contend for a shared cache line.
+// Readers sum the counters of all threads.
+typedef struct RegexpCacheCounters
+{
+	pg_atomic_uint64 hits;
+	pg_atomic_uint64 misses;
+	struct RegexpCacheCounters *next;
+} RegexpCacheCounters;
+
+static __thread RegexpCacheCounters *regexp_cache_counters = NULL;
+
+// The counters of the live threads, and the lookups of the threads that
+// exited, guarded by regexp_cache_counters_mutex.
+static pthread_mutex_t regexp_cache_counters_mutex = PTHREAD_MUTEX_INITIALIZER;
+static RegexpCacheCounters *regexp_cache_counters_list = NULL;
+static uint64 retired_regex_cache_hits = 0;
+static uint64 retired_regex_cache_misses = 0;
+
+// Retires the counters of a thread when it exits.
+static pthread_key_t regexp_cache_counters_key;
+static pthread_once_t regexp_cache_counters_key_once = PTHREAD_ONCE_INIT;
+static bool regexp_cache_counters_key_created = false;
+
+// Deletes RegexpCacheMemoryContext when a thread exits. Threads that cache
+// their memory contexts clean up the regex cache along with them, but threads
+// that only ever use a MemoryContextPGArena would otherwise leak it.
+static pthread_key_t regexp_cache_thread_exit_key;
+static pthread_once_t regexp_cache_thread_exit_key_once = PTHREAD_ONCE_INIT;
+static bool regexp_cache_thread_exit_key_created = false;
+
+extern void AsetDeleteFreelists(void);
+// SPANGRES END
+
 
 /* Local functions */
 static regexp_matches_ctx *setup_regexp_matches(text *orig_str, text *pattern,
@@ -134,11 +185,127 @@ static Datum build_regexp_split_result(regexp_matches_ctx *splitctx);
 // encapsulation, we thought better to add the function directly here
 // than to copy all the functions that required it into a separate shim file.
 void CleanupCompiledRegexCache() {
-	for (int i = 0; i < num_res; ++i) {
-		pg_regfree(&re_array[i].cre_re);
-		pfree(re_array[i].cre_pat);
-	}
 	num_res = 0;
+	if (RegexpCacheMemoryContext != NULL) {
+		// Deletes the contexts of all cached regexes as well.
+		MemoryContextDelete(RegexpCacheMemoryContext);
+		RegexpCacheMemoryContext = NULL;
+	}
+}
+
+static void
+RegexpCacheThreadExit(void *arg)
+{
+	CleanupCompiledRegexCache();
+	// The deleted contexts are kept on the thread's freelists for reuse, which
+	// is not going to happen anymore. Other contexts of the thread may still
+	// refer to the freelists if one is current.
+	if (CurrentMemoryContext == NULL)
+		AsetDeleteFreelists();
+}
+
+static void
+CreateRegexpCacheThreadExitKey(void)
+{
+	// Errors cannot be thrown from here. Without the key, the cache is only
+	// cleaned up explicitly.
+	regexp_cache_thread_exit_key_created =
+		pthread_key_create(&regexp_cache_thread_exit_key,
+						   RegexpCacheThreadExit) == 0;
+}
+
+static void
+RetireRegexpCacheCounters(void *arg)
+{
+	RegexpCacheCounters *counters = (RegexpCacheCounters *) arg;
+	RegexpCacheCounters **link;
+
+	pthread_mutex_lock(&regexp_cache_counters_mutex);
+	for (link = &regexp_cache_counters_list; *link != NULL;
+		 link = &(*link)->next)
+	{
+		if (*link == counters)
+		{
+			*link = counters->next;
+			break;
+		}
+	}
+	retired_regex_cache_hits += pg_atomic_read_u64(&counters->hits);
+	retired_regex_cache_misses += pg_atomic_read_u64(&counters->misses);
+	pthread_mutex_unlock(&regexp_cache_counters_mutex);
+
+	regexp_cache_counters = NULL;
+	free(counters);
+}
+
+static void
+CreateRegexpCacheCountersKey(void)
+{
+	// Without the key, the counters of exited threads stay registered.
+	regexp_cache_counters_key_created =
+		pthread_key_create(&regexp_cache_counters_key,
+						   RetireRegexpCacheCounters) == 0;
+}
+
+// Returns the counters of this thread, registering them on first use, or NULL
+// if they cannot be allocated, in which case lookups are not counted.
+static RegexpCacheCounters *
+GetRegexpCacheCounters(void)
+{
+	RegexpCacheCounters *counters = regexp_cache_counters;
+
+	if (counters != NULL)
+		return counters;
+	counters = (RegexpCacheCounters *) malloc(sizeof(RegexpCacheCounters));
+	if (counters == NULL)
+		return NULL;
+	pg_atomic_init_u64(&counters->hits, 0);
+	pg_atomic_init_u64(&counters->misses, 0);
+
+	pthread_mutex_lock(&regexp_cache_counters_mutex);
+	counters->next = regexp_cache_counters_list;
+	regexp_cache_counters_list = counters;
+	pthread_mutex_unlock(&regexp_cache_counters_mutex);
+
+	pthread_once(&regexp_cache_counters_key_once,
+				 CreateRegexpCacheCountersKey);
+	if (regexp_cache_counters_key_created)
+		pthread_setspecific(regexp_cache_counters_key, counters);
+	regexp_cache_counters = counters;
+	return counters;
+}
+
+// Counts a lookup in `counter`, which only this thread updates.
+static inline void
+CountRegexpCacheLookup(pg_atomic_uint64 *counter)
+{
+	pg_atomic_write_u64(counter, pg_atomic_read_u64(counter) + 1);
+}
+
+uint64_t CompiledRegexCacheHits() {
+	uint64		hits;
+	RegexpCacheCounters *counters;
+
+	pthread_mutex_lock(&regexp_cache_counters_mutex);
+	hits = retired_regex_cache_hits;
+	for (counters = regexp_cache_counters_list; counters != NULL;
+		 counters = counters->next)
+		hits += pg_atomic_read_u64(&counters->hits);
+	pthread_mutex_unlock(&regexp_cache_counters_mutex);
+	return hits;
+}
+
+uint64_t CompiledRegexCacheMisses() {
+	uint64		misses;
+	RegexpCacheCounters *counters;
+
+	pthread_mutex_lock(&regexp_cache_counters_mutex);
+	misses = retired_regex_cache_misses;
+	for (counters = regexp_cache_counters_list; counters != NULL;
+		 counters = counters->next)
+		misses += pg_atomic_read_u64(&counters->misses);
+	pthread_mutex_unlock(&regexp_cache_counters_mutex);
+	return misses;
 }
 // SPANGRES END
 
@@ -165,6 +332,11 @@ RE_compile_and_cache(text *text_re, int cflags, Oid collation)
 	int			regcomp_result;
 	cached_re_str re_temp;
 	char		errMsg[100];
+	// SPANGRES BEGIN
+	MemoryContext re_cxt;
+	MemoryContext oldcontext;
+	RegexpCacheCounters *counters = GetRegexpCacheCounters();
+	// SPANGRES END
 
 	/*
 	 * Look for a match among previously compiled REs.  Since the data
@@ -188,10 +360,19 @@ RE_compile_and_cache(text *text_re, int cflags, Oid collation)
 				re_array[0] = re_temp;
 			}
 
+			// SPANGRES BEGIN
+			if (counters != NULL)
+				CountRegexpCacheLookup(&counters->hits);
+			// SPANGRES END
 			return &re_array[0].cre_re;
 		}
 	}
 
+	// SPANGRES BEGIN
+	if (counters != NULL)
+		CountRegexpCacheLookup(&counters->misses);
+	// SPANGRES END
+
 	/*
 	 * Couldn't find it, so try to compile the new RE.  To avoid leaking
 	 * resources on failure, we build into the re_temp local.
@@ -203,17 +384,56 @@ RE_compile_and_cache(text *text_re, int cflags, Oid collation)
 									   pattern,
 									   text_re_len);
 
-	regcomp_result = pg_regcomp(&re_temp.cre_re,
-								pattern,
-								pattern_len,
-								cflags,
-								collation);
+	// SPANGRES BEGIN
+	// Compile into a context of its own under RegexpCacheMemoryContext, so the
+	// compiled regex outlives the current context and can be freed on its own.
+	if (RegexpCacheMemoryContext == NULL)
+	{
+		RegexpCacheMemoryContext = AllocSetContextCreate(NULL,
+														 "RegexpCacheMemoryContext",
+														 ALLOCSET_SMALL_SIZES);
+		pthread_once(&regexp_cache_thread_exit_key_once,
+					 CreateRegexpCacheThreadExitKey);
+		// The destructor only runs for a non-NULL value.
+		if (regexp_cache_thread_exit_key_created)
+			pthread_setspecific(regexp_cache_thread_exit_key,
+								RegexpCacheMemoryContext);
+	}
+	re_cxt = AllocSetContextCreate(RegexpCacheMemoryContext,
+								   "RegexpMemoryContext",
+								   ALLOCSET_SMALL_SIZES);
+	oldcontext = MemoryContextSwitchTo(re_cxt);
+
+	// pg_regcomp reports out of memory and cancellation as errors, in which
+	// case the caller's context must be restored and the partially compiled
+	// regex freed, since nothing else refers to re_cxt.
+	PG_TRY();
+	{
+		regcomp_result = pg_regcomp(&re_temp.cre_re,
+									pattern,
+									pattern_len,
+									cflags,
+									collation);
+	}
+	PG_CATCH();
+	{
+		MemoryContextSwitchTo(oldcontext);
+		MemoryContextDelete(re_cxt);
+		PG_RE_THROW();
+	}
+	PG_END_TRY();
+
+	MemoryContextSwitchTo(oldcontext);
+	// SPANGRES END
 
 	pfree(pattern);
 
 	if (regcomp_result != REG_OKAY)
 	{
 		/* re didn't compile (no need for pg_regfree, if so) */
+		// SPANGRES BEGIN
+		MemoryContextDelete(re_cxt);
+		// SPANGRES END
 
 		/*
 		 * Here and in other places in this file, do CHECK_FOR_INTERRUPTS
@@ -230,11 +450,15 @@ RE_compile_and_cache(text *text_re, int cflags, Oid collation)
 	}
 
 	// SPANGRES BEGIN
-	re_temp.cre_pat = palloc(Max(text_re_len, 1));
+	re_temp.cre_pat = MemoryContextAlloc(re_cxt, Max(text_re_len, 1));
+	re_temp.cre_context = re_cxt;
 	// SPANGRES END
 	if (re_temp.cre_pat == NULL)
 	{
 		pg_regfree(&re_temp.cre_re);
+		// SPANGRES BEGIN
+		MemoryContextDelete(re_cxt);
+		// SPANGRES END
 		ereport(ERROR,
 				(errcode(ERRCODE_OUT_OF_MEMORY),
 				 errmsg("out of memory")));
@@ -252,9 +476,9 @@ RE_compile_and_cache(text *text_re, int cflags, Oid collation)
 	{
 		--num_res;
 		Assert(num_res < MAX_CACHED_RES);
-		pg_regfree(&re_array[num_res].cre_re);
 		// SPANGRES BEGIN
-		pfree(re_array[num_res].cre_pat);
+		// Frees the compiled regex and its pattern.
+		MemoryContextDelete(re_array[num_res].cre_context);
 		// SPANGRES END
 	}
 
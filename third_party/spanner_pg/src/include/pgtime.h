@@ -84,6 +84,8 @@ extern size_t pg_strftime(char *s, size_t max, const char *format,
 // Make these globals thread-locals and add a cleanup function.
 // See pgtz.c for more background.
 void ClearTimezoneHashtablePointer();
+struct HTAB *GetTimezoneHashtablePointer();
+void SetTimezoneHashtablePointer(struct HTAB *cache);
 extern __thread PGDLLIMPORT pg_tz *session_timezone;
 extern __thread PGDLLIMPORT pg_tz *log_timezone;
 // Make gmtptr global so that it can be cleaned up.
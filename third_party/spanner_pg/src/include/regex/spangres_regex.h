@@ -12,6 +12,11 @@
 // on this thread.
 extern void CleanupCompiledRegexCache();
 
+// Returns the number of lookups in the compiled regex caches of all threads
+// that found the pattern already compiled, or had to compile it, respectively.
+extern uint64_t CompiledRegexCacheHits();
+extern uint64_t CompiledRegexCacheMisses();
+
 // SPANGRES END
 
 #endif  // SRC_INCLUDE_REGEX_SPANGRES_REGEX_H_
@@ -223,6 +223,10 @@ typedef struct
 static __thread HTAB *timezone_cache = NULL;
 void ClearTimezoneHashtablePointer() { timezone_cache = NULL; }
 bool TimezoneCleared() { return timezone_cache == NULL; }
+// Let a thread-local memory context that outlives one setup/teardown cycle
+// keep its loaded timezones and reinstall them in the next cycle.
+HTAB *GetTimezoneHashtablePointer() { return timezone_cache; }
+void SetTimezoneHashtablePointer(HTAB *cache) { timezone_cache = cache; }
 /* SPANGRES END */
 
 static bool